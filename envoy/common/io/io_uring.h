@@ -2,7 +2,10 @@
 
 #include <functional>
 
+#include "envoy/buffer/buffer.h"
+#include "envoy/common/optref.h"
 #include "envoy/common/pure.h"
+#include "envoy/event/file_event.h"
 #include "envoy/network/address.h"
 #include "envoy/thread_local/thread_local.h"
 
@@ -133,6 +136,20 @@ public:
    */
   virtual IoUringResult prepareClose(os_fd_t fd, Request* user_data) PURE;
 
+  /**
+   * Prepares a cancellation and puts it into the submission queue.
+   * Returns IoUringResult::Failed in case the submission queue is full already
+   * and IoUringResult::Ok otherwise.
+   */
+  virtual IoUringResult prepareCancel(Request* cancelling_user_data, Request* user_data) PURE;
+
+  /**
+   * Prepares a shutdown system call and puts it into the submission queue.
+   * Returns IoUringResult::Failed in case the submission queue is full already
+   * and IoUringResult::Ok otherwise.
+   */
+  virtual IoUringResult prepareShutdown(os_fd_t fd, int how, Request* user_data) PURE;
+
   /**
    * Submits the entries in the submission queue to the kernel using the
    * `io_uring_enter()` system call.
@@ -166,6 +183,45 @@ public:
 using IoUringPtr = std::unique_ptr<IoUring>;
 class IoUringWorker;
 
+/**
+ * The status of IoUringSocket.
+ */
+enum IoUringSocketStatus {
+  Initialized,
+  ReadEnabled,
+  ReadDisabled,
+  Closed,
+};
+
+/**
+ * A callback will be invoked when a close requested done on the socket.
+ */
+using IoUringSocketOnClosedCb = std::function<void()>;
+
+/**
+ * The data returned from the read request.
+ */
+struct ReadParam {
+  Buffer::Instance& buf_;
+  int32_t result_;
+};
+
+/**
+ * The data returned from the write request.
+ */
+struct WriteParam {
+  int32_t result_;
+};
+
+/**
+ * The socket accepted by the accept request.
+ */
+struct AcceptedSocketParam {
+  os_fd_t fd_;
+  sockaddr_storage* remote_addr_;
+  socklen_t remote_addr_len_;
+};
+
 /**
  * Abstract for each socket.
  */
@@ -251,6 +307,96 @@ public:
    * @param type the request type of injected completion.
    */
   virtual void injectCompletion(Request::RequestType type) PURE;
+
+  /**
+   * Enable the socket. Read requests will be submitted and the file ready callback will be
+   * invoked with the read data.
+   */
+  virtual void enableRead() PURE;
+
+  /**
+   * Disable the socket. No further read requests will be submitted, the data already read
+   * from the kernel is kept until the socket is enabled again.
+   */
+  virtual void disableRead() PURE;
+
+  /**
+   * Enable or disable the delivery of the Closed event when the socket is disabled and the
+   * peer closes the connection.
+   * @param enable true to enable the close event.
+   */
+  virtual void enableCloseEvent(bool enable) PURE;
+
+  /**
+   * Close the socket. All the inflight requests are cancelled and a close request is submitted.
+   * The socket is released when the close request is done.
+   * @param keep_fd_open indicates the fd is not closed, only the inflight requests are cancelled.
+   * It is used when the fd is still owned by others, e.g. a listening socket shared by the
+   * listeners.
+   * @param cb the callback invoked when the socket is closed.
+   */
+  virtual void close(bool keep_fd_open, IoUringSocketOnClosedCb cb = nullptr) PURE;
+
+  /**
+   * Connect to the given address.
+   * @param address the peer address.
+   */
+  virtual void connect(const Network::Address::InstanceConstSharedPtr& address) PURE;
+
+  /**
+   * Move the data into the socket's write buffer and submit a write request for it. The write
+   * buffer is bounded: once it is full, the data is left in the given buffer and a Write event
+   * is delivered when there is room again.
+   * @param data the data to write, the moved data is drained from it.
+   * @return the number of bytes moved.
+   */
+  virtual uint64_t write(Buffer::Instance& data) PURE;
+
+  /**
+   * Copy the data in the slices into the socket's write buffer and submit a write request for it.
+   * As with write(Buffer::Instance&), no more than the room left in the write buffer is copied.
+   * @param slices the slices to write.
+   * @param num_slice the number of slices.
+   * @return the number of bytes copied.
+   */
+  virtual uint64_t write(const Buffer::RawSlice* slices, uint64_t num_slice) PURE;
+
+  /**
+   * Shutdown the socket. The shutdown request is submitted after all the pending data is
+   * written.
+   * @param how is SHUT_RD, SHUT_WR or SHUT_RDWR.
+   */
+  virtual void shutdown(int how) PURE;
+
+  /**
+   * Replace the file ready callback of the socket.
+   * @param cb the new callback.
+   */
+  virtual void setFileReadyCb(Event::FileReadyCb cb) PURE;
+
+  /**
+   * Return the data read from the kernel but not consumed yet and the result of the latest read
+   * request. The result is positive if there is no error, 0 if the remote closed the connection
+   * and a negative errno otherwise.
+   */
+  virtual OptRef<ReadParam> getReadParam() PURE;
+
+  /**
+   * Return the result of the latest failed write or connect request. It is only valid in the
+   * file ready callback for the Write event.
+   */
+  virtual OptRef<WriteParam> getWriteParam() PURE;
+
+  /**
+   * Return the socket accepted by the latest accept request. It is only valid in the file
+   * ready callback for the Read event of an accept socket.
+   */
+  virtual OptRef<AcceptedSocketParam> getAcceptedSocketParam() PURE;
+
+  /**
+   * Return the current status of the socket.
+   */
+  virtual IoUringSocketStatus getStatus() const PURE;
 };
 
 using IoUringSocketPtr = std::unique_ptr<IoUringSocket>;
@@ -266,6 +412,90 @@ public:
    * Return the current thread's dispatcher.
    */
   virtual Event::Dispatcher& dispatcher() PURE;
+
+  /**
+   * Add a listening socket to the worker. Accept requests are submitted for it and every
+   * accepted connection is delivered through the Read event.
+   * @param fd the listening socket.
+   * @param cb the file ready callback.
+   */
+  virtual IoUringSocket& addAcceptSocket(os_fd_t fd, Event::FileReadyCb cb) PURE;
+
+  /**
+   * Add an accepted socket to the worker.
+   * @param fd the accepted socket.
+   * @param cb the file ready callback.
+   */
+  virtual IoUringSocket& addServerSocket(os_fd_t fd, Event::FileReadyCb cb) PURE;
+
+  /**
+   * Add a client socket to the worker. The socket is connected with IoUringSocket::connect().
+   * @param fd the client socket.
+   * @param cb the file ready callback.
+   */
+  virtual IoUringSocket& addClientSocket(os_fd_t fd, Event::FileReadyCb cb) PURE;
+
+  /**
+   * Submit an accept request for the socket.
+   */
+  virtual Request* submitAcceptRequest(IoUringSocket& socket) PURE;
+
+  /**
+   * Submit a connect request for the socket.
+   */
+  virtual Request* submitConnectRequest(IoUringSocket& socket,
+                                        const Network::Address::InstanceConstSharedPtr& address)
+      PURE;
+
+  /**
+   * Submit a read request for the socket. The read buffer is owned by the request.
+   */
+  virtual Request* submitReadRequest(IoUringSocket& socket) PURE;
+
+  /**
+   * Submit a write request for the slices. The slices must stay valid until the request is done.
+   */
+  virtual Request* submitWriteRequest(IoUringSocket& socket,
+                                      const Buffer::RawSliceVector& slices) PURE;
+
+  /**
+   * Submit a close request for the socket.
+   */
+  virtual Request* submitCloseRequest(IoUringSocket& socket) PURE;
+
+  /**
+   * Submit a cancel request for the inflight request of the socket.
+   */
+  virtual Request* submitCancelRequest(IoUringSocket& socket, Request* request_to_cancel) PURE;
+
+  /**
+   * Submit a shutdown request for the socket.
+   */
+  virtual Request* submitShutdownRequest(IoUringSocket& socket, int how) PURE;
+};
+
+/**
+ * Abstract factory for IoUringWorker wrappers.
+ */
+class IoUringWorkerFactory {
+public:
+  virtual ~IoUringWorkerFactory() = default;
+
+  /**
+   * Returns the current thread's IoUringWorker. If the thread has not registered an
+   * IoUringWorker, an absl::nullopt will be returned.
+   */
+  virtual OptRef<IoUringWorker> getIoUringWorker() PURE;
+
+  /**
+   * Initializes an IoUringWorker on every registered thread.
+   */
+  virtual void onWorkerThreadInitialized() PURE;
+
+  /**
+   * Indicates whether the current thread has been registered for an IoUringWorker.
+   */
+  virtual bool currentThreadRegistered() PURE;
 };
 
 /**
@@ -205,6 +205,12 @@ public:
    */
   virtual std::chrono::milliseconds fileFlushIntervalMsec() const PURE;
 
+  /**
+   * @return bool whether the log files are flushed by a single shared thread, with a buffer per
+   *         writing thread, instead of a thread per file.
+   */
+  virtual bool fileFlushSharedThread() const PURE;
+
   /**
    * @return const std::string& the server's cluster.
    */
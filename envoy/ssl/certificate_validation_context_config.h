@@ -94,6 +94,14 @@ public:
    * @return the max depth used when verifying the certificate-chain
    */
   virtual absl::optional<uint32_t> maxVerifyDepth() const PURE;
+
+  /**
+   * @return the configuration of the verification of the certificate chains off the worker
+   * threads, or nullptr if they are verified on the worker threads.
+   */
+  virtual const envoy::extensions::transport_sockets::tls::v3::CertificateValidationContext::
+      AsyncValidation*
+      asyncValidation() const PURE;
 };
 
 using CertificateValidationContextConfigPtr = std::unique_ptr<CertificateValidationContextConfig>;
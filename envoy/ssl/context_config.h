@@ -113,6 +113,12 @@ public:
    */
   virtual const std::string& tlsKeyLogPath() const PURE;
 
+  /**
+   * @return whether the encryption of the records sent is handed over to the kernel (kTLS) once
+   *         the handshake completes.
+   */
+  virtual bool kernelTlsOffload() const PURE;
+
   /**
    * @return the access log manager object reference
    */
@@ -160,6 +166,15 @@ public:
     MustStaple,
   };
 
+  struct DynamicRecordSizing {
+    // The size of the plaintext of the small records.
+    uint32_t small_record_size_;
+    // The number of bytes sent in small records after the handshake and after each idle period.
+    uint64_t small_record_bytes_;
+    // How long a connection must have sent nothing to send small records again.
+    std::chrono::milliseconds idle_timeout_;
+  };
+
   /**
    * @return True if client certificate is required, false otherwise.
    */
@@ -194,11 +209,23 @@ public:
    */
   virtual bool disableStatefulSessionResumption() const PURE;
 
+  /**
+   * @return True if the TLS sessions are cached by the cache shared by all the server contexts,
+   * false otherwise.
+   */
+  virtual bool sharedSessionCache() const PURE;
+
   /**
    * @return True if we allow full scan certificates when there is no cert matching SNI during
    * downstream TLS handshake, false otherwise.
    */
   virtual bool fullScanCertsOnSNIMismatch() const PURE;
+
+  /**
+   * @return the sizes of the records sent with dynamic record sizing, or absl::nullopt if the
+   * records sent are always as large as the data written allows.
+   */
+  virtual absl::optional<DynamicRecordSizing> dynamicRecordSizing() const PURE;
 };
 
 using ServerContextConfigPtr = std::unique_ptr<ServerContextConfig>;
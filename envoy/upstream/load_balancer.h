@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstdint>
+#include <functional>
 #include <memory>
 
 #include "envoy/common/pure.h"
@@ -187,6 +188,23 @@ public:
 
 using LoadBalancerFactorySharedPtr = std::shared_ptr<LoadBalancerFactory>;
 
+/**
+ * Threads that thread aware load balancers can use to build their shared state off the main thread.
+ */
+class LoadBalancerBuildPool {
+public:
+  virtual ~LoadBalancerBuildPool() = default;
+
+  /**
+   * Run a build on one of the build threads. Builds start in the order they are posted. A build
+   * that has not started when the pool is destroyed is dropped.
+   * @param build supplies the build to run.
+   */
+  virtual void post(std::function<void()> build) PURE;
+};
+
+using LoadBalancerBuildPoolSharedPtr = std::shared_ptr<LoadBalancerBuildPool>;
+
 /**
  * A thread aware load balancer is a load balancer that is global to all workers on behalf of a
  * cluster. These load balancers are harder to write so not every load balancer has to be one.
@@ -230,6 +248,15 @@ public:
    * will do this at the appropriate time.
    */
   virtual void initialize() PURE;
+
+  /**
+   * Supply the threads used to rebuild the shared state after initialization. The cluster manager
+   * calls this before initialize() when background builds are enabled. While a build runs, the
+   * worker load balancers keep using the previous state. Load balancers that don't support
+   * background builds ignore the pool.
+   * @param pool supplies the build pool.
+   */
+  virtual void setBuildPool(LoadBalancerBuildPoolSharedPtr) {}
 };
 
 using ThreadAwareLoadBalancerPtr = std::unique_ptr<ThreadAwareLoadBalancer>;
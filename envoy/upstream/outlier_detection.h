@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <functional>
 #include <memory>
+#include <vector>
 
 #include "envoy/common/pure.h"
 #include "envoy/common/time.h"
@@ -133,6 +134,18 @@ public:
    */
   virtual void addChangedStateCb(ChangeStateCb cb) PURE;
 
+  /**
+   * Outlier detection change states callback.
+   */
+  using ChangeStatesCb = std::function<void(const std::vector<HostSharedPtr>& hosts)>;
+
+  /**
+   * Add a changed states callback to the detector. Like the changed state callbacks, it is called
+   * whenever hosts change state due to outlier status, but all the hosts ejected or brought back
+   * in by the same detection interval are passed to a single call.
+   */
+  virtual void addChangedStatesCb(ChangeStatesCb cb) PURE;
+
   /**
    * Returns the average success rate of the hosts in the Detector for the last aggregation
    * interval.
@@ -730,6 +730,9 @@ public:
   COUNTER(upstream_cx_none_healthy)                                                                \
   COUNTER(upstream_cx_overflow)                                                                    \
   COUNTER(upstream_cx_pool_overflow)                                                               \
+  COUNTER(upstream_cx_preconnect_setup_avoided_ms)                                                 \
+  COUNTER(upstream_cx_preconnect_unused)                                                           \
+  COUNTER(upstream_cx_preconnect_used)                                                             \
   COUNTER(upstream_cx_protocol_error)                                                              \
   COUNTER(upstream_cx_rx_bytes_total)                                                              \
   COUNTER(upstream_cx_total)                                                                       \
@@ -742,6 +745,8 @@ public:
   COUNTER(upstream_internal_redirect_succeeded_total)                                              \
   COUNTER(upstream_rq_cancelled)                                                                   \
   COUNTER(upstream_rq_completed)                                                                   \
+  COUNTER(upstream_rq_cross_worker)                                                                \
+  COUNTER(upstream_rq_cross_worker_hops)                                                           \
   COUNTER(upstream_rq_maintenance_mode)                                                            \
   COUNTER(upstream_rq_max_duration_reached)                                                        \
   COUNTER(upstream_rq_pending_failure_eject)                                                       \
@@ -963,6 +968,13 @@ public:
    */
   virtual float peekaheadRatio() const PURE;
 
+  /**
+   * @return the window over which the connection pools smooth their stream arrival and completion
+   *         rates to preconnect ahead of the predicted demand, or absl::nullopt if the connection
+   *         pools do not predict the demand.
+   */
+  virtual const absl::optional<std::chrono::milliseconds> adaptivePreconnectWindow() const PURE;
+
   /**
    * @return soft limit on size of the cluster's connections read and write buffers.
    */
@@ -1204,6 +1216,12 @@ public:
    */
   virtual bool connectionPoolPerDownstreamConnection() const PURE;
 
+  /**
+   * @return whether the HTTP/2 and HTTP/3 connections to a host are shared by the workers, rather
+   *         than each worker opening its own.
+   */
+  virtual bool shareConnectionPoolsAcrossWorkers() const PURE;
+
   /**
    * @return true if this cluster is configured to ignore hosts for the purpose of load balancing
    * computations until they have been health checked for the first time.
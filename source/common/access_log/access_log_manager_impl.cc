@@ -1,5 +1,6 @@
 #include "source/common/access_log/access_log_manager_impl.h"
 
+#include <algorithm>
 #include <string>
 
 #include "envoy/common/exception.h"
@@ -13,6 +14,74 @@
 namespace Envoy {
 namespace AccessLog {
 
+namespace {
+
+// Ids are never reused, see AccessLogFileImpl::threadBuffer().
+std::atomic<uint64_t> next_file_id{0};
+
+} // namespace
+
+AccessLogFlushThread::AccessLogFlushThread(std::chrono::milliseconds flush_interval_msec,
+                                           Thread::ThreadFactory& thread_factory,
+                                           AccessLogFileStats& stats)
+    : flush_interval_msec_(flush_interval_msec), stats_(stats),
+      flush_thread_(thread_factory.createThread([this]() -> void { flushThreadFunc(); },
+                                                Thread::Options{"AccessLogFlush"})) {}
+
+AccessLogFlushThread::~AccessLogFlushThread() {
+  {
+    Thread::LockGuard lock(event_lock_);
+    flush_thread_exit_ = true;
+    flush_event_.notifyOne();
+  }
+  flush_thread_->join();
+}
+
+void AccessLogFlushThread::registerFile(AccessLogFileImpl& file) {
+  Thread::LockGuard lock(files_lock_);
+  files_.push_back(&file);
+}
+
+void AccessLogFlushThread::unregisterFile(AccessLogFileImpl& file) {
+  Thread::LockGuard lock(files_lock_);
+  files_.erase(std::find(files_.begin(), files_.end(), &file));
+}
+
+void AccessLogFlushThread::requestFlush() {
+  if (flush_requested_.exchange(true)) {
+    return;
+  }
+  Thread::LockGuard lock(event_lock_);
+  flush_event_.notifyOne();
+}
+
+void AccessLogFlushThread::flushThreadFunc() {
+  while (true) {
+    bool flushed_by_timer = false;
+    {
+      Thread::LockGuard lock(event_lock_);
+      // flush_requested_ is checked under the lock so that a request made before the wait starts
+      // is not missed, see requestFlush().
+      if (!flush_requested_ && !flush_thread_exit_) {
+        flushed_by_timer = flush_event_.waitFor(event_lock_, flush_interval_msec_) ==
+                           Thread::CondVar::WaitStatus::Timeout;
+      }
+      if (flush_thread_exit_) {
+        return;
+      }
+      flush_requested_ = false;
+    }
+
+    if (flushed_by_timer) {
+      stats_.flushed_by_timer_.inc();
+    }
+    Thread::LockGuard lock(files_lock_);
+    for (AccessLogFileImpl* file : files_) {
+      file->flushFromSharedThread();
+    }
+  }
+}
+
 AccessLogManagerImpl::~AccessLogManagerImpl() {
   for (auto& [log_key, log_file_ptr] : access_logs_) {
     ENVOY_LOG(debug, "destroying access logger {}", log_key);
@@ -34,29 +103,40 @@ AccessLogManagerImpl::createAccessLog(const Filesystem::FilePathAndType& file_in
   if (access_logs_.count(file_name)) {
     return access_logs_[file_name];
   }
-  access_logs_[file_name] =
-      std::make_shared<AccessLogFileImpl>(std::move(file), dispatcher_, lock_, file_stats_,
-                                          file_flush_interval_msec_, api_.threadFactory());
+  if (shared_flush_thread_ && flush_thread_ == nullptr) {
+    flush_thread_ = std::make_shared<AccessLogFlushThread>(file_flush_interval_msec_,
+                                                           api_.threadFactory(), file_stats_);
+  }
+  access_logs_[file_name] = std::make_shared<AccessLogFileImpl>(
+      std::move(file), dispatcher_, lock_, file_stats_, file_flush_interval_msec_,
+      api_.threadFactory(), flush_thread_);
   return access_logs_[file_name];
 }
 
 AccessLogFileImpl::AccessLogFileImpl(Filesystem::FilePtr&& file, Event::Dispatcher& dispatcher,
                                      Thread::BasicLockable& lock, AccessLogFileStats& stats,
                                      std::chrono::milliseconds flush_interval_msec,
-                                     Thread::ThreadFactory& thread_factory)
-    : file_(std::move(file)), file_lock_(lock),
-      flush_timer_(dispatcher.createTimer([this]() -> void {
-        stats_.flushed_by_timer_.inc();
-        flush_event_.notifyOne();
-        flush_timer_->enableTimer(flush_interval_msec_);
-      })),
-      thread_factory_(thread_factory), flush_interval_msec_(flush_interval_msec), stats_(stats) {
-  flush_timer_->enableTimer(flush_interval_msec_);
+                                     Thread::ThreadFactory& thread_factory,
+                                     AccessLogFlushThreadSharedPtr shared_flush_thread)
+    : file_(std::move(file)), file_lock_(lock), thread_factory_(thread_factory),
+      flush_interval_msec_(flush_interval_msec), stats_(stats),
+      shared_flush_thread_(std::move(shared_flush_thread)), id_(next_file_id++) {
+  if (shared_flush_thread_ == nullptr) {
+    flush_timer_ = dispatcher.createTimer([this]() -> void {
+      stats_.flushed_by_timer_.inc();
+      flush_event_.notifyOne();
+      flush_timer_->enableTimer(flush_interval_msec_);
+    });
+    flush_timer_->enableTimer(flush_interval_msec_);
+  }
   auto open_result = open();
   if (!open_result.return_value_) {
     throw EnvoyException(fmt::format("unable to open file '{}': {}", file_->path(),
                                      open_result.err_->getErrorDetails()));
   }
+  if (shared_flush_thread_ != nullptr) {
+    shared_flush_thread_->registerFile(*this);
+  }
 }
 
 Filesystem::FlagSet AccessLogFileImpl::defaultFlags() {
@@ -72,13 +152,35 @@ Api::IoCallBoolResult AccessLogFileImpl::open() {
   return result;
 }
 
+bool AccessLogFileImpl::doReopen() {
+  if (file_->isOpen()) {
+    const Api::IoCallBoolResult result = file_->close();
+    ASSERT(result.return_value_, fmt::format("unable to close file '{}': {}", file_->path(),
+                                             result.err_->getErrorDetails()));
+  }
+  const Api::IoCallBoolResult open_result = open();
+  if (!open_result.return_value_) {
+    stats_.reopen_failed_.inc();
+    return false;
+  }
+  return true;
+}
+
 void AccessLogFileImpl::reopen() {
   Thread::LockGuard lock(write_lock_);
   reopen_file_ = true;
+  if (shared_flush_thread_ != nullptr) {
+    shared_flush_thread_->requestFlush();
+    return;
+  }
   flush_event_.notifyOne();
 }
 
 AccessLogFileImpl::~AccessLogFileImpl() {
+  if (shared_flush_thread_ != nullptr) {
+    shared_flush_thread_->unregisterFile(*this);
+  }
+
   {
     Thread::LockGuard lock(write_lock_);
     flush_thread_exit_ = true;
@@ -94,6 +196,11 @@ AccessLogFileImpl::~AccessLogFileImpl() {
     if (flush_buffer_.length() > 0) {
       doWrite(flush_buffer_);
     }
+    if (shared_flush_thread_ != nullptr) {
+      Thread::LockGuard flush_lock(flush_lock_);
+      gatherThreadBuffers();
+      doWrite(about_to_write_buffer_);
+    }
     const Api::IoCallBoolResult result = file_->close();
     ASSERT(result.return_value_, fmt::format("unable to close file '{}': {}", file_->path(),
                                              result.err_->getErrorDetails()));
@@ -101,6 +208,11 @@ AccessLogFileImpl::~AccessLogFileImpl() {
 }
 
 void AccessLogFileImpl::doWrite(Buffer::Instance& buffer) {
+  if (buffer.length() == 0) {
+    return;
+  }
+  stats_.flush_batches_.inc();
+  stats_.flush_batch_bytes_.add(buffer.length());
   Buffer::RawSliceVector slices = buffer.getRawSlices();
 
   // We must do the actual writes to disk under lock, so that we don't intermix chunks from
@@ -168,24 +280,50 @@ void AccessLogFileImpl::flushThreadFunc() {
     }
 
     if (do_reopen) {
-      if (file_->isOpen()) {
-        const Api::IoCallBoolResult result = file_->close();
-        ASSERT(result.return_value_, fmt::format("unable to close file '{}': {}", file_->path(),
-                                                 result.err_->getErrorDetails()));
-      }
-      const Api::IoCallBoolResult open_result = open();
-      if (!open_result.return_value_) {
-        stats_.reopen_failed_.inc();
-      } else {
-        do_reopen = false;
-      }
+      do_reopen = !doReopen();
     }
     // doWrite no matter file isOpen, if not, we can drain buffer
     doWrite(about_to_write_buffer_);
   }
 }
 
+void AccessLogFileImpl::flushFromSharedThread() {
+  std::unique_lock<Thread::BasicLockable> flush_lock;
+
+  {
+    Thread::LockGuard write_lock(write_lock_);
+    flush_lock = std::unique_lock<Thread::BasicLockable>(flush_lock_);
+    if (reopen_file_) {
+      retry_reopen_ = true;
+      reopen_file_ = false;
+    }
+  }
+
+  gatherThreadBuffers();
+  // A failed reopen is retried on the next flush rather than in a tight loop.
+  if (retry_reopen_) {
+    retry_reopen_ = !doReopen();
+  }
+  // doWrite no matter file isOpen, if not, we can drain buffer
+  doWrite(about_to_write_buffer_);
+}
+
+void AccessLogFileImpl::gatherThreadBuffers() {
+  Thread::LockGuard lock(thread_buffers_lock_);
+  for (const auto& thread_buffer : thread_buffers_) {
+    Thread::LockGuard buffer_lock(thread_buffer->lock_);
+    about_to_write_buffer_.move(thread_buffer->buffer_);
+  }
+}
+
 void AccessLogFileImpl::flush() {
+  if (shared_flush_thread_ != nullptr) {
+    Thread::LockGuard flush_lock(flush_lock_);
+    gatherThreadBuffers();
+    doWrite(about_to_write_buffer_);
+    return;
+  }
+
   std::unique_lock<Thread::BasicLockable> flush_buffer_lock;
 
   {
@@ -210,6 +348,11 @@ void AccessLogFileImpl::flush() {
 }
 
 void AccessLogFileImpl::write(absl::string_view data) {
+  if (shared_flush_thread_ != nullptr) {
+    writeToThreadBuffer(data);
+    return;
+  }
+
   Thread::LockGuard lock(write_lock_);
 
   if (flush_thread_ == nullptr) {
@@ -224,6 +367,53 @@ void AccessLogFileImpl::write(absl::string_view data) {
   }
 }
 
+AccessLogFileImpl::ThreadBufferMap& AccessLogFileImpl::threadBufferMap() {
+  thread_local ThreadBufferMap thread_buffers;
+  return thread_buffers;
+}
+
+AccessLogFileImpl::ThreadBuffer& AccessLogFileImpl::threadBuffer() {
+  // The buffers are owned by the file, and a cached pointer is only used by the file it belongs
+  // to. Since the ids of the files are never reused, the pointers to the buffers of a destroyed
+  // file are never dereferenced.
+  ThreadBufferMap& thread_buffers = threadBufferMap();
+  auto it = thread_buffers.find(id_);
+  if (it != thread_buffers.end()) {
+    return *it->second.buffer_;
+  }
+
+  // The entries of the destroyed files are dropped whenever the thread starts writing to another
+  // file, so that the map does not grow as files come and go.
+  absl::erase_if(thread_buffers, [](const auto& entry) { return entry.second.owner_.expired(); });
+  auto new_buffer = std::make_shared<ThreadBuffer>();
+  thread_buffers.emplace(id_, CachedThreadBuffer{new_buffer.get(), new_buffer});
+  ThreadBuffer& thread_buffer = *new_buffer;
+  Thread::LockGuard lock(thread_buffers_lock_);
+  thread_buffers_.push_back(std::move(new_buffer));
+  return thread_buffer;
+}
+
+size_t AccessLogFileImpl::threadBufferCountForTest() { return threadBufferMap().size(); }
+
+void AccessLogFileImpl::writeToThreadBuffer(absl::string_view data) {
+  ThreadBuffer& thread_buffer = threadBuffer();
+
+  // The stats are updated first so that the flush thread never subtracts data that is not yet
+  // accounted for.
+  stats_.write_buffered_.inc();
+  stats_.write_buffered_per_thread_.inc();
+  stats_.write_total_buffered_.add(data.length());
+  uint64_t buffered;
+  {
+    Thread::LockGuard lock(thread_buffer.lock_);
+    thread_buffer.buffer_.add(data.data(), data.size());
+    buffered = thread_buffer.buffer_.length();
+  }
+  if (buffered > MIN_FLUSH_SIZE) {
+    shared_flush_thread_->requestFlush();
+  }
+}
+
 void AccessLogFileImpl::createFlushStructures() {
   flush_thread_ = thread_factory_.createThread([this]() -> void { flushThreadFunc(); },
                                                Thread::Options{"AccessLogFlush"});
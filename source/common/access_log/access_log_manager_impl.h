@@ -1,6 +1,9 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "envoy/access_log/access_log.h"
 #include "envoy/api/api.h"
@@ -13,14 +16,18 @@
 #include "source/common/common/logger.h"
 #include "source/common/common/thread.h"
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_map.h"
 
 namespace Envoy {
 
 #define ACCESS_LOG_FILE_STATS(COUNTER, GAUGE)                                                      \
+  COUNTER(flush_batch_bytes)                                                                       \
+  COUNTER(flush_batches)                                                                           \
   COUNTER(flushed_by_timer)                                                                        \
   COUNTER(reopen_failed)                                                                           \
   COUNTER(write_buffered)                                                                          \
+  COUNTER(write_buffered_per_thread)                                                               \
   COUNTER(write_completed)                                                                         \
   COUNTER(write_failed)                                                                            \
   GAUGE(write_total_buffered, Accumulate)
@@ -31,13 +38,56 @@ struct AccessLogFileStats {
 
 namespace AccessLog {
 
+class AccessLogFileImpl;
+
+/**
+ * A single flush thread shared by all the access log files of a manager. The files register
+ * themselves when created and are flushed in turn every flush interval, or as soon as one of them
+ * requests a flush because it buffered enough data.
+ */
+class AccessLogFlushThread {
+public:
+  AccessLogFlushThread(std::chrono::milliseconds flush_interval_msec,
+                       Thread::ThreadFactory& thread_factory, AccessLogFileStats& stats);
+  ~AccessLogFlushThread();
+
+  void registerFile(AccessLogFileImpl& file);
+  /**
+   * Unregister a file. When this returns the file is not being flushed by the flush thread and
+   * won't be anymore.
+   */
+  void unregisterFile(AccessLogFileImpl& file);
+  /**
+   * Wake up the flush thread. This is cheap to call repeatedly, only the first call after a flush
+   * acquires the lock.
+   */
+  void requestFlush();
+
+private:
+  void flushThreadFunc();
+
+  // These locks are never held at the same time.
+  Thread::MutexBasicLockable files_lock_; // Held while registering files and while flushing them.
+  Thread::MutexBasicLockable event_lock_; // Only used to wait for and signal the flush_event_.
+  Thread::CondVar flush_event_;
+  std::vector<AccessLogFileImpl*> files_ ABSL_GUARDED_BY(files_lock_);
+  std::atomic<bool> flush_requested_{false};
+  bool flush_thread_exit_ ABSL_GUARDED_BY(event_lock_){false};
+  const std::chrono::milliseconds flush_interval_msec_;
+  AccessLogFileStats& stats_;
+  Thread::ThreadPtr flush_thread_;
+};
+
+using AccessLogFlushThreadSharedPtr = std::shared_ptr<AccessLogFlushThread>;
+
 class AccessLogManagerImpl : public AccessLogManager, Logger::Loggable<Logger::Id::main> {
 public:
   AccessLogManagerImpl(std::chrono::milliseconds file_flush_interval_msec, Api::Api& api,
                        Event::Dispatcher& dispatcher, Thread::BasicLockable& lock,
-                       Stats::Store& stats_store)
+                       Stats::Store& stats_store, bool shared_flush_thread = false)
       : file_flush_interval_msec_(file_flush_interval_msec), api_(api), dispatcher_(dispatcher),
-        lock_(lock), file_stats_{
+        lock_(lock), shared_flush_thread_(shared_flush_thread),
+        file_stats_{
                          ACCESS_LOG_FILE_STATS(POOL_COUNTER_PREFIX(stats_store, "filesystem."),
                                                POOL_GAUGE_PREFIX(stats_store, "filesystem."))} {}
   ~AccessLogManagerImpl() override;
@@ -51,23 +101,29 @@ private:
   Api::Api& api_;
   Event::Dispatcher& dispatcher_;
   Thread::BasicLockable& lock_;
+  const bool shared_flush_thread_;
   AccessLogFileStats file_stats_;
+  // Created with the first file when shared_flush_thread_ is set. The files keep a reference to it
+  // since they can outlive the manager.
+  AccessLogFlushThreadSharedPtr flush_thread_;
   absl::node_hash_map<std::string, AccessLogFileSharedPtr> access_logs_;
 };
 
 /**
  * This is a file implementation geared for writing out access logs. It turn out that in certain
  * cases even if a standard file is opened with O_NONBLOCK, the kernel can still block when writing.
- * This implementation uses a flush thread per file, with the idea there aren't that many
- * files. If this turns out to be a good implementation we can potentially have a single flush
- * thread that flushes all files, but we will start with this.
+ * By default this implementation uses a flush thread per file, with the idea there aren't that
+ * many files. Alternatively the files can be flushed by a single AccessLogFlushThread, in which
+ * case each thread writing to a file appends to its own buffer so that the writing threads don't
+ * contend on a shared lock, and the flush thread gathers all the buffers of a file into one batch.
  */
 class AccessLogFileImpl : public AccessLogFile {
 public:
   AccessLogFileImpl(Filesystem::FilePtr&& file, Event::Dispatcher& dispatcher,
                     Thread::BasicLockable& lock, AccessLogFileStats& stats,
                     std::chrono::milliseconds flush_interval_msec,
-                    Thread::ThreadFactory& thread_factory);
+                    Thread::ThreadFactory& thread_factory,
+                    AccessLogFlushThreadSharedPtr shared_flush_thread = nullptr);
   ~AccessLogFileImpl() override;
 
   // AccessLog::AccessLogFile
@@ -81,9 +137,45 @@ public:
   void reopen() override;
   void flush() override;
 
+  /**
+   * Called by the shared flush thread to write the buffers of all the threads, and to reopen the
+   * file if requested.
+   */
+  void flushFromSharedThread();
+
+  /**
+   * @return the number of files the calling thread holds a buffer of in its thread local map.
+   */
+  static size_t threadBufferCountForTest();
+
 private:
+  // The buffer of a thread writing to the file when using a shared flush thread. The lock is only
+  // contended when the flush thread moves the data out of the buffer.
+  struct ThreadBuffer {
+    Thread::MutexBasicLockable lock_;
+    Buffer::OwnedImpl buffer_ ABSL_GUARDED_BY(lock_);
+  };
+
+  // A buffer cached in the thread local map of a thread. The raw pointer is used on the write path,
+  // and the weak pointer tells whether the file owning the buffer is gone.
+  struct CachedThreadBuffer {
+    ThreadBuffer* buffer_;
+    std::weak_ptr<ThreadBuffer> owner_;
+  };
+  using ThreadBufferMap = absl::flat_hash_map<uint64_t, CachedThreadBuffer>;
+
+  // The buffers of the calling thread, by file id.
+  static ThreadBufferMap& threadBufferMap();
+
   void doWrite(Buffer::Instance& buffer);
   void flushThreadFunc();
+  void writeToThreadBuffer(absl::string_view data);
+  ThreadBuffer& threadBuffer();
+  // Move the data of all the thread buffers to about_to_write_buffer_.
+  // Must be called with flush_lock_ held.
+  void gatherThreadBuffers();
+  // Returns false if the file could not be reopened.
+  bool doReopen();
   Api::IoCallBoolResult open();
   void createFlushStructures();
 
@@ -98,7 +190,9 @@ private:
   // These locks are always acquired in the following order if multiple locks are held:
   //    1) write_lock_
   //    2) flush_lock_
-  //    3) file_lock_
+  //    3) thread_buffers_lock_
+  //    4) ThreadBuffer::lock_
+  //    5) file_lock_
   Thread::BasicLockable& file_lock_;      // This lock is used only by the flush thread when writing
                                           // to disk. This is used to make sure that file blocks do
                                           // not get interleaved by multiple processes writing to
@@ -134,6 +228,14 @@ private:
                                                         // matter if it reached the MIN_FLUSH_SIZE
                                                         // or not.
   AccessLogFileStats& stats_;
+  // Set when the file is flushed by a shared flush thread instead of flush_thread_.
+  const AccessLogFlushThreadSharedPtr shared_flush_thread_;
+  // Only used by the shared flush thread, under flush_lock_.
+  bool retry_reopen_{false};
+  // Identifies the file in the thread local map of thread buffers.
+  const uint64_t id_;
+  Thread::MutexBasicLockable thread_buffers_lock_;
+  std::vector<std::shared_ptr<ThreadBuffer>> thread_buffers_ ABSL_GUARDED_BY(thread_buffers_lock_);
 };
 
 } // namespace AccessLog
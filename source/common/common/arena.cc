@@ -0,0 +1,78 @@
+#include "source/common/common/arena.h"
+
+#include "source/common/common/assert.h"
+
+#include "absl/container/flat_hash_map.h"
+
+namespace Envoy {
+
+ArenaBlockPool::~ArenaBlockPool() {
+  for (void* block : free_blocks_) {
+    ::operator delete(block);
+  }
+}
+
+ArenaBlockPool& ArenaBlockPool::threadLocal(uint32_t block_size) {
+  // There is usually a single block size per process, the pools are never destroyed before the
+  // thread exits.
+  thread_local absl::flat_hash_map<uint32_t, std::unique_ptr<ArenaBlockPool>> pools;
+  std::unique_ptr<ArenaBlockPool>& pool = pools[block_size];
+  if (pool == nullptr) {
+    pool = std::make_unique<ArenaBlockPool>(block_size);
+  }
+  return *pool;
+}
+
+void* ArenaBlockPool::allocateBlock() {
+  if (free_blocks_.empty()) {
+    return ::operator new(block_size_);
+  }
+  void* block = free_blocks_.back();
+  free_blocks_.pop_back();
+  return block;
+}
+
+void ArenaBlockPool::releaseBlock(void* block) {
+  if (free_blocks_.size() >= MaxFreeBlocks) {
+    ::operator delete(block);
+    return;
+  }
+  free_blocks_.push_back(block);
+}
+
+Arena::~Arena() {
+  for (void* block : blocks_) {
+    pool_.releaseBlock(block);
+  }
+}
+
+void* Arena::allocate(size_t size, size_t alignment) {
+  ASSERT((alignment & (alignment - 1)) == 0);
+  // The blocks are only aligned for the fundamental types, see ::operator new().
+  if (alignment > alignof(std::max_align_t)) {
+    heap_fallbacks_++;
+    return nullptr;
+  }
+  size_t padding = reinterpret_cast<uintptr_t>(current_) & (alignment - 1);
+  if (padding != 0) {
+    padding = alignment - padding;
+  }
+  if (current_ == nullptr || size + padding > remaining_) {
+    if (size > pool_.blockSize() || blocks_.size() >= max_blocks_) {
+      heap_fallbacks_++;
+      return nullptr;
+    }
+    // The rest of the current block is wasted.
+    current_ = static_cast<char*>(pool_.allocateBlock());
+    remaining_ = pool_.blockSize();
+    blocks_.push_back(current_);
+    padding = 0;
+  }
+  void* memory = current_ + padding;
+  current_ += padding + size;
+  remaining_ -= padding + size;
+  bytes_used_ += size;
+  return memory;
+}
+
+} // namespace Envoy
@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "source/common/common/non_copyable.h"
+
+#include "absl/container/inlined_vector.h"
+
+namespace Envoy {
+
+/**
+ * Configuration of an Arena.
+ */
+struct ArenaConfig {
+  // The size of the blocks the arena allocates from.
+  uint32_t block_size_;
+  // The maximum number of blocks of an arena, the allocations fall back to the heap past it.
+  uint32_t max_blocks_;
+};
+
+/**
+ * Pool of reusable memory blocks of a fixed size. A pool is only used by the thread it belongs to,
+ * so that the blocks of the arenas of a worker are recycled without any synchronization.
+ */
+class ArenaBlockPool : NonCopyable {
+public:
+  explicit ArenaBlockPool(uint32_t block_size) : block_size_(block_size) {}
+  ~ArenaBlockPool();
+
+  /**
+   * @return the pool of blocks of the given size of the calling thread.
+   */
+  static ArenaBlockPool& threadLocal(uint32_t block_size);
+
+  void* allocateBlock();
+  void releaseBlock(void* block);
+
+  uint32_t blockSize() const { return block_size_; }
+  size_t freeBlocks() const { return free_blocks_.size(); }
+
+  // The maximum number of free blocks kept by a pool, the other blocks are returned to the heap.
+  static constexpr size_t MaxFreeBlocks = 1024;
+
+private:
+  const uint32_t block_size_;
+  std::vector<void*> free_blocks_;
+};
+
+/**
+ * Bump allocator over the blocks of an ArenaBlockPool. The memory of the arena is released in one
+ * shot when it is destroyed, the objects allocated from it must be destroyed before.
+ */
+class Arena : NonCopyable {
+public:
+  Arena(ArenaBlockPool& pool, uint32_t max_blocks) : pool_(pool), max_blocks_(max_blocks) {}
+  ~Arena();
+
+  /**
+   * @return memory of the given size and alignment, or nullptr if the allocation doesn't fit in a
+   *         block or the arena has no block left. The caller must then fall back to the heap.
+   */
+  void* allocate(size_t size, size_t alignment);
+
+  /**
+   * @return the number of bytes allocated from the arena.
+   */
+  uint64_t bytesUsed() const { return bytes_used_; }
+
+  /**
+   * @return the number of allocations which did not fit in the arena.
+   */
+  uint64_t heapFallbacks() const { return heap_fallbacks_; }
+
+private:
+  ArenaBlockPool& pool_;
+  const uint32_t max_blocks_;
+  absl::InlinedVector<void*, 4> blocks_;
+  char* current_{};
+  size_t remaining_{};
+  uint64_t bytes_used_{};
+  uint64_t heap_fallbacks_{};
+};
+
+/**
+ * Deleter of an object which may have been allocated from an Arena, in which case the object is
+ * only destroyed since its memory is released with the arena.
+ */
+template <class T> struct ArenaDeleter {
+  void operator()(T* object) const {
+    if (from_arena_) {
+      object->~T();
+    } else {
+      delete object;
+    }
+  }
+
+  bool from_arena_{false};
+};
+
+template <class T> using ArenaPtr = std::unique_ptr<T, ArenaDeleter<T>>;
+
+/**
+ * Creates an object in the arena if set and if it has room left, or on the heap otherwise.
+ */
+template <class T, class... Args> ArenaPtr<T> makeArenaPtr(Arena* arena, Args&&... args) {
+  if (arena != nullptr) {
+    void* memory = arena->allocate(sizeof(T), alignof(T));
+    if (memory != nullptr) {
+      return ArenaPtr<T>(new (memory) T(std::forward<Args>(args)...), ArenaDeleter<T>{true});
+    }
+  }
+  return ArenaPtr<T>(new T(std::forward<Args>(args)...), ArenaDeleter<T>{false});
+}
+
+} // namespace Envoy
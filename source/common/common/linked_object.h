@@ -17,8 +17,8 @@ namespace LinkedList {
  * @param item supplies the item to move in.
  * @param list supplies the list to move the item into.
  */
-template <typename T, typename U>
-void moveIntoList(std::unique_ptr<T>&& item, std::list<std::unique_ptr<U>>& list) {
+template <typename T, typename TD, typename U, typename UD>
+void moveIntoList(std::unique_ptr<T, TD>&& item, std::list<std::unique_ptr<U, UD>>& list) {
   ASSERT(!item->inserted_);
   item->inserted_ = true;
   auto position = list.emplace(list.begin(), std::move(item));
@@ -30,8 +30,8 @@ void moveIntoList(std::unique_ptr<T>&& item, std::list<std::unique_ptr<U>>& list
  * @param item supplies the item to move in.
  * @param list supplies the list to move the item into.
  */
-template <typename T, typename U>
-void moveIntoListBack(std::unique_ptr<T>&& item, std::list<std::unique_ptr<U>>& list) {
+template <typename T, typename TD, typename U, typename UD>
+void moveIntoListBack(std::unique_ptr<T, TD>&& item, std::list<std::unique_ptr<U, UD>>& list) {
   ASSERT(!item->inserted_);
   item->inserted_ = true;
   auto position = list.emplace(list.end(), std::move(item));
@@ -42,11 +42,12 @@ void moveIntoListBack(std::unique_ptr<T>&& item, std::list<std::unique_ptr<U>>&
 
 /**
  * Mixin class that allows an object contained in a unique pointer to be easily linked and unlinked
- * from lists.
+ * from lists. The deleter of the unique pointer can be overridden, e.g. for objects which may be
+ * allocated from an arena.
  */
-template <class T> class LinkedObject {
+template <class T, class Deleter = std::default_delete<T>> class LinkedObject {
 public:
-  using ListType = std::list<std::unique_ptr<T>>;
+  using ListType = std::list<std::unique_ptr<T, Deleter>>;
 
   /**
    * @return the list iterator for the object.
@@ -77,11 +78,11 @@ public:
    * Remove this item from a list.
    * @param list supplies the list to remove from. This item should be in this list.
    */
-  std::unique_ptr<T> removeFromList(ListType& list) {
+  std::unique_ptr<T, Deleter> removeFromList(ListType& list) {
     ASSERT(inserted_);
     ASSERT(std::find(list.begin(), list.end(), *entry_) != list.end());
 
-    std::unique_ptr<T> removed = std::move(*entry_);
+    std::unique_ptr<T, Deleter> removed = std::move(*entry_);
     list.erase(entry_);
     inserted_ = false;
     return removed;
@@ -91,10 +92,12 @@ protected:
   LinkedObject() = default;
 
 private:
-  template <typename U, typename V>
-  friend void LinkedList::moveIntoList(std::unique_ptr<U>&&, std::list<std::unique_ptr<V>>&);
-  template <typename U, typename V>
-  friend void LinkedList::moveIntoListBack(std::unique_ptr<U>&&, std::list<std::unique_ptr<V>>&);
+  template <typename U, typename UD, typename V, typename VD>
+  friend void LinkedList::moveIntoList(std::unique_ptr<U, UD>&&,
+                                       std::list<std::unique_ptr<V, VD>>&);
+  template <typename U, typename UD, typename V, typename VD>
+  friend void LinkedList::moveIntoListBack(std::unique_ptr<U, UD>&&,
+                                           std::list<std::unique_ptr<V, VD>>&);
 
   typename ListType::iterator entry_;
   bool inserted_{false}; // iterators do not have any "invalid" value so we need this boolean for
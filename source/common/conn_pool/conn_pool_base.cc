@@ -1,5 +1,7 @@
 #include "source/common/conn_pool/conn_pool_base.h"
 
+#include <cmath>
+
 #include "source/common/common/assert.h"
 #include "source/common/common/debug_recursion_checker.h"
 #include "source/common/network/transport_socket_options_impl.h"
@@ -98,7 +100,8 @@ bool ConnPoolImplBase::shouldCreateNewConnection(float global_preconnect_ratio)
     // new streams are established or torn down and simply attempts to maintain
     // the correct ratio of streams and anticipated capacity.
     return shouldConnect(pending_streams_.size(), num_active_streams_, connecting_stream_capacity_,
-                         perUpstreamPreconnectRatio());
+                         perUpstreamPreconnectRatio()) ||
+           predictedStreamsNeedConnection();
   }
 }
 
@@ -106,6 +109,53 @@ float ConnPoolImplBase::perUpstreamPreconnectRatio() const {
   return host_->cluster().perUpstreamPreconnectRatio();
 }
 
+void ConnPoolImplBase::updatePredictedStreams() {
+  const absl::optional<std::chrono::milliseconds> window =
+      host_->cluster().adaptivePreconnectWindow();
+  if (!window.has_value()) {
+    return;
+  }
+  const MonotonicTime now = dispatcher_.timeSource().monotonicTime();
+  const double window_seconds = std::chrono::duration<double>(window.value()).count();
+  const double elapsed_seconds = std::chrono::duration<double>(now - last_growth_update_).count();
+  const uint64_t demand = pending_streams_.size() + num_active_streams_;
+  // The growth rate is the sum of the changes in the demand, each weighted by exp(-age / window),
+  // over the window. The changes since the last update are weighted as of now.
+  stream_growth_rate_ = stream_growth_rate_ * std::exp(-elapsed_seconds / window_seconds) +
+                        (static_cast<double>(demand) - static_cast<double>(last_demand_)) /
+                            window_seconds;
+  last_growth_update_ = now;
+  last_demand_ = demand;
+  predicted_streams_ = stream_growth_rate_ > 0
+                           ? static_cast<uint32_t>(std::lround(stream_growth_rate_ * connect_latency_))
+                           : 0;
+}
+
+bool ConnPoolImplBase::predictedStreamsNeedConnection() const {
+  if (predicted_streams_ == 0) {
+    return false;
+  }
+  // The ready connections are counted until they cover the demand, so that this stays cheap for
+  // large pools.
+  const uint64_t demand = pending_streams_.size() + predicted_streams_;
+  uint64_t capacity = connecting_stream_capacity_;
+  for (auto it = ready_clients_.begin(); it != ready_clients_.end() && capacity < demand; ++it) {
+    capacity += (*it)->currentUnusedCapacity();
+  }
+  return demand > capacity;
+}
+
+void ConnPoolImplBase::updateConnectLatency(std::chrono::milliseconds connect_duration) {
+  if (!host_->cluster().adaptivePreconnectWindow().has_value()) {
+    return;
+  }
+  // Each connection counts for a quarter of the smoothed latency, so that it follows changes in
+  // the latency within a few connections without being thrown off by a single outlier.
+  const double latency = std::chrono::duration<double>(connect_duration).count();
+  connect_latency_ =
+      connect_latency_ == 0 ? latency : connect_latency_ + (latency - connect_latency_) / 4;
+}
+
 ConnPoolImplBase::ConnectionResult ConnPoolImplBase::tryCreateNewConnections() {
   ConnPoolImplBase::ConnectionResult result;
   // Somewhat arbitrarily cap the number of connections preconnected due to new
@@ -114,6 +164,7 @@ ConnPoolImplBase::ConnectionResult ConnPoolImplBase::tryCreateNewConnections() {
   // unhealthy, and connections are not immediately preconnected, it could be that
   // many connections are desired when the host becomes healthy again, but
   // overwhelming it with connections is not desirable.
+  updatePredictedStreams();
   for (int i = 0; i < 3; ++i) {
     result = tryCreateNewConnection();
     if (result != ConnectionResult::CreatedNewConnection) {
@@ -143,11 +194,15 @@ ConnPoolImplBase::tryCreateNewConnection(float global_preconnect_ratio) {
   if (can_create_connection || (ready_clients_.empty() && busy_clients_.empty() &&
                                 connecting_clients_.empty() && early_data_clients_.empty())) {
     ENVOY_LOG(debug, "creating a new connection (connecting={})", connecting_clients_.size());
+    // The connection is established ahead of the demand if the connecting capacity already covers
+    // the pending streams.
+    const bool preconnected = pending_streams_.size() <= connecting_stream_capacity_;
     ActiveClientPtr client = instantiateActiveClient();
     if (client.get() == nullptr) {
       ENVOY_LOG(trace, "connection creation failed");
       return ConnectionResult::FailedToCreateConnection;
     }
+    client->preconnected_ = preconnected;
     ASSERT(client->state() == ActiveClient::State::Connecting);
     ASSERT(std::numeric_limits<uint64_t>::max() - connecting_stream_capacity_ >=
            static_cast<uint64_t>(client->currentUnusedCapacity()));
@@ -171,6 +226,10 @@ void ConnPoolImplBase::attachStreamToClient(Envoy::ConnectionPool::ActiveClient&
   if (client.state() == Envoy::ConnectionPool::ActiveClient::State::ReadyForEarlyData) {
     traffic_stats.upstream_rq_0rtt_.inc();
   }
+  if (client.preconnected_) {
+    client.preconnected_ = false;
+    traffic_stats.upstream_cx_preconnect_used_.inc();
+  }
 
   if (enforceMaxRequests() && !host_->cluster().resourceManager(priority_).requests().canCreate()) {
     ENVOY_LOG(debug, "max streams overflow");
@@ -263,6 +322,11 @@ ConnectionPool::Cancellable* ConnPoolImplBase::newStreamImpl(AttachContext& cont
   if (!ready_clients_.empty()) {
     ActiveClient& client = *ready_clients_.front();
     ENVOY_CONN_LOG(debug, "using existing fully connected connection", client);
+    if (client.preconnected_) {
+      // The stream does not wait for the connection preconnected for it to be established.
+      host_->cluster().trafficStats()->upstream_cx_preconnect_setup_avoided_ms_.add(
+          client.connect_duration_.count());
+    }
     attachStreamToClient(client, context);
     // Even if there's a ready client, we may want to preconnect to handle the next incoming stream.
     tryCreateNewConnections();
@@ -484,6 +548,9 @@ void ConnPoolImplBase::onConnectionEvent(ActiveClient& client, absl::string_view
     ENVOY_CONN_LOG(debug, "client disconnected, failure reason: {}", client, failure_reason);
 
     Envoy::Upstream::reportUpstreamCxDestroy(host_, event);
+    if (client.preconnected_) {
+      host_->cluster().trafficStats()->upstream_cx_preconnect_unused_.inc();
+    }
     const bool incomplete_stream = client.closingWithIncompleteStream();
     if (incomplete_stream) {
       Envoy::Upstream::reportUpstreamCxDestroyActiveRequest(host_, event);
@@ -564,8 +631,10 @@ void ConnPoolImplBase::onConnectionEvent(ActiveClient& client, absl::string_view
     ASSERT(connecting_stream_capacity_ >= client.currentUnusedCapacity());
     connecting_stream_capacity_ -= client.currentUnusedCapacity();
     client.has_handshake_completed_ = true;
+    client.connect_duration_ = client.conn_connect_ms_->elapsed();
     client.conn_connect_ms_->complete();
     client.conn_connect_ms_.reset();
+    updateConnectLatency(client.connect_duration_);
     if (client.state() == ActiveClient::State::Connecting ||
         client.state() == ActiveClient::State::ReadyForEarlyData) {
       transitionActiveClientState(client,
@@ -144,10 +144,14 @@ public:
   Upstream::HostDescriptionConstSharedPtr real_host_description_;
   Stats::TimespanPtr conn_connect_ms_;
   Stats::TimespanPtr conn_length_;
+  // How long the connection took to be established.
+  std::chrono::milliseconds connect_duration_{};
   Event::TimerPtr connect_timer_;
   Event::TimerPtr connection_duration_timer_;
   bool resources_released_{false};
   bool timed_out_{false};
+  // True if the connection was established ahead of the demand, until it serves a stream.
+  bool preconnected_{false};
   // TODO(danzh) remove this once http codec exposes the handshake state for h3.
   bool has_handshake_completed_{false};
 
@@ -345,6 +349,17 @@ protected:
 
   float perUpstreamPreconnectRatio() const;
 
+  // Updates the streams predicted to need a connection, if the cluster has an adaptive preconnect
+  // window.
+  void updatePredictedStreams();
+
+  // Returns true if the pending and predicted streams exceed the capacity of the connecting and
+  // ready connections.
+  bool predictedStreamsNeedConnection() const;
+
+  // Updates the connection establishment latency the predicted streams are based on.
+  void updateConnectLatency(std::chrono::milliseconds connect_duration);
+
   ConnectionPool::Cancellable*
   addPendingStream(Envoy::ConnectionPool::PendingStreamPtr&& pending_stream) {
     LinkedList::moveIntoList(std::move(pending_stream), pending_streams_);
@@ -401,6 +416,16 @@ private:
   // The number of streams currently attached to clients.
   uint32_t num_active_streams_{0};
 
+  // The adaptive preconnect state. The net rate at which the pending and active streams grow, in
+  // streams per second, as of the last update, and the smoothed connection establishment latency,
+  // in seconds. The predicted streams are those expected to arrive, net of those expected to
+  // complete, while a new connection is established.
+  double stream_growth_rate_{0};
+  double connect_latency_{0};
+  MonotonicTime last_growth_update_;
+  uint64_t last_demand_{0};
+  uint32_t predicted_streams_{0};
+
   // Whether the connection pool is currently in the process of closing
   // all connections so that it can be gracefully deleted.
   bool is_draining_for_deletion_{false};
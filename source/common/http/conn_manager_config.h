@@ -13,6 +13,7 @@
 #include "envoy/tracing/tracer.h"
 #include "envoy/type/v3/percent.pb.h"
 
+#include "source/common/common/arena.h"
 #include "source/common/http/date_provider.h"
 #include "source/common/local_reply/local_reply.h"
 #include "source/common/network/utility.h"
@@ -54,6 +55,8 @@ namespace Http {
   COUNTER(downstream_rq_3xx)                                                                       \
   COUNTER(downstream_rq_4xx)                                                                       \
   COUNTER(downstream_rq_5xx)                                                                       \
+  COUNTER(downstream_rq_arena_bytes)                                                               \
+  COUNTER(downstream_rq_arena_heap_fallback)                                                       \
   COUNTER(downstream_rq_completed)                                                                 \
   COUNTER(downstream_rq_failed_path_normalization)                                                 \
   COUNTER(downstream_rq_http1_total)                                                               \
@@ -538,6 +541,12 @@ public:
    *         Connection Lifetime.
    */
   virtual bool addProxyProtocolConnectionState() const PURE;
+
+  /**
+   * @return the configuration of the per stream arena, or nullptr if the streams are allocated
+   *         on the heap.
+   */
+  virtual const ArenaConfig* streamArenaConfig() const PURE;
 };
 } // namespace Http
 } // namespace Envoy
@@ -866,6 +866,10 @@ ConnectionManagerImpl::ActiveStream::ActiveStream(ConnectionManagerImpl& connect
   filter_manager_.streamInfo().setStreamIdProvider(
       std::make_shared<HttpStreamIdProviderImpl>(*this));
 
+  if (connection_manager_.config_.streamArenaConfig() != nullptr) {
+    filter_manager_.initializeArena(*connection_manager_.config_.streamArenaConfig());
+  }
+
   if (connection_manager_.config_.isRoutable() &&
       connection_manager.config_.routeConfigProvider() != nullptr) {
     route_config_update_requester_ =
@@ -956,6 +960,11 @@ void ConnectionManagerImpl::ActiveStream::completeRequest() {
         StreamInfo::ResponseFlag::DownstreamConnectionTermination);
   }
   connection_manager_.stats_.named_.downstream_rq_active_.dec();
+  if (const Arena* arena = filter_manager_.arena(); arena != nullptr) {
+    connection_manager_.stats_.named_.downstream_rq_arena_bytes_.add(arena->bytesUsed());
+    connection_manager_.stats_.named_.downstream_rq_arena_heap_fallback_.add(
+        arena->heapFallbacks());
+  }
   if (filter_manager_.streamInfo().healthCheck()) {
     connection_manager_.config_.tracingStats().health_check_.inc();
   }
@@ -14,6 +14,7 @@
 #include "envoy/protobuf/message_validator.h"
 
 #include "source/common/buffer/watermark_buffer.h"
+#include "source/common/common/arena.h"
 #include "source/common/common/dump_state_utils.h"
 #include "source/common/common/linked_object.h"
 #include "source/common/common/logger.h"
@@ -169,9 +170,10 @@ struct ActiveStreamFilterBase : public virtual StreamFilterCallbacks,
 /**
  * Wrapper for a stream decoder filter.
  */
-struct ActiveStreamDecoderFilter : public ActiveStreamFilterBase,
-                                   public StreamDecoderFilterCallbacks,
-                                   LinkedObject<ActiveStreamDecoderFilter> {
+struct ActiveStreamDecoderFilter
+    : public ActiveStreamFilterBase,
+      public StreamDecoderFilterCallbacks,
+      LinkedObject<ActiveStreamDecoderFilter, ArenaDeleter<ActiveStreamDecoderFilter>> {
   ActiveStreamDecoderFilter(FilterManager& parent, StreamDecoderFilterSharedPtr filter,
                             bool is_encoder_decoder_filter, FilterContext filter_context)
       : ActiveStreamFilterBase(parent, is_encoder_decoder_filter, std::move(filter_context)),
@@ -258,14 +260,15 @@ struct ActiveStreamDecoderFilter : public ActiveStreamFilterBase,
   bool is_grpc_request_{};
 };
 
-using ActiveStreamDecoderFilterPtr = std::unique_ptr<ActiveStreamDecoderFilter>;
+using ActiveStreamDecoderFilterPtr = ArenaPtr<ActiveStreamDecoderFilter>;
 
 /**
  * Wrapper for a stream encoder filter.
  */
-struct ActiveStreamEncoderFilter : public ActiveStreamFilterBase,
-                                   public StreamEncoderFilterCallbacks,
-                                   LinkedObject<ActiveStreamEncoderFilter> {
+struct ActiveStreamEncoderFilter
+    : public ActiveStreamFilterBase,
+      public StreamEncoderFilterCallbacks,
+      LinkedObject<ActiveStreamEncoderFilter, ArenaDeleter<ActiveStreamEncoderFilter>> {
   ActiveStreamEncoderFilter(FilterManager& parent, StreamEncoderFilterSharedPtr filter,
                             bool is_encoder_decoder_filter, FilterContext filter_context)
       : ActiveStreamFilterBase(parent, is_encoder_decoder_filter, std::move(filter_context)),
@@ -317,7 +320,7 @@ struct ActiveStreamEncoderFilter : public ActiveStreamFilterBase,
   StreamEncoderFilterSharedPtr handle_;
 };
 
-using ActiveStreamEncoderFilterPtr = std::unique_ptr<ActiveStreamEncoderFilter>;
+using ActiveStreamEncoderFilterPtr = ArenaPtr<ActiveStreamEncoderFilter>;
 
 /**
  * Callbacks invoked by the FilterManager to pass filter data/events back to the caller.
@@ -767,6 +770,20 @@ public:
   // Possibly increases buffer_limit_ to the value of limit.
   void setBufferLimit(uint32_t limit);
 
+  /**
+   * Allocates the filter wrappers of the stream from an arena backed by the blocks of the pool of
+   * the calling thread. This must be called before the filter chain is created.
+   */
+  void initializeArena(const ArenaConfig& config) {
+    ASSERT(decoder_filters_.empty() && encoder_filters_.empty());
+    arena_.emplace(ArenaBlockPool::threadLocal(config.block_size_), config.max_blocks_);
+  }
+
+  /**
+   * @return the arena of the stream, or nullptr if the stream doesn't have one.
+   */
+  Arena* arena() { return arena_.has_value() ? &arena_.value() : nullptr; }
+
   /**
    * @return bool whether any above high watermark triggers are currently active
    */
@@ -883,24 +900,24 @@ private:
 
     void addStreamDecoderFilter(Http::StreamDecoderFilterSharedPtr filter) override {
       manager_.addStreamFilterBase(filter.get());
-      manager_.addStreamDecoderFilter(std::make_unique<ActiveStreamDecoderFilter>(
-          manager_, std::move(filter), false, context_));
+      manager_.addStreamDecoderFilter(makeArenaPtr<ActiveStreamDecoderFilter>(
+          manager_.arena(), manager_, std::move(filter), false, context_));
     }
 
     void addStreamEncoderFilter(Http::StreamEncoderFilterSharedPtr filter) override {
       manager_.addStreamFilterBase(filter.get());
-      manager_.addStreamEncoderFilter(std::make_unique<ActiveStreamEncoderFilter>(
-          manager_, std::move(filter), false, context_));
+      manager_.addStreamEncoderFilter(makeArenaPtr<ActiveStreamEncoderFilter>(
+          manager_.arena(), manager_, std::move(filter), false, context_));
     }
 
     void addStreamFilter(Http::StreamFilterSharedPtr filter) override {
       StreamDecoderFilter* decoder_filter = filter.get();
       manager_.addStreamFilterBase(decoder_filter);
 
-      manager_.addStreamDecoderFilter(
-          std::make_unique<ActiveStreamDecoderFilter>(manager_, filter, true, context_));
-      manager_.addStreamEncoderFilter(
-          std::make_unique<ActiveStreamEncoderFilter>(manager_, std::move(filter), true, context_));
+      manager_.addStreamDecoderFilter(makeArenaPtr<ActiveStreamDecoderFilter>(
+          manager_.arena(), manager_, filter, true, context_));
+      manager_.addStreamEncoderFilter(makeArenaPtr<ActiveStreamEncoderFilter>(
+          manager_.arena(), manager_, std::move(filter), true, context_));
     }
 
     void addAccessLogHandler(AccessLog::InstanceSharedPtr handler) override {
@@ -994,6 +1011,8 @@ private:
   Buffer::BufferMemoryAccountSharedPtr account_;
   const bool proxy_100_continue_;
 
+  // Declared before the filters since their memory may belong to it.
+  absl::optional<Arena> arena_;
   std::list<ActiveStreamDecoderFilterPtr> decoder_filters_;
   std::list<ActiveStreamEncoderFilterPtr> encoder_filters_;
   std::list<StreamFilterBase*> filters_;
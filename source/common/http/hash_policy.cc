@@ -39,12 +39,15 @@ public:
 
   absl::optional<uint64_t> evaluate(const Network::Address::Instance*,
                                     const RequestHeaderMap& headers,
-                                    const HashPolicy::AddCookieCallback,
-                                    const StreamInfo::FilterStateSharedPtr) const override {
+                                    const HashPolicy::AddCookieCallback&,
+                                    const StreamInfo::FilterStateSharedPtr&) const override {
     absl::optional<uint64_t> hash;
 
     const auto header = headers.get(header_name_);
-    if (!header.empty()) {
+    if (header.size() == 1 && regex_rewrite_ == nullptr) {
+      // The common case of a single value needs neither sorting nor a copy of the value.
+      hash = HashUtil::xxHash64(header[0]->value().getStringView());
+    } else if (!header.empty()) {
       absl::InlinedVector<absl::string_view, 1> header_values;
       size_t num_headers_to_hash = header.size();
       header_values.reserve(num_headers_to_hash);
@@ -86,14 +89,13 @@ public:
 
   absl::optional<uint64_t> evaluate(const Network::Address::Instance*,
                                     const RequestHeaderMap& headers,
-                                    const HashPolicy::AddCookieCallback add_cookie,
-                                    const StreamInfo::FilterStateSharedPtr) const override {
+                                    const HashPolicy::AddCookieCallback& add_cookie,
+                                    const StreamInfo::FilterStateSharedPtr&) const override {
     absl::optional<uint64_t> hash;
-    std::string value = Utility::parseCookieValue(headers, key_);
+    // The cookie is hashed in place; only a newly generated cookie is materialized.
+    const absl::string_view value = Utility::findCookieValue(headers, key_);
     if (value.empty() && ttl_.has_value()) {
-      value = add_cookie(key_, path_, ttl_.value(), attributes_);
-      hash = HashUtil::xxHash64(value);
-
+      hash = HashUtil::xxHash64(add_cookie(key_, path_, ttl_.value(), attributes_));
     } else if (!value.empty()) {
       hash = HashUtil::xxHash64(value);
     }
@@ -112,8 +114,8 @@ public:
   IpHashMethod(bool terminal) : HashMethodImplBase(terminal) {}
 
   absl::optional<uint64_t> evaluate(const Network::Address::Instance* downstream_addr,
-                                    const RequestHeaderMap&, const HashPolicy::AddCookieCallback,
-                                    const StreamInfo::FilterStateSharedPtr) const override {
+                                    const RequestHeaderMap&, const HashPolicy::AddCookieCallback&,
+                                    const StreamInfo::FilterStateSharedPtr&) const override {
     if (downstream_addr == nullptr) {
       return absl::nullopt;
     }
@@ -136,15 +138,15 @@ public:
 
   absl::optional<uint64_t> evaluate(const Network::Address::Instance*,
                                     const RequestHeaderMap& headers,
-                                    const HashPolicy::AddCookieCallback,
-                                    const StreamInfo::FilterStateSharedPtr) const override {
+                                    const HashPolicy::AddCookieCallback&,
+                                    const StreamInfo::FilterStateSharedPtr&) const override {
     absl::optional<uint64_t> hash;
 
     const HeaderEntry* header = headers.Path();
     if (header) {
-      Http::Utility::QueryParamsMulti query_parameters =
-          Http::Utility::QueryParamsMulti::parseQueryString(header->value().getStringView());
-      const auto val = query_parameters.getFirstValue(parameter_name_);
+      // Only the parameter of interest is looked up, and it is hashed in place.
+      const auto val =
+          Http::Utility::findQueryParameter(header->value().getStringView(), parameter_name_);
       if (val.has_value()) {
         hash = HashUtil::xxHash64(val.value());
       }
@@ -163,8 +165,8 @@ public:
 
   absl::optional<uint64_t>
   evaluate(const Network::Address::Instance*, const RequestHeaderMap&,
-           const HashPolicy::AddCookieCallback,
-           const StreamInfo::FilterStateSharedPtr filter_state) const override {
+           const HashPolicy::AddCookieCallback&,
+           const StreamInfo::FilterStateSharedPtr& filter_state) const override {
     if (auto typed_state = filter_state->getDataReadOnly<Hashable>(key_); typed_state != nullptr) {
       return typed_state->hash();
     }
@@ -24,10 +24,12 @@ public:
   class HashMethod {
   public:
     virtual ~HashMethod() = default;
+    // The callback and the filter state are passed by reference so that evaluating a chain of
+    // methods does not copy them once per method.
     virtual absl::optional<uint64_t>
     evaluate(const Network::Address::Instance* downstream_addr, const RequestHeaderMap& headers,
-             const AddCookieCallback add_cookie,
-             const StreamInfo::FilterStateSharedPtr filter_state) const PURE;
+             const AddCookieCallback& add_cookie,
+             const StreamInfo::FilterStateSharedPtr& filter_state) const PURE;
 
     // If the method is a terminal method, ignore rest of the hash policy chain.
     virtual bool terminal() const PURE;
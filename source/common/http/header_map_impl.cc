@@ -1,5 +1,6 @@
 #include "source/common/http/header_map_impl.h"
 
+#include <atomic>
 #include <cstdint>
 #include <list>
 #include <memory>
@@ -10,6 +11,7 @@
 #include "source/common/common/assert.h"
 #include "source/common/common/dump_state_utils.h"
 #include "source/common/common/empty_string.h"
+#include "source/common/common/macros.h"
 #include "source/common/runtime/runtime_features.h"
 #include "source/common/singleton/const_singleton.h"
 
@@ -24,7 +26,6 @@ namespace {
 
 constexpr absl::string_view DelimiterForInlineHeaders{","};
 constexpr absl::string_view DelimiterForInlineCookies{"; "};
-const static int kMinHeadersForLazyMap = 3; // Optimal hard-coded value based on benchmarks.
 
 bool validatedLowerCaseString(absl::string_view str) {
   auto lower_case_str = LowerCaseString(str);
@@ -38,6 +39,18 @@ absl::string_view delimiterByHeader(const LowerCaseString& key) {
   return DelimiterForInlineHeaders;
 }
 
+uint32_t readMinHeadersForLazyMap() {
+  return Runtime::runtimeFeatureEnabled("envoy.reloadable_features.header_map_hash_index")
+             ? HeaderMapImpl::DefaultMinHeadersForLazyMap
+             : HeaderMapImpl::LegacyMinHeadersForLazyMap;
+}
+
+// The header maps are created on the request path, so the runtime guard is read once rather than
+// on every header map construction. Changes of the guard take effect on restart.
+std::atomic<uint32_t>& minHeadersForLazyMap() {
+  MUTABLE_CONSTRUCT_ON_FIRST_USE(std::atomic<uint32_t>, readMinHeadersForLazyMap());
+}
+
 } // namespace
 
 // Initialize as a Type::Reference
@@ -59,11 +72,21 @@ template <> bool HeaderMapImpl::HeaderList::isPseudoHeader(const LowerCaseString
   return key.get().c_str()[0] == ':';
 }
 
+HeaderMapImpl::HeaderList::HeaderList()
+    : pseudo_headers_end_(headers_.end()),
+      min_headers_for_lazy_map_(minHeadersForLazyMap().load(std::memory_order_relaxed)) {}
+
+void HeaderMapImpl::reloadMinHeadersForLazyMapForTest() {
+  minHeadersForLazyMap().store(readMinHeadersForLazyMap(), std::memory_order_relaxed);
+}
+
 bool HeaderMapImpl::HeaderList::maybeMakeMap() {
   if (lazy_map_.empty()) {
-    if (headers_.size() < kMinHeadersForLazyMap) {
+    if (headers_.size() < min_headers_for_lazy_map_) {
       return false;
     }
+    index_.clear();
+    index_active_ = false;
     // Add all entries from the list into the map.
     for (auto node = headers_.begin(); node != headers_.end(); ++node) {
       HeaderNodeVector& v = lazy_map_[node->key().getStringView()];
@@ -73,6 +96,15 @@ bool HeaderMapImpl::HeaderList::maybeMakeMap() {
   return true;
 }
 
+void HeaderMapImpl::HeaderList::maybeMakeIndex() {
+  if (!index_active_) {
+    for (auto node = headers_.begin(); node != headers_.end(); ++node) {
+      index_.add(node);
+    }
+    index_active_ = true;
+  }
+}
+
 size_t HeaderMapImpl::HeaderList::remove(absl::string_view key) {
   size_t removed_bytes = 0;
   if (maybeMakeMap()) {
@@ -88,15 +120,12 @@ size_t HeaderMapImpl::HeaderList::remove(absl::string_view key) {
       }
     }
   } else {
-    // Erase all same key entries from the list.
-    for (auto i = headers_.begin(); i != headers_.end();) {
-      if (i->key() == key) {
-        removed_bytes += i->key().size() + i->value().size();
-        i = erase(i, false /* remove_from_map */);
-      } else {
-        ++i;
-      }
-    }
+    // Erase all same key entries from the index and from the list.
+    maybeMakeIndex();
+    index_.remove(key, [&](HeaderNode node) {
+      removed_bytes += node->key().size() + node->value().size();
+      erase(node, false /* remove_from_map */);
+    });
   }
   return removed_bytes;
 }
@@ -377,14 +406,10 @@ HeaderMap::NonConstGetResult HeaderMapImpl::getExisting(absl::string_view key) {
     return ret;
   }
 
-  // If the requested header is not an O(1) header and the lazy map is not in use, we do a full
-  // scan. Doing the trie lookup is wasteful in the miss case, but is present for code consistency
+  // If the requested header is not an O(1) header and the lazy map is not in use, we scan the hash
+  // index. Doing the trie lookup is wasteful in the miss case, but is present for code consistency
   // with other functions that do similar things.
-  for (HeaderEntryImpl& header : headers_) {
-    if (header.key() == key) {
-      ret.push_back(&header);
-    }
-  }
+  headers_.indexFind(key, [&ret](HeaderEntryImpl& header) { ret.push_back(&header); });
 
   return ret;
 }
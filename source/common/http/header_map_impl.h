@@ -1,11 +1,13 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cstdint>
 #include <list>
 #include <memory>
 #include <string>
 #include <type_traits>
+#include <vector>
 
 #include "envoy/common/optref.h"
 #include "envoy/http/header_map.h"
@@ -15,6 +17,8 @@
 #include "source/common/http/headers.h"
 #include "source/common/runtime/runtime_features.h"
 
+#include "absl/hash/hash.h"
+
 namespace Envoy {
 namespace Http {
 
@@ -77,6 +81,16 @@ public:
   // Performs a manual byte size count for test verification.
   void verifyByteSizeInternalForTest() const;
 
+  // The number of headers from which the lookups use a map instead of the hash index. The hash
+  // index is scanned linearly, the map keeps the lookups cheap for a very large number of headers.
+  static constexpr uint32_t DefaultMinHeadersForLazyMap = 128;
+  // The number of headers from which the map is used when
+  // envoy.reloadable_features.header_map_hash_index is disabled.
+  static constexpr uint32_t LegacyMinHeadersForLazyMap = 3;
+
+  // Re-reads envoy.reloadable_features.header_map_hash_index, which is otherwise read once.
+  static void reloadMinHeadersForLazyMapForTest();
+
   // Note: This class does not actually implement Http::HeaderMap to avoid virtual inheritance in
   // the derived classes. Instead, it is used as a mix-in class for TypedHeaderMapImpl below. This
   // both avoid virtual inheritance and allows the concrete final header maps to use a variable
@@ -128,6 +142,8 @@ protected:
     HeaderString key_;
     HeaderString value_;
     std::list<HeaderEntryImpl>::iterator entry_;
+    // The slot of the entry in the hash index of the header list, when the index is used.
+    uint32_t index_slot_{};
   };
   using HeaderNode = std::list<HeaderEntryImpl>::iterator;
 
@@ -183,12 +199,130 @@ protected:
     size_t size_;
   };
 
+  /**
+   * Compact array of the hashes of the header keys, with the matching list nodes. The nodes with
+   * the same key are kept in insertion order. Finding a key scans the contiguous hashes, which the
+   * compiler vectorizes, and only compares the keys of the nodes with a matching hash.
+   */
+  class HashIndex {
+  public:
+    static uint32_t hash(absl::string_view key) {
+      const uint32_t key_hash = static_cast<uint32_t>(absl::Hash<absl::string_view>{}(key));
+      // No key hashes to RemovedHash, so that the removed slots never match a lookup.
+      return key_hash == RemovedHash ? key_hash + 1 : key_hash;
+    }
+
+    void add(HeaderNode node) {
+      node->index_slot_ = static_cast<uint32_t>(hashes_.size());
+      hashes_.push_back(hash(node->key().getStringView()));
+      nodes_.push_back(node);
+    }
+
+    /**
+     * Removes a node through its slot. The slot is left empty until half of the slots are empty,
+     * when the index is compacted.
+     */
+    void remove(HeaderNode node) {
+      const uint32_t slot = node->index_slot_;
+      ASSERT(slot < nodes_.size() && nodes_[slot] == node);
+      hashes_[slot] = RemovedHash;
+      if (++removed_slots_ * 2 >= hashes_.size()) {
+        compact([](size_t) { return false; });
+      }
+    }
+
+    /**
+     * Calls cb with the node of each header with the given key, in insertion order.
+     */
+    template <class Callback> void find(absl::string_view key, Callback cb) const {
+      const uint32_t key_hash = hash(key);
+      const size_t size = hashes_.size();
+      for (size_t block = 0; block < size; block += BlockSize) {
+        const size_t block_end = std::min(block + BlockSize, size);
+        // This loop has no early exit so that it can be vectorized.
+        bool any_match = false;
+        for (size_t i = block; i < block_end; ++i) {
+          any_match |= hashes_[i] == key_hash;
+        }
+        if (!any_match) {
+          continue;
+        }
+        for (size_t i = block; i < block_end; ++i) {
+          if (hashes_[i] == key_hash && nodes_[i]->key() == key) {
+            cb(nodes_[i]);
+          }
+        }
+      }
+    }
+
+    /**
+     * Removes the nodes for which the predicate returns true. The predicate is called with the
+     * nodes in insertion order.
+     */
+    template <class NodePredicate> void removeIf(NodePredicate p) {
+      compact([&](size_t i) { return p(nodes_[i]); });
+    }
+
+    /**
+     * Removes the nodes with the given key, calling cb with each of them before removal.
+     */
+    template <class Callback> void remove(absl::string_view key, Callback cb) {
+      const uint32_t key_hash = hash(key);
+      compact([&](size_t i) {
+        if (hashes_[i] == key_hash && nodes_[i]->key() == key) {
+          cb(nodes_[i]);
+          return true;
+        }
+        return false;
+      });
+    }
+
+    void clear() {
+      hashes_.clear();
+      nodes_.clear();
+      removed_slots_ = 0;
+    }
+
+  private:
+    // The number of hashes compared before checking for a match.
+    static constexpr size_t BlockSize = 16;
+    // The hash of the removed slots, whose nodes are no longer valid.
+    static constexpr uint32_t RemovedHash = 0;
+
+    /**
+     * Drops the removed slots and the slots for which remove_slot returns true, keeping the order
+     * of the remaining nodes. remove_slot is only called for the slots that hold a valid node.
+     */
+    template <class SlotPredicate> void compact(SlotPredicate remove_slot) {
+      size_t kept = 0;
+      for (size_t i = 0; i < nodes_.size(); ++i) {
+        if (hashes_[i] == RemovedHash || remove_slot(i)) {
+          continue;
+        }
+        hashes_[kept] = hashes_[i];
+        nodes_[kept] = nodes_[i];
+        nodes_[kept]->index_slot_ = static_cast<uint32_t>(kept);
+        ++kept;
+      }
+      hashes_.resize(kept);
+      nodes_.resize(kept);
+      removed_slots_ = 0;
+    }
+
+    std::vector<uint32_t> hashes_;
+    std::vector<HeaderNode> nodes_;
+    // The number of removed slots not yet compacted.
+    size_t removed_slots_{0};
+  };
+
   /**
    * List of HeaderEntryImpl that keeps the pseudo headers (key starting with ':') in the front
    * of the list (as required by nghttp2) and otherwise maintains insertion order.
-   * When the list size is greater or equal to 3, all headers are added to a map, to allow fast
-   * access given a header key. Once the map is initialized, it will be used even
-   * if the number of headers decreases below the threshold.
+   * On the first lookup of a key, all headers are added to a HashIndex, to allow fast access
+   * given a header key. When the list size is greater or equal to a threshold, all headers are
+   * added to a map instead, so that the lookups don't scale with the number of headers. Once the
+   * map is initialized, it will be used even if the number of headers decreases below the
+   * threshold.
    *
    * Note: the internal iterators held in fields make this unsafe to copy and move, since the
    * reference to end() is not preserved across a move (see Notes in
@@ -202,7 +336,7 @@ protected:
     using HeaderNodeVector = absl::InlinedVector<HeaderNode, 1>;
     using HeaderLazyMap = absl::flat_hash_map<absl::string_view, HeaderNodeVector>;
 
-    HeaderList() : pseudo_headers_end_(headers_.end()) {}
+    HeaderList();
 
     template <class Key> bool isPseudoHeader(const Key& key) {
       return !key.getStringView().empty() && key.getStringView()[0] == ':';
@@ -214,6 +348,8 @@ protected:
                                       std::forward<Key>(key), std::forward<Value>(value)...);
       if (!lazy_map_.empty()) {
         lazy_map_[i->key().getStringView()].push_back(i);
+      } else if (index_active_) {
+        index_.add(i);
       }
       if (!is_pseudo_header && pseudo_headers_end_ == headers_.end()) {
         pseudo_headers_end_ = i;
@@ -226,7 +362,11 @@ protected:
         pseudo_headers_end_++;
       }
       if (remove_from_map) {
-        lazy_map_.erase(i->key().getStringView());
+        if (index_active_) {
+          index_.remove(i);
+        } else {
+          lazy_map_.erase(i->key().getStringView());
+        }
       }
       return headers_.erase(i);
     }
@@ -263,9 +403,22 @@ protected:
             map_it++;
           }
         }
+      } else if (index_active_) {
+        // The hash index is used, iterate over its elements and remove those that satisfy the
+        // predicate from the index and from the list.
+        index_.removeIf([&](HeaderNode it) {
+          if (p(*(it->entry_))) {
+            if (pseudo_headers_end_ == it->entry_) {
+              pseudo_headers_end_++;
+            }
+            headers_.erase(it);
+            return true;
+          }
+          return false;
+        });
       } else {
-        // The lazy map isn't used, iterate over the list elements and remove elements that satisfy
-        // the predicate.
+        // No lookup structure is used, iterate over the list elements and remove elements that
+        // satisfy the predicate.
         headers_.remove_if([&](const HeaderEntryImpl& entry) {
           const bool to_remove = p(entry);
           if (to_remove) {
@@ -279,12 +432,22 @@ protected:
     }
 
     /*
-     * Creates and populates a map if the number of headers is at least 3.
+     * Creates and populates a map if the number of headers is at least the lazy map threshold.
      *
      * @return if a map was created.
      */
     bool maybeMakeMap();
 
+    /*
+     * Calls cb with each header with the given key, using the hash index. Must only be called
+     * when maybeMakeMap() returns false.
+     */
+    template <class Callback> void indexFind(absl::string_view key, Callback cb) {
+      ASSERT(lazy_map_.empty());
+      maybeMakeIndex();
+      index_.find(key, [&cb](HeaderNode node) { cb(*node); });
+    }
+
     /*
      * Removes a given key and its values from the HeaderList.
      *
@@ -306,12 +469,21 @@ protected:
       headers_.clear();
       pseudo_headers_end_ = headers_.end();
       lazy_map_.clear();
+      index_.clear();
+      index_active_ = false;
     }
 
   private:
+    // Populates the hash index on first use.
+    void maybeMakeIndex();
+
     std::list<HeaderEntryImpl> headers_;
     HeaderNode pseudo_headers_end_;
     HeaderLazyMap lazy_map_;
+    // Only one of the hash index and the lazy map is used at a time.
+    HashIndex index_;
+    bool index_active_{false};
+    const uint32_t min_headers_for_lazy_map_;
   };
 
   void insertByKey(HeaderString&& key, HeaderString&& value);
@@ -0,0 +1,582 @@
+#include "source/common/http/shared_conn_pool.h"
+
+#include "source/common/common/assert.h"
+#include "source/common/common/dump_state_utils.h"
+#include "source/common/http/header_map_impl.h"
+
+namespace Envoy {
+namespace Http {
+
+SharedConnPoolEntrySharedPtr SharedConnPoolRegistry::find(const Key& key) const {
+  absl::ReaderMutexLock lock(&mutex_);
+  auto it = entries_.find(key);
+  if (it == entries_.end() || it->second->closed_) {
+    return nullptr;
+  }
+  return it->second;
+}
+
+SharedConnPoolEntrySharedPtr
+SharedConnPoolRegistry::tryRegister(const Key& key, SharedConnPoolEntrySharedPtr entry) {
+  absl::MutexLock lock(&mutex_);
+  SharedConnPoolEntrySharedPtr& registered = entries_[key];
+  if (registered == nullptr || registered->closed_) {
+    registered = std::move(entry);
+  }
+  return registered;
+}
+
+void SharedConnPoolRegistry::unregister(const Key& key, const SharedConnPoolEntry& entry) {
+  absl::MutexLock lock(&mutex_);
+  auto it = entries_.find(key);
+  if (it != entries_.end() && it->second.get() == &entry) {
+    entries_.erase(it);
+  }
+}
+
+SharedConnPool::SharedConnPool(SharedConnPoolRegistrySharedPtr registry,
+                               SharedConnPoolRegistry::Key key, Event::Dispatcher& dispatcher,
+                               Upstream::HostConstSharedPtr host, PoolFactory pool_factory)
+    : registry_(std::move(registry)), key_(std::move(key)), dispatcher_(dispatcher),
+      host_(std::move(host)), pool_factory_(std::move(pool_factory)) {}
+
+SharedConnPool::~SharedConnPool() {
+  destroying_ = true;
+  closeEntry();
+  if (entry_ != nullptr) {
+    entry_->pool_ = nullptr;
+  }
+  // Like the streams left on the connections of a pool, the streams handed off to the owner are
+  // reset, or failed if they are not ready yet.
+  while (!requesters_.empty()) {
+    requesters_.front()->onPoolDestroyed();
+  }
+  // Destroying the pool resets the streams left on its connections, which tells the other workers.
+  pool_.reset();
+}
+
+bool SharedConnPool::hasActiveConnections() const {
+  return (pool_ != nullptr && pool_->hasActiveConnections()) || !requesters_.empty();
+}
+
+ConnectionPool::Cancellable* SharedConnPool::newStream(ResponseDecoder& response_decoder,
+                                                       ConnectionPool::Callbacks& callbacks,
+                                                       const Instance::StreamOptions& options) {
+  if (!resolveOwner()) {
+    callbacks.onPoolFailure(ConnectionPool::PoolFailureReason::LocalConnectionFailure,
+                            "shared connection pool draining", host_);
+    return nullptr;
+  }
+  if (pool_ != nullptr) {
+    return pool_->newStream(response_decoder, callbacks, options);
+  }
+
+  host_->cluster().trafficStats()->upstream_rq_cross_worker_.inc();
+  auto state = std::make_shared<StreamState>(dispatcher_, options);
+  auto requester = std::make_unique<RequesterStream>(*this, response_decoder, callbacks, state);
+  state->requester_ = requester.get();
+  LinkedList::moveIntoList(std::move(requester), requesters_);
+  dispatchStream(state);
+  return state->requester_;
+}
+
+absl::string_view SharedConnPool::protocolDescription() const {
+  return pool_ != nullptr ? pool_->protocolDescription() : "cross-worker";
+}
+
+void SharedConnPool::addIdleCallback(IdleCb cb) { idle_callbacks_.push_back(std::move(cb)); }
+
+bool SharedConnPool::isIdle() const {
+  return (pool_ == nullptr || pool_->isIdle()) && requesters_.empty() && owner_streams_.empty();
+}
+
+void SharedConnPool::drainConnections(Envoy::ConnectionPool::DrainBehavior drain_behavior) {
+  if (drain_behavior == Envoy::ConnectionPool::DrainBehavior::DrainAndDelete) {
+    draining_for_deletion_ = true;
+    closeEntry();
+  }
+  if (pool_ != nullptr) {
+    // The pool calls back once it is idle.
+    pool_->drainConnections(drain_behavior);
+  } else if (draining_for_deletion_) {
+    checkForIdleAndNotify();
+  }
+}
+
+bool SharedConnPool::maybePreconnect(float preconnect_ratio) {
+  // Only the owning worker opens connections.
+  return pool_ != nullptr && pool_->maybePreconnect(preconnect_ratio);
+}
+
+bool SharedConnPool::resolveOwner() {
+  if (pool_ != nullptr) {
+    return true;
+  }
+  if (remote_entry_ != nullptr && !remote_entry_->closed_) {
+    return true;
+  }
+  remote_entry_ = registry_->find(key_);
+  if (remote_entry_ != nullptr) {
+    return true;
+  }
+  if (draining_for_deletion_) {
+    return false;
+  }
+
+  auto entry = std::make_shared<SharedConnPoolEntry>(dispatcher_, *this);
+  remote_entry_ = registry_->tryRegister(key_, entry);
+  if (remote_entry_ != entry) {
+    // Another worker became the owner in the meantime.
+    return true;
+  }
+  ENVOY_LOG(debug, "owning the connections shared by the workers");
+  remote_entry_ = nullptr;
+  entry_ = std::move(entry);
+  pool_ = pool_factory_();
+  pool_->addIdleCallback([this]() { checkForIdleAndNotify(); });
+  return true;
+}
+
+void SharedConnPool::dispatchStream(const StreamStateSharedPtr& state) {
+  if (pool_ != nullptr) {
+    state->owner_entry_ = entry_;
+    onStreamFromOtherWorker(state);
+    return;
+  }
+
+  ASSERT(remote_entry_ != nullptr);
+  host_->cluster().trafficStats()->upstream_rq_cross_worker_hops_.inc();
+  state->owner_entry_ = remote_entry_;
+  remote_entry_->dispatcher_.post([entry = remote_entry_, state]() {
+    if (entry->closed_ || entry->pool_ == nullptr) {
+      state->requester_dispatcher_.post([state]() {
+        if (state->requester_ != nullptr) {
+          state->requester_->onOwnerClosed();
+        }
+      });
+      return;
+    }
+    entry->pool_->onStreamFromOtherWorker(state);
+  });
+}
+
+void SharedConnPool::onStreamFromOtherWorker(const StreamStateSharedPtr& state) {
+  ASSERT(pool_ != nullptr);
+  auto owner = std::make_unique<OwnerStream>(*this, state);
+  OwnerStream* owner_stream = owner.get();
+  state->owner_ = owner_stream;
+  LinkedList::moveIntoList(std::move(owner), owner_streams_);
+  owner_stream->newStream();
+}
+
+void SharedConnPool::onStreamDone() {
+  if (draining_for_deletion_ || idle_pending_) {
+    checkForIdleAndNotify();
+  }
+}
+
+void SharedConnPool::closeEntry() {
+  if (entry_ == nullptr || entry_->closed_) {
+    return;
+  }
+  entry_->closed_ = true;
+  registry_->unregister(key_, *entry_);
+}
+
+void SharedConnPool::checkForIdleAndNotify() {
+  if (destroying_) {
+    return;
+  }
+  if (!isIdle()) {
+    idle_pending_ = pool_ == nullptr || pool_->isIdle();
+    return;
+  }
+  idle_pending_ = false;
+  for (const Instance::IdleCb& cb : idle_callbacks_) {
+    cb();
+  }
+}
+
+SharedConnPool::RequesterStream::RequesterStream(SharedConnPool& parent, ResponseDecoder& decoder,
+                                                 ConnectionPool::Callbacks& callbacks,
+                                                 StreamStateSharedPtr state)
+    : parent_(parent), decoder_(decoder), callbacks_(callbacks), state_(std::move(state)) {}
+
+SharedConnPool::RequesterStream::~RequesterStream() {
+  if (state_->requester_ == this) {
+    state_->requester_ = nullptr;
+  }
+}
+
+void SharedConnPool::RequesterStream::onPoolFailure(ConnectionPool::PoolFailureReason reason,
+                                                    absl::string_view transport_failure_reason) {
+  Upstream::HostDescriptionConstSharedPtr host = parent_.host_;
+  done();
+  callbacks_.onPoolFailure(reason, transport_failure_reason, host);
+}
+
+void SharedConnPool::RequesterStream::onPoolReady(const ReadyInfo& info) {
+  connection_info_provider_ = std::make_shared<Network::ConnectionInfoSetterImpl>(
+      info.local_address_, info.remote_address_);
+  if (info.connection_id_.has_value()) {
+    connection_info_provider_->setConnectionID(info.connection_id_.value());
+  }
+  stream_info_ = std::make_unique<StreamInfo::StreamInfoImpl>(
+      parent_.dispatcher_.timeSource(), connection_info_provider_,
+      StreamInfo::FilterState::LifeSpan::Connection);
+  auto upstream_info = std::make_shared<StreamInfo::UpstreamInfoImpl>();
+  if (info.upstream_timing_.has_value()) {
+    upstream_info->upstreamTiming() = info.upstream_timing_.value();
+  }
+  upstream_info->setUpstreamNumStreams(info.num_streams_);
+  stream_info_->setUpstreamInfo(upstream_info);
+  buffer_limit_ = info.buffer_limit_;
+  ready_ = true;
+  callbacks_.onPoolReady(*this, parent_.host_, *stream_info_, info.protocol_);
+}
+
+void SharedConnPool::RequesterStream::onOwnerClosed() {
+  if (!parent_.resolveOwner()) {
+    onPoolFailure(ConnectionPool::PoolFailureReason::LocalConnectionFailure,
+                  "shared connection pool draining");
+    return;
+  }
+  parent_.dispatchStream(state_);
+}
+
+void SharedConnPool::RequesterStream::onPoolDestroyed() {
+  if (ready_) {
+    resetStream(StreamResetReason::LocalReset);
+    return;
+  }
+  postToOwner(
+      [](OwnerStream& owner) { owner.cancel(Envoy::ConnectionPool::CancelPolicy::Default); });
+  onPoolFailure(ConnectionPool::PoolFailureReason::LocalConnectionFailure,
+                "shared connection pool destroyed");
+}
+
+void SharedConnPool::RequesterStream::onDecode1xxHeaders(ResponseHeaderMapPtr&& headers) {
+  decoder_.decode1xxHeaders(std::move(headers));
+}
+
+void SharedConnPool::RequesterStream::onDecodeHeaders(ResponseHeaderMapPtr&& headers,
+                                                      bool end_stream) {
+  remote_end_stream_ = end_stream;
+  decoder_.decodeHeaders(std::move(headers), end_stream);
+  maybeDone();
+}
+
+void SharedConnPool::RequesterStream::onDecodeData(Buffer::Instance& data, bool end_stream) {
+  remote_end_stream_ = end_stream;
+  decoder_.decodeData(data, end_stream);
+  maybeDone();
+}
+
+void SharedConnPool::RequesterStream::onDecodeTrailers(ResponseTrailerMapPtr&& trailers) {
+  remote_end_stream_ = true;
+  decoder_.decodeTrailers(std::move(trailers));
+  maybeDone();
+}
+
+void SharedConnPool::RequesterStream::onDecodeMetadata(MetadataMapPtr&& metadata_map) {
+  decoder_.decodeMetadata(std::move(metadata_map));
+}
+
+void SharedConnPool::RequesterStream::onReset(StreamResetReason reason) {
+  runResetCallbacks(reason);
+  done();
+}
+
+void SharedConnPool::RequesterStream::cancel(Envoy::ConnectionPool::CancelPolicy cancel_policy) {
+  postToOwner([cancel_policy](OwnerStream& owner) { owner.cancel(cancel_policy); });
+  done();
+}
+
+Status SharedConnPool::RequesterStream::encodeHeaders(const RequestHeaderMap& headers,
+                                                      bool end_stream) {
+  local_end_stream_ = end_stream;
+  postToOwner([copy = createHeaderMap<RequestHeaderMapImpl>(headers),
+               end_stream](OwnerStream& owner) { owner.encodeHeaders(*copy, end_stream); });
+  maybeDone();
+  return okStatus();
+}
+
+void SharedConnPool::RequesterStream::encodeData(Buffer::Instance& data, bool end_stream) {
+  // The data is copied rather than moved, since its slices may only be released on this worker.
+  auto buffer = std::make_unique<Buffer::OwnedImpl>();
+  buffer->add(data);
+  data.drain(data.length());
+  local_end_stream_ = end_stream;
+  postToOwner([buffer = std::move(buffer), end_stream](OwnerStream& owner) {
+    owner.encodeData(*buffer, end_stream);
+  });
+  maybeDone();
+}
+
+void SharedConnPool::RequesterStream::encodeTrailers(const RequestTrailerMap& trailers) {
+  local_end_stream_ = true;
+  postToOwner([copy = createHeaderMap<RequestTrailerMapImpl>(trailers)](OwnerStream& owner) {
+    owner.encodeTrailers(*copy);
+  });
+  maybeDone();
+}
+
+void SharedConnPool::RequesterStream::encodeMetadata(const MetadataMapVector& metadata_map_vector) {
+  MetadataMapVector copy;
+  for (const MetadataMapPtr& metadata_map : metadata_map_vector) {
+    copy.push_back(std::make_unique<MetadataMap>(*metadata_map));
+  }
+  postToOwner([copy = std::move(copy)](OwnerStream& owner) { owner.encodeMetadata(copy); });
+}
+
+void SharedConnPool::RequesterStream::enableTcpTunneling() {
+  postToOwner([](OwnerStream& owner) { owner.enableTcpTunneling(); });
+}
+
+CodecEventCallbacks*
+SharedConnPool::RequesterStream::registerCodecEventCallbacks(CodecEventCallbacks* codec_callbacks) {
+  std::swap(codec_callbacks, codec_callbacks_);
+  return codec_callbacks;
+}
+
+void SharedConnPool::RequesterStream::readDisable(bool disable) {
+  postToOwner([disable](OwnerStream& owner) { owner.readDisable(disable); });
+}
+
+void SharedConnPool::RequesterStream::setFlushTimeout(std::chrono::milliseconds timeout) {
+  postToOwner([timeout](OwnerStream& owner) { owner.setFlushTimeout(timeout); });
+}
+
+void SharedConnPool::RequesterStream::resetStream(StreamResetReason reason) {
+  postToOwner([reason](OwnerStream& owner) { owner.resetStream(reason); });
+  runResetCallbacks(reason);
+  done();
+}
+
+void SharedConnPool::RequesterStream::postToOwner(absl::AnyInvocable<void(OwnerStream&)> cb) {
+  ASSERT(state_->owner_entry_ != nullptr);
+  state_->owner_entry_->dispatcher_.post([state = state_, cb = std::move(cb)]() mutable {
+    if (state->owner_ != nullptr) {
+      cb(*state->owner_);
+    }
+  });
+}
+
+void SharedConnPool::RequesterStream::maybeDone() {
+  if (local_end_stream_ && remote_end_stream_) {
+    done();
+  }
+}
+
+void SharedConnPool::RequesterStream::done() {
+  if (done_) {
+    return;
+  }
+  done_ = true;
+  state_->requester_ = nullptr;
+  parent_.dispatcher_.deferredDelete(removeFromList(parent_.requesters_));
+  parent_.onStreamDone();
+}
+
+SharedConnPool::OwnerStream::OwnerStream(SharedConnPool& parent, StreamStateSharedPtr state)
+    : parent_(parent), state_(std::move(state)) {}
+
+SharedConnPool::OwnerStream::~OwnerStream() {
+  if (state_->owner_ == this) {
+    state_->owner_ = nullptr;
+  }
+}
+
+void SharedConnPool::OwnerStream::newStream() {
+  ConnectionPool::Cancellable* handle = parent_.pool_->newStream(*this, *this, state_->options_);
+  // The callbacks may have run already, in which case there is no handle.
+  if (handle != nullptr) {
+    handle_ = handle;
+  }
+}
+
+void SharedConnPool::OwnerStream::cancel(Envoy::ConnectionPool::CancelPolicy cancel_policy) {
+  if (handle_ != nullptr) {
+    handle_->cancel(cancel_policy);
+    handle_ = nullptr;
+    done();
+  } else if (encoder_ != nullptr) {
+    // The stream became ready before the cancellation made it over.
+    resetStream(StreamResetReason::LocalReset);
+  }
+}
+
+void SharedConnPool::OwnerStream::encodeHeaders(const RequestHeaderMap& headers, bool end_stream) {
+  local_end_stream_ = end_stream;
+  const Status status = encoder_->encodeHeaders(headers, end_stream);
+  if (!status.ok()) {
+    ENVOY_LOG(debug, "failed to encode the headers of another worker: {}", status.message());
+    resetUpstream(StreamResetReason::LocalReset);
+    return;
+  }
+  maybeDone();
+}
+
+void SharedConnPool::OwnerStream::encodeData(Buffer::Instance& data, bool end_stream) {
+  local_end_stream_ = end_stream;
+  encoder_->encodeData(data, end_stream);
+  maybeDone();
+}
+
+void SharedConnPool::OwnerStream::encodeTrailers(const RequestTrailerMap& trailers) {
+  local_end_stream_ = true;
+  encoder_->encodeTrailers(trailers);
+  maybeDone();
+}
+
+void SharedConnPool::OwnerStream::encodeMetadata(const MetadataMapVector& metadata_map_vector) {
+  encoder_->encodeMetadata(metadata_map_vector);
+}
+
+void SharedConnPool::OwnerStream::enableTcpTunneling() { encoder_->enableTcpTunneling(); }
+
+void SharedConnPool::OwnerStream::readDisable(bool disable) {
+  encoder_->getStream().readDisable(disable);
+}
+
+void SharedConnPool::OwnerStream::setFlushTimeout(std::chrono::milliseconds timeout) {
+  encoder_->getStream().setFlushTimeout(timeout);
+}
+
+void SharedConnPool::OwnerStream::resetStream(StreamResetReason reason) {
+  Stream& stream = encoder_->getStream();
+  stream.removeCallbacks(*this);
+  encoder_ = nullptr;
+  stream.resetStream(reason);
+  done();
+}
+
+void SharedConnPool::OwnerStream::onPoolFailure(ConnectionPool::PoolFailureReason reason,
+                                                absl::string_view transport_failure_reason,
+                                                Upstream::HostDescriptionConstSharedPtr) {
+  handle_ = nullptr;
+  postToRequester([reason, transport_failure_reason = std::string(transport_failure_reason)](
+                      RequesterStream& requester) {
+    requester.onPoolFailure(reason, transport_failure_reason);
+  });
+  done();
+}
+
+void SharedConnPool::OwnerStream::onPoolReady(RequestEncoder& encoder,
+                                              Upstream::HostDescriptionConstSharedPtr,
+                                              StreamInfo::StreamInfo& info,
+                                              absl::optional<Protocol> protocol) {
+  handle_ = nullptr;
+  encoder_ = &encoder;
+  encoder.getStream().addCallbacks(*this);
+
+  ReadyInfo ready_info;
+  const Network::ConnectionInfoProvider& provider = encoder.getStream().connectionInfoProvider();
+  ready_info.local_address_ = provider.localAddress();
+  ready_info.remote_address_ = provider.remoteAddress();
+  ready_info.connection_id_ = info.downstreamAddressProvider().connectionID();
+  if (info.upstreamInfo()) {
+    ready_info.upstream_timing_ = info.upstreamInfo()->upstreamTiming();
+    ready_info.num_streams_ = info.upstreamInfo()->upstreamNumStreams();
+  }
+  ready_info.protocol_ = protocol;
+  ready_info.buffer_limit_ = encoder.getStream().bufferLimit();
+  postToRequester(
+      [ready_info](RequesterStream& requester) { requester.onPoolReady(ready_info); });
+}
+
+void SharedConnPool::OwnerStream::decode1xxHeaders(ResponseHeaderMapPtr&& headers) {
+  postToRequester([headers = std::move(headers)](RequesterStream& requester) mutable {
+    requester.onDecode1xxHeaders(std::move(headers));
+  });
+}
+
+void SharedConnPool::OwnerStream::decodeHeaders(ResponseHeaderMapPtr&& headers, bool end_stream) {
+  remote_end_stream_ = end_stream;
+  postToRequester([headers = std::move(headers), end_stream](RequesterStream& requester) mutable {
+    requester.onDecodeHeaders(std::move(headers), end_stream);
+  });
+  maybeDone();
+}
+
+void SharedConnPool::OwnerStream::decodeData(Buffer::Instance& data, bool end_stream) {
+  // The data is copied rather than moved, since its slices may only be released on this worker.
+  auto buffer = std::make_unique<Buffer::OwnedImpl>();
+  buffer->add(data);
+  data.drain(data.length());
+  remote_end_stream_ = end_stream;
+  postToRequester([buffer = std::move(buffer), end_stream](RequesterStream& requester) {
+    requester.onDecodeData(*buffer, end_stream);
+  });
+  maybeDone();
+}
+
+void SharedConnPool::OwnerStream::decodeTrailers(ResponseTrailerMapPtr&& trailers) {
+  remote_end_stream_ = true;
+  postToRequester([trailers = std::move(trailers)](RequesterStream& requester) mutable {
+    requester.onDecodeTrailers(std::move(trailers));
+  });
+  maybeDone();
+}
+
+void SharedConnPool::OwnerStream::decodeMetadata(MetadataMapPtr&& metadata_map) {
+  postToRequester([metadata_map = std::move(metadata_map)](RequesterStream& requester) mutable {
+    requester.onDecodeMetadata(std::move(metadata_map));
+  });
+}
+
+void SharedConnPool::OwnerStream::dumpState(std::ostream& os, int indent_level) const {
+  const char* spaces = spacesForLevel(indent_level);
+  os << spaces << "SharedConnPool::OwnerStream " << this << DUMP_MEMBER(local_end_stream_)
+     << DUMP_MEMBER(remote_end_stream_) << "\n";
+}
+
+void SharedConnPool::OwnerStream::onResetStream(StreamResetReason reason, absl::string_view) {
+  encoder_ = nullptr;
+  postToRequester([reason](RequesterStream& requester) { requester.onReset(reason); });
+  done();
+}
+
+void SharedConnPool::OwnerStream::onAboveWriteBufferHighWatermark() {
+  postToRequester([](RequesterStream& requester) { requester.runHighWatermarkCallbacks(); });
+}
+
+void SharedConnPool::OwnerStream::onBelowWriteBufferLowWatermark() {
+  postToRequester([](RequesterStream& requester) { requester.runLowWatermarkCallbacks(); });
+}
+
+void SharedConnPool::OwnerStream::postToRequester(absl::AnyInvocable<void(RequesterStream&)> cb) {
+  state_->requester_dispatcher_.post([state = state_, cb = std::move(cb)]() mutable {
+    if (state->requester_ != nullptr) {
+      cb(*state->requester_);
+    }
+  });
+}
+
+void SharedConnPool::OwnerStream::resetUpstream(StreamResetReason reason) {
+  resetStream(reason);
+  postToRequester([reason](RequesterStream& requester) { requester.onReset(reason); });
+}
+
+void SharedConnPool::OwnerStream::maybeDone() {
+  if (local_end_stream_ && remote_end_stream_) {
+    done();
+  }
+}
+
+void SharedConnPool::OwnerStream::done() {
+  if (done_) {
+    return;
+  }
+  done_ = true;
+  if (encoder_ != nullptr) {
+    encoder_->getStream().removeCallbacks(*this);
+    encoder_ = nullptr;
+  }
+  state_->owner_ = nullptr;
+  parent_.dispatcher_.deferredDelete(removeFromList(parent_.owner_streams_));
+  parent_.onStreamDone();
+}
+
+} // namespace Http
+} // namespace Envoy
@@ -0,0 +1,316 @@
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <list>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "envoy/event/deferred_deletable.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/http/codec.h"
+#include "envoy/http/conn_pool.h"
+#include "envoy/upstream/resource_manager.h"
+#include "envoy/upstream/upstream.h"
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/common/linked_object.h"
+#include "source/common/common/logger.h"
+#include "source/common/http/codec_helper.h"
+#include "source/common/network/socket_impl.h"
+#include "source/common/stream_info/stream_info_impl.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Http {
+
+class SharedConnPool;
+
+/**
+ * A connection pool of one worker which accepts streams from the other workers. The dispatcher
+ * may be posted to from any thread, while the pool is only accessed on the dispatcher's thread.
+ */
+struct SharedConnPoolEntry {
+  SharedConnPoolEntry(Event::Dispatcher& dispatcher, SharedConnPool& pool)
+      : dispatcher_(dispatcher), pool_(&pool) {}
+
+  Event::Dispatcher& dispatcher_;
+  // Cleared when the pool is destroyed.
+  SharedConnPool* pool_;
+  // Set once the pool stops accepting streams from the other workers.
+  std::atomic<bool> closed_{false};
+};
+
+using SharedConnPoolEntrySharedPtr = std::shared_ptr<SharedConnPoolEntry>;
+
+/**
+ * The process wide registry of the connection pools which accept streams from the other workers,
+ * keyed by host, priority and pool hash key.
+ */
+class SharedConnPoolRegistry {
+public:
+  using Key = std::tuple<const Upstream::HostDescription*, Upstream::ResourcePriority,
+                         std::vector<uint8_t>>;
+
+  /**
+   * @return the open entry registered for the key, or nullptr if there is none.
+   */
+  SharedConnPoolEntrySharedPtr find(const Key& key) const;
+
+  /**
+   * Registers the entry for the key, unless another open entry is already registered.
+   * @return the entry registered for the key once the call returns.
+   */
+  SharedConnPoolEntrySharedPtr tryRegister(const Key& key, SharedConnPoolEntrySharedPtr entry);
+
+  /**
+   * Removes the entry for the key, if it is still the registered one.
+   */
+  void unregister(const Key& key, const SharedConnPoolEntry& entry);
+
+private:
+  mutable absl::Mutex mutex_;
+  absl::flat_hash_map<Key, SharedConnPoolEntrySharedPtr> entries_ ABSL_GUARDED_BY(mutex_);
+};
+
+using SharedConnPoolRegistrySharedPtr = std::shared_ptr<SharedConnPoolRegistry>;
+
+/**
+ * An HTTP/2 or HTTP/3 connection pool whose connections are shared by the workers. The first
+ * worker to create a stream for a host owns the connections. The other workers hand their streams
+ * off to the owning worker, which encodes the requests on its connections and posts the responses
+ * back. When the owner goes away, the next stream makes another worker the owner.
+ */
+class SharedConnPool : public ConnectionPool::Instance,
+                       protected Logger::Loggable<Logger::Id::pool> {
+public:
+  using PoolFactory = std::function<ConnectionPool::InstancePtr()>;
+
+  SharedConnPool(SharedConnPoolRegistrySharedPtr registry, SharedConnPoolRegistry::Key key,
+                 Event::Dispatcher& dispatcher, Upstream::HostConstSharedPtr host,
+                 PoolFactory pool_factory);
+  ~SharedConnPool() override;
+
+  // ConnectionPool::Instance
+  bool hasActiveConnections() const override;
+  ConnectionPool::Cancellable* newStream(ResponseDecoder& response_decoder,
+                                         ConnectionPool::Callbacks& callbacks,
+                                         const Instance::StreamOptions& options) override;
+  absl::string_view protocolDescription() const override;
+  void addIdleCallback(IdleCb cb) override;
+  bool isIdle() const override;
+  void drainConnections(Envoy::ConnectionPool::DrainBehavior drain_behavior) override;
+  Upstream::HostDescriptionConstSharedPtr host() const override { return host_; }
+  bool maybePreconnect(float preconnect_ratio) override;
+
+  /**
+   * @return true if the streams are created on a connection pool owned by this worker.
+   */
+  bool isOwner() const { return pool_ != nullptr; }
+
+private:
+  class RequesterStream;
+  class OwnerStream;
+  using RequesterStreamPtr = std::unique_ptr<RequesterStream>;
+  using OwnerStreamPtr = std::unique_ptr<OwnerStream>;
+
+  // What the requesting worker learns about the upstream stream once it is ready.
+  struct ReadyInfo {
+    Network::Address::InstanceConstSharedPtr local_address_;
+    Network::Address::InstanceConstSharedPtr remote_address_;
+    absl::optional<uint64_t> connection_id_;
+    absl::optional<StreamInfo::UpstreamTiming> upstream_timing_;
+    size_t num_streams_{};
+    absl::optional<Protocol> protocol_;
+    uint32_t buffer_limit_{};
+  };
+
+  // The state of a stream shared by the requesting and the owning worker. Each pointer is only
+  // accessed on the thread of its worker and is cleared when the stream goes away there.
+  struct StreamState {
+    StreamState(Event::Dispatcher& requester_dispatcher, const Instance::StreamOptions& options)
+        : requester_dispatcher_(requester_dispatcher), options_(options) {}
+
+    Event::Dispatcher& requester_dispatcher_;
+    const Instance::StreamOptions options_;
+    SharedConnPoolEntrySharedPtr owner_entry_;
+    RequesterStream* requester_{};
+    OwnerStream* owner_{};
+  };
+  using StreamStateSharedPtr = std::shared_ptr<StreamState>;
+
+  // The stream handed to the router of the requesting worker. It copies whatever the router
+  // encodes over to the owning worker and replays what the upstream sends back.
+  class RequesterStream : public ConnectionPool::Cancellable,
+                          public RequestEncoder,
+                          public Stream,
+                          public StreamCallbackHelper,
+                          public LinkedObject<RequesterStream>,
+                          public Event::DeferredDeletable {
+  public:
+    RequesterStream(SharedConnPool& parent, ResponseDecoder& decoder,
+                    ConnectionPool::Callbacks& callbacks, StreamStateSharedPtr state);
+    ~RequesterStream() override;
+
+    void onPoolFailure(ConnectionPool::PoolFailureReason reason,
+                       absl::string_view transport_failure_reason);
+    void onPoolReady(const ReadyInfo& info);
+    void onOwnerClosed();
+    // Resets the stream, or fails it if it is not ready yet, when the pool is destroyed.
+    void onPoolDestroyed();
+    void onDecode1xxHeaders(ResponseHeaderMapPtr&& headers);
+    void onDecodeHeaders(ResponseHeaderMapPtr&& headers, bool end_stream);
+    void onDecodeData(Buffer::Instance& data, bool end_stream);
+    void onDecodeTrailers(ResponseTrailerMapPtr&& trailers);
+    void onDecodeMetadata(MetadataMapPtr&& metadata_map);
+    void onReset(StreamResetReason reason);
+
+    // ConnectionPool::Cancellable
+    void cancel(Envoy::ConnectionPool::CancelPolicy cancel_policy) override;
+
+    // RequestEncoder
+    Status encodeHeaders(const RequestHeaderMap& headers, bool end_stream) override;
+    void encodeTrailers(const RequestTrailerMap& trailers) override;
+    void enableTcpTunneling() override;
+
+    // StreamEncoder
+    void encodeData(Buffer::Instance& data, bool end_stream) override;
+    Stream& getStream() override { return *this; }
+    void encodeMetadata(const MetadataMapVector& metadata_map_vector) override;
+    Http1StreamEncoderOptionsOptRef http1StreamEncoderOptions() override { return absl::nullopt; }
+
+    // Stream
+    void addCallbacks(StreamCallbacks& callbacks) override { addCallbacksHelper(callbacks); }
+    void removeCallbacks(StreamCallbacks& callbacks) override { removeCallbacksHelper(callbacks); }
+    CodecEventCallbacks* registerCodecEventCallbacks(CodecEventCallbacks* codec_callbacks) override;
+    void readDisable(bool disable) override;
+    uint32_t bufferLimit() const override { return buffer_limit_; }
+    const Network::ConnectionInfoProvider& connectionInfoProvider() override {
+      return *connection_info_provider_;
+    }
+    void setFlushTimeout(std::chrono::milliseconds timeout) override;
+    Buffer::BufferMemoryAccountSharedPtr account() const override { return account_; }
+    void setAccount(Buffer::BufferMemoryAccountSharedPtr account) override { account_ = account; }
+    const StreamInfo::BytesMeterSharedPtr& bytesMeter() override { return bytes_meter_; }
+
+    // StreamResetHandler
+    void resetStream(StreamResetReason reason) override;
+
+  private:
+    // Runs the callback on the owning worker if the stream is still there.
+    void postToOwner(absl::AnyInvocable<void(OwnerStream&)> cb);
+    void maybeDone();
+    void done();
+
+    SharedConnPool& parent_;
+    ResponseDecoder& decoder_;
+    ConnectionPool::Callbacks& callbacks_;
+    StreamStateSharedPtr state_;
+    std::shared_ptr<Network::ConnectionInfoSetterImpl> connection_info_provider_;
+    std::unique_ptr<StreamInfo::StreamInfoImpl> stream_info_;
+    CodecEventCallbacks* codec_callbacks_{};
+    Buffer::BufferMemoryAccountSharedPtr account_;
+    StreamInfo::BytesMeterSharedPtr bytes_meter_{std::make_shared<StreamInfo::BytesMeter>()};
+    uint32_t buffer_limit_{};
+    bool ready_{};
+    bool remote_end_stream_{};
+    bool done_{};
+  };
+
+  // The stream created on the pool of the owning worker on behalf of another worker.
+  class OwnerStream : public ConnectionPool::Callbacks,
+                      public ResponseDecoder,
+                      public StreamCallbacks,
+                      public LinkedObject<OwnerStream>,
+                      public Event::DeferredDeletable {
+  public:
+    OwnerStream(SharedConnPool& parent, StreamStateSharedPtr state);
+    ~OwnerStream() override;
+
+    void newStream();
+    void cancel(Envoy::ConnectionPool::CancelPolicy cancel_policy);
+    void encodeHeaders(const RequestHeaderMap& headers, bool end_stream);
+    void encodeData(Buffer::Instance& data, bool end_stream);
+    void encodeTrailers(const RequestTrailerMap& trailers);
+    void encodeMetadata(const MetadataMapVector& metadata_map_vector);
+    void enableTcpTunneling();
+    void readDisable(bool disable);
+    void setFlushTimeout(std::chrono::milliseconds timeout);
+    void resetStream(StreamResetReason reason);
+
+    // ConnectionPool::Callbacks
+    void onPoolFailure(ConnectionPool::PoolFailureReason reason,
+                       absl::string_view transport_failure_reason,
+                       Upstream::HostDescriptionConstSharedPtr host) override;
+    void onPoolReady(RequestEncoder& encoder, Upstream::HostDescriptionConstSharedPtr host,
+                     StreamInfo::StreamInfo& info, absl::optional<Protocol> protocol) override;
+
+    // ResponseDecoder
+    void decode1xxHeaders(ResponseHeaderMapPtr&& headers) override;
+    void decodeHeaders(ResponseHeaderMapPtr&& headers, bool end_stream) override;
+    void decodeTrailers(ResponseTrailerMapPtr&& trailers) override;
+    void dumpState(std::ostream& os, int indent_level) const override;
+
+    // StreamDecoder
+    void decodeData(Buffer::Instance& data, bool end_stream) override;
+    void decodeMetadata(MetadataMapPtr&& metadata_map) override;
+
+    // StreamCallbacks
+    void onResetStream(StreamResetReason reason,
+                       absl::string_view transport_failure_reason) override;
+    void onAboveWriteBufferHighWatermark() override;
+    void onBelowWriteBufferLowWatermark() override;
+
+  private:
+    // Runs the callback on the requesting worker if the stream is still there.
+    void postToRequester(absl::AnyInvocable<void(RequesterStream&)> cb);
+    // Resets the upstream stream, e.g. when the request cannot be encoded.
+    void resetUpstream(StreamResetReason reason);
+    void maybeDone();
+    void done();
+
+    SharedConnPool& parent_;
+    StreamStateSharedPtr state_;
+    ConnectionPool::Cancellable* handle_{};
+    RequestEncoder* encoder_{};
+    bool local_end_stream_{};
+    bool remote_end_stream_{};
+    bool done_{};
+  };
+
+  // Finds the pool the next stream is created on, becoming the owner if no other worker is.
+  // Returns false if there is none, which only happens once draining for deletion.
+  bool resolveOwner();
+  // Hands the stream off to the owning worker or creates it locally if this worker is the owner.
+  void dispatchStream(const StreamStateSharedPtr& state);
+  void onStreamFromOtherWorker(const StreamStateSharedPtr& state);
+  void onStreamDone();
+  void closeEntry();
+  void checkForIdleAndNotify();
+
+  const SharedConnPoolRegistrySharedPtr registry_;
+  const SharedConnPoolRegistry::Key key_;
+  Event::Dispatcher& dispatcher_;
+  const Upstream::HostConstSharedPtr host_;
+  const PoolFactory pool_factory_;
+  // The pool of this worker, if it owns the connections.
+  ConnectionPool::InstancePtr pool_;
+  // The registered entry of this worker, if it owns the connections.
+  SharedConnPoolEntrySharedPtr entry_;
+  // The entry of the worker owning the connections, if it is another one.
+  SharedConnPoolEntrySharedPtr remote_entry_;
+  std::list<RequesterStreamPtr> requesters_;
+  std::list<OwnerStreamPtr> owner_streams_;
+  std::list<IdleCb> idle_callbacks_;
+  bool draining_for_deletion_{};
+  // Set when the pool became idle while streams of other workers were still using it.
+  bool idle_pending_{};
+  bool destroying_{};
+};
+
+} // namespace Http
+} // namespace Envoy
@@ -324,8 +324,8 @@ void forEachCookie(
   for (size_t index = 0; index < cookie_headers.size(); index++) {
     auto cookie_header_value = cookie_headers[index]->value().getStringView();
 
-    // Split the cookie header into individual cookies.
-    for (const auto& s : StringUtil::splitToken(cookie_header_value, ";")) {
+    // Split the cookie header into individual cookies, without materializing the pieces.
+    for (absl::string_view s : absl::StrSplit(cookie_header_value, ';', absl::SkipEmpty())) {
       // Find the key part of the cookie (i.e. the name of the cookie).
       size_t first_non_space = s.find_first_not_of(' ');
       size_t equals_index = s.find('=');
@@ -514,6 +514,34 @@ Utility::QueryParamsMulti Utility::QueryParamsMulti::parseQueryString(absl::stri
   return Utility::QueryParamsMulti::parseParameters(url, start, /*decode_params=*/false);
 }
 
+absl::optional<absl::string_view> Utility::findQueryParameter(absl::string_view url,
+                                                              absl::string_view name) {
+  size_t start = url.find('?');
+  if (start == absl::string_view::npos) {
+    return absl::nullopt;
+  }
+
+  // Walks the parameters the way parseParameters() does, stopping at the first match.
+  start++;
+  while (start < url.size()) {
+    size_t end = url.find('&', start);
+    if (end == absl::string_view::npos) {
+      end = url.size();
+    }
+    const absl::string_view param = url.substr(start, end - start);
+    const size_t equal = param.find('=');
+    if (equal == absl::string_view::npos) {
+      if (param == name) {
+        return absl::string_view();
+      }
+    } else if (param.substr(0, equal) == name) {
+      return param.substr(equal + 1);
+    }
+    start = end + 1;
+  }
+  return absl::nullopt;
+}
+
 Utility::QueryParams Utility::parseAndDecodeQueryString(absl::string_view url) {
   size_t start = url.find('?');
   if (start == std::string::npos) {
@@ -662,6 +690,19 @@ std::string Utility::parseCookieValue(const HeaderMap& headers, const std::strin
   return parseCookie(headers, key, Http::Headers::get().Cookie);
 }
 
+absl::string_view Utility::findCookieValue(const HeaderMap& headers, absl::string_view key) {
+  absl::string_view value;
+  forEachCookie(headers, Http::Headers::get().Cookie,
+                [key, &value](absl::string_view k, absl::string_view v) -> bool {
+                  if (key == k) {
+                    value = v;
+                    return false;
+                  }
+                  return true;
+                });
+  return value;
+}
+
 std::string Utility::parseSetCookieValue(const Http::HeaderMap& headers, const std::string& key) {
   return parseCookie(headers, key, Http::Headers::get().SetCookie);
 }
@@ -265,6 +265,17 @@ std::string createSslRedirectPath(const RequestHeaderMap& headers);
  */
 QueryParams parseQueryString(absl::string_view url);
 
+/**
+ * Find the value of the first query parameter with the given name in a URL, without parsing the
+ * rest of the query string. As with parseQueryString(), the value is not percent-decoded.
+ * @param url supplies the url to search.
+ * @param name supplies the name of the parameter.
+ * @return absl::optional<absl::string_view> the value of the parameter, pointing into the url, or
+ *         absl::nullopt if the parameter is not present.
+ */
+absl::optional<absl::string_view> findQueryParameter(absl::string_view url,
+                                                     absl::string_view name);
+
 /**
  * Parse a URL into query parameters.
  * @param url supplies the url to parse.
@@ -327,6 +338,14 @@ std::string replaceQueryString(const HeaderString& path, const QueryParams& para
  **/
 std::string parseCookieValue(const HeaderMap& headers, const std::string& key);
 
+/**
+ * Find a particular value in a cookie, without copying it.
+ * @param headers supplies the headers to get the cookie from.
+ * @param key the key for the particular cookie value to return
+ * @return absl::string_view the cookie value, pointing into the headers, or "" if none exists
+ **/
+absl::string_view findCookieValue(const HeaderMap& headers, absl::string_view key);
+
 /**
  * Parse cookies from header into a map.
  * @param headers supplies the headers to get cookies from.
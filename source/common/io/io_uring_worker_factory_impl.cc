@@ -0,0 +1,41 @@
+#include "source/common/io/io_uring_worker_factory_impl.h"
+
+namespace Envoy {
+namespace Io {
+
+IoUringWorkerFactoryImpl::IoUringWorkerFactoryImpl(uint32_t io_uring_size,
+                                                   bool use_submission_queue_polling,
+                                                   uint32_t read_buffer_size,
+                                                   std::chrono::milliseconds write_timeout,
+                                                   ThreadLocal::SlotAllocator& tls)
+    : io_uring_size_(io_uring_size), use_submission_queue_polling_(use_submission_queue_polling),
+      read_buffer_size_(read_buffer_size), write_timeout_(write_timeout), tls_(tls) {}
+
+OptRef<IoUringWorker> IoUringWorkerFactoryImpl::getIoUringWorker() {
+  // The threads which are not registered, e.g. the file flush threads, never have a worker.
+  if (!tls_.currentThreadRegistered()) {
+    return absl::nullopt;
+  }
+  OptRef<IoUringWorkerImpl> worker = tls_.get();
+  if (!worker.has_value()) {
+    return absl::nullopt;
+  }
+  return *worker;
+}
+
+void IoUringWorkerFactoryImpl::onWorkerThreadInitialized() {
+  tls_.set([io_uring_size = io_uring_size_,
+            use_submission_queue_polling = use_submission_queue_polling_,
+            read_buffer_size = read_buffer_size_,
+            write_timeout = write_timeout_](Event::Dispatcher& dispatcher) {
+    return std::make_shared<IoUringWorkerImpl>(io_uring_size, use_submission_queue_polling,
+                                               read_buffer_size, write_timeout, dispatcher);
+  });
+}
+
+bool IoUringWorkerFactoryImpl::currentThreadRegistered() {
+  return tls_.currentThreadRegistered();
+}
+
+} // namespace Io
+} // namespace Envoy
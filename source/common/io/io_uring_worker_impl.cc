@@ -1,10 +1,30 @@
 #include "source/common/io/io_uring_worker_impl.h"
 
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/common/assert.h"
+#include "source/common/common/utility.h"
+
 namespace Envoy {
 namespace Io {
 
-IoUringSocketEntry::IoUringSocketEntry(os_fd_t fd, IoUringWorkerImpl& parent)
-    : fd_(fd), parent_(parent) {}
+ReadRequest::ReadRequest(IoUringSocket& socket, uint32_t size)
+    : Request(RequestType::Read, socket), buf_(std::make_unique<uint8_t[]>(size)),
+      iov_(std::make_unique<struct iovec>()) {
+  iov_->iov_base = buf_.get();
+  iov_->iov_len = size;
+}
+
+WriteRequest::WriteRequest(IoUringSocket& socket, const Buffer::RawSliceVector& slices)
+    : Request(RequestType::Write, socket), iov_(std::make_unique<struct iovec[]>(slices.size())) {
+  for (size_t i = 0; i < slices.size(); i++) {
+    iov_[i].iov_base = slices[i].mem_;
+    iov_[i].iov_len = slices[i].len_;
+  }
+}
+
+IoUringSocketEntry::IoUringSocketEntry(os_fd_t fd, IoUringWorkerImpl& parent,
+                                       Event::FileReadyCb cb)
+    : fd_(fd), parent_(parent), cb_(std::move(cb)) {}
 
 void IoUringSocketEntry::cleanup() {
   IoUringSocketEntryPtr socket = parent_.removeSocket(*this);
@@ -25,12 +45,19 @@ void IoUringSocketEntry::injectCompletion(Request::RequestType type) {
 }
 
 IoUringWorkerImpl::IoUringWorkerImpl(uint32_t io_uring_size, bool use_submission_queue_polling,
+                                     uint32_t read_buffer_size,
+                                     std::chrono::milliseconds write_timeout,
                                      Event::Dispatcher& dispatcher)
     : IoUringWorkerImpl(std::make_unique<IoUringImpl>(io_uring_size, use_submission_queue_polling),
-                        dispatcher) {}
+                        dispatcher, read_buffer_size, write_timeout) {}
 
-IoUringWorkerImpl::IoUringWorkerImpl(IoUringPtr&& io_uring, Event::Dispatcher& dispatcher)
-    : io_uring_(std::move(io_uring)), dispatcher_(dispatcher) {
+IoUringWorkerImpl::IoUringWorkerImpl(IoUringPtr&& io_uring, Event::Dispatcher& dispatcher,
+                                     uint32_t read_buffer_size,
+                                     std::chrono::milliseconds write_timeout,
+                                     uint64_t write_buffer_limit)
+    : io_uring_(std::move(io_uring)), read_buffer_size_(read_buffer_size),
+      write_timeout_(write_timeout), write_buffer_limit_(write_buffer_limit),
+      dispatcher_(dispatcher) {
   const os_fd_t event_fd = io_uring_->registerEventfd();
   // We only care about the read event of Eventfd, since we only receive the
   // event here.
@@ -47,6 +74,110 @@ IoUringWorkerImpl::~IoUringWorkerImpl() {
 
 Event::Dispatcher& IoUringWorkerImpl::dispatcher() { return dispatcher_; }
 
+IoUringSocket& IoUringWorkerImpl::addAcceptSocket(os_fd_t fd, Event::FileReadyCb cb) {
+  ENVOY_LOG(trace, "add accept socket, fd = {}", fd);
+  return addSocket(std::make_unique<IoUringAcceptSocket>(fd, *this, std::move(cb)));
+}
+
+IoUringSocket& IoUringWorkerImpl::addServerSocket(os_fd_t fd, Event::FileReadyCb cb) {
+  ENVOY_LOG(trace, "add server socket, fd = {}", fd);
+  return addSocket(std::make_unique<IoUringServerSocket>(fd, *this, std::move(cb)));
+}
+
+IoUringSocket& IoUringWorkerImpl::addClientSocket(os_fd_t fd, Event::FileReadyCb cb) {
+  ENVOY_LOG(trace, "add client socket, fd = {}", fd);
+  return addSocket(std::make_unique<IoUringClientSocket>(fd, *this, std::move(cb)));
+}
+
+template <typename PrepareFn>
+void IoUringWorkerImpl::prepareRequest(PrepareFn prepare_fn, absl::string_view name) {
+  IoUringResult res = prepare_fn();
+  if (res == IoUringResult::Failed) {
+    // The submission queue is full. Submit the queued requests to make room for this one, even
+    // if the submit is delayed.
+    io_uring_->submit();
+    res = prepare_fn();
+    RELEASE_ASSERT(res == IoUringResult::Ok, fmt::format("unable to prepare {} request", name));
+  }
+  submit();
+}
+
+Request* IoUringWorkerImpl::submitAcceptRequest(IoUringSocket& socket) {
+  AcceptRequest* req = new AcceptRequest(socket);
+  ENVOY_LOG(trace, "submit accept request, fd = {}, accept req = {}", socket.fd(), fmt::ptr(req));
+  prepareRequest(
+      [this, &socket, req]() {
+        return io_uring_->prepareAccept(socket.fd(),
+                                        reinterpret_cast<struct sockaddr*>(&req->remote_addr_),
+                                        &req->remote_addr_len_, req);
+      },
+      "accept");
+  return req;
+}
+
+Request*
+IoUringWorkerImpl::submitConnectRequest(IoUringSocket& socket,
+                                        const Network::Address::InstanceConstSharedPtr& address) {
+  ConnectRequest* req = new ConnectRequest(socket, address);
+  ENVOY_LOG(trace, "submit connect request, fd = {}, connect req = {}", socket.fd(),
+            fmt::ptr(req));
+  prepareRequest(
+      [this, &socket, req]() { return io_uring_->prepareConnect(socket.fd(), req->address_, req); },
+      "connect");
+  return req;
+}
+
+Request* IoUringWorkerImpl::submitReadRequest(IoUringSocket& socket) {
+  ReadRequest* req = new ReadRequest(socket, read_buffer_size_);
+  ENVOY_LOG(trace, "submit read request, fd = {}, read req = {}", socket.fd(), fmt::ptr(req));
+  prepareRequest(
+      [this, &socket, req]() {
+        return io_uring_->prepareReadv(socket.fd(), req->iov_.get(), 1, 0, req);
+      },
+      "read");
+  return req;
+}
+
+Request* IoUringWorkerImpl::submitWriteRequest(IoUringSocket& socket,
+                                               const Buffer::RawSliceVector& slices) {
+  WriteRequest* req = new WriteRequest(socket, slices);
+  ENVOY_LOG(trace, "submit write request, fd = {}, write req = {}", socket.fd(), fmt::ptr(req));
+  prepareRequest(
+      [this, &socket, &slices, req]() {
+        return io_uring_->prepareWritev(socket.fd(), req->iov_.get(), slices.size(), 0, req);
+      },
+      "write");
+  return req;
+}
+
+Request* IoUringWorkerImpl::submitCloseRequest(IoUringSocket& socket) {
+  Request* req = new Request(Request::RequestType::Close, socket);
+  ENVOY_LOG(trace, "submit close request, fd = {}, close req = {}", socket.fd(), fmt::ptr(req));
+  prepareRequest([this, &socket, req]() { return io_uring_->prepareClose(socket.fd(), req); },
+                 "close");
+  return req;
+}
+
+Request* IoUringWorkerImpl::submitCancelRequest(IoUringSocket& socket, Request* request_to_cancel) {
+  Request* req = new Request(Request::RequestType::Cancel, socket);
+  ENVOY_LOG(trace, "submit cancel request, fd = {}, cancel req = {}, req to cancel = {}",
+            socket.fd(), fmt::ptr(req), fmt::ptr(request_to_cancel));
+  prepareRequest(
+      [this, request_to_cancel, req]() { return io_uring_->prepareCancel(request_to_cancel, req); },
+      "cancel");
+  return req;
+}
+
+Request* IoUringWorkerImpl::submitShutdownRequest(IoUringSocket& socket, int how) {
+  Request* req = new Request(Request::RequestType::Shutdown, socket);
+  ENVOY_LOG(trace, "submit shutdown request, fd = {}, shutdown req = {}", socket.fd(),
+            fmt::ptr(req));
+  prepareRequest(
+      [this, &socket, how, req]() { return io_uring_->prepareShutdown(socket.fd(), how, req); },
+      "shutdown");
+  return req;
+}
+
 IoUringSocketEntry& IoUringWorkerImpl::addSocket(IoUringSocketEntryPtr&& socket) {
   LinkedList::moveIntoListBack(std::move(socket), sockets_);
   return *sockets_.back();
@@ -123,5 +254,451 @@ void IoUringWorkerImpl::submit() {
   }
 }
 
+IoUringAcceptSocket::IoUringAcceptSocket(os_fd_t fd, IoUringWorkerImpl& parent,
+                                         Event::FileReadyCb cb)
+    : IoUringSocketEntry(fd, parent, std::move(cb)) {}
+
+void IoUringAcceptSocket::close(bool keep_fd_open, IoUringSocketOnClosedCb cb) {
+  IoUringSocketEntry::close(keep_fd_open, cb);
+  keep_fd_open_ = keep_fd_open;
+
+  // The sockets which are accepted but not delivered will never be delivered.
+  for (const AcceptedSocket& socket : accepted_sockets_) {
+    Api::OsSysCallsSingleton::get().close(socket.fd_);
+  }
+  accepted_sockets_.clear();
+
+  if (accept_req_ != nullptr && cancel_req_ == nullptr) {
+    cancel_req_ = parent_.submitCancelRequest(*this, accept_req_);
+  }
+  closeIfDone();
+}
+
+void IoUringAcceptSocket::enableRead() {
+  if (status_ == Closed) {
+    return;
+  }
+  IoUringSocketEntry::enableRead();
+  if (!accepted_sockets_.empty()) {
+    injectCompletion(Request::RequestType::Accept);
+  }
+  submitAcceptRequest();
+}
+
+void IoUringAcceptSocket::disableRead() {
+  if (status_ == Closed) {
+    return;
+  }
+  // The inflight accept request is kept, the socket accepted by it will be delivered once the
+  // socket is enabled again.
+  IoUringSocketEntry::disableRead();
+}
+
+void IoUringAcceptSocket::connect(const Network::Address::InstanceConstSharedPtr&) {
+  ENVOY_BUG(false, "connect on a listening io_uring socket");
+}
+
+uint64_t IoUringAcceptSocket::write(Buffer::Instance&) {
+  ENVOY_BUG(false, "write on a listening io_uring socket");
+  return 0;
+}
+
+uint64_t IoUringAcceptSocket::write(const Buffer::RawSlice*, uint64_t) {
+  ENVOY_BUG(false, "write on a listening io_uring socket");
+  return 0;
+}
+
+void IoUringAcceptSocket::shutdown(int) {
+  ENVOY_BUG(false, "shutdown on a listening io_uring socket");
+}
+
+void IoUringAcceptSocket::onAccept(Request* req, int32_t result, bool injected) {
+  IoUringSocketEntry::onAccept(req, result, injected);
+  if (!injected) {
+    ASSERT(req == accept_req_);
+    accept_req_ = nullptr;
+    if (result >= 0) {
+      if (status_ == Closed) {
+        Api::OsSysCallsSingleton::get().close(result);
+      } else {
+        AcceptRequest* accept_req = static_cast<AcceptRequest*>(req);
+        accepted_sockets_.push_back(
+            {result, accept_req->remote_addr_, accept_req->remote_addr_len_});
+      }
+    } else if (result != -ECANCELED) {
+      ENVOY_LOG(debug, "accept request failed, fd = {}, error = {}", fd_, errorDetails(-result));
+    }
+  }
+
+  if (status_ == Closed) {
+    closeIfDone();
+    return;
+  }
+
+  deliverAcceptedSockets();
+  submitAcceptRequest();
+}
+
+void IoUringAcceptSocket::onCancel(Request* req, int32_t result, bool injected) {
+  IoUringSocketEntry::onCancel(req, result, injected);
+  ASSERT(req == cancel_req_);
+  cancel_req_ = nullptr;
+  closeIfDone();
+}
+
+void IoUringAcceptSocket::onClose(Request* req, int32_t result, bool injected) {
+  IoUringSocketEntry::onClose(req, result, injected);
+  if (on_closed_cb_) {
+    on_closed_cb_();
+  }
+  cleanup();
+}
+
+void IoUringAcceptSocket::deliverAcceptedSockets() {
+  while (status_ == ReadEnabled && !accepted_sockets_.empty()) {
+    AcceptedSocket socket = accepted_sockets_.front();
+    accepted_sockets_.pop_front();
+
+    accepted_socket_param_ =
+        AcceptedSocketParam{socket.fd_, &socket.remote_addr_, socket.remote_addr_len_};
+    cb_(Event::FileReadyType::Read);
+    // The owner didn't take the socket, e.g. the owner was closed in the callback.
+    if (SOCKET_VALID(accepted_socket_param_->fd_)) {
+      Api::OsSysCallsSingleton::get().close(accepted_socket_param_->fd_);
+    }
+    accepted_socket_param_.reset();
+  }
+}
+
+void IoUringAcceptSocket::submitAcceptRequest() {
+  if (status_ == ReadEnabled && accept_req_ == nullptr) {
+    accept_req_ = parent_.submitAcceptRequest(*this);
+  }
+}
+
+void IoUringAcceptSocket::closeIfDone() {
+  if (accept_req_ != nullptr || cancel_req_ != nullptr || close_submitted_) {
+    return;
+  }
+
+  if (keep_fd_open_) {
+    if (on_closed_cb_) {
+      on_closed_cb_();
+    }
+    cleanup();
+    return;
+  }
+
+  close_submitted_ = true;
+  parent_.submitCloseRequest(*this);
+}
+
+IoUringServerSocket::IoUringServerSocket(os_fd_t fd, IoUringWorkerImpl& parent,
+                                         Event::FileReadyCb cb)
+    : IoUringSocketEntry(fd, parent, std::move(cb)) {}
+
+void IoUringServerSocket::close(bool keep_fd_open, IoUringSocketOnClosedCb cb) {
+  IoUringSocketEntry::close(keep_fd_open, cb);
+  keep_fd_open_ = keep_fd_open;
+
+  if (connect_req_ != nullptr) {
+    cancel_reqs_.push_back(parent_.submitCancelRequest(*this, connect_req_));
+  }
+  if (read_req_ != nullptr) {
+    cancel_reqs_.push_back(parent_.submitCancelRequest(*this, read_req_));
+  }
+
+  if (keep_fd_open) {
+    // Nobody will read the pending data since the fd is handed over to others.
+    write_buf_.drain(write_buf_.length());
+    shutdown_how_.reset();
+    if (write_req_ != nullptr) {
+      cancel_reqs_.push_back(parent_.submitCancelRequest(*this, write_req_));
+    }
+  } else if (write_req_ != nullptr || write_buf_.length() > 0) {
+    // The owner regards the data as written, so flush it to the kernel before closing the fd,
+    // but don't wait forever for a peer which doesn't read.
+    write_timeout_timer_ = parent_.dispatcher().createTimer([this]() {
+      ENVOY_LOG(trace, "write timeout when closing the socket, fd = {}, pending data = {}", fd_,
+                write_buf_.length());
+      write_buf_.drain(write_buf_.length());
+      shutdown_how_.reset();
+      if (write_req_ != nullptr) {
+        cancel_reqs_.push_back(parent_.submitCancelRequest(*this, write_req_));
+      }
+      closeIfDone();
+    });
+    write_timeout_timer_->enableTimer(parent_.writeTimeout());
+  }
+
+  closeIfDone();
+}
+
+void IoUringServerSocket::enableRead() {
+  if (status_ == Closed) {
+    return;
+  }
+  IoUringSocketEntry::enableRead();
+  // Deliver the data which was read before the socket was disabled.
+  if (read_buf_.length() > 0 || read_error_ <= 0) {
+    injectCompletion(Request::RequestType::Read);
+    return;
+  }
+  submitReadRequest();
+}
+
+void IoUringServerSocket::disableRead() {
+  if (status_ == Closed) {
+    return;
+  }
+  // The inflight read request is kept, the data read by it will be delivered once the socket
+  // is enabled again.
+  IoUringSocketEntry::disableRead();
+}
+
+void IoUringServerSocket::connect(const Network::Address::InstanceConstSharedPtr&) {
+  ENVOY_BUG(false, "connect on an accepted io_uring socket");
+}
+
+uint64_t IoUringServerSocket::write(Buffer::Instance& data) {
+  ASSERT(status_ != Closed);
+  const uint64_t bytes_written = std::min(data.length(), writeBufferRoom());
+  write_buf_.move(data, bytes_written);
+  write_blocked_ = data.length() > 0;
+  submitWriteOrShutdownRequest();
+  return bytes_written;
+}
+
+uint64_t IoUringServerSocket::write(const Buffer::RawSlice* slices, uint64_t num_slice) {
+  ASSERT(status_ != Closed);
+  uint64_t bytes_written = 0;
+  write_blocked_ = false;
+  for (uint64_t i = 0; i < num_slice; i++) {
+    const uint64_t length = std::min<uint64_t>(slices[i].len_, writeBufferRoom());
+    write_buf_.add(slices[i].mem_, length);
+    bytes_written += length;
+    if (length < slices[i].len_) {
+      write_blocked_ = true;
+      break;
+    }
+  }
+  submitWriteOrShutdownRequest();
+  return bytes_written;
+}
+
+void IoUringServerSocket::shutdown(int how) {
+  ASSERT(status_ != Closed);
+  // The shutdown request is submitted after all the pending data is written.
+  shutdown_how_ = how;
+  submitWriteOrShutdownRequest();
+}
+
+void IoUringServerSocket::onClose(Request* req, int32_t result, bool injected) {
+  IoUringSocketEntry::onClose(req, result, injected);
+  if (on_closed_cb_) {
+    on_closed_cb_();
+  }
+  cleanup();
+}
+
+void IoUringServerSocket::onRead(Request* req, int32_t result, bool injected) {
+  IoUringSocketEntry::onRead(req, result, injected);
+  if (!injected) {
+    ASSERT(req == read_req_);
+    read_req_ = nullptr;
+    if (result > 0) {
+      // Hand over the buffer of the request to the read buffer without copying the data.
+      ReadRequest* read_req = static_cast<ReadRequest*>(req);
+      Buffer::BufferFragment* fragment = new Buffer::BufferFragmentImpl(
+          read_req->buf_.release(), result,
+          [](const void* data, size_t, const Buffer::BufferFragmentImpl* this_fragment) {
+            delete[] reinterpret_cast<const uint8_t*>(data);
+            delete this_fragment;
+          });
+      read_buf_.addBufferFragment(*fragment);
+    } else if (result != -ECANCELED && result != -EAGAIN) {
+      // The remote closed the connection or an error happened.
+      read_error_ = result;
+    }
+  }
+
+  if (status_ == Closed) {
+    closeIfDone();
+    return;
+  }
+
+  if (status_ == ReadEnabled) {
+    deliverReadEvent(injected);
+  } else if (status_ == ReadDisabled && enable_close_event_ && read_error_ <= 0 && !injected) {
+    cb_(Event::FileReadyType::Closed);
+  }
+
+  submitReadRequest();
+}
+
+void IoUringServerSocket::onWrite(Request* req, int32_t result, bool injected) {
+  IoUringSocketEntry::onWrite(req, result, injected);
+  if (injected) {
+    // The owner activated the Write event.
+    if (status_ != Closed) {
+      cb_(Event::FileReadyType::Write);
+    }
+    return;
+  }
+
+  ASSERT(req == write_req_);
+  write_req_ = nullptr;
+  if (result >= 0) {
+    write_buf_.drain(result);
+    // Let the owner write again once half of the write buffer is free, rather than for every
+    // write request which frees a little room.
+    if (write_blocked_ && write_buf_.length() <= parent_.writeBufferLimit() / 2) {
+      write_blocked_ = false;
+      if (status_ != Closed) {
+        cb_(Event::FileReadyType::Write);
+      }
+    }
+  } else {
+    // The data can't be written anymore.
+    write_buf_.drain(write_buf_.length());
+    shutdown_how_.reset();
+    if (result != -ECANCELED) {
+      ENVOY_LOG(debug, "write request failed, fd = {}, error = {}", fd_, errorDetails(-result));
+      write_param_ = WriteParam{result};
+      if (status_ != Closed) {
+        cb_(Event::FileReadyType::Write);
+      }
+    }
+  }
+
+  submitWriteOrShutdownRequest();
+  closeIfDone();
+}
+
+void IoUringServerSocket::onCancel(Request* req, int32_t result, bool injected) {
+  IoUringSocketEntry::onCancel(req, result, injected);
+  ASSERT(!injected);
+  cancel_reqs_.remove(req);
+  closeIfDone();
+}
+
+void IoUringServerSocket::onShutdown(Request* req, int32_t result, bool injected) {
+  IoUringSocketEntry::onShutdown(req, result, injected);
+  ASSERT(!injected);
+  ASSERT(req == shutdown_req_);
+  shutdown_req_ = nullptr;
+  if (result < 0) {
+    ENVOY_LOG(debug, "shutdown request failed, fd = {}, error = {}", fd_, errorDetails(-result));
+  }
+  submitWriteOrShutdownRequest();
+  closeIfDone();
+}
+
+void IoUringServerSocket::submitReadRequest() {
+  if (read_req_ != nullptr || !readReady() || read_error_ <= 0) {
+    return;
+  }
+  // Keep reading while the socket is disabled only to detect the remote close, and only if
+  // the data read before is consumed.
+  if (status_ == ReadEnabled ||
+      (status_ == ReadDisabled && enable_close_event_ && read_buf_.length() == 0)) {
+    read_req_ = parent_.submitReadRequest(*this);
+  }
+}
+
+void IoUringServerSocket::submitWriteOrShutdownRequest() {
+  if (write_req_ != nullptr || shutdown_req_ != nullptr) {
+    return;
+  }
+
+  if (write_buf_.length() > 0) {
+    Buffer::RawSliceVector slices = write_buf_.getRawSlices(IOV_MAX);
+    write_req_ = parent_.submitWriteRequest(*this, slices);
+    return;
+  }
+
+  if (shutdown_how_.has_value()) {
+    shutdown_req_ = parent_.submitShutdownRequest(*this, shutdown_how_.value());
+    shutdown_how_.reset();
+  }
+}
+
+uint64_t IoUringServerSocket::writeBufferRoom() const {
+  const uint64_t limit = parent_.writeBufferLimit();
+  return write_buf_.length() < limit ? limit - write_buf_.length() : 0;
+}
+
+void IoUringServerSocket::closeIfDone() {
+  if (status_ != Closed || close_submitted_) {
+    return;
+  }
+  if (connect_req_ != nullptr || read_req_ != nullptr || write_req_ != nullptr ||
+      shutdown_req_ != nullptr || !cancel_reqs_.empty() || write_buf_.length() > 0) {
+    return;
+  }
+
+  write_timeout_timer_.reset();
+  if (keep_fd_open_) {
+    if (on_closed_cb_) {
+      on_closed_cb_();
+    }
+    cleanup();
+    return;
+  }
+
+  close_submitted_ = true;
+  parent_.submitCloseRequest(*this);
+}
+
+void IoUringServerSocket::deliverReadEvent(bool force) {
+  if (!force && read_buf_.length() == 0 && read_error_ > 0) {
+    return;
+  }
+
+  cb_(Event::FileReadyType::Read);
+}
+
+OptRef<ReadParam> IoUringServerSocket::getReadParam() {
+  // The data is kept in the read buffer until it is consumed, so the owner may read it at any
+  // time, e.g. the listener filters peek the data outside of the Read event.
+  read_param_.emplace(ReadParam{
+      read_buf_, read_error_ > 0 ? static_cast<int32_t>(read_buf_.length()) : read_error_});
+  return *read_param_;
+}
+
+IoUringClientSocket::IoUringClientSocket(os_fd_t fd, IoUringWorkerImpl& parent,
+                                         Event::FileReadyCb cb)
+    : IoUringServerSocket(fd, parent, std::move(cb)) {}
+
+void IoUringClientSocket::connect(const Network::Address::InstanceConstSharedPtr& address) {
+  ASSERT(connect_req_ == nullptr && !connected_);
+  connect_req_ = parent_.submitConnectRequest(*this, address);
+}
+
+void IoUringClientSocket::onConnect(Request* req, int32_t result, bool injected) {
+  IoUringSocketEntry::onConnect(req, result, injected);
+  ASSERT(!injected);
+  ASSERT(req == connect_req_);
+  connect_req_ = nullptr;
+
+  if (status_ == Closed) {
+    closeIfDone();
+    return;
+  }
+
+  if (result == 0) {
+    connected_ = true;
+  } else {
+    ENVOY_LOG(debug, "connect request failed, fd = {}, error = {}", fd_, errorDetails(-result));
+    write_param_ = WriteParam{result};
+  }
+  // The owner checks the result of the connect in the Write event.
+  cb_(Event::FileReadyType::Write);
+
+  if (status_ != Closed) {
+    submitReadRequest();
+  }
+}
+
 } // namespace Io
 } // namespace Envoy
@@ -2,6 +2,7 @@
 
 #include "envoy/common/io/io_uring.h"
 
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/common/linked_object.h"
 #include "source/common/io/io_uring_impl.h"
 
@@ -11,15 +12,73 @@ namespace Io {
 class IoUringSocketEntry;
 using IoUringSocketEntryPtr = std::unique_ptr<IoUringSocketEntry>;
 
+class AcceptRequest : public Request {
+public:
+  AcceptRequest(IoUringSocket& socket) : Request(RequestType::Accept, socket) {}
+
+  sockaddr_storage remote_addr_{};
+  socklen_t remote_addr_len_{sizeof(remote_addr_)};
+};
+
+class ConnectRequest : public Request {
+public:
+  ConnectRequest(IoUringSocket& socket, const Network::Address::InstanceConstSharedPtr& address)
+      : Request(RequestType::Connect, socket), address_(address) {}
+
+  // Keep the address alive until the kernel has consumed it.
+  Network::Address::InstanceConstSharedPtr address_;
+};
+
+class ReadRequest : public Request {
+public:
+  ReadRequest(IoUringSocket& socket, uint32_t size);
+
+  // The buffer is handed over to the socket's read buffer as a fragment once the request is
+  // done, so the data read by the kernel is never copied.
+  std::unique_ptr<uint8_t[]> buf_;
+  std::unique_ptr<struct iovec> iov_;
+};
+
+class WriteRequest : public Request {
+public:
+  WriteRequest(IoUringSocket& socket, const Buffer::RawSliceVector& slices);
+
+  std::unique_ptr<struct iovec[]> iov_;
+};
+
 class IoUringWorkerImpl : public IoUringWorker, private Logger::Loggable<Logger::Id::io> {
 public:
+  // The default size of the buffer of each read request.
+  static constexpr uint32_t DefaultReadBufferSize = 8192;
+
+  // The default time to wait for the pending data to be written when closing a socket.
+  static constexpr std::chrono::milliseconds DefaultWriteTimeout{1000};
+
+  // The most data buffered by each socket while it is written into the kernel.
+  static constexpr uint64_t DefaultWriteBufferLimit = 64 * 1024;
+
   IoUringWorkerImpl(uint32_t io_uring_size, bool use_submission_queue_polling,
+                    uint32_t read_buffer_size, std::chrono::milliseconds write_timeout,
                     Event::Dispatcher& dispatcher);
-  IoUringWorkerImpl(IoUringPtr&& io_uring, Event::Dispatcher& dispatcher);
+  IoUringWorkerImpl(IoUringPtr&& io_uring, Event::Dispatcher& dispatcher,
+                    uint32_t read_buffer_size = DefaultReadBufferSize,
+                    std::chrono::milliseconds write_timeout = DefaultWriteTimeout,
+                    uint64_t write_buffer_limit = DefaultWriteBufferLimit);
   ~IoUringWorkerImpl() override;
 
   // IoUringWorker
   Event::Dispatcher& dispatcher() override;
+  IoUringSocket& addAcceptSocket(os_fd_t fd, Event::FileReadyCb cb) override;
+  IoUringSocket& addServerSocket(os_fd_t fd, Event::FileReadyCb cb) override;
+  IoUringSocket& addClientSocket(os_fd_t fd, Event::FileReadyCb cb) override;
+  Request* submitAcceptRequest(IoUringSocket& socket) override;
+  Request* submitConnectRequest(IoUringSocket& socket,
+                                const Network::Address::InstanceConstSharedPtr& address) override;
+  Request* submitReadRequest(IoUringSocket& socket) override;
+  Request* submitWriteRequest(IoUringSocket& socket, const Buffer::RawSliceVector& slices) override;
+  Request* submitCloseRequest(IoUringSocket& socket) override;
+  Request* submitCancelRequest(IoUringSocket& socket, Request* request_to_cancel) override;
+  Request* submitShutdownRequest(IoUringSocket& socket, int how) override;
 
   // Remove a socket from this worker.
   IoUringSocketEntryPtr removeSocket(IoUringSocketEntry& socket);
@@ -30,14 +89,29 @@ public:
   // Return the number of sockets in this worker.
   size_t getNumOfSockets() const { return sockets_.size(); }
 
+  // Return the time to wait for the pending data to be written when closing a socket.
+  std::chrono::milliseconds writeTimeout() const { return write_timeout_; }
+
+  // Return the most data buffered by each socket while it is written into the kernel.
+  uint64_t writeBufferLimit() const { return write_buffer_limit_; }
+
 protected:
   // Add a socket to the worker.
   IoUringSocketEntry& addSocket(IoUringSocketEntryPtr&& socket);
   void onFileEvent();
   void submit();
+  // Prepare a request with the given function. If the submission queue is full, the queued
+  // requests are submitted to the kernel first to make room for the new one.
+  template <typename PrepareFn> void prepareRequest(PrepareFn prepare_fn, absl::string_view name);
 
   // The iouring instance.
   IoUringPtr io_uring_;
+  // The size of the buffer of each read request.
+  const uint32_t read_buffer_size_;
+  // The time to wait for the pending data to be written when closing a socket.
+  const std::chrono::milliseconds write_timeout_;
+  // The most data buffered by each socket while it is written into the kernel.
+  const uint64_t write_buffer_limit_;
   // The dispatcher of this worker is running on.
   Event::Dispatcher& dispatcher_;
   // The file event of iouring's eventfd.
@@ -55,7 +129,7 @@ class IoUringSocketEntry : public IoUringSocket,
                            public Event::DeferredDeletable,
                            protected Logger::Loggable<Logger::Id::io> {
 public:
-  IoUringSocketEntry(os_fd_t fd, IoUringWorkerImpl& parent);
+  IoUringSocketEntry(os_fd_t fd, IoUringWorkerImpl& parent, Event::FileReadyCb cb = nullptr);
 
   // IoUringSocket
   IoUringWorker& getIoUringWorker() const override { return parent_; }
@@ -97,6 +171,18 @@ public:
     }
   }
   void injectCompletion(Request::RequestType type) override;
+  void enableRead() override { status_ = ReadEnabled; }
+  void disableRead() override { status_ = ReadDisabled; }
+  void enableCloseEvent(bool enable) override { enable_close_event_ = enable; }
+  void close(bool, IoUringSocketOnClosedCb cb) override {
+    status_ = Closed;
+    on_closed_cb_ = cb;
+  }
+  void setFileReadyCb(Event::FileReadyCb cb) override { cb_ = std::move(cb); }
+  OptRef<ReadParam> getReadParam() override { return absl::nullopt; }
+  OptRef<WriteParam> getWriteParam() override { return absl::nullopt; }
+  OptRef<AcceptedSocketParam> getAcceptedSocketParam() override { return absl::nullopt; }
+  IoUringSocketStatus getStatus() const override { return status_; }
 
 protected:
   /**
@@ -109,6 +195,139 @@ protected:
   // This records already injected completion request type to
   // avoid duplicated injections.
   uint8_t injected_completions_{0};
+  // The file ready callback of the IoHandle which owns this socket.
+  Event::FileReadyCb cb_;
+  IoUringSocketStatus status_{Initialized};
+  bool enable_close_event_{false};
+  // Whether the fd is kept open when the socket is closed.
+  bool keep_fd_open_{false};
+  IoUringSocketOnClosedCb on_closed_cb_;
+};
+
+/**
+ * IoUringSocket for listening sockets. It keeps one accept request inflight while the socket is
+ * enabled and delivers every accepted socket to the owner through a Read event.
+ */
+class IoUringAcceptSocket : public IoUringSocketEntry {
+public:
+  IoUringAcceptSocket(os_fd_t fd, IoUringWorkerImpl& parent, Event::FileReadyCb cb);
+
+  // IoUringSocket
+  void close(bool keep_fd_open, IoUringSocketOnClosedCb cb = nullptr) override;
+  void enableRead() override;
+  void disableRead() override;
+  // A listening socket neither connects nor sends data.
+  void connect(const Network::Address::InstanceConstSharedPtr&) override;
+  uint64_t write(Buffer::Instance&) override;
+  uint64_t write(const Buffer::RawSlice*, uint64_t) override;
+  void shutdown(int) override;
+  void onAccept(Request* req, int32_t result, bool injected) override;
+  void onCancel(Request* req, int32_t result, bool injected) override;
+  void onClose(Request* req, int32_t result, bool injected) override;
+  OptRef<AcceptedSocketParam> getAcceptedSocketParam() override {
+    return makeOptRefFromPtr(accepted_socket_param_.has_value() ? &accepted_socket_param_.value()
+                                                                : nullptr);
+  }
+
+private:
+  struct AcceptedSocket {
+    os_fd_t fd_;
+    sockaddr_storage remote_addr_;
+    socklen_t remote_addr_len_;
+  };
+
+  void deliverAcceptedSockets();
+  void submitAcceptRequest();
+  void closeIfDone();
+
+  Request* accept_req_{nullptr};
+  Request* cancel_req_{nullptr};
+  bool close_submitted_{false};
+  // The sockets which are accepted but not delivered yet, e.g. the socket is disabled.
+  std::list<AcceptedSocket> accepted_sockets_;
+  absl::optional<AcceptedSocketParam> accepted_socket_param_;
+};
+
+/**
+ * IoUringSocket for accepted sockets. Read requests are submitted while the socket is enabled,
+ * and the written data is buffered in the socket until the write request is done.
+ */
+class IoUringServerSocket : public IoUringSocketEntry {
+public:
+  IoUringServerSocket(os_fd_t fd, IoUringWorkerImpl& parent, Event::FileReadyCb cb);
+
+  // IoUringSocket
+  void close(bool keep_fd_open, IoUringSocketOnClosedCb cb = nullptr) override;
+  void enableRead() override;
+  void disableRead() override;
+  // An accepted socket is already connected.
+  void connect(const Network::Address::InstanceConstSharedPtr&) override;
+  uint64_t write(Buffer::Instance& data) override;
+  uint64_t write(const Buffer::RawSlice* slices, uint64_t num_slice) override;
+  void shutdown(int how) override;
+  void onClose(Request* req, int32_t result, bool injected) override;
+  void onRead(Request* req, int32_t result, bool injected) override;
+  void onWrite(Request* req, int32_t result, bool injected) override;
+  void onCancel(Request* req, int32_t result, bool injected) override;
+  void onShutdown(Request* req, int32_t result, bool injected) override;
+  OptRef<ReadParam> getReadParam() override;
+  OptRef<WriteParam> getWriteParam() override {
+    return makeOptRefFromPtr(write_param_.has_value() ? &write_param_.value() : nullptr);
+  }
+
+protected:
+  // Whether the socket is able to submit read requests.
+  virtual bool readReady() const { return true; }
+  void submitReadRequest();
+  void submitWriteOrShutdownRequest();
+  // The room left in the write buffer.
+  uint64_t writeBufferRoom() const;
+  void closeIfDone();
+  // Deliver the Read event to the owner. The event is always delivered if `force` is true,
+  // otherwise it is only delivered when there is data or an error.
+  void deliverReadEvent(bool force);
+
+  // The inflight connect request, it is only submitted by the client socket.
+  Request* connect_req_{nullptr};
+  Request* read_req_{nullptr};
+  Request* write_req_{nullptr};
+  Request* shutdown_req_{nullptr};
+  std::list<Request*> cancel_reqs_;
+  bool close_submitted_{false};
+
+  // The data read from the kernel but not consumed by the owner yet.
+  Buffer::OwnedImpl read_buf_;
+  // The result of the latest read request. A positive value means there is no error.
+  int32_t read_error_{1};
+  absl::optional<ReadParam> read_param_;
+
+  // The data waiting to be written into the kernel.
+  Buffer::OwnedImpl write_buf_;
+  // Whether the owner was left with data to write because the write buffer was full, in which
+  // case it waits for the Write event.
+  bool write_blocked_{false};
+  absl::optional<WriteParam> write_param_;
+  absl::optional<int> shutdown_how_;
+  // Bounds the time the socket waits for the pending data to be written after being closed.
+  Event::TimerPtr write_timeout_timer_;
+};
+
+/**
+ * IoUringSocket for client sockets. The socket behaves as a server socket once it is connected.
+ */
+class IoUringClientSocket : public IoUringServerSocket {
+public:
+  IoUringClientSocket(os_fd_t fd, IoUringWorkerImpl& parent, Event::FileReadyCb cb);
+
+  // IoUringSocket
+  void connect(const Network::Address::InstanceConstSharedPtr& address) override;
+  void onConnect(Request* req, int32_t result, bool injected) override;
+
+protected:
+  bool readReady() const override { return connected_; }
+
+private:
+  bool connected_{false};
 };
 
 } // namespace Io
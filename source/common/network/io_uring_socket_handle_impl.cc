@@ -0,0 +1,354 @@
+#include "source/common/network/io_uring_socket_handle_impl.h"
+
+#include "envoy/buffer/buffer.h"
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/common/assert.h"
+#include "source/common/common/utility.h"
+#include "source/common/network/io_socket_error_impl.h"
+
+namespace Envoy {
+namespace Network {
+
+IoUringSocketHandleImpl::IoUringSocketHandleImpl(Io::IoUringWorkerFactory& io_uring_worker_factory,
+                                                 os_fd_t fd, bool socket_v6only,
+                                                 absl::optional<int> domain, bool is_server_socket)
+    : IoSocketHandleImpl(fd, socket_v6only, domain),
+      io_uring_worker_factory_(io_uring_worker_factory),
+      io_uring_socket_type_(is_server_socket ? IoUringSocketType::Server
+                                             : IoUringSocketType::Unknown) {}
+
+IoUringSocketHandleImpl::~IoUringSocketHandleImpl() {
+  if (SOCKET_VALID(fd_)) {
+    // The listening sockets owned by the main thread may outlive the IoUringWorkers, the fd is
+    // closed directly if the current thread doesn't have an IoUringWorker anymore.
+    if (io_uring_socket_.has_value() && io_uring_worker_factory_.getIoUringWorker().has_value()) {
+      IoUringSocketHandleImpl::close();
+      return;
+    }
+    io_uring_socket_.reset();
+    IoSocketHandleImpl::close();
+  }
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::close() {
+  if (!io_uring_socket_.has_value()) {
+    return IoSocketHandleImpl::close();
+  }
+
+  ENVOY_LOG(trace, "close io_uring socket, fd = {}, type = {}", fd_,
+            static_cast<int>(io_uring_socket_type_));
+  ASSERT(SOCKET_VALID(fd_));
+  // The fd is closed by the io_uring socket once all the inflight requests are done.
+  io_uring_socket_->close(false);
+  io_uring_socket_.reset();
+  SET_SOCKET_INVALID(fd_);
+  return Api::ioCallUint64ResultNoError();
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::readv(uint64_t max_length,
+                                                       Buffer::RawSlice* slices,
+                                                       uint64_t num_slice) {
+  if (!io_uring_socket_.has_value()) {
+    return IoSocketHandleImpl::readv(max_length, slices, num_slice);
+  }
+
+  OptRef<Io::ReadParam> read_param = io_uring_socket_->getReadParam();
+  if (!read_param.has_value()) {
+    return {0, IoSocketError::getIoSocketEagainError()};
+  }
+  if (read_param->buf_.length() == 0) {
+    return readResultWithoutData(*read_param);
+  }
+
+  uint64_t bytes_read = 0;
+  for (uint64_t i = 0; i < num_slice && bytes_read < max_length; i++) {
+    const uint64_t slice_length =
+        std::min({slices[i].len_, max_length - bytes_read, read_param->buf_.length()});
+    if (slice_length == 0) {
+      break;
+    }
+    read_param->buf_.copyOut(0, slice_length, slices[i].mem_);
+    read_param->buf_.drain(slice_length);
+    bytes_read += slice_length;
+  }
+  return {bytes_read, Api::IoError::none()};
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::read(Buffer::Instance& buffer,
+                                                      absl::optional<uint64_t> max_length_opt) {
+  if (!io_uring_socket_.has_value()) {
+    return IoSocketHandleImpl::read(buffer, max_length_opt);
+  }
+
+  const uint64_t max_length = max_length_opt.value_or(UINT64_MAX);
+  if (max_length == 0) {
+    return Api::ioCallUint64ResultNoError();
+  }
+
+  OptRef<Io::ReadParam> read_param = io_uring_socket_->getReadParam();
+  if (!read_param.has_value()) {
+    return {0, IoSocketError::getIoSocketEagainError()};
+  }
+  if (read_param->buf_.length() == 0) {
+    return readResultWithoutData(*read_param);
+  }
+
+  // The data read by the kernel is moved into the buffer without copying.
+  const uint64_t bytes_read = std::min(max_length, read_param->buf_.length());
+  buffer.move(read_param->buf_, bytes_read);
+  return {bytes_read, Api::IoError::none()};
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::writev(const Buffer::RawSlice* slices,
+                                                        uint64_t num_slice) {
+  if (!io_uring_socket_.has_value()) {
+    return IoSocketHandleImpl::writev(slices, num_slice);
+  }
+
+  absl::optional<Api::IoCallUint64Result> error = writeError();
+  if (error.has_value()) {
+    return std::move(error.value());
+  }
+  uint64_t length = 0;
+  for (uint64_t i = 0; i < num_slice; i++) {
+    length += slices[i].len_;
+  }
+  const uint64_t bytes_written = io_uring_socket_->write(slices, num_slice);
+  if (bytes_written == 0 && length > 0) {
+    // The write buffer of the socket is full, the Write event is delivered once it drains.
+    return {0, IoSocketError::getIoSocketEagainError()};
+  }
+  return {bytes_written, Api::IoError::none()};
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::write(Buffer::Instance& buffer) {
+  if (!io_uring_socket_.has_value()) {
+    return IoSocketHandleImpl::write(buffer);
+  }
+
+  absl::optional<Api::IoCallUint64Result> error = writeError();
+  if (error.has_value()) {
+    return std::move(error.value());
+  }
+  const uint64_t length = buffer.length();
+  const uint64_t bytes_written = io_uring_socket_->write(buffer);
+  if (bytes_written == 0 && length > 0) {
+    // The write buffer of the socket is full, the Write event is delivered once it drains.
+    return {0, IoSocketError::getIoSocketEagainError()};
+  }
+  return {bytes_written, Api::IoError::none()};
+}
+
+Api::IoCallUint64Result IoUringSocketHandleImpl::recv(void* buffer, size_t length, int flags) {
+  if (!io_uring_socket_.has_value()) {
+    return IoSocketHandleImpl::recv(buffer, length, flags);
+  }
+
+  // The data has been read from the kernel, e.g. the listener filters peek the data which is
+  // already in the read buffer of the io_uring socket.
+  OptRef<Io::ReadParam> read_param = io_uring_socket_->getReadParam();
+  if (!read_param.has_value()) {
+    return {0, IoSocketError::getIoSocketEagainError()};
+  }
+  if (read_param->buf_.length() == 0) {
+    return readResultWithoutData(*read_param);
+  }
+
+  const uint64_t bytes_read = std::min<uint64_t>(length, read_param->buf_.length());
+  read_param->buf_.copyOut(0, bytes_read, buffer);
+  if (!(flags & MSG_PEEK)) {
+    read_param->buf_.drain(bytes_read);
+  }
+  return {bytes_read, Api::IoError::none()};
+}
+
+Api::SysCallIntResult IoUringSocketHandleImpl::listen(int backlog) {
+  io_uring_socket_type_ = IoUringSocketType::Accept;
+  return IoSocketHandleImpl::listen(backlog);
+}
+
+IoHandlePtr IoUringSocketHandleImpl::accept(struct sockaddr* addr, socklen_t* addrlen) {
+  if (!io_uring_socket_.has_value()) {
+    // The accepted socket may still use io_uring if it is handed over to a worker thread.
+    auto result = Api::OsSysCallsSingleton::get().accept(fd_, addr, addrlen);
+    if (SOCKET_INVALID(result.return_value_)) {
+      return nullptr;
+    }
+    return std::make_unique<IoUringSocketHandleImpl>(
+        io_uring_worker_factory_, result.return_value_, socket_v6only_, domain_, true);
+  }
+
+  OptRef<Io::AcceptedSocketParam> accepted_socket_param =
+      io_uring_socket_->getAcceptedSocketParam();
+  if (!accepted_socket_param.has_value() || !SOCKET_VALID(accepted_socket_param->fd_)) {
+    return nullptr;
+  }
+
+  *addrlen = std::min(*addrlen, accepted_socket_param->remote_addr_len_);
+  memcpy(addr, accepted_socket_param->remote_addr_, *addrlen); // NOLINT(safe-memcpy)
+  const os_fd_t fd = accepted_socket_param->fd_;
+  // The accepted socket is owned by the new handle from now on.
+  SET_SOCKET_INVALID(accepted_socket_param->fd_);
+  return std::make_unique<IoUringSocketHandleImpl>(io_uring_worker_factory_, fd, socket_v6only_,
+                                                   domain_, true);
+}
+
+Api::SysCallIntResult IoUringSocketHandleImpl::connect(Address::InstanceConstSharedPtr address) {
+  if (!io_uring_socket_.has_value()) {
+    connected_without_io_uring_ = true;
+    return IoSocketHandleImpl::connect(address);
+  }
+
+  ASSERT(io_uring_socket_type_ == IoUringSocketType::Client);
+  io_uring_socket_->connect(address);
+  return Api::SysCallIntResult{-1, SOCKET_ERROR_IN_PROGRESS};
+}
+
+Api::SysCallIntResult IoUringSocketHandleImpl::getOption(int level, int optname, void* optval,
+                                                         socklen_t* optlen) {
+  // The result of the connect request is consumed by io_uring instead of being kept as the
+  // pending error of the socket.
+  if (io_uring_socket_.has_value() && io_uring_socket_type_ == IoUringSocketType::Client &&
+      level == SOL_SOCKET && optname == SO_ERROR && *optlen >= sizeof(int)) {
+    OptRef<Io::WriteParam> write_param = io_uring_socket_->getWriteParam();
+    *static_cast<int*>(optval) = write_param.has_value() ? -write_param->result_ : 0;
+    *optlen = sizeof(int);
+    return {0, 0};
+  }
+  return IoSocketHandleImpl::getOption(level, optname, optval, optlen);
+}
+
+void IoUringSocketHandleImpl::initializeFileEvent(Event::Dispatcher& dispatcher,
+                                                  Event::FileReadyCb cb,
+                                                  Event::FileTriggerType trigger,
+                                                  uint32_t events) {
+  if (io_uring_socket_.has_value()) {
+    // The file events were reset but the io_uring socket was kept, e.g. the listener filters
+    // finished and the connection takes over the socket with the data already read.
+    io_uring_socket_->setFileReadyCb(std::move(cb));
+    enableFileEvents(events);
+    return;
+  }
+
+  OptRef<Io::IoUringWorker> worker = io_uring_worker_factory_.getIoUringWorker();
+  if (!worker.has_value() || &worker->dispatcher() != &dispatcher ||
+      connected_without_io_uring_) {
+    IoSocketHandleImpl::initializeFileEvent(dispatcher, cb, trigger, events);
+    return;
+  }
+
+  switch (io_uring_socket_type_) {
+  case IoUringSocketType::Accept:
+    io_uring_socket_ = worker->addAcceptSocket(fd_, std::move(cb));
+    break;
+  case IoUringSocketType::Server:
+    io_uring_socket_ = worker->addServerSocket(fd_, std::move(cb));
+    break;
+  case IoUringSocketType::Unknown:
+  case IoUringSocketType::Client:
+    io_uring_socket_type_ = IoUringSocketType::Client;
+    io_uring_socket_ = worker->addClientSocket(fd_, std::move(cb));
+    break;
+  }
+  enableFileEvents(events);
+}
+
+IoHandlePtr IoUringSocketHandleImpl::duplicate() {
+  auto result = Api::OsSysCallsSingleton::get().duplicate(fd_);
+  RELEASE_ASSERT(result.return_value_ != -1,
+                 fmt::format("duplicate failed for '{}': ({}) {}", fd_, result.errno_,
+                             errorDetails(result.errno_)));
+  auto handle = std::make_unique<IoUringSocketHandleImpl>(
+      io_uring_worker_factory_, result.return_value_, socket_v6only_, domain_,
+      io_uring_socket_type_ == IoUringSocketType::Server);
+  if (io_uring_socket_type_ == IoUringSocketType::Accept) {
+    handle->io_uring_socket_type_ = IoUringSocketType::Accept;
+  }
+  return handle;
+}
+
+void IoUringSocketHandleImpl::activateFileEvents(uint32_t events) {
+  if (!io_uring_socket_.has_value()) {
+    IoSocketHandleImpl::activateFileEvents(events);
+    return;
+  }
+
+  if (events & Event::FileReadyType::Read) {
+    io_uring_socket_->injectCompletion(io_uring_socket_type_ == IoUringSocketType::Accept
+                                           ? Io::Request::RequestType::Accept
+                                           : Io::Request::RequestType::Read);
+  }
+  if (events & Event::FileReadyType::Write) {
+    io_uring_socket_->injectCompletion(Io::Request::RequestType::Write);
+  }
+}
+
+void IoUringSocketHandleImpl::enableFileEvents(uint32_t events) {
+  if (!io_uring_socket_.has_value()) {
+    IoSocketHandleImpl::enableFileEvents(events);
+    return;
+  }
+
+  // The io_uring socket buffers the data until the write request is done, and delivers the Write
+  // event by itself when the full write buffer drains, so only the Read and Closed events need
+  // to be handled.
+  if (events & Event::FileReadyType::Read) {
+    io_uring_socket_->enableRead();
+  } else {
+    io_uring_socket_->disableRead();
+  }
+  io_uring_socket_->enableCloseEvent(events & Event::FileReadyType::Closed);
+}
+
+void IoUringSocketHandleImpl::resetFileEvents() {
+  if (!io_uring_socket_.has_value()) {
+    IoSocketHandleImpl::resetFileEvents();
+    return;
+  }
+
+  if (io_uring_socket_type_ == IoUringSocketType::Accept) {
+    // The listening socket may be still used by other listeners, so only stop accepting.
+    io_uring_socket_->close(true);
+    io_uring_socket_.reset();
+    return;
+  }
+
+  // Keep the io_uring socket and the data it has read for the next owner of the file events.
+  io_uring_socket_->disableRead();
+  io_uring_socket_->enableCloseEvent(false);
+  io_uring_socket_->setFileReadyCb([](uint32_t) {});
+}
+
+Api::SysCallIntResult IoUringSocketHandleImpl::shutdown(int how) {
+  if (!io_uring_socket_.has_value()) {
+    return IoSocketHandleImpl::shutdown(how);
+  }
+
+  // The shutdown is submitted after the pending data is written.
+  io_uring_socket_->shutdown(how);
+  return Api::SysCallIntResult{0, 0};
+}
+
+Api::IoCallUint64Result
+IoUringSocketHandleImpl::readResultWithoutData(const Io::ReadParam& read_param) const {
+  if (read_param.result_ == 0) {
+    // The remote closed the connection.
+    return Api::ioCallUint64ResultNoError();
+  }
+  if (read_param.result_ < 0) {
+    return {0, IoSocketError::create(-read_param.result_)};
+  }
+  return {0, IoSocketError::getIoSocketEagainError()};
+}
+
+absl::optional<Api::IoCallUint64Result> IoUringSocketHandleImpl::writeError() {
+  OptRef<Io::WriteParam> write_param = io_uring_socket_->getWriteParam();
+  if (!write_param.has_value()) {
+    return absl::nullopt;
+  }
+  return Api::IoCallUint64Result(0, IoSocketError::create(-write_param->result_));
+}
+
+} // namespace Network
+} // namespace Envoy
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "envoy/common/io/io_uring.h"
+
+#include "source/common/network/io_socket_handle_impl.h"
+
+namespace Envoy {
+namespace Network {
+
+/**
+ * The type of the socket handled by io_uring. It is decided by the first operation issued on the
+ * socket, e.g. listen() makes it an accept socket and connect() makes it a client socket.
+ */
+enum class IoUringSocketType {
+  Unknown,
+  Accept,
+  Server,
+  Client,
+};
+
+/**
+ * IoHandle derivative for TCP sockets which submits accept, connect, read, write, shutdown and
+ * close to the io_uring of the current thread's IoUringWorker. The file events are emulated by the
+ * completions of the requests. On threads without an IoUringWorker, e.g. before the workers are
+ * initialized, it behaves as IoSocketHandleImpl.
+ */
+class IoUringSocketHandleImpl : public IoSocketHandleImpl {
+public:
+  IoUringSocketHandleImpl(Io::IoUringWorkerFactory& io_uring_worker_factory,
+                          os_fd_t fd = INVALID_SOCKET, bool socket_v6only = false,
+                          absl::optional<int> domain = absl::nullopt,
+                          bool is_server_socket = false);
+  ~IoUringSocketHandleImpl() override;
+
+  Api::IoCallUint64Result close() override;
+  Api::IoCallUint64Result readv(uint64_t max_length, Buffer::RawSlice* slices,
+                                uint64_t num_slice) override;
+  Api::IoCallUint64Result read(Buffer::Instance& buffer,
+                               absl::optional<uint64_t> max_length) override;
+  Api::IoCallUint64Result writev(const Buffer::RawSlice* slices, uint64_t num_slice) override;
+  Api::IoCallUint64Result write(Buffer::Instance& buffer) override;
+  Api::IoCallUint64Result recv(void* buffer, size_t length, int flags) override;
+  Api::SysCallIntResult listen(int backlog) override;
+  IoHandlePtr accept(struct sockaddr* addr, socklen_t* addrlen) override;
+  Api::SysCallIntResult connect(Address::InstanceConstSharedPtr address) override;
+  Api::SysCallIntResult getOption(int level, int optname, void* optval, socklen_t* optlen) override;
+  void initializeFileEvent(Event::Dispatcher& dispatcher, Event::FileReadyCb cb,
+                           Event::FileTriggerType trigger, uint32_t events) override;
+  IoHandlePtr duplicate() override;
+  void activateFileEvents(uint32_t events) override;
+  void enableFileEvents(uint32_t events) override;
+  void resetFileEvents() override;
+  Api::SysCallIntResult shutdown(int how) override;
+
+private:
+  // Returns the error of the latest read if the read buffer of the io_uring socket is drained.
+  Api::IoCallUint64Result readResultWithoutData(const Io::ReadParam& read_param) const;
+  // Returns the error of the latest failed write or connect, if any.
+  absl::optional<Api::IoCallUint64Result> writeError();
+
+  Io::IoUringWorkerFactory& io_uring_worker_factory_;
+  IoUringSocketType io_uring_socket_type_;
+  OptRef<Io::IoUringSocket> io_uring_socket_;
+  // Set if connect() is issued as a syscall, the socket is then handled as a regular socket.
+  bool connected_without_io_uring_{false};
+};
+
+} // namespace Network
+} // namespace Envoy
@@ -9,10 +9,29 @@
 #include "source/common/network/address_impl.h"
 #include "source/common/network/io_socket_handle_impl.h"
 #include "source/common/network/win32_socket_handle_impl.h"
+#include "source/common/protobuf/utility.h"
+
+#if defined(__linux__) && !defined(__ANDROID_API__)
+#include "source/common/io/io_uring_impl.h"
+#include "source/common/io/io_uring_worker_factory_impl.h"
+#include "source/common/network/io_uring_socket_handle_impl.h"
+#endif
 
 namespace Envoy {
 namespace Network {
 
+namespace {
+constexpr uint32_t DefaultIoUringSize = 1000;
+constexpr uint32_t DefaultIoUringReadBufferSize = 8192;
+constexpr uint32_t DefaultIoUringWriteTimeoutMs = 1000;
+} // namespace
+
+void DefaultSocketInterfaceExtension::onServerInitialized() {
+  if (io_uring_worker_factory_ != nullptr) {
+    io_uring_worker_factory_->onWorkerThreadInitialized();
+  }
+}
+
 IoHandlePtr SocketInterfaceImpl::makePlatformSpecificSocket(int socket_fd, bool socket_v6only,
                                                             absl::optional<int> domain) {
   if constexpr (Event::PlatformDefaultTriggerType == Event::FileTriggerType::EmulatedEdge) {
@@ -70,7 +89,21 @@ IoHandlePtr SocketInterfaceImpl::socket(Socket::Type socket_type, Address::Type
       Api::OsSysCallsSingleton::get().socket(domain, flags, protocol);
   RELEASE_ASSERT(SOCKET_VALID(result.return_value_),
                  fmt::format("socket(2) failed, got error: {}", errorDetails(result.errno_)));
-  IoHandlePtr io_handle = makeSocket(result.return_value_, socket_v6only, domain);
+  IoHandlePtr io_handle;
+#if defined(__linux__) && !defined(__ANDROID_API__)
+  // Only the TCP sockets are handled by io_uring.
+  if (socket_type == Socket::Type::Stream) {
+    std::shared_ptr<Io::IoUringWorkerFactory> io_uring_worker_factory =
+        io_uring_worker_factory_.lock();
+    if (io_uring_worker_factory != nullptr) {
+      io_handle = std::make_unique<IoUringSocketHandleImpl>(
+          *io_uring_worker_factory, result.return_value_, socket_v6only, domain);
+    }
+  }
+#endif
+  if (io_handle == nullptr) {
+    io_handle = makeSocket(result.return_value_, socket_v6only, domain);
+  }
 
 #if defined(__APPLE__) || defined(WIN32)
   // Cannot set SOCK_NONBLOCK as a ::socket flag.
@@ -116,9 +149,35 @@ bool SocketInterfaceImpl::ipFamilySupported(int domain) {
 }
 
 Server::BootstrapExtensionPtr
-SocketInterfaceImpl::createBootstrapExtension(const Protobuf::Message&,
-                                              Server::Configuration::ServerFactoryContext&) {
-  return std::make_unique<SocketInterfaceExtension>(*this);
+SocketInterfaceImpl::createBootstrapExtension(const Protobuf::Message& message,
+                                              Server::Configuration::ServerFactoryContext& context) {
+  std::shared_ptr<Io::IoUringWorkerFactory> io_uring_worker_factory;
+#if defined(__linux__) && !defined(__ANDROID_API__)
+  const auto& config = MessageUtil::downcastAndValidate<
+      const envoy::extensions::network::socket_interface::v3::DefaultSocketInterface&>(
+      message, context.messageValidationVisitor());
+  if (config.has_io_uring_options()) {
+    if (Io::isIoUringSupported()) {
+      const auto& options = config.io_uring_options();
+      io_uring_worker_factory = std::make_shared<Io::IoUringWorkerFactoryImpl>(
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(options, io_uring_size, DefaultIoUringSize),
+          options.enable_submission_queue_polling(),
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(options, read_buffer_size, DefaultIoUringReadBufferSize),
+          std::chrono::milliseconds(PROTOBUF_GET_WRAPPED_OR_DEFAULT(options, write_timeout_ms,
+                                                                    DefaultIoUringWriteTimeoutMs)),
+          context.threadLocal());
+      io_uring_worker_factory_ = io_uring_worker_factory;
+    } else {
+      ENVOY_LOG_MISC(warn, "io_uring is not supported by the kernel, falling back to the default "
+                           "socket API.");
+    }
+  }
+#else
+  UNREFERENCED_PARAMETER(message);
+  UNREFERENCED_PARAMETER(context);
+#endif
+  return std::make_unique<DefaultSocketInterfaceExtension>(*this,
+                                                           std::move(io_uring_worker_factory));
 }
 
 ProtobufTypes::MessagePtr SocketInterfaceImpl::createEmptyConfigProto() {
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "envoy/common/io/io_uring.h"
 #include "envoy/network/socket.h"
 
 #include "source/common/network/socket_interface.h"
@@ -7,6 +8,22 @@
 namespace Envoy {
 namespace Network {
 
+// Bootstrap extension of the default socket interface which initializes the IoUringWorkers
+// once the server is initialized.
+class DefaultSocketInterfaceExtension : public SocketInterfaceExtension {
+public:
+  DefaultSocketInterfaceExtension(SocketInterface& sock_interface,
+                                  std::shared_ptr<Io::IoUringWorkerFactory> io_uring_worker_factory)
+      : SocketInterfaceExtension(sock_interface),
+        io_uring_worker_factory_(std::move(io_uring_worker_factory)) {}
+
+  // Server::BootstrapExtension
+  void onServerInitialized() override;
+
+private:
+  std::shared_ptr<Io::IoUringWorkerFactory> io_uring_worker_factory_;
+};
+
 class SocketInterfaceImpl : public SocketInterfaceBase {
 public:
   // SocketInterface
@@ -32,6 +49,10 @@ public:
 protected:
   virtual IoHandlePtr makeSocket(int socket_fd, bool socket_v6only,
                                  absl::optional<int> domain) const;
+
+private:
+  // The factory is owned by the bootstrap extension, which outlives all the sockets.
+  std::weak_ptr<Io::IoUringWorkerFactory> io_uring_worker_factory_;
 };
 
 DECLARE_FACTORY(SocketInterfaceImpl);
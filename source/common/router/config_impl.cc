@@ -1802,7 +1802,64 @@ VirtualHostImpl::VirtualHostImpl(
                                                   optional_http_filters, factory_context, validator,
                                                   validation_clusters));
     }
+    if (virtual_host.index_routes()) {
+      buildRouteIndex(virtual_host);
+    }
+  }
+}
+
+void VirtualHostImpl::buildRouteIndex(const envoy::config::route::v3::VirtualHost& virtual_host) {
+  route_index_ = std::make_unique<RouteIndex>();
+  for (const auto& route : virtual_host.routes()) {
+    const auto& match = route.match();
+    const bool case_sensitive = PROTOBUF_GET_WRAPPED_OR_DEFAULT(match, case_sensitive, true);
+    switch (match.path_specifier_case()) {
+    case envoy::config::route::v3::RouteMatch::PathSpecifierCase::kPrefix:
+      route_index_->addPrefix(match.prefix(), case_sensitive);
+      break;
+    case envoy::config::route::v3::RouteMatch::PathSpecifierCase::kPath:
+      route_index_->addExact(match.path(), case_sensitive);
+      break;
+    case envoy::config::route::v3::RouteMatch::PathSpecifierCase::kSafeRegex:
+      route_index_->addRegex(match.safe_regex().regex());
+      break;
+    case envoy::config::route::v3::RouteMatch::PathSpecifierCase::kPathSeparatedPrefix:
+      // The separator following the prefix is checked when matching the candidate.
+      route_index_->addPrefix(match.path_separated_prefix(), case_sensitive);
+      break;
+    default:
+      route_index_->addUnindexed();
+      break;
+    }
+  }
+  route_index_->finalize();
+  ASSERT(route_index_->size() == routes_.size());
+}
+
+RouteConstSharedPtr VirtualHostImpl::getRouteFromIndex(const Http::RequestHeaderMap& headers,
+                                                       const StreamInfo::StreamInfo& stream_info,
+                                                       uint64_t random_value) const {
+  // The path is sanitized as in RouteEntryImplBase::sanitizePathBeforePathMatching().
+  absl::string_view path = headers.getPathValue();
+  if (shared_virtual_host_->globalRouteConfig().ignorePathParametersInPathMatching()) {
+    const size_t pos = path.find_first_of(';');
+    if (pos != absl::string_view::npos) {
+      path.remove_suffix(path.length() - pos);
+    }
+  }
+  path = Http::PathUtil::removeQueryAndFragment(path);
+
+  RouteIndex::Candidates candidates;
+  route_index_->candidates(path, candidates);
+  for (const uint32_t index : candidates) {
+    RouteConstSharedPtr route_entry = routes_[index]->matches(headers, stream_info, random_value);
+    if (route_entry != nullptr) {
+      return route_entry;
+    }
   }
+
+  ENVOY_LOG(debug, "route was resolved but final route list did not match incoming request");
+  return nullptr;
 }
 
 const std::shared_ptr<const SslRedirectRoute> VirtualHostImpl::SSL_REDIRECT_ROUTE{
@@ -1893,6 +1950,12 @@ RouteConstSharedPtr VirtualHostImpl::getRouteFromEntries(const RouteCallback& cb
     return nullptr;
   }
 
+  // The route callback may continue with the routes following a match, so it always walks the
+  // whole list. Pathless requests can only match the routes supporting them.
+  if (route_index_ != nullptr && cb == nullptr && headers.Path() != nullptr) {
+    return getRouteFromIndex(headers, stream_info, random_value);
+  }
+
   // Check for a route that matches the request.
   return getRouteFromRoutes(cb, headers, stream_info, random_value, routes_);
 }
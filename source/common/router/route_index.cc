@@ -0,0 +1,150 @@
+#include "source/common/router/route_index.h"
+
+#include <algorithm>
+
+#include "source/common/common/assert.h"
+
+#include "absl/strings/ascii.h"
+
+namespace Envoy {
+namespace Router {
+
+void RouteIndex::Trie::add(absl::string_view prefix, uint32_t route) {
+  uint32_t node = 0;
+  for (const char c : prefix) {
+    auto& children = nodes_[node].children_;
+    auto iter = std::lower_bound(
+        children.begin(), children.end(), c,
+        [](const std::pair<char, uint32_t>& child, char value) { return child.first < value; });
+    if (iter != children.end() && iter->first == c) {
+      node = iter->second;
+      continue;
+    }
+    const uint32_t child = nodes_.size();
+    children.insert(iter, {c, child});
+    // The insertion may reallocate the nodes, so the reference to the children is not used after.
+    nodes_.emplace_back();
+    node = child;
+  }
+  nodes_[node].routes_.push_back(route);
+}
+
+void RouteIndex::Trie::match(absl::string_view path, bool lower_case,
+                             Candidates& candidates) const {
+  uint32_t node = 0;
+  candidates.insert(candidates.end(), nodes_[0].routes_.begin(), nodes_[0].routes_.end());
+  for (char c : path) {
+    if (lower_case) {
+      c = absl::ascii_tolower(c);
+    }
+    const auto& children = nodes_[node].children_;
+    auto iter = std::lower_bound(
+        children.begin(), children.end(), c,
+        [](const std::pair<char, uint32_t>& child, char value) { return child.first < value; });
+    if (iter == children.end() || iter->first != c) {
+      return;
+    }
+    node = iter->second;
+    candidates.insert(candidates.end(), nodes_[node].routes_.begin(), nodes_[node].routes_.end());
+  }
+}
+
+void RouteIndex::addPrefix(absl::string_view prefix, bool case_sensitive) {
+  ASSERT(!finalized_);
+  if (case_sensitive) {
+    prefixes_.add(prefix, nextRoute());
+  } else {
+    prefixes_ignore_case_.add(absl::AsciiStrToLower(prefix), nextRoute());
+  }
+}
+
+void RouteIndex::addExact(absl::string_view path, bool case_sensitive) {
+  ASSERT(!finalized_);
+  if (case_sensitive) {
+    exact_paths_[std::string(path)].push_back(nextRoute());
+  } else {
+    exact_paths_ignore_case_[absl::AsciiStrToLower(path)].push_back(nextRoute());
+  }
+}
+
+void RouteIndex::addRegex(const std::string& regex) {
+  ASSERT(!finalized_);
+  if (regex_set_ == nullptr) {
+    re2::RE2::Options options;
+    options.set_log_errors(false);
+    regex_set_ = std::make_unique<re2::RE2::Set>(options, re2::RE2::ANCHOR_BOTH);
+  }
+  const uint32_t route = nextRoute();
+  std::string error;
+  if (regex_set_->Add(regex, &error) < 0) {
+    ENVOY_LOG(debug, "regex '{}' is not indexed: {}", regex, error);
+    unindexed_.push_back(route);
+    return;
+  }
+  regex_routes_.push_back(route);
+}
+
+void RouteIndex::addUnindexed() {
+  ASSERT(!finalized_);
+  unindexed_.push_back(nextRoute());
+}
+
+void RouteIndex::finalize() {
+  ASSERT(!finalized_);
+  finalized_ = true;
+  if (regex_set_ == nullptr) {
+    return;
+  }
+  if (regex_routes_.empty() || !regex_set_->Compile()) {
+    // E.g. the combined program is too large, the regex routes are then always evaluated.
+    if (!regex_routes_.empty()) {
+      ENVOY_LOG(debug, "failed to compile the regex set of {} routes", regex_routes_.size());
+    }
+    unindexed_.insert(unindexed_.end(), regex_routes_.begin(), regex_routes_.end());
+    std::sort(unindexed_.begin(), unindexed_.end());
+    regex_routes_.clear();
+    regex_set_.reset();
+  }
+}
+
+void RouteIndex::candidates(absl::string_view path, Candidates& candidates) const {
+  ASSERT(finalized_);
+  candidates.assign(unindexed_.begin(), unindexed_.end());
+
+  prefixes_.match(path, false, candidates);
+  if (!prefixes_ignore_case_.empty()) {
+    prefixes_ignore_case_.match(path, true, candidates);
+  }
+
+  if (!exact_paths_.empty()) {
+    auto iter = exact_paths_.find(path);
+    if (iter != exact_paths_.end()) {
+      candidates.insert(candidates.end(), iter->second.begin(), iter->second.end());
+    }
+  }
+  if (!exact_paths_ignore_case_.empty()) {
+    auto iter = exact_paths_ignore_case_.find(absl::AsciiStrToLower(path));
+    if (iter != exact_paths_ignore_case_.end()) {
+      candidates.insert(candidates.end(), iter->second.begin(), iter->second.end());
+    }
+  }
+
+  if (regex_set_ != nullptr) {
+    std::vector<int> matched;
+    re2::RE2::Set::ErrorInfo error_info;
+    if (regex_set_->Match(path, &matched, &error_info)) {
+      for (const int pattern : matched) {
+        candidates.push_back(regex_routes_[pattern]);
+      }
+    } else if (error_info.kind != re2::RE2::Set::kNoError) {
+      // E.g. the DFA ran out of memory, every regex route is then evaluated.
+      candidates.insert(candidates.end(), regex_routes_.begin(), regex_routes_.end());
+    }
+  }
+
+  // Every route is reported at most once, since it has a single path matcher.
+  std::sort(candidates.begin(), candidates.end());
+}
+
+} // namespace Router
+} // namespace Envoy
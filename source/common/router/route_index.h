@@ -0,0 +1,88 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "source/common/common/logger.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/inlined_vector.h"
+#include "absl/strings/string_view.h"
+#include "re2/set.h"
+
+namespace Envoy {
+namespace Router {
+
+/**
+ * Index over the path matchers of an ordered list of routes, used to find the routes which may
+ * match a path without evaluating every route. Prefix routes are kept in a trie, exact path routes
+ * in a hash map and regex routes in a single RE2::Set. Routes with other path matchers are always
+ * reported as candidates.
+ *
+ * The index only narrows down the routes by path: the candidates still have to be matched in order
+ * to preserve the first-match-wins semantics, and to evaluate the other match criteria.
+ */
+class RouteIndex : Logger::Loggable<Logger::Id::router> {
+public:
+  using Candidates = absl::InlinedVector<uint32_t, 16>;
+
+  // The routes are added in order, the first added route has the index 0.
+  void addPrefix(absl::string_view prefix, bool case_sensitive);
+  void addExact(absl::string_view path, bool case_sensitive);
+  void addRegex(const std::string& regex);
+  void addUnindexed();
+
+  /**
+   * Compiles the index, no route can be added afterwards.
+   */
+  void finalize();
+
+  /**
+   * @param path supplies the path to match, without the query and the fragment.
+   * @param candidates receives, in ascending order, the indices of the routes whose path matcher
+   *        may match the path.
+   */
+  void candidates(absl::string_view path, Candidates& candidates) const;
+
+  uint32_t size() const { return num_routes_; }
+
+private:
+  struct TrieNode {
+    // Sorted by the character.
+    std::vector<std::pair<char, uint32_t>> children_;
+    std::vector<uint32_t> routes_;
+  };
+
+  class Trie {
+  public:
+    Trie() : nodes_(1) {}
+    void add(absl::string_view prefix, uint32_t route);
+    // Adds the routes of all the prefixes of the path. If lower_case is set, the path is lower
+    // cased while walking the trie.
+    void match(absl::string_view path, bool lower_case, Candidates& candidates) const;
+    bool empty() const { return nodes_.size() == 1 && nodes_[0].routes_.empty(); }
+
+  private:
+    std::vector<TrieNode> nodes_;
+  };
+
+  uint32_t nextRoute() { return num_routes_++; }
+
+  uint32_t num_routes_{0};
+  Trie prefixes_;
+  Trie prefixes_ignore_case_;
+  absl::flat_hash_map<std::string, std::vector<uint32_t>> exact_paths_;
+  // Keys are lower cased.
+  absl::flat_hash_map<std::string, std::vector<uint32_t>> exact_paths_ignore_case_;
+  std::unique_ptr<re2::RE2::Set> regex_set_;
+  // The index of the route of each pattern of the regex set.
+  std::vector<uint32_t> regex_routes_;
+  std::vector<uint32_t> unindexed_;
+  bool finalized_{false};
+};
+
+using RouteIndexPtr = std::unique_ptr<RouteIndex>;
+
+} // namespace Router
+} // namespace Envoy
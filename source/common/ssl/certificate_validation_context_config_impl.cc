@@ -42,6 +42,9 @@ CertificateValidationContextConfigImpl::CertificateValidationContextConfigImpl(
       api_(api), only_verify_leaf_cert_crl_(config.only_verify_leaf_cert_crl()),
       max_verify_depth_(config.has_max_verify_depth()
                             ? absl::optional<uint32_t>(config.max_verify_depth().value())
+                            : absl::nullopt),
+      async_validation_(config.has_async_validation()
+                            ? absl::make_optional(config.async_validation())
                             : absl::nullopt) {}
 
 absl::StatusOr<std::unique_ptr<CertificateValidationContextConfigImpl>>
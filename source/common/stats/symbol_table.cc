@@ -261,7 +261,7 @@ bool StatName::startsWith(StatName prefix) const {
 
 std::vector<absl::string_view> SymbolTable::decodeStrings(StatName stat_name) const {
   std::vector<absl::string_view> strings;
-  Thread::LockGuard lock(lock_);
+  absl::ReaderMutexLock lock(&lock_);
   Encoding::decodeTokens(
       stat_name,
       [this, &strings](Symbol symbol)
@@ -311,18 +311,33 @@ void SymbolTable::addTokensToEncoding(const absl::string_view name, Encoding& en
   const std::vector<absl::string_view> tokens = absl::StrSplit(name, '.');
   std::vector<Symbol> symbols;
   symbols.reserve(tokens.size());
+  recordLookup(name);
 
-  // Now take the lock and populate the Symbol objects, which involves bumping
-  // ref-counts in this.
+  // Most names only have tokens which are already in the table, whose
+  // ref-counts are bumped with the lock held shared. The symbols acquired
+  // here can't be freed while the lock is released below, since their
+  // ref-counts were bumped.
   {
-    Thread::LockGuard lock(lock_);
-    recent_lookups_.lookup(name);
+    absl::ReaderMutexLock lock(&lock_);
     for (auto& token : tokens) {
+      auto encode_find = encode_map_.find(token);
+      if (encode_find == encode_map_.end()) {
+        break;
+      }
+      ++encode_find->second.ref_count_;
+      symbols.push_back(encode_find->second.symbol_);
+    }
+  }
+
+  // Now take the lock exclusively to populate the remaining Symbol objects.
+  if (symbols.size() < tokens.size()) {
+    absl::MutexLock lock(&lock_);
+    for (size_t i = symbols.size(); i < tokens.size(); ++i) {
       // TODO(jmarantz): consider using StatNameDynamicStorage for tokens with
       // length below some threshold, say 4 bytes. It might be preferable not to
       // reserve Symbols for every 3 digit number found (for example) in ipv4
       // addresses.
-      symbols.push_back(toSymbol(token));
+      symbols.push_back(toSymbol(tokens[i]));
     }
   }
 
@@ -330,8 +345,33 @@ void SymbolTable::addTokensToEncoding(const absl::string_view name, Encoding& en
   encoding.addSymbols(symbols);
 }
 
+void SymbolTable::recordLookup(absl::string_view name) {
+  if (!record_lookups_) {
+    unrecorded_lookups_[lookupCounterIndex()].count_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  Thread::LockGuard lock(recent_lookups_lock_);
+  recent_lookups_.lookup(name);
+}
+
+size_t SymbolTable::lookupCounterIndex() {
+  // The threads are assigned counters round-robin on their first lookup.
+  static std::atomic<size_t> next_index{0};
+  thread_local const size_t index =
+      next_index.fetch_add(1, std::memory_order_relaxed) % NumLookupCounters;
+  return index;
+}
+
+uint64_t SymbolTable::unrecordedLookups() const {
+  uint64_t total = 0;
+  for (const LookupCounter& counter : unrecorded_lookups_) {
+    total += counter.count_.load(std::memory_order_relaxed);
+  }
+  return total;
+}
+
 uint64_t SymbolTable::numSymbols() const {
-  Thread::LockGuard lock(lock_);
+  absl::ReaderMutexLock lock(&lock_);
   ASSERT(encode_map_.size() == decode_map_.size());
   return encode_map_.size();
 }
@@ -344,7 +384,7 @@ void SymbolTable::incRefCount(const StatName& stat_name) {
   // Before taking the lock, decode the array of symbols from the SymbolTable::Storage.
   const SymbolVec symbols = Encoding::decodeSymbols(stat_name);
 
-  Thread::LockGuard lock(lock_);
+  absl::ReaderMutexLock lock(&lock_);
   for (Symbol symbol : symbols) {
     auto decode_search = decode_map_.find(symbol);
 
@@ -366,21 +406,42 @@ void SymbolTable::free(const StatName& stat_name) {
   // Before taking the lock, decode the array of symbols from the SymbolTable::Storage.
   const SymbolVec symbols = Encoding::decodeSymbols(stat_name);
 
-  Thread::LockGuard lock(lock_);
-  for (Symbol symbol : symbols) {
-    auto decode_search = decode_map_.find(symbol);
-    ASSERT(decode_search != decode_map_.end());
+  SymbolVec unused_symbols;
+  {
+    absl::ReaderMutexLock lock(&lock_);
+    for (Symbol symbol : symbols) {
+      auto decode_search = decode_map_.find(symbol);
+      ASSERT(decode_search != decode_map_.end());
+
+      auto encode_search = encode_map_.find(decode_search->second->toStringView());
+      ASSERT(encode_search != encode_map_.end());
+
+      // The "if (--EXPR.ref_count_)" pattern speeds up BM_CreateRace by 20% in
+      // symbol_table_speed_test.cc, relative to breaking out the decrement into a
+      // separate step, likely due to the non-trivial dereferences in EXPR.
+      if (--encode_search->second.ref_count_ == 0) {
+        unused_symbols.push_back(symbol);
+      }
+    }
+  }
+  if (unused_symbols.empty()) {
+    return;
+  }
 
+  // Erase the mappings of the symbols which are still unused once the lock is
+  // held exclusively, and add them to the reuse pool. A symbol may have been
+  // re-acquired by an encode() in the meantime, or even erased and re-used for
+  // another token by a concurrent free() and encode(), in which case its
+  // current mapping is left alone unless its ref-count is zero as well.
+  absl::MutexLock lock(&lock_);
+  for (Symbol symbol : unused_symbols) {
+    auto decode_search = decode_map_.find(symbol);
+    if (decode_search == decode_map_.end()) {
+      continue;
+    }
     auto encode_search = encode_map_.find(decode_search->second->toStringView());
     ASSERT(encode_search != encode_map_.end());
-
-    // If that was the last remaining client usage of the symbol, erase the
-    // current mappings and add the now-unused symbol to the reuse pool.
-    //
-    // The "if (--EXPR.ref_count_)" pattern speeds up BM_CreateRace by 20% in
-    // symbol_table_speed_test.cc, relative to breaking out the decrement into a
-    // separate step, likely due to the non-trivial dereferences in EXPR.
-    if (--encode_search->second.ref_count_ == 0) {
+    if (encode_search->second.ref_count_ == 0) {
       decode_map_.erase(decode_search);
       encode_map_.erase(encode_search);
       pool_.push(symbol);
@@ -395,11 +456,11 @@ uint64_t SymbolTable::getRecentLookups(const RecentLookupsFn& iter) const {
   // We don't want to hold lock_ while calling the iterator, but we need it to
   // access recent_lookups_, so we buffer in name_count_map.
   {
-    Thread::LockGuard lock(lock_);
+    Thread::LockGuard lock(recent_lookups_lock_);
     recent_lookups_.forEach(
         [&name_count_map](absl::string_view str, uint64_t count)
             ABSL_NO_THREAD_SAFETY_ANALYSIS { name_count_map[std::string(str)] += count; });
-    total += recent_lookups_.total();
+    total += recent_lookups_.total() + unrecordedLookups();
   }
 
   // Now we have the collated name-count map data: we need to vectorize and
@@ -445,17 +506,21 @@ DynamicSpans SymbolTable::getDynamicSpans(StatName stat_name) const {
 }
 
 void SymbolTable::setRecentLookupCapacity(uint64_t capacity) {
-  Thread::LockGuard lock(lock_);
+  Thread::LockGuard lock(recent_lookups_lock_);
   recent_lookups_.setCapacity(capacity);
+  record_lookups_ = capacity > 0;
 }
 
 void SymbolTable::clearRecentLookups() {
-  Thread::LockGuard lock(lock_);
+  Thread::LockGuard lock(recent_lookups_lock_);
   recent_lookups_.clear();
+  for (LookupCounter& counter : unrecorded_lookups_) {
+    counter.count_.store(0, std::memory_order_relaxed);
+  }
 }
 
 uint64_t SymbolTable::recentLookupCapacity() const {
-  Thread::LockGuard lock(lock_);
+  Thread::LockGuard lock(recent_lookups_lock_);
   return recent_lookups_.capacity();
 }
 
@@ -492,7 +557,7 @@ Symbol SymbolTable::toSymbol(absl::string_view sv) {
 }
 
 absl::string_view SymbolTable::fromSymbol(const Symbol symbol) const
-    ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
+    ABSL_SHARED_LOCKS_REQUIRED(lock_) {
   auto search = decode_map_.find(symbol);
   RELEASE_ASSERT(search != decode_map_.end(), "no such symbol");
   return search->second->toStringView();
@@ -513,12 +578,12 @@ bool SymbolTable::lessThan(const StatName& a, const StatName& b) const {
   // Proactively take the table lock in anticipation that we'll need to
   // convert at least one symbol to a string_view, and it's easier not to
   // bother to lazily take the lock.
-  Thread::LockGuard lock(lock_);
+  absl::ReaderMutexLock lock(&lock_);
   return lessThanLockHeld(a, b);
 }
 
 bool SymbolTable::lessThanLockHeld(const StatName& a, const StatName& b) const
-    ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_) {
+    ABSL_SHARED_LOCKS_REQUIRED(lock_) {
   Encoding::TokenIter a_iter(a), b_iter(b);
   while (true) {
     Encoding::TokenIter::TokenType a_type = a_iter.next();
@@ -548,7 +613,7 @@ bool SymbolTable::lessThanLockHeld(const StatName& a, const StatName& b) const
 
 #ifndef ENVOY_CONFIG_COVERAGE
 void SymbolTable::debugPrint() const {
-  Thread::LockGuard lock(lock_);
+  absl::ReaderMutexLock lock(&lock_);
   std::vector<Symbol> symbols;
   for (const auto& p : decode_map_) {
     symbols.push_back(p.first);
@@ -557,7 +622,8 @@ void SymbolTable::debugPrint() const {
   for (Symbol symbol : symbols) {
     const InlineString& token = *decode_map_.find(symbol)->second;
     const SharedSymbol& shared_symbol = encode_map_.find(token.toStringView())->second;
-    ENVOY_LOG_MISC(info, "{}: '{}' ({})", symbol, token.toStringView(), shared_symbol.ref_count_);
+    ENVOY_LOG_MISC(info, "{}: '{}' ({})", symbol, token.toStringView(),
+                   shared_symbol.ref_count_.load());
   }
 }
 #endif
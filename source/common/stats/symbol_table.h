@@ -1,6 +1,8 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <atomic>
 #include <memory>
 #include <stack>
 #include <string>
@@ -14,11 +16,13 @@
 #include "source/common/common/utility.h"
 #include "source/common/stats/recent_lookups.h"
 
+#include "absl/base/optimization.h"
 #include "absl/container/fixed_array.h"
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/inlined_vector.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/str_split.h"
+#include "absl/synchronization/mutex.h"
 
 namespace Envoy {
 namespace Stats {
@@ -349,7 +353,7 @@ public:
   void sortByStatNames(Iter begin, Iter end, GetStatName get_stat_name) const {
     // Grab the lock once before sorting begins, so we don't have to re-take
     // it on every comparison.
-    Thread::LockGuard lock(lock_);
+    absl::ReaderMutexLock lock(&lock_);
     StatNameCompare<GetStatName, Obj> compare(*this, get_stat_name);
     std::sort(begin, end, compare);
   }
@@ -397,13 +401,19 @@ private:
 
   struct SharedSymbol {
     SharedSymbol(Symbol symbol) : symbol_(symbol) {}
+    // The encode map only moves its values while lock_ is held exclusively.
+    SharedSymbol(SharedSymbol&& src) noexcept
+        : symbol_(src.symbol_), ref_count_(src.ref_count_.load()) {}
 
     Symbol symbol_;
-    uint32_t ref_count_{1};
+    // Bumped and decremented with lock_ held shared, so that encoding and
+    // freeing the names of existing symbols don't serialize.
+    std::atomic<uint32_t> ref_count_{1};
   };
 
-  // This must be held during both encode() and free().
-  mutable Thread::MutexBasicLockable lock_;
+  // This is held shared to look up existing symbols and to bump or decrement
+  // their reference counts, and exclusively to add or remove symbols.
+  mutable absl::Mutex lock_;
 
   /**
    * Decodes a uint8_t array into an array of period-delimited strings. Note
@@ -434,7 +444,7 @@ private:
    * @param symbol the individual symbol to be decoded.
    * @return absl::string_view the decoded string.
    */
-  absl::string_view fromSymbol(Symbol symbol) const ABSL_EXCLUSIVE_LOCKS_REQUIRED(lock_);
+  absl::string_view fromSymbol(Symbol symbol) const ABSL_SHARED_LOCKS_REQUIRED(lock_);
 
   /**
    * Stages a new symbol for use. To be called after a successful insertion.
@@ -450,8 +460,13 @@ private:
    */
   void addTokensToEncoding(absl::string_view name, Encoding& encoding);
 
+  /**
+   * Records the lookup of a name for getRecentLookups().
+   */
+  void recordLookup(absl::string_view name);
+
   Symbol monotonicCounter() {
-    Thread::LockGuard lock(lock_);
+    absl::ReaderMutexLock lock(&lock_);
     return monotonic_counter_;
   }
 
@@ -474,7 +489,23 @@ private:
   // TODO(ambuc): There might be an optimization here relating to storing ranges of freed symbols
   // using an Envoy::IntervalSet.
   std::stack<Symbol> pool_ ABSL_GUARDED_BY(lock_);
-  RecentLookups recent_lookups_ ABSL_GUARDED_BY(lock_);
+
+  // The recent lookups have their own lock, which is only taken when their
+  // capacity is non-zero. Otherwise only the number of lookups is counted.
+  mutable Thread::MutexBasicLockable recent_lookups_lock_;
+  RecentLookups recent_lookups_ ABSL_GUARDED_BY(recent_lookups_lock_);
+  std::atomic<bool> record_lookups_{false};
+
+  // The lookups that are only counted are spread over counters on separate
+  // cache lines, each thread incrementing the same one, so that the threads
+  // encoding concurrently don't contend on a single counter.
+  struct ABSL_CACHELINE_ALIGNED LookupCounter {
+    std::atomic<uint64_t> count_{0};
+  };
+  static constexpr size_t NumLookupCounters = 16;
+  static size_t lookupCounterIndex();
+  uint64_t unrecordedLookups() const;
+  std::array<LookupCounter, NumLookupCounters> unrecorded_lookups_;
 };
 
 // Base class for holding the backing-storing for a StatName. The two derived
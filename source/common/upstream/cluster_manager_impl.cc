@@ -1,5 +1,6 @@
 #include "source/common/upstream/cluster_manager_impl.h"
 
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
 #include <functional>
@@ -333,6 +334,11 @@ ClusterManagerImpl::ClusterManagerImpl(
     local_cluster_name_ = cm_config.local_cluster_name();
   }
 
+  if (cm_config.load_balancer_build_threads() > 0) {
+    lb_build_pool_ = std::make_shared<LoadBalancerBuildPoolImpl>(
+        api.threadFactory(), cm_config.load_balancer_build_threads());
+  }
+
   // Initialize the XdsResourceDelegate extension, if set on the bootstrap config.
   if (bootstrap.has_xds_delegate_extension()) {
     auto& factory = Config::Utility::getAndCheckFactory<Config::XdsResourcesDelegateFactory>(
@@ -952,6 +958,9 @@ ClusterManagerImpl::loadCluster(const envoy::config::cluster::v3::Cluster& clust
         typed_lb_factory->create(cluster_info->loadBalancerConfig(), *cluster_info,
                                  cluster_reference.prioritySet(), runtime_, random_, time_source_);
   }
+  if (lb_build_pool_ != nullptr && cluster_entry_it->second->thread_aware_lb_ != nullptr) {
+    cluster_entry_it->second->thread_aware_lb_->setBuildPool(lb_build_pool_);
+  }
 
   updateClusterCounts();
   return result;
@@ -1981,22 +1990,52 @@ ClusterManagerImpl::ThreadLocalClusterManagerImpl::ClusterEntry::httpConnPoolImp
   }
 
   // If configured, use the downstream connection id in pool hash key
-  if (cluster_info_->connectionPoolPerDownstreamConnection() && context &&
-      context->downstreamConnection()) {
+  const bool have_downstream_connection_key =
+      cluster_info_->connectionPoolPerDownstreamConnection() && context &&
+      context->downstreamConnection();
+  if (have_downstream_connection_key) {
     context->downstreamConnection()->hashKey(hash_key);
   }
 
+  // Only the multiplexed connections which are not bound to a downstream connection are shared
+  // by the workers.
+  const bool share_across_workers =
+      cluster_info_->shareConnectionPoolsAcrossWorkers() && !have_downstream_connection_key &&
+      std::all_of(upstream_protocols.begin(), upstream_protocols.end(),
+                  [](Http::Protocol protocol) {
+                    return protocol == Http::Protocol::Http2 || protocol == Http::Protocol::Http3;
+                  });
+
   ConnPoolsContainer& container = *parent_.getHttpConnPoolsContainer(host, true);
 
   // Note: to simplify this, we assume that the factory is only called in the scope of this
   // function. Otherwise, we'd need to capture a few of these variables by value.
   ConnPoolsContainer::ConnPools::PoolOptRef pool =
       container.pools_->getPool(priority, hash_key, [&]() {
-        auto pool = parent_.parent_.factory_.allocateConnPool(
-            parent_.thread_local_dispatcher_, host, priority, upstream_protocols,
-            alternate_protocol_options, !upstream_options->empty() ? upstream_options : nullptr,
-            have_transport_socket_options ? context->upstreamTransportSocketOptions() : nullptr,
-            parent_.parent_.time_source_, parent_.cluster_manager_state_, quic_info_);
+        // The pool shared by the workers is only allocated by its first stream, so the arguments
+        // are captured by value. The cluster entry outlives its pools, and the shared pool no
+        // longer allocates once drained for deletion.
+        Http::SharedConnPool::PoolFactory allocate_pool =
+            [&parent = parent_, &quic_info = quic_info_, host, priority, upstream_protocols,
+             alternate_protocol_options,
+             options = !upstream_options->empty() ? upstream_options : nullptr,
+             transport_socket_options = have_transport_socket_options
+                                            ? context->upstreamTransportSocketOptions()
+                                            : nullptr]() mutable {
+              return parent.parent_.factory_.allocateConnPool(
+                  parent.thread_local_dispatcher_, host, priority, upstream_protocols,
+                  alternate_protocol_options, options, transport_socket_options,
+                  parent.parent_.time_source_, parent.cluster_manager_state_, quic_info);
+            };
+        Http::ConnectionPool::InstancePtr pool;
+        if (share_across_workers) {
+          pool = std::make_unique<Http::SharedConnPool>(
+              parent_.parent_.shared_conn_pool_registry_,
+              Http::SharedConnPoolRegistry::Key{host.get(), priority, hash_key},
+              parent_.thread_local_dispatcher_, host, std::move(allocate_pool));
+        } else {
+          pool = allocate_pool();
+        }
 
         pool->addIdleCallback([&parent = parent_, host, priority, hash_key]() {
           parent.httpConnPoolIsIdle(host, priority, hash_key);
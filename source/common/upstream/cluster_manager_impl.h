@@ -33,10 +33,12 @@
 #include "source/common/http/async_client_impl.h"
 #include "source/common/http/http_server_properties_cache_impl.h"
 #include "source/common/http/http_server_properties_cache_manager_impl.h"
+#include "source/common/http/shared_conn_pool.h"
 #include "source/common/quic/quic_stat_names.h"
 #include "source/common/tcp/async_tcp_client_impl.h"
 #include "source/common/upstream/cluster_discovery_manager.h"
 #include "source/common/upstream/host_utility.h"
+#include "source/common/upstream/load_balancer_build_pool.h"
 #include "source/common/upstream/load_stats_reporter.h"
 #include "source/common/upstream/od_cds_api_impl.h"
 #include "source/common/upstream/priority_conn_pool_map.h"
@@ -872,6 +874,11 @@ protected:
 private:
   ClusterMap warming_clusters_;
   const bool deferred_cluster_creation_;
+  // Rebuilds the thread aware load balancers in the background, if enabled.
+  LoadBalancerBuildPoolSharedPtr lb_build_pool_;
+  // The HTTP/2 and HTTP/3 connection pools accepting streams from the other workers.
+  Http::SharedConnPoolRegistrySharedPtr shared_conn_pool_registry_{
+      std::make_shared<Http::SharedConnPoolRegistry>()};
   absl::optional<envoy::config::core::v3::BindConfig> bind_config_;
   Outlier::EventLoggerSharedPtr outlier_event_logger_;
   const LocalInfo::LocalInfo& local_info_;
@@ -1,12 +1,16 @@
 #pragma once
+#include <algorithm>
 #include <cstdint>
 #include <iostream>
-#include <queue>
+#include <list>
+#include <vector>
 
 #include "envoy/upstream/scheduler.h"
 
 #include "source/common/common/assert.h"
 
+#include "absl/container/flat_hash_map.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -58,12 +62,30 @@ public:
     const double deadline = current_time_ + 1.0 / weight;
     EDF_TRACE("Insertion {} in queue with deadline {} and weight {}.",
               static_cast<const void*>(entry.get()), deadline, weight);
-    queue_.push({deadline, order_offset_++, entry});
-    ASSERT(queue_.top().deadline_ >= current_time_);
+    queue_.push_back({deadline, order_offset_++, entry});
+    std::push_heap(queue_.begin(), queue_.end());
+    ASSERT(queue_.front().deadline_ >= current_time_);
   }
 
   bool empty() const override { return queue_.empty(); }
 
+  /**
+   * Removes an entry from the schedule. The queued entry is skipped when it is picked, and the
+   * queue is compacted once removed entries make up half of it. An entry that is added again after
+   * being removed is scheduled afresh.
+   * @param entry supplies the entry to remove.
+   */
+  void remove(const std::shared_ptr<C>& entry) {
+    // Only the queued entries added before this point are removed.
+    removed_[entry.get()] = order_offset_;
+    prepick_list_.remove_if([&entry](const std::weak_ptr<C>& prepicked) {
+      return prepicked.lock() == entry;
+    });
+    if (removed_.size() * 2 >= queue_.size()) {
+      compact();
+    }
+  }
+
 private:
   /**
    * Clears expired entries and pops the next unexpired entry in the queue.
@@ -75,18 +97,22 @@ private:
         EDF_TRACE("Queue is empty.");
         return nullptr;
       }
-      const EdfEntry& edf_entry = queue_.top();
+      std::pop_heap(queue_.begin(), queue_.end());
+      const EdfEntry edf_entry = std::move(queue_.back());
+      queue_.pop_back();
       // Entry has been removed, let's see if there's another one.
       std::shared_ptr<C> ret = edf_entry.entry_.lock();
       if (!ret) {
         EDF_TRACE("Entry has expired, repick.");
-        queue_.pop();
+        continue;
+      }
+      if (isRemoved(edf_entry, *ret)) {
+        EDF_TRACE("Entry has been removed, repick.");
         continue;
       }
       ASSERT(edf_entry.deadline_ >= current_time_);
       current_time_ = edf_entry.deadline_;
       EDF_TRACE("Picked {}, current_time_={}.", static_cast<const void*>(ret.get()), current_time_);
-      queue_.pop();
       return ret;
     }
   }
@@ -95,8 +121,8 @@ private:
     double deadline_;
     // Tie breaker for entries with the same deadline. This is used to provide FIFO behavior.
     uint64_t order_offset_;
-    // We only hold a weak pointer, since we don't support a remove operator. This allows entries to
-    // be lazily unloaded from the queue.
+    // We only hold a weak pointer, so that entries that are destroyed without being removed are
+    // lazily unloaded from the queue.
     std::weak_ptr<C> entry_;
 
     // Flip < direction to make this a min queue.
@@ -106,6 +132,28 @@ private:
     }
   };
 
+  bool isRemoved(const EdfEntry& edf_entry, const C& entry) const {
+    if (removed_.empty()) {
+      return false;
+    }
+    const auto it = removed_.find(&entry);
+    return it != removed_.end() && edf_entry.order_offset_ < it->second;
+  }
+
+  /**
+   * Drops the removed and expired entries from the queue.
+   */
+  void compact() {
+    queue_.erase(std::remove_if(queue_.begin(), queue_.end(),
+                                [this](const EdfEntry& edf_entry) {
+                                  std::shared_ptr<C> entry = edf_entry.entry_.lock();
+                                  return entry == nullptr || isRemoved(edf_entry, *entry);
+                                }),
+                 queue_.end());
+    std::make_heap(queue_.begin(), queue_.end());
+    removed_.clear();
+  }
+
   // Current time in EDF scheduler.
   // TODO(htuch): Is it worth the small extra complexity to use integer time for performance
   // reasons?
@@ -113,9 +161,12 @@ private:
   // Offset used during addition to break ties when entries have the same weight but should reflect
   // FIFO insertion order in picks.
   uint64_t order_offset_{};
-  // Min priority queue for EDF.
-  std::priority_queue<EdfEntry> queue_;
+  // Min priority queue for EDF, kept with the std heap algorithms so that it can be compacted.
+  std::vector<EdfEntry> queue_;
   std::list<std::weak_ptr<C>> prepick_list_;
+  // Removed entries, mapped to the order offset at the time of removal. Queued entries of a removed
+  // entry with a lower order offset are skipped.
+  absl::flat_hash_map<const C*, uint64_t> removed_;
 };
 
 #undef EDF_DEBUG
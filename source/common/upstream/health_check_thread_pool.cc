@@ -0,0 +1,77 @@
+#include "source/common/upstream/health_check_thread_pool.h"
+
+#include "envoy/server/factory_context.h"
+#include "envoy/singleton/manager.h"
+
+#include "source/common/common/assert.h"
+
+#include "absl/strings/str_cat.h"
+
+namespace Envoy {
+namespace Upstream {
+
+SINGLETON_MANAGER_REGISTRATION(health_check_thread_pool);
+
+HealthCheckThreadPool::HealthCheckThreadPool(Api::Api& api, ThreadLocal::Instance& tls,
+                                             uint32_t num_threads)
+    : tls_(tls) {
+  ASSERT(num_threads > 0);
+  dispatchers_.reserve(num_threads);
+  threads_.reserve(num_threads);
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    dispatchers_.push_back(api.allocateDispatcher(absl::StrCat("health_check_", i)));
+    Event::Dispatcher& dispatcher = *dispatchers_.back();
+    // The sessions create codec clients and stats, which use the thread local data of the thread.
+    tls_.registerThread(dispatcher, false);
+    threads_.push_back(api.threadFactory().createThread(
+        [this, &dispatcher]() -> void { threadRoutine(dispatcher); },
+        Thread::Options{"HealthCheck"}));
+  }
+}
+
+HealthCheckThreadPool::~HealthCheckThreadPool() { shutdown(); }
+
+std::shared_ptr<HealthCheckThreadPool>
+HealthCheckThreadPool::create(Singleton::Manager& singleton_manager, Api::Api& api,
+                              ThreadLocal::Instance& tls, uint32_t num_threads) {
+  if (num_threads == 0) {
+    return nullptr;
+  }
+  return singleton_manager.getTyped<HealthCheckThreadPool>(
+      SINGLETON_MANAGER_REGISTERED_NAME(health_check_thread_pool), [&api, &tls, num_threads] {
+        return std::make_shared<HealthCheckThreadPool>(api, tls, num_threads);
+      });
+}
+
+HealthCheckDispatchersSharedPtr
+HealthCheckThreadPool::get(Server::Configuration::HealthCheckerFactoryContext& context) {
+  // The thread pool is created by the server at startup, see create().
+  return context.serverFactoryContext().singletonManager().getTyped<HealthCheckThreadPool>(
+      SINGLETON_MANAGER_REGISTERED_NAME(health_check_thread_pool));
+}
+
+void HealthCheckThreadPool::shutdown() {
+  for (auto& dispatcher : dispatchers_) {
+    dispatcher->exit();
+  }
+  for (auto& thread : threads_) {
+    thread->join();
+  }
+  threads_.clear();
+}
+
+Event::Dispatcher& HealthCheckThreadPool::nextDispatcher() {
+  return *dispatchers_[next_dispatcher_++ % dispatchers_.size()];
+}
+
+void HealthCheckThreadPool::threadRoutine(Event::Dispatcher& dispatcher) {
+  ENVOY_LOG(debug, "health check thread entering dispatch loop");
+  dispatcher.run(Event::Dispatcher::RunType::RunUntilExit);
+  ENVOY_LOG(debug, "health check thread exited dispatch loop");
+  // Destroy what the sessions left to be deleted on this thread before it exits.
+  dispatcher.shutdown();
+  tls_.shutdownThread();
+}
+
+} // namespace Upstream
+} // namespace Envoy
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "envoy/api/api.h"
+#include "envoy/event/dispatcher.h"
+#include "envoy/server/health_checker_config.h"
+#include "envoy/singleton/instance.h"
+#include "envoy/thread/thread.h"
+#include "envoy/thread_local/thread_local.h"
+
+#include "source/common/common/logger.h"
+
+namespace Envoy {
+namespace Upstream {
+
+/**
+ * Dispatchers running the active health check sessions instead of the main thread dispatcher.
+ */
+class HealthCheckDispatchers {
+public:
+  virtual ~HealthCheckDispatchers() = default;
+
+  /**
+   * @return the dispatcher to run the next health check session on.
+   */
+  virtual Event::Dispatcher& nextDispatcher() PURE;
+};
+
+using HealthCheckDispatchersSharedPtr = std::shared_ptr<HealthCheckDispatchers>;
+
+/**
+ * A fixed number of threads, each running a dispatcher shared by the health checkers of all the
+ * clusters. @see ClusterManager.health_check_threads. Like the workers, the threads are registered
+ * with the thread local instance, so the pool must be created before any thread local slot is set.
+ */
+class HealthCheckThreadPool : public HealthCheckDispatchers,
+                              public Singleton::Instance,
+                              Logger::Loggable<Logger::Id::hc> {
+public:
+  HealthCheckThreadPool(Api::Api& api, ThreadLocal::Instance& tls, uint32_t num_threads);
+  ~HealthCheckThreadPool() override;
+
+  /**
+   * Creates the thread pool shared by the health checkers, if health_check_threads is set.
+   * @return the thread pool, or nullptr if the health checks run on the main thread.
+   */
+  static std::shared_ptr<HealthCheckThreadPool>
+  create(Singleton::Manager& singleton_manager, Api::Api& api, ThreadLocal::Instance& tls,
+         uint32_t num_threads);
+
+  /**
+   * @return the thread pool shared by the health checkers, or nullptr if the health checks run
+   *         on the main thread.
+   */
+  static HealthCheckDispatchersSharedPtr
+  get(Server::Configuration::HealthCheckerFactoryContext& context);
+
+  /**
+   * Stops the threads. Must be called once the health checkers are destroyed, and after the
+   * global thread local shutdown.
+   */
+  void shutdown();
+
+  // Upstream::HealthCheckDispatchers
+  Event::Dispatcher& nextDispatcher() override;
+
+private:
+  void threadRoutine(Event::Dispatcher& dispatcher);
+
+  ThreadLocal::Instance& tls_;
+  std::vector<Event::DispatcherPtr> dispatchers_;
+  std::vector<Thread::ThreadPtr> threads_;
+  uint64_t next_dispatcher_{};
+};
+
+using HealthCheckThreadPoolSharedPtr = std::shared_ptr<HealthCheckThreadPool>;
+
+} // namespace Upstream
+} // namespace Envoy
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace Envoy {
+namespace Upstream {
+
+// Least Request Heap
+// ------------------
+// This scheduler picks the entry with the highest effective weight, which is the weight of the
+// entry scaled down by its number of outstanding requests. The entries are kept in a binary max
+// heap, and the heap position of every entry is indexed so that the key of any entry is updated in
+// O(log n).
+//
+// The outstanding requests of an entry are shared by all the workers and change without
+// notification, so every entry caches the count it last observed. Each pick observes the current
+// count of a fixed number of entries in turn, so that every cached count is refreshed within a
+// bounded number of picks. The picked entry is counted one more request right away, so that back
+// to back picks spread across the entries before their requests are accounted for. These picks
+// are kept until the count of the entry grows by as many requests, for at most a full round of
+// observations, so that the picks whose requests never start are eventually dropped. The count of
+// the best entry is also observed before it is picked.
+//
+// Entries of equal effective weight are picked in round robin order.
+template <class C> class LeastRequestHeap {
+public:
+  // Returns the current number of outstanding requests of an entry.
+  using ActiveRequestsCb = std::function<uint64_t(const C&)>;
+  // Returns the effective weight of an entry with the given number of outstanding requests.
+  using WeightCb = std::function<double(const C&, uint64_t)>;
+
+  /**
+   * @param active_requests supplies the outstanding requests of an entry.
+   * @param weight supplies the effective weight of an entry.
+   * @param refresh_count supplies the number of entries, other than the picked one, whose
+   *        outstanding requests are observed on each pick.
+   */
+  LeastRequestHeap(ActiveRequestsCb active_requests, WeightCb weight, uint32_t refresh_count)
+      : active_requests_(std::move(active_requests)), weight_(std::move(weight)),
+        refresh_count_(refresh_count) {}
+
+  /**
+   * Inserts an entry. The heap is built on the first pick that follows.
+   * @param entry supplies the entry to insert.
+   */
+  void add(std::shared_ptr<C> entry) {
+    const uint64_t active_requests = active_requests_(*entry);
+    const double weight = weight_(*entry, active_requests);
+    positions_.push_back(heap_.size());
+    heap_.push_back(
+        {std::move(entry), active_requests, 0, 0, weight, next_order_++, positions_.size() - 1});
+    built_ = false;
+  }
+
+  /**
+   * Moves the entries added so far ahead of each other in the round robin order of entries of equal
+   * weight, so that load balancers with the same entries do not pick them in lock step.
+   * @param offset supplies the number of entries to move ahead.
+   */
+  void rotate(uint64_t offset) {
+    if (heap_.empty()) {
+      return;
+    }
+    const uint64_t size = heap_.size();
+    for (Entry& entry : heap_) {
+      entry.order_ = (entry.order_ + size - offset % size) % size;
+    }
+    built_ = false;
+  }
+
+  /**
+   * Picks the entry with the highest effective weight and counts a new outstanding request on it.
+   * @return std::shared_ptr<C> the picked entry or nullptr if there are no entries.
+   */
+  std::shared_ptr<C> pick() {
+    if (heap_.empty()) {
+      return nullptr;
+    }
+    if (!built_) {
+      build();
+    }
+
+    for (uint32_t i = 0; i < refresh_count_; ++i) {
+      observe(positions_[next_refresh_], true);
+      next_refresh_ = (next_refresh_ + 1) % positions_.size();
+    }
+    // The observed count of the best entry may move it down the heap.
+    observe(0, false);
+
+    Entry& top = heap_.front();
+    std::shared_ptr<C> picked = top.entry_;
+    ++top.picked_requests_;
+    ++top.recent_picks_;
+    top.weight_ = weight_(*picked, top.active_requests_ + top.picked_requests_);
+    top.order_ = next_order_++;
+    siftDown(0);
+    return picked;
+  }
+
+  bool empty() const { return heap_.empty(); }
+  size_t size() const { return heap_.size(); }
+
+private:
+  struct Entry {
+    std::shared_ptr<C> entry_;
+    // The outstanding requests last observed.
+    uint64_t active_requests_;
+    // The picks not accounted for by the observed outstanding requests yet.
+    uint64_t picked_requests_;
+    // The picks since the entry was last observed in turn.
+    uint64_t recent_picks_;
+    double weight_;
+    // Tie breaker for entries with the same weight, the lowest is picked first.
+    uint64_t order_;
+    // The index of the entry in positions_.
+    size_t id_;
+  };
+
+  static bool before(const Entry& a, const Entry& b) {
+    return a.weight_ > b.weight_ || (a.weight_ == b.weight_ && a.order_ < b.order_);
+  }
+
+  void build() {
+    uint64_t max_order = 0;
+    for (const Entry& entry : heap_) {
+      max_order = std::max(max_order, entry.order_);
+    }
+    next_order_ = max_order + 1;
+    for (size_t i = heap_.size() / 2; i > 0; --i) {
+      siftDown(i - 1);
+    }
+    built_ = true;
+  }
+
+  // Observes the outstanding requests of an entry. The picks accounted for by the growth of its
+  // requests are dropped, and when the entry is observed in turn, so are the picks made before the
+  // previous round of observations.
+  void observe(size_t position, bool in_turn) {
+    Entry& entry = heap_[position];
+    const uint64_t active_requests = active_requests_(*entry.entry_);
+    if (active_requests > entry.active_requests_) {
+      entry.picked_requests_ -=
+          std::min(entry.picked_requests_, active_requests - entry.active_requests_);
+    }
+    if (in_turn) {
+      entry.picked_requests_ = std::min(entry.picked_requests_, entry.recent_picks_);
+      entry.recent_picks_ = 0;
+    }
+    entry.active_requests_ = active_requests;
+    entry.weight_ = weight_(*entry.entry_, entry.active_requests_ + entry.picked_requests_);
+    if (siftUp(position) == position) {
+      siftDown(position);
+    }
+  }
+
+  void swap(size_t a, size_t b) {
+    std::swap(heap_[a], heap_[b]);
+    positions_[heap_[a].id_] = a;
+    positions_[heap_[b].id_] = b;
+  }
+
+  size_t siftUp(size_t position) {
+    while (position > 0) {
+      const size_t parent = (position - 1) / 2;
+      if (!before(heap_[position], heap_[parent])) {
+        break;
+      }
+      swap(position, parent);
+      position = parent;
+    }
+    return position;
+  }
+
+  void siftDown(size_t position) {
+    const size_t size = heap_.size();
+    while (true) {
+      size_t best = position;
+      const size_t left = 2 * position + 1;
+      const size_t right = left + 1;
+      if (left < size && before(heap_[left], heap_[best])) {
+        best = left;
+      }
+      if (right < size && before(heap_[right], heap_[best])) {
+        best = right;
+      }
+      if (best == position) {
+        return;
+      }
+      swap(position, best);
+      position = best;
+    }
+  }
+
+  const ActiveRequestsCb active_requests_;
+  const WeightCb weight_;
+  const uint32_t refresh_count_;
+  std::vector<Entry> heap_;
+  // The heap position of every entry, indexed by the id of the entry.
+  std::vector<size_t> positions_;
+  uint64_t next_order_{};
+  size_t next_refresh_{};
+  bool built_{};
+};
+
+} // namespace Upstream
+} // namespace Envoy
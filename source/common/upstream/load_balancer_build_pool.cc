@@ -0,0 +1,50 @@
+#include "source/common/upstream/load_balancer_build_pool.h"
+
+#include "source/common/common/assert.h"
+
+namespace Envoy {
+namespace Upstream {
+
+LoadBalancerBuildPoolImpl::LoadBalancerBuildPoolImpl(Thread::ThreadFactory& thread_factory,
+                                                     uint32_t num_threads) {
+  ASSERT(num_threads > 0);
+  threads_.reserve(num_threads);
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    threads_.push_back(thread_factory.createThread([this]() -> void { buildThreadRoutine(); },
+                                                   Thread::Options{"LbBuild"}));
+  }
+}
+
+LoadBalancerBuildPoolImpl::~LoadBalancerBuildPoolImpl() {
+  {
+    absl::MutexLock lock(&mutex_);
+    shutdown_ = true;
+  }
+  for (auto& thread : threads_) {
+    thread->join();
+  }
+}
+
+void LoadBalancerBuildPoolImpl::post(std::function<void()> build) {
+  absl::MutexLock lock(&mutex_);
+  builds_.push_back(std::move(build));
+}
+
+void LoadBalancerBuildPoolImpl::buildThreadRoutine() {
+  while (true) {
+    std::function<void()> build;
+    {
+      absl::MutexLock lock(&mutex_);
+      mutex_.Await(absl::Condition(this, &LoadBalancerBuildPoolImpl::hasBuildOrShutdown));
+      if (shutdown_) {
+        return;
+      }
+      build = std::move(builds_.front());
+      builds_.pop_front();
+    }
+    build();
+  }
+}
+
+} // namespace Upstream
+} // namespace Envoy
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <functional>
+#include <list>
+#include <vector>
+
+#include "envoy/thread/thread.h"
+#include "envoy/upstream/load_balancer.h"
+
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Upstream {
+
+/**
+ * A fixed number of threads running the posted builds in order.
+ */
+class LoadBalancerBuildPoolImpl : public LoadBalancerBuildPool {
+public:
+  LoadBalancerBuildPoolImpl(Thread::ThreadFactory& thread_factory, uint32_t num_threads);
+  ~LoadBalancerBuildPoolImpl() override;
+
+  // Upstream::LoadBalancerBuildPool
+  void post(std::function<void()> build) override;
+
+private:
+  void buildThreadRoutine();
+  bool hasBuildOrShutdown() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    return shutdown_ || !builds_.empty();
+  }
+
+  mutable absl::Mutex mutex_;
+  std::list<std::function<void()>> builds_ ABSL_GUARDED_BY(mutex_);
+  bool shutdown_ ABSL_GUARDED_BY(mutex_){false};
+  std::vector<Thread::ThreadPtr> threads_;
+};
+
+} // namespace Upstream
+} // namespace Envoy
@@ -1023,13 +1023,14 @@ EdfLoadBalancerBase::EdfLoadBalancerBase(
                                                slow_start_config.value(), min_weight_percent, 10) /
                                                100.0
                                          : 0.1) {
-  // We fully recompute the schedulers for a given host set here on membership change, which is
-  // consistent with what other LB implementations do (e.g. thread aware).
-  // The downside of a full recompute is that time complexity is O(n * log n),
-  // so we will need to do better at delta tracking to scale (see
-  // https://github.com/envoyproxy/envoy/issues/2874).
+  // The schedulers for a given host set are recomputed on membership change, unless the update only
+  // added and removed hosts, in which case the delta is applied to the existing schedulers. A full
+  // recompute is O(n * log n) on every worker, which does not scale to large host sets with
+  // frequent churn (see https://github.com/envoyproxy/envoy/issues/2874).
   priority_update_cb_ = priority_set.addPriorityUpdateCb(
-      [this](uint32_t priority, const HostVector&, const HostVector&) { refresh(priority); });
+      [this](uint32_t priority, const HostVector& hosts_added, const HostVector& hosts_removed) {
+        refresh(priority, hosts_added, hosts_removed);
+      });
   member_update_cb_ = priority_set.addMemberUpdateCb(
       [this](const HostVector& hosts_added, const HostVector&) -> void {
         if (isSlowStartEnabled()) {
@@ -1040,7 +1041,7 @@ EdfLoadBalancerBase::EdfLoadBalancerBase(
 
 void EdfLoadBalancerBase::initialize() {
   for (uint32_t priority = 0; priority < priority_set_.hostSetsPerPriority().size(); ++priority) {
-    refresh(priority);
+    refresh(priority, {}, {});
   }
 }
 
@@ -1068,67 +1069,155 @@ void EdfLoadBalancerBase::recalculateHostsInSlowStart(const HostVector& hosts) {
   }
 }
 
-void EdfLoadBalancerBase::refresh(uint32_t priority) {
-  const auto add_hosts_source = [this](HostsSource source, const HostVector& hosts) {
-    // Nuke existing scheduler if it exists.
-    auto& scheduler = scheduler_[source] = Scheduler{};
-    refreshHostSource(source);
-    if (isSlowStartEnabled()) {
-      recalculateHostsInSlowStart(hosts);
-    }
-
-    // Check if the original host weights are equal and no hosts are in slow start mode, in that
-    // case EDF creation is skipped. When all original weights are equal and no hosts are in slow
-    // start mode we can rely on unweighted host pick to do optimal round robin and least-loaded
-    // host selection with lower memory and CPU overhead.
-    if (hostWeightsAreEqual(hosts) && noHostsAreInSlowStart()) {
-      // Skip edf creation.
-      return;
+void EdfLoadBalancerBase::refresh(uint32_t priority, const HostVector& hosts_added,
+                                  const HostVector& hosts_removed) {
+  // Updates that don't add or remove hosts signal health, weight or metadata changes, after which
+  // the schedulers are always rebuilt. Slow start weights change over time, so they are also
+  // rebuilt when slow start is enabled.
+  const bool apply_delta = (!hosts_added.empty() || !hosts_removed.empty()) &&
+                           !isSlowStartEnabled() &&
+                           Runtime::runtimeFeatureEnabled(
+                               "envoy.reloadable_features.edf_lb_host_delta_updates");
+  absl::flat_hash_set<const Host*> added;
+  absl::flat_hash_set<const Host*> removed;
+  if (apply_delta) {
+    added.reserve(hosts_added.size());
+    for (const auto& host : hosts_added) {
+      added.insert(host.get());
     }
-    scheduler.edf_ = std::make_unique<EdfScheduler<const Host>>();
-
-    // Populate scheduler with host list.
-    // TODO(mattklein123): We must build the EDF schedule even if all of the hosts are currently
-    // weighted 1. This is because currently we don't refresh host sets if only weights change.
-    // We should probably change this to refresh at all times. See the comment in
-    // BaseDynamicClusterImpl::updateDynamicHostList about this.
-    for (const auto& host : hosts) {
-      // We use a fixed weight here. While the weight may change without
-      // notification, this will only be stale until this host is next picked,
-      // at which point it is reinserted into the EdfScheduler with its new
-      // weight in chooseHost().
-      scheduler.edf_->add(hostWeight(*host), host);
+    removed.reserve(hosts_removed.size());
+    for (const auto& host : hosts_removed) {
+      removed.insert(host.get());
     }
+  }
 
-    // Cycle through hosts to achieve the intended offset behavior.
-    // TODO(htuch): Consider how we can avoid biasing towards earlier hosts in the schedule across
-    // refreshes for the weighted case.
-    if (!hosts.empty()) {
-      for (uint32_t i = 0; i < seed_ % hosts.size(); ++i) {
-        auto host =
-            scheduler.edf_->pickAndAdd([this](const Host& host) { return hostWeight(host); });
+  const auto update_hosts_source = [&](HostsSource source, HostVectorConstSharedPtr hosts) {
+    if (apply_delta) {
+      auto it = scheduler_.find(source);
+      if (it != scheduler_.end() && applyHostsDelta(it->second, hosts, added, removed)) {
+        refreshHostSource(source);
+        return;
       }
     }
+    rebuildHostSource(source, std::move(hosts));
   };
   // Populate EdfSchedulers for each valid HostsSource value for the host set at this priority.
   const auto& host_set = priority_set_.hostSetsPerPriority()[priority];
-  add_hosts_source(HostsSource(priority, HostsSource::SourceType::AllHosts), host_set->hosts());
-  add_hosts_source(HostsSource(priority, HostsSource::SourceType::HealthyHosts),
-                   host_set->healthyHosts());
-  add_hosts_source(HostsSource(priority, HostsSource::SourceType::DegradedHosts),
-                   host_set->degradedHosts());
+  update_hosts_source(HostsSource(priority, HostsSource::SourceType::AllHosts),
+                      host_set->hostsPtr());
+  const HealthyHostVectorConstSharedPtr healthy_hosts = host_set->healthyHostsPtr();
+  update_hosts_source(HostsSource(priority, HostsSource::SourceType::HealthyHosts),
+                      HostVectorConstSharedPtr(healthy_hosts, &healthy_hosts->get()));
+  const DegradedHostVectorConstSharedPtr degraded_hosts = host_set->degradedHostsPtr();
+  update_hosts_source(HostsSource(priority, HostsSource::SourceType::DegradedHosts),
+                      HostVectorConstSharedPtr(degraded_hosts, &degraded_hosts->get()));
+  const HostsPerLocalityConstSharedPtr healthy_hosts_per_locality =
+      host_set->healthyHostsPerLocalityPtr();
   for (uint32_t locality_index = 0;
-       locality_index < host_set->healthyHostsPerLocality().get().size(); ++locality_index) {
-    add_hosts_source(
+       locality_index < healthy_hosts_per_locality->get().size(); ++locality_index) {
+    update_hosts_source(
         HostsSource(priority, HostsSource::SourceType::LocalityHealthyHosts, locality_index),
-        host_set->healthyHostsPerLocality().get()[locality_index]);
+        HostVectorConstSharedPtr(healthy_hosts_per_locality,
+                                 &healthy_hosts_per_locality->get()[locality_index]));
   }
+  const HostsPerLocalityConstSharedPtr degraded_hosts_per_locality =
+      host_set->degradedHostsPerLocalityPtr();
   for (uint32_t locality_index = 0;
-       locality_index < host_set->degradedHostsPerLocality().get().size(); ++locality_index) {
-    add_hosts_source(
+       locality_index < degraded_hosts_per_locality->get().size(); ++locality_index) {
+    update_hosts_source(
         HostsSource(priority, HostsSource::SourceType::LocalityDegradedHosts, locality_index),
-        host_set->degradedHostsPerLocality().get()[locality_index]);
+        HostVectorConstSharedPtr(degraded_hosts_per_locality,
+                                 &degraded_hosts_per_locality->get()[locality_index]));
+  }
+}
+
+void EdfLoadBalancerBase::rebuildHostSource(const HostsSource& source,
+                                            HostVectorConstSharedPtr hosts_ptr) {
+  const HostVector& hosts = *hosts_ptr;
+  // Nuke existing scheduler if it exists.
+  auto& scheduler = scheduler_[source] = Scheduler{};
+  refreshHostSource(source);
+  if (isSlowStartEnabled()) {
+    recalculateHostsInSlowStart(hosts);
+  }
+
+  // Check if the original host weights are equal and no hosts are in slow start mode, in that
+  // case EDF creation is skipped. When all original weights are equal and no hosts are in slow
+  // start mode we can rely on unweighted host pick to do optimal round robin and least-loaded
+  // host selection with lower memory and CPU overhead.
+  if (hostWeightsAreEqual(hosts) && noHostsAreInSlowStart()) {
+    // Skip edf creation.
+    return;
+  }
+  if (buildWeightedHostSource(source, hosts)) {
+    scheduler.weighted_host_pick_ = true;
+    return;
+  }
+  scheduler.edf_ = std::make_unique<EdfScheduler<const Host>>();
+  scheduler.hosts_ = std::move(hosts_ptr);
+
+  // Populate scheduler with host list.
+  // TODO(mattklein123): We must build the EDF schedule even if all of the hosts are currently
+  // weighted 1. This is because currently we don't refresh host sets if only weights change.
+  // We should probably change this to refresh at all times. See the comment in
+  // BaseDynamicClusterImpl::updateDynamicHostList about this.
+  for (const auto& host : hosts) {
+    // We use a fixed weight here. While the weight may change without
+    // notification, this will only be stale until this host is next picked,
+    // at which point it is reinserted into the EdfScheduler with its new
+    // weight in chooseHost().
+    scheduler.edf_->add(hostWeight(*host), host);
+  }
+
+  // Cycle through hosts to achieve the intended offset behavior.
+  // TODO(htuch): Consider how we can avoid biasing towards earlier hosts in the schedule across
+  // refreshes for the weighted case.
+  if (!hosts.empty()) {
+    for (uint32_t i = 0; i < seed_ % hosts.size(); ++i) {
+      auto host =
+          scheduler.edf_->pickAndAdd([this](const Host& host) { return hostWeight(host); });
+    }
+  }
+}
+
+bool EdfLoadBalancerBase::applyHostsDelta(Scheduler& scheduler, HostVectorConstSharedPtr hosts_ptr,
+                                          const absl::flat_hash_set<const Host*>& added,
+                                          const absl::flat_hash_set<const Host*>& removed) {
+  // Unweighted host sources are cheap to rebuild.
+  if (scheduler.edf_ == nullptr) {
+    return false;
+  }
+
+  // Verify that the new hosts are the previous hosts with the delta applied. The host lists keep
+  // their relative order across updates, so a single pass comparing host pointers is enough. Any
+  // other change, e.g. a host becoming unhealthy in the same update, rebuilds the scheduler.
+  const HostVector& previous_hosts = *scheduler.hosts_;
+  const HostVector& hosts = *hosts_ptr;
+  HostVector hosts_added;
+  HostVector hosts_removed;
+  size_t i = 0;
+  size_t j = 0;
+  while (i < previous_hosts.size() || j < hosts.size()) {
+    if (i < previous_hosts.size() && j < hosts.size() && previous_hosts[i] == hosts[j]) {
+      ++i;
+      ++j;
+    } else if (i < previous_hosts.size() && removed.contains(previous_hosts[i].get())) {
+      hosts_removed.push_back(previous_hosts[i++]);
+    } else if (j < hosts.size() && added.contains(hosts[j].get())) {
+      hosts_added.push_back(hosts[j++]);
+    } else {
+      return false;
+    }
+  }
+
+  for (const auto& host : hosts_removed) {
+    scheduler.edf_->remove(host);
+  }
+  for (const auto& host : hosts_added) {
+    scheduler.edf_->add(hostWeight(*host), host);
   }
+  scheduler.hosts_ = std::move(hosts_ptr);
+  return true;
 }
 
 bool EdfLoadBalancerBase::isSlowStartEnabled() const {
@@ -1169,6 +1258,9 @@ HostConstSharedPtr EdfLoadBalancerBase::peekAnotherHost(LoadBalancerContext* con
   // weights of 2 or more hosts differ.
   if (scheduler.edf_ != nullptr) {
     return scheduler.edf_->peekAgain([this](const Host& host) { return hostWeight(host); });
+  } else if (scheduler.weighted_host_pick_) {
+    // The picks of the load balancer implementation are not deterministic.
+    return nullptr;
   } else {
     const HostVector& hosts_to_use = hostSourceToHosts(*hosts_source);
     if (hosts_to_use.empty()) {
@@ -1196,6 +1288,8 @@ HostConstSharedPtr EdfLoadBalancerBase::chooseHostOnce(LoadBalancerContext* cont
   if (scheduler.edf_ != nullptr) {
     auto host = scheduler.edf_->pickAndAdd([this](const Host& host) { return hostWeight(host); });
     return host;
+  } else if (scheduler.weighted_host_pick_) {
+    return weightedHostPick(*hosts_source);
   } else {
     const HostVector& hosts_to_use = hostSourceToHosts(*hosts_source);
     if (hosts_to_use.empty()) {
@@ -1245,6 +1339,10 @@ double EdfLoadBalancerBase::applySlowStartFactor(double host_weight, const Host&
 }
 
 double LeastRequestLoadBalancer::hostWeight(const Host& host) const {
+  return hostWeight(host, host.stats().rq_active_.value());
+}
+
+double LeastRequestLoadBalancer::hostWeight(const Host& host, uint64_t active_requests) const {
   // This method is called to calculate the dynamic weight as following when all load balancing
   // weights are not equal:
   //
@@ -1268,10 +1366,9 @@ double LeastRequestLoadBalancer::hostWeight(const Host& host) const {
   // If the value of active requests is the max value, adding +1 will overflow
   // it and cause a divide by zero. This won't happen in normal cases but stops
   // failing fuzz tests
-  const uint64_t active_request_value =
-      host.stats().rq_active_.value() != std::numeric_limits<uint64_t>::max()
-          ? host.stats().rq_active_.value() + 1
-          : host.stats().rq_active_.value();
+  const uint64_t active_request_value = active_requests != std::numeric_limits<uint64_t>::max()
+                                            ? active_requests + 1
+                                            : active_requests;
 
   if (active_request_bias_ == 1.0) {
     host_weight = static_cast<double>(host.weight()) / active_request_value;
@@ -1320,6 +1417,35 @@ HostConstSharedPtr LeastRequestLoadBalancer::unweightedHostPick(const HostVector
   return candidate_host;
 }
 
+bool LeastRequestLoadBalancer::buildWeightedHostSource(const HostsSource& source,
+                                                       const HostVector& hosts) {
+  // Without an active request bias the weights do not depend on the active requests, and the EDF
+  // scheduler provides the expected weighted round robin.
+  if (!least_outstanding_requests_ || active_request_bias_ == 0.0) {
+    return false;
+  }
+  // The requests started on a host are accounted for as it is picked, and the active requests of
+  // choice_count_ other hosts are observed on each pick.
+  auto heap = std::make_unique<LeastRequestHeap<const Host>>(
+      [](const Host& host) { return host.stats().rq_active_.value(); },
+      [this](const Host& host, uint64_t active_requests) {
+        return hostWeight(host, active_requests);
+      },
+      choice_count_);
+  for (const auto& host : hosts) {
+    heap->add(host);
+  }
+  heap->rotate(seed_);
+  heaps_[source] = std::move(heap);
+  return true;
+}
+
+HostConstSharedPtr LeastRequestLoadBalancer::weightedHostPick(const HostsSource& source) {
+  const auto it = heaps_.find(source);
+  ASSERT(it != heaps_.end());
+  return it->second->pick();
+}
+
 HostConstSharedPtr RandomLoadBalancer::peekAnotherHost(LoadBalancerContext* context) {
   if (tooManyPreconnects(stashed_random_.size(), total_healthy_hosts_)) {
     return nullptr;
@@ -22,8 +22,11 @@
 #include "source/common/protobuf/utility.h"
 #include "source/common/runtime/runtime_protos.h"
 #include "source/common/upstream/edf_scheduler.h"
+#include "source/common/upstream/least_request_heap.h"
 #include "source/common/upstream/subset_lb_config.h"
 
+#include "absl/container/flat_hash_set.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -526,11 +529,23 @@ protected:
     // host weights of 2 or more hosts differ. When not present, the
     // implementation of chooseHostOnce falls back to unweightedHostPick.
     std::unique_ptr<EdfScheduler<const Host>> edf_;
+    // The hosts that edf_ was built from, used to apply membership deltas to it.
+    HostVectorConstSharedPtr hosts_;
+    // Set instead of edf_ when the weighted hosts are picked by weightedHostPick().
+    bool weighted_host_pick_{};
   };
 
   void initialize();
 
-  virtual void refresh(uint32_t priority);
+  /**
+   * Updates the schedulers of a priority after its host set changed. The schedulers are rebuilt,
+   * unless the update only added and removed hosts and the delta can be applied to them.
+   * @param priority supplies the updated priority.
+   * @param hosts_added supplies the hosts added to the priority.
+   * @param hosts_removed supplies the hosts removed from the priority.
+   */
+  virtual void refresh(uint32_t priority, const HostVector& hosts_added,
+                       const HostVector& hosts_removed);
 
   bool isSlowStartEnabled() const;
   bool noHostsAreInSlowStart() const;
@@ -548,12 +563,29 @@ protected:
 
 private:
   friend class EdfLoadBalancerBasePeer;
+  void rebuildHostSource(const HostsSource& source, HostVectorConstSharedPtr hosts);
+  // Returns false if the hosts are not the scheduler's hosts with the delta applied.
+  bool applyHostsDelta(Scheduler& scheduler, HostVectorConstSharedPtr hosts,
+                       const absl::flat_hash_set<const Host*>& added,
+                       const absl::flat_hash_set<const Host*>& removed);
   virtual void refreshHostSource(const HostsSource& source) PURE;
   virtual double hostWeight(const Host& host) const PURE;
   virtual HostConstSharedPtr unweightedHostPeek(const HostVector& hosts_to_use,
                                                 const HostsSource& source) PURE;
   virtual HostConstSharedPtr unweightedHostPick(const HostVector& hosts_to_use,
                                                 const HostsSource& source) PURE;
+  /**
+   * Called when a host source with weighted hosts is rebuilt, before its EDF scheduler is built.
+   * @param source supplies the host source.
+   * @param hosts supplies the hosts of the source.
+   * @return true if the hosts of the source are picked by weightedHostPick() rather than through
+   *         an EDF scheduler.
+   */
+  virtual bool buildWeightedHostSource(const HostsSource&, const HostVector&) { return false; }
+  /**
+   * Picks a host of a source for which buildWeightedHostSource() returned true.
+   */
+  virtual HostConstSharedPtr weightedHostPick(const HostsSource&) { return nullptr; }
 
   // Scheduler for each valid HostsSource.
   absl::flat_hash_map<HostsSource, Scheduler, HostsSourceHash> scheduler_;
@@ -710,12 +742,17 @@ public:
             least_request_config.has_active_request_bias()
                 ? absl::optional<Runtime::Double>(
                       {least_request_config.active_request_bias(), runtime})
-                : absl::nullopt) {
+                : absl::nullopt),
+        least_outstanding_requests_(
+            least_request_config.weighted_selection_method() ==
+            envoy::extensions::load_balancing_policies::least_request::v3::LeastRequest::
+                LEAST_OUTSTANDING_REQUESTS) {
     initialize();
   }
 
 protected:
-  void refresh(uint32_t priority) override {
+  void refresh(uint32_t priority, const HostVector& hosts_added,
+               const HostVector& hosts_removed) override {
     active_request_bias_ = active_request_bias_runtime_ != absl::nullopt
                                ? active_request_bias_runtime_.value().value()
                                : 1.0;
@@ -727,25 +764,37 @@ protected:
       active_request_bias_ = 1.0;
     }
 
-    EdfLoadBalancerBase::refresh(priority);
+    EdfLoadBalancerBase::refresh(priority, hosts_added, hosts_removed);
   }
 
 private:
-  void refreshHostSource(const HostsSource&) override {}
+  void refreshHostSource(const HostsSource& source) override { heaps_.erase(source); }
   double hostWeight(const Host& host) const override;
+  // Returns the weight of the host scaled by the given number of active requests.
+  double hostWeight(const Host& host, uint64_t active_requests) const;
   HostConstSharedPtr unweightedHostPeek(const HostVector& hosts_to_use,
                                         const HostsSource& source) override;
   HostConstSharedPtr unweightedHostPick(const HostVector& hosts_to_use,
                                         const HostsSource& source) override;
+  bool buildWeightedHostSource(const HostsSource& source, const HostVector& hosts) override;
+  HostConstSharedPtr weightedHostPick(const HostsSource& source) override;
 
   const uint32_t choice_count_;
 
   // The exponent used to calculate host weights can be configured via runtime. We cache it for
-  // performance reasons and refresh it in `LeastRequestLoadBalancer::refresh(uint32_t priority)`
+  // performance reasons and refresh it in `LeastRequestLoadBalancer::refresh()`
   // whenever a `HostSet` is updated.
   double active_request_bias_{};
 
   const absl::optional<Runtime::Double> active_request_bias_runtime_;
+
+  // Whether the weighted hosts are picked by their least outstanding requests rather than through
+  // the EDF scheduler.
+  const bool least_outstanding_requests_{};
+  // Heaps of the weighted host sources, used instead of the EDF schedulers when
+  // least_outstanding_requests_ is set and the active request bias is not 0.0.
+  absl::flat_hash_map<HostsSource, std::unique_ptr<LeastRequestHeap<const Host>>, HostsSourceHash>
+      heaps_;
 };
 
 /**
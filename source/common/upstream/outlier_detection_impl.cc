@@ -628,10 +628,12 @@ DetectorImpl::EjectionPair DetectorImpl::successRateEjectionThreshold(
   // threshold returned = 52
   double mean = success_rate_sum / valid_success_rate_hosts.size();
   double variance = 0;
-  std::for_each(valid_success_rate_hosts.begin(), valid_success_rate_hosts.end(),
-                [&variance, mean](HostSuccessRatePair v) {
-                  variance += std::pow(v.success_rate_ - mean, 2);
-                });
+  // Iterate by reference to not touch the reference count of every host, and square by
+  // multiplication rather than through std::pow().
+  for (const HostSuccessRatePair& v : valid_success_rate_hosts) {
+    const double deviation = v.success_rate_ - mean;
+    variance += deviation * deviation;
+  }
   variance /= valid_success_rate_hosts.size();
   double stdev = std::sqrt(variance);
 
@@ -742,7 +744,12 @@ void DetectorImpl::processSuccessRateEjections(
 void DetectorImpl::onIntervalTimer() {
   MonotonicTime now = time_source_.monotonicTime();
 
-  for (auto host : host_monitors_) {
+  if (Runtime::runtimeFeatureEnabled(
+          "envoy.reloadable_features.outlier_detection_coalesce_updates")) {
+    interval_changed_hosts_.emplace();
+  }
+
+  for (const auto& host : host_monitors_) {
     checkHostForUneject(host.first, host.second, now);
 
     // Need to update the writer bucket to keep the data valid.
@@ -757,7 +764,7 @@ void DetectorImpl::onIntervalTimer() {
   processSuccessRateEjections(DetectorHostMonitor::SuccessRateMonitorType::LocalOrigin);
 
   // Decrement time backoff for all hosts which have not been ejected.
-  for (auto host : host_monitors_) {
+  for (const auto& host : host_monitors_) {
     if (!host.first->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK)) {
       auto& monitor = host.second;
       // Node is healthy and was not ejected since the last check.
@@ -772,15 +779,34 @@ void DetectorImpl::onIntervalTimer() {
     }
   }
 
+  if (interval_changed_hosts_.has_value()) {
+    const HostVector changed_hosts = std::move(interval_changed_hosts_.value());
+    interval_changed_hosts_.reset();
+    if (!changed_hosts.empty()) {
+      runStatesCallbacks(changed_hosts);
+    }
+  }
+
   armIntervalTimer();
 }
 
 void DetectorImpl::runCallbacks(HostSharedPtr host) {
+  if (interval_changed_hosts_.has_value()) {
+    interval_changed_hosts_->push_back(host);
+  } else {
+    runStatesCallbacks({host});
+  }
   for (const ChangeStateCb& cb : callbacks_) {
     cb(host);
   }
 }
 
+void DetectorImpl::runStatesCallbacks(const HostVector& hosts) {
+  for (const ChangeStatesCb& cb : states_callbacks_) {
+    cb(hosts);
+  }
+}
+
 void EventLoggerImpl::logEject(const HostDescriptionConstSharedPtr& host, Detector& detector,
                                envoy::data::cluster::v3::OutlierEjectionType type, bool enforced) {
   envoy::data::cluster::v3::OutlierDetectionEvent event;
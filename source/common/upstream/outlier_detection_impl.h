@@ -387,6 +387,7 @@ public:
 
   // Upstream::Outlier::Detector
   void addChangedStateCb(ChangeStateCb cb) override { callbacks_.push_back(cb); }
+  void addChangedStatesCb(ChangeStatesCb cb) override { states_callbacks_.push_back(cb); }
   double
   successRateAverage(DetectorHostMonitor::SuccessRateMonitorType monitor_type) const override {
     return getSRNums(monitor_type).success_rate_average_;
@@ -435,6 +436,7 @@ private:
                                         envoy::data::cluster::v3::OutlierEjectionType type);
   void onIntervalTimer();
   void runCallbacks(HostSharedPtr host);
+  void runStatesCallbacks(const HostVector& hosts);
   bool enforceEjection(envoy::data::cluster::v3::OutlierEjectionType type);
   void updateEnforcedEjectionStats(envoy::data::cluster::v3::OutlierEjectionType type);
   void updateDetectedEjectionStats(envoy::data::cluster::v3::OutlierEjectionType type);
@@ -465,6 +467,11 @@ private:
   EjectionsActiveHelper ejections_active_helper_{stats_.ejections_active_};
   Event::TimerPtr interval_timer_;
   std::list<ChangeStateCb> callbacks_;
+  std::list<ChangeStatesCb> states_callbacks_;
+  // Hosts which changed state while the detection interval is processed. They are passed to the
+  // changed states callbacks at once at the end of the interval, so that the cluster updates its
+  // priority set a single time. Not set outside of the interval processing.
+  absl::optional<HostVector> interval_changed_hosts_;
   absl::node_hash_map<HostSharedPtr, DetectorHostMonitorImpl*> host_monitors_;
   EventLoggerSharedPtr event_logger_;
   Common::CallbackHandlePtr member_update_cb_;
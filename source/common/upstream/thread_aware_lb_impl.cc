@@ -90,54 +90,146 @@ void normalizeWeights(const HostSet& host_set, bool in_panic,
 } // namespace
 
 void ThreadAwareLoadBalancerBase::initialize() {
-  // TODO(mattklein123): In the future, once initialized and the initial LB is built, it would be
-  // better to use a background thread for computing LB updates. This has the substantial benefit
-  // that if the LB computation thread falls behind, host set updates can be trivially collapsed.
-  // I will look into doing this in a follow up. Doing everything using a background thread heavily
-  // complicated initialization as the load balancer would need its own initialized callback. I
-  // think the synchronous/asynchronous split is probably the best option.
+  // The initial build is done synchronously, so that the load balancer does not need its own
+  // initialized callback. Once a build pool is set, the following builds run in the background,
+  // and the host set updates received while a build is running are collapsed.
   priority_update_cb_ = priority_set_.addPriorityUpdateCb(
-      [this](uint32_t, const HostVector&, const HostVector&) -> void { refresh(); });
+      [this](uint32_t priority, const HostVector&, const HostVector&) -> void {
+        refresh(priority);
+      });
 
-  refresh();
+  build(*buildInput());
 }
 
-void ThreadAwareLoadBalancerBase::refresh() {
-  auto per_priority_state_vector = std::make_shared<std::vector<PerPriorityStatePtr>>(
-      priority_set_.hostSetsPerPriority().size());
-  auto healthy_per_priority_load =
+void ThreadAwareLoadBalancerBase::refresh(uint32_t updated_priority) {
+  // The weights are normalized on the main thread since this reads the host sets and may throw.
+  BuildInputPtr input = buildInput();
+  ASSERT(updated_priority < input->updated_priorities_.size());
+  input->updated_priorities_[updated_priority] = true;
+  if (build_pool_ == nullptr) {
+    build(*input);
+    return;
+  }
+
+  {
+    absl::MutexLock lock(&build_state_->mutex_);
+    if (build_state_->pending_ != nullptr) {
+      // The pending build is replaced, so the priorities it would have rebuilt are kept.
+      const auto& pending_updated = build_state_->pending_->updated_priorities_;
+      for (size_t i = 0; i < pending_updated.size() && i < input->updated_priorities_.size(); ++i) {
+        if (pending_updated[i]) {
+          input->updated_priorities_[i] = true;
+        }
+      }
+    }
+    build_state_->pending_ = std::move(input);
+    if (build_state_->scheduled_) {
+      return;
+    }
+    build_state_->scheduled_ = true;
+  }
+  // The build may run after this load balancer is destroyed, so it only uses the load balancer
+  // while building_ is set, which stopBackgroundBuilds() waits for.
+  build_pool_->post([state = build_state_, this]() { runBackgroundBuilds(state, *this); });
+}
+
+void ThreadAwareLoadBalancerBase::runBackgroundBuilds(const BuildStateSharedPtr& state,
+                                                      ThreadAwareLoadBalancerBase& lb) {
+  while (true) {
+    BuildInputPtr input;
+    {
+      absl::MutexLock lock(&state->mutex_);
+      if (state->stopped_ || state->pending_ == nullptr) {
+        state->scheduled_ = false;
+        return;
+      }
+      input = std::move(state->pending_);
+      state->building_ = true;
+    }
+    lb.build(*input);
+    {
+      absl::MutexLock lock(&state->mutex_);
+      state->building_ = false;
+    }
+  }
+}
+
+void ThreadAwareLoadBalancerBase::stopBackgroundBuilds() {
+  absl::MutexLock lock(&build_state_->mutex_);
+  build_state_->stopped_ = true;
+  build_state_->pending_.reset();
+  build_state_->mutex_.Await(absl::Condition(
+      +[](bool* building) { return !*building; }, &build_state_->building_));
+}
+
+ThreadAwareLoadBalancerBase::BuildInputPtr ThreadAwareLoadBalancerBase::buildInput() {
+  auto input = std::make_unique<BuildInput>();
+  input->per_priority_.resize(priority_set_.hostSetsPerPriority().size());
+  input->updated_priorities_.resize(input->per_priority_.size());
+  input->healthy_per_priority_load_ =
       std::make_shared<HealthyLoad>(per_priority_load_.healthy_priority_load_);
-  auto degraded_per_priority_load =
+  input->degraded_per_priority_load_ =
       std::make_shared<DegradedLoad>(per_priority_load_.degraded_priority_load_);
 
   for (const auto& host_set : priority_set_.hostSetsPerPriority()) {
     const uint32_t priority = host_set->priority();
-    (*per_priority_state_vector)[priority] = std::make_unique<PerPriorityState>();
-    const auto& per_priority_state = (*per_priority_state_vector)[priority];
+    PriorityBuildInput& priority_input = input->per_priority_[priority];
     // Copy panic flag from LoadBalancerBase. It is calculated when there is a change
     // in hosts set or hosts' health.
-    per_priority_state->global_panic_ = per_priority_panic_[priority];
+    priority_input.global_panic_ = per_priority_panic_[priority];
 
     // Normalize host and locality weights such that the sum of all normalized weights is 1.
-    NormalizedHostWeightVector normalized_host_weights;
-    double min_normalized_weight = 1.0;
-    double max_normalized_weight = 0.0;
-    normalizeWeights(*host_set, per_priority_state->global_panic_, normalized_host_weights,
-                     min_normalized_weight, max_normalized_weight, locality_weighted_balancing_);
-    per_priority_state->current_lb_ = createLoadBalancer(
-        std::move(normalized_host_weights), min_normalized_weight, max_normalized_weight);
+    normalizeWeights(*host_set, priority_input.global_panic_,
+                     priority_input.normalized_host_weights_, priority_input.min_normalized_weight_,
+                     priority_input.max_normalized_weight_, locality_weighted_balancing_);
+  }
+  return input;
+}
+
+void ThreadAwareLoadBalancerBase::build(BuildInput& input) {
+  const size_t num_priorities = input.per_priority_.size();
+  auto per_priority_state_vector =
+      std::make_shared<std::vector<PerPriorityStatePtr>>(num_priorities);
+  std::vector<HashingLoadBalancerSharedPtr> lbs(num_priorities);
+
+  for (size_t priority = 0; priority < num_priorities; ++priority) {
+    PriorityBuildInput& priority_input = input.per_priority_[priority];
+    (*per_priority_state_vector)[priority] = std::make_unique<PerPriorityState>();
+    const auto& per_priority_state = (*per_priority_state_vector)[priority];
+    per_priority_state->global_panic_ = priority_input.global_panic_;
+
+    // An update of one priority refreshes all of them, the other ones keep their table.
+    if (!input.updated_priorities_[priority] && priority < last_inputs_.size() &&
+        last_inputs_[priority].normalized_host_weights_ ==
+            priority_input.normalized_host_weights_ &&
+        last_inputs_[priority].global_panic_ == priority_input.global_panic_) {
+      lbs[priority] = last_lbs_[priority];
+    } else {
+      lbs[priority] = createLoadBalancer(priority_input.normalized_host_weights_,
+                                         priority_input.min_normalized_weight_,
+                                         priority_input.max_normalized_weight_);
+    }
+    per_priority_state->current_lb_ = lbs[priority];
   }
 
   {
     absl::WriterMutexLock lock(&factory_->mutex_);
-    factory_->healthy_per_priority_load_ = healthy_per_priority_load;
-    factory_->degraded_per_priority_load_ = degraded_per_priority_load;
+    factory_->healthy_per_priority_load_ = input.healthy_per_priority_load_;
+    factory_->degraded_per_priority_load_ = input.degraded_per_priority_load_;
     factory_->per_priority_state_ = per_priority_state_vector;
+    factory_->generation_++;
   }
+
+  last_inputs_ = std::move(input.per_priority_);
+  last_lbs_ = std::move(lbs);
 }
 
 HostConstSharedPtr
 ThreadAwareLoadBalancerBase::LoadBalancerImpl::chooseHost(LoadBalancerContext* context) {
+  if (factory_->generation_.load(std::memory_order_acquire) != generation_) {
+    factory_->copyState(*this);
+  }
+
   // Make sure we correctly return nullptr for any early chooseHost() calls.
   if (per_priority_state_ == nullptr) {
     return nullptr;
@@ -176,15 +268,19 @@ ThreadAwareLoadBalancerBase::LoadBalancerImpl::chooseHost(LoadBalancerContext* c
 }
 
 LoadBalancerPtr ThreadAwareLoadBalancerBase::LoadBalancerFactoryImpl::create(LoadBalancerParams) {
-  auto lb = std::make_unique<LoadBalancerImpl>(stats_, random_);
+  auto lb = std::make_unique<LoadBalancerImpl>(shared_from_this(), stats_, random_);
+  copyState(*lb);
+  return lb;
+}
 
+void ThreadAwareLoadBalancerBase::LoadBalancerFactoryImpl::copyState(LoadBalancerImpl& lb) {
   // We must protect current_lb_ via a RW lock since it is accessed and written to by multiple
   // threads. All complex processing has already been precalculated however.
   absl::ReaderMutexLock lock(&mutex_);
-  lb->healthy_per_priority_load_ = healthy_per_priority_load_;
-  lb->degraded_per_priority_load_ = degraded_per_priority_load_;
-  lb->per_priority_state_ = per_priority_state_;
-  return lb;
+  lb.healthy_per_priority_load_ = healthy_per_priority_load_;
+  lb.degraded_per_priority_load_ = degraded_per_priority_load_;
+  lb.per_priority_state_ = per_priority_state_;
+  lb.generation_ = generation_.load(std::memory_order_relaxed);
 }
 
 double ThreadAwareLoadBalancerBase::BoundedLoadHashingLoadBalancer::hostOverloadFactor(
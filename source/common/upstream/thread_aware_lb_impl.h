@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <bitset>
 
 #include "envoy/common/callback.h"
@@ -88,6 +89,9 @@ public:
   // Upstream::ThreadAwareLoadBalancer
   LoadBalancerFactorySharedPtr factory() override { return factory_; }
   void initialize() override;
+  void setBuildPool(LoadBalancerBuildPoolSharedPtr build_pool) override {
+    build_pool_ = std::move(build_pool);
+  }
 
   // Upstream::LoadBalancer
   HostConstSharedPtr chooseHost(LoadBalancerContext*) override { return nullptr; }
@@ -112,6 +116,13 @@ protected:
       : LoadBalancerBase(priority_set, stats, runtime, random, healthy_panic_threshold),
         factory_(new LoadBalancerFactoryImpl(stats, random)),
         locality_weighted_balancing_(locality_weighted_balancing) {}
+  ~ThreadAwareLoadBalancerBase() override { stopBackgroundBuilds(); }
+
+  /**
+   * Waits for a running background build to finish and drops the pending one. Must be called by
+   * the destructor of the derived class, since the builds call createLoadBalancer().
+   */
+  void stopBackgroundBuilds();
 
 private:
   struct PerPriorityState {
@@ -120,9 +131,39 @@ private:
   };
   using PerPriorityStatePtr = std::unique_ptr<PerPriorityState>;
 
+  // The inputs of a build, taken on the main thread when the host sets change.
+  struct PriorityBuildInput {
+    NormalizedHostWeightVector normalized_host_weights_;
+    double min_normalized_weight_{1.0};
+    double max_normalized_weight_{0.0};
+    bool global_panic_{};
+  };
+  struct BuildInput {
+    std::vector<PriorityBuildInput> per_priority_;
+    // The priorities whose host set was updated since the previous build.
+    std::vector<bool> updated_priorities_;
+    std::shared_ptr<HealthyLoad> healthy_per_priority_load_;
+    std::shared_ptr<DegradedLoad> degraded_per_priority_load_;
+  };
+  using BuildInputPtr = std::unique_ptr<BuildInput>;
+
+  // State shared with the build posted to the build pool. At most one build runs per load
+  // balancer at a time; the host set updates received meanwhile are collapsed into the latest one.
+  struct BuildState {
+    absl::Mutex mutex_;
+    BuildInputPtr pending_ ABSL_GUARDED_BY(mutex_);
+    bool scheduled_ ABSL_GUARDED_BY(mutex_){};
+    bool building_ ABSL_GUARDED_BY(mutex_){};
+    bool stopped_ ABSL_GUARDED_BY(mutex_){};
+  };
+  using BuildStateSharedPtr = std::shared_ptr<BuildState>;
+
+  struct LoadBalancerFactoryImpl;
+
   struct LoadBalancerImpl : public LoadBalancer {
-    LoadBalancerImpl(ClusterLbStats& stats, Random::RandomGenerator& random)
-        : stats_(stats), random_(random) {}
+    LoadBalancerImpl(std::shared_ptr<LoadBalancerFactoryImpl> factory, ClusterLbStats& stats,
+                     Random::RandomGenerator& random)
+        : factory_(std::move(factory)), stats_(stats), random_(random) {}
 
     // Upstream::LoadBalancer
     HostConstSharedPtr chooseHost(LoadBalancerContext* context) override;
@@ -138,14 +179,17 @@ private:
       return {};
     }
 
+    const std::shared_ptr<LoadBalancerFactoryImpl> factory_;
     ClusterLbStats& stats_;
     Random::RandomGenerator& random_;
+    uint64_t generation_{};
     std::shared_ptr<std::vector<PerPriorityStatePtr>> per_priority_state_;
     std::shared_ptr<HealthyLoad> healthy_per_priority_load_;
     std::shared_ptr<DegradedLoad> degraded_per_priority_load_;
   };
 
-  struct LoadBalancerFactoryImpl : public LoadBalancerFactory {
+  struct LoadBalancerFactoryImpl : public LoadBalancerFactory,
+                                   public std::enable_shared_from_this<LoadBalancerFactoryImpl> {
     LoadBalancerFactoryImpl(ClusterLbStats& stats, Random::RandomGenerator& random)
         : stats_(stats), random_(random) {}
 
@@ -153,8 +197,13 @@ private:
     // Ignore the params for the thread-aware LB.
     LoadBalancerPtr create(LoadBalancerParams) override;
 
+    void copyState(LoadBalancerImpl& lb);
+
     ClusterLbStats& stats_;
     Random::RandomGenerator& random_;
+    // Bumped on each published state, so that the worker load balancers created before a
+    // background build finished pick up its result.
+    std::atomic<uint64_t> generation_{};
     absl::Mutex mutex_;
     std::shared_ptr<std::vector<PerPriorityStatePtr>> per_priority_state_ ABSL_GUARDED_BY(mutex_);
     // This is split out of PerPriorityState so LoadBalancerBase::ChoosePriority can be reused.
@@ -165,11 +214,21 @@ private:
   virtual HashingLoadBalancerSharedPtr
   createLoadBalancer(const NormalizedHostWeightVector& normalized_host_weights,
                      double min_normalized_weight, double max_normalized_weight) PURE;
-  void refresh();
+  void refresh(uint32_t updated_priority);
+  BuildInputPtr buildInput();
+  void build(BuildInput& input);
+  static void runBackgroundBuilds(const BuildStateSharedPtr& state,
+                                  ThreadAwareLoadBalancerBase& lb);
 
   std::shared_ptr<LoadBalancerFactoryImpl> factory_;
   const bool locality_weighted_balancing_{};
   Common::CallbackHandlePtr priority_update_cb_;
+  LoadBalancerBuildPoolSharedPtr build_pool_;
+  const BuildStateSharedPtr build_state_{std::make_shared<BuildState>()};
+  // The inputs and results of the last build, used to skip rebuilding the priorities which were
+  // not updated. Only accessed by the builds, which never run concurrently.
+  std::vector<PriorityBuildInput> last_inputs_;
+  std::vector<HashingLoadBalancerSharedPtr> last_lbs_;
 };
 
 } // namespace Upstream
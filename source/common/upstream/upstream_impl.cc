@@ -397,24 +397,66 @@ HostDescriptionImpl::HostDescriptionImpl(
     const envoy::config::core::v3::Locality& locality,
     const envoy::config::endpoint::v3::Endpoint::HealthCheckConfig& health_check_config,
     uint32_t priority, TimeSource& time_source)
-    : cluster_(cluster), hostname_(hostname),
-      health_checks_hostname_(health_check_config.hostname()), address_(dest_address),
+    : HostDescriptionImpl(cluster, hostname, dest_address, metadata, makeLocality(locality),
+                          health_check_config, priority, time_source) {}
+
+HostDescriptionImpl::HostDescriptionImpl(
+    ClusterInfoConstSharedPtr cluster, const std::string& hostname,
+    Network::Address::InstanceConstSharedPtr dest_address, MetadataConstSharedPtr metadata,
+    LocalityConstSharedPtr locality,
+    const envoy::config::endpoint::v3::Endpoint::HealthCheckConfig& health_check_config,
+    uint32_t priority, TimeSource& time_source)
+    : cluster_(cluster), hostname_(hostname), address_(dest_address), metadata_(metadata),
+      locality_(std::move(locality)),
+      locality_zone_stat_name_(locality_->zone(), cluster->statsScope().symbolTable()),
+      socket_factory_(resolveTransportSocketFactory(dest_address, metadata_.get())),
+      creation_time_(time_source.monotonicTime()), priority_(priority),
       canary_(Config::Metadata::metadataValue(metadata.get(),
                                               Config::MetadataFilters::get().ENVOY_LB,
                                               Config::MetadataEnvoyLbKeys::get().CANARY)
-                  .bool_value()),
-      metadata_(metadata), locality_(locality),
-      locality_zone_stat_name_(locality.zone(), cluster->statsScope().symbolTable()),
-      priority_(priority),
-      socket_factory_(resolveTransportSocketFactory(dest_address, metadata_.get())),
-      creation_time_(time_source.monotonicTime()) {
+                  .bool_value()) {
   if (health_check_config.port_value() != 0 && dest_address->type() != Network::Address::Type::Ip) {
     // Setting the health check port to non-0 only works for IP-type addresses. Setting the port
     // for a pipe address is a misconfiguration. Throw an exception.
     throw EnvoyException(
         fmt::format("Invalid host configuration: non-zero port for non-IP address"));
   }
-  health_check_address_ = resolveHealthCheckAddress(health_check_config, dest_address);
+  if (!health_check_config.hostname().empty()) {
+    health_check_overrides_ = std::make_unique<HealthCheckOverrides>();
+    health_check_overrides_->hostname_ = health_check_config.hostname();
+  }
+  setHealthCheckAddress(resolveHealthCheckAddress(health_check_config, dest_address));
+}
+
+HostDescriptionImpl::~HostDescriptionImpl() { delete stats_.load(); }
+
+LocalityConstSharedPtr
+HostDescriptionImpl::makeLocality(const envoy::config::core::v3::Locality& locality) {
+  if (locality.region().empty() && locality.zone().empty() && locality.sub_zone().empty()) {
+    // Alias the default instance, which is never deleted.
+    return LocalityConstSharedPtr(LocalityConstSharedPtr(),
+                                  &envoy::config::core::v3::Locality::default_instance());
+  }
+  return std::make_shared<const envoy::config::core::v3::Locality>(locality);
+}
+
+const HostStats& HostDescriptionImpl::statsIfAllocated() const {
+  const HostStats* stats = stats_.load(std::memory_order_acquire);
+  if (stats != nullptr) {
+    return *stats;
+  }
+  static const HostStats* unused_stats = new HostStats();
+  return *unused_stats;
+}
+
+HostStats& HostDescriptionImpl::allocateStats() const {
+  auto stats = std::make_unique<HostStats>();
+  HostStats* expected = nullptr;
+  // Another thread may allocate the stats concurrently, in which case its stats are used.
+  if (!stats_.compare_exchange_strong(expected, stats.get(), std::memory_order_acq_rel)) {
+    return *expected;
+  }
+  return *stats.release();
 }
 
 Network::UpstreamTransportSocketFactory& HostDescriptionImpl::resolveTransportSocketFactory(
@@ -1076,6 +1118,7 @@ ClusterInfoImpl::ClusterInfoImpl(
       drain_connections_on_host_removal_(config.ignore_health_on_host_removal()),
       connection_pool_per_downstream_connection_(
           config.connection_pool_per_downstream_connection()),
+      share_connection_pools_across_workers_(config.share_connection_pools_across_workers()),
       warm_hosts_(!config.health_checks().empty() &&
                   common_lb_config_->ignore_new_hosts_until_first_hc()),
       set_local_interface_name_on_upstream_connections_(
@@ -1207,6 +1250,12 @@ ClusterInfoImpl::ClusterInfoImpl(
     optional_timeouts_.set<OptionalTimeoutNames::MaxConnectionDuration>(*max_connection_duration);
   }
 
+  if (config.preconnect_policy().has_adaptive_preconnect_window()) {
+    optional_timeouts_.set<OptionalTimeoutNames::AdaptivePreconnectWindow>(
+        std::chrono::milliseconds(DurationUtil::durationToMilliseconds(
+            config.preconnect_policy().adaptive_preconnect_window())));
+  }
+
   if (config.has_eds_cluster_config()) {
     if (config.type() != envoy::config::cluster::v3::Cluster::EDS) {
       throw EnvoyException("eds_cluster_config set in a non-EDS cluster");
@@ -1425,6 +1474,9 @@ ClusterImplBase::ClusterImplBase(const envoy::config::cluster::v3::Cluster& clus
       local_cluster_(cluster_context.clusterManager().localClusterName().value_or("") ==
                      cluster.name()),
       const_metadata_shared_pool_(Config::Metadata::getConstMetadataSharedPool(
+          cluster_context.serverFactoryContext().singletonManager(),
+          cluster_context.serverFactoryContext().mainThreadDispatcher())),
+      const_locality_shared_pool_(getConstLocalitySharedPool(
           cluster_context.serverFactoryContext().singletonManager(),
           cluster_context.serverFactoryContext().mainThreadDispatcher())) {
 
@@ -1617,7 +1669,7 @@ void ClusterImplBase::finishInitialization() {
   initialization_complete_callback_ = nullptr;
 
   if (health_checker_ != nullptr) {
-    reloadHealthyHosts(nullptr);
+    reloadHealthyHosts({});
   }
 
   if (snapped_callback != nullptr) {
@@ -1634,7 +1686,7 @@ void ClusterImplBase::setHealthChecker(const HealthCheckerSharedPtr& health_chec
         // If we get a health check completion that resulted in a state change, signal to
         // update the host sets on all threads.
         if (changed_state == HealthTransition::Changed) {
-          reloadHealthyHosts(host);
+          reloadHealthyHosts({host});
         }
       });
 }
@@ -1645,11 +1697,14 @@ void ClusterImplBase::setOutlierDetector(const Outlier::DetectorSharedPtr& outli
   }
 
   outlier_detector_ = outlier_detector;
-  outlier_detector_->addChangedStateCb(
-      [this](const HostSharedPtr& host) -> void { reloadHealthyHosts(host); });
+  outlier_detector_->addChangedStatesCb([this](const HostVector& hosts) -> void {
+    // The hosts changing state together are reloaded with a single update.
+    ASSERT(!hosts.empty());
+    reloadHealthyHosts(hosts);
+  });
 }
 
-void ClusterImplBase::reloadHealthyHosts(const HostSharedPtr& host) {
+void ClusterImplBase::reloadHealthyHosts(const HostVector& hosts) {
   // Every time a host changes Health Check state we cause a full healthy host recalculation which
   // for expensive LBs (ring, subset, etc.) can be quite time consuming. During startup, this
   // can also block worker threads by doing this repeatedly. There is no reason to do this
@@ -1659,10 +1714,10 @@ void ClusterImplBase::reloadHealthyHosts(const HostSharedPtr& host) {
     return;
   }
 
-  reloadHealthyHostsHelper(host);
+  reloadHealthyHostsHelper(hosts);
 }
 
-void ClusterImplBase::reloadHealthyHostsHelper(const HostSharedPtr&) {
+void ClusterImplBase::reloadHealthyHostsHelper(const HostVector&) {
   const auto& host_sets = prioritySet().hostSetsPerPriority();
   for (size_t priority = 0; priority < host_sets.size(); ++priority) {
     const auto& host_set = host_sets[priority];
@@ -1916,7 +1971,7 @@ void PriorityStateManager::initializePriorityFor(
   }
 }
 
-void PriorityStateManager::registerHostForPriority(
+HostSharedPtr PriorityStateManager::registerHostForPriority(
     const std::string& hostname, Network::Address::InstanceConstSharedPtr address,
     const std::vector<Network::Address::InstanceConstSharedPtr>& address_list,
     const envoy::config::endpoint::v3::LocalityLbEndpoints& locality_lb_endpoint,
@@ -1924,14 +1979,16 @@ void PriorityStateManager::registerHostForPriority(
   auto metadata = lb_endpoint.has_metadata()
                       ? parent_.constMetadataSharedPool()->getObject(lb_endpoint.metadata())
                       : nullptr;
-  const auto host = std::make_shared<HostImpl>(
+  auto host = std::make_shared<HostImpl>(
       parent_.info(), hostname, address, metadata, lb_endpoint.load_balancing_weight().value(),
-      locality_lb_endpoint.locality(), lb_endpoint.endpoint().health_check_config(),
-      locality_lb_endpoint.priority(), lb_endpoint.health_status(), time_source);
+      parent_.constLocalitySharedPool()->getObject(locality_lb_endpoint.locality()),
+      lb_endpoint.endpoint().health_check_config(), locality_lb_endpoint.priority(),
+      lb_endpoint.health_status(), time_source);
   if (!address_list.empty()) {
     host->setAddressList(address_list);
   }
   registerHostForPriority(host, locality_lb_endpoint);
+  return host;
 }
 
 void PriorityStateManager::registerHostForPriority(
@@ -2356,5 +2413,17 @@ Network::Address::InstanceConstSharedPtr resolveHealthCheckAddress(
   return health_check_address;
 }
 
+SINGLETON_MANAGER_REGISTRATION(const_locality_shared_pool);
+
+ConstLocalitySharedPoolSharedPtr getConstLocalitySharedPool(Singleton::Manager& manager,
+                                                            Event::Dispatcher& dispatcher) {
+  return manager.getTyped<SharedPool::ObjectSharedPool<const envoy::config::core::v3::Locality,
+                                                       LocalityHash, LocalityEqualTo>>(
+      SINGLETON_MANAGER_REGISTERED_NAME(const_locality_shared_pool), [&dispatcher] {
+        return std::make_shared<SharedPool::ObjectSharedPool<
+            const envoy::config::core::v3::Locality, LocalityHash, LocalityEqualTo>>(dispatcher);
+      });
+}
+
 } // namespace Upstream
 } // namespace Envoy
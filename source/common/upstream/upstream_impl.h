@@ -73,6 +73,11 @@ namespace Upstream {
 
 using ClusterProto = envoy::config::cluster::v3::Cluster;
 
+using LocalityConstSharedPtr = std::shared_ptr<const envoy::config::core::v3::Locality>;
+using ConstLocalitySharedPoolSharedPtr =
+    std::shared_ptr<SharedPool::ObjectSharedPool<const envoy::config::core::v3::Locality,
+                                                 LocalityHash, LocalityEqualTo>>;
+
 using UpstreamNetworkFilterConfigProviderManager =
     Filter::FilterConfigProviderManager<Network::FilterFactoryCb,
                                         Server::Configuration::UpstreamFactoryContext>;
@@ -194,6 +199,19 @@ public:
       const envoy::config::core::v3::Locality& locality,
       const envoy::config::endpoint::v3::Endpoint::HealthCheckConfig& health_check_config,
       uint32_t priority, TimeSource& time_source);
+  // The locality may be shared with other hosts, @see ClusterImplBase::constLocalitySharedPool().
+  HostDescriptionImpl(
+      ClusterInfoConstSharedPtr cluster, const std::string& hostname,
+      Network::Address::InstanceConstSharedPtr dest_address, MetadataConstSharedPtr metadata,
+      LocalityConstSharedPtr locality,
+      const envoy::config::endpoint::v3::Endpoint::HealthCheckConfig& health_check_config,
+      uint32_t priority, TimeSource& time_source);
+  ~HostDescriptionImpl() override;
+
+  /**
+   * @return a locality to share with a host, which does not allocate for the empty locality.
+   */
+  static LocalityConstSharedPtr makeLocality(const envoy::config::core::v3::Locality& locality);
 
   Network::UpstreamTransportSocketFactory& transportSocketFactory() const override {
     absl::ReaderMutexLock lock(&metadata_mutex_);
@@ -249,18 +267,26 @@ public:
     static DetectorHostMonitorNullImpl* null_outlier_detector = new DetectorHostMonitorNullImpl();
     return *null_outlier_detector;
   }
-  HostStats& stats() const override { return stats_; }
+  HostStats& stats() const override {
+    HostStats* stats = stats_.load(std::memory_order_acquire);
+    return stats != nullptr ? *stats : allocateStats();
+  }
   LoadMetricStats& loadMetricStats() const override { return load_metric_stats_; }
-  const std::string& hostnameForHealthChecks() const override { return health_checks_hostname_; }
+  const std::string& hostnameForHealthChecks() const override {
+    return health_check_overrides_ != nullptr ? health_check_overrides_->hostname_ : EMPTY_STRING;
+  }
   const std::string& hostname() const override { return hostname_; }
   Network::Address::InstanceConstSharedPtr address() const override { return address_; }
   const std::vector<Network::Address::InstanceConstSharedPtr>& addressList() const override {
     return address_list_;
   }
   Network::Address::InstanceConstSharedPtr healthCheckAddress() const override {
-    return health_check_address_;
+    if (health_check_overrides_ != nullptr && health_check_overrides_->address_ != nullptr) {
+      return health_check_overrides_->address_;
+    }
+    return address_;
   }
-  const envoy::config::core::v3::Locality& locality() const override { return locality_; }
+  const envoy::config::core::v3::Locality& locality() const override { return *locality_; }
   Stats::StatName localityZoneStatName() const override {
     return locality_zone_stat_name_.statName();
   }
@@ -280,7 +306,17 @@ protected:
   void setAddress(Network::Address::InstanceConstSharedPtr address) { address_ = address; }
 
   void setHealthCheckAddress(Network::Address::InstanceConstSharedPtr address) {
-    health_check_address_ = address;
+    // Most hosts are health checked on their own address, which is not stored twice.
+    if (address == address_) {
+      if (health_check_overrides_ != nullptr) {
+        health_check_overrides_->address_ = nullptr;
+      }
+      return;
+    }
+    if (health_check_overrides_ == nullptr) {
+      health_check_overrides_ = std::make_unique<HealthCheckOverrides>();
+    }
+    health_check_overrides_->address_ = std::move(address);
   }
 
   void setHealthCheckerImpl(HealthCheckHostMonitorPtr&& health_checker) {
@@ -295,28 +331,44 @@ protected:
     last_hc_pass_time_.emplace(std::move(last_hc_pass_time));
   }
 
+  /**
+   * @return the stats of the host, or zeroed stats if they were never used, without allocating
+   *         them.
+   */
+  const HostStats& statsIfAllocated() const;
+
 private:
+  // The health check settings of the few hosts which do not use the ones of the host.
+  struct HealthCheckOverrides {
+    std::string hostname_;
+    // nullptr if the health checks use the address of the host.
+    Network::Address::InstanceConstSharedPtr address_;
+  };
+
+  HostStats& allocateStats() const;
+
+  // The members are laid out to keep the hosts of large clusters small: the locality is shared
+  // between the hosts, and the stats and health check overrides are only allocated when used.
   ClusterInfoConstSharedPtr cluster_;
   const std::string hostname_;
-  const std::string health_checks_hostname_;
   Network::Address::InstanceConstSharedPtr address_;
   // The first entry in the address_list_ should match the value in address_.
   std::vector<Network::Address::InstanceConstSharedPtr> address_list_;
-  Network::Address::InstanceConstSharedPtr health_check_address_;
-  std::atomic<bool> canary_;
+  std::unique_ptr<HealthCheckOverrides> health_check_overrides_;
   mutable absl::Mutex metadata_mutex_;
   MetadataConstSharedPtr metadata_ ABSL_GUARDED_BY(metadata_mutex_);
-  const envoy::config::core::v3::Locality locality_;
+  const LocalityConstSharedPtr locality_;
   Stats::StatNameDynamicStorage locality_zone_stat_name_;
-  mutable HostStats stats_;
+  mutable std::atomic<HostStats*> stats_{};
   mutable LoadMetricStatsImpl load_metric_stats_;
   Outlier::DetectorHostMonitorPtr outlier_detector_;
   HealthCheckHostMonitorPtr health_checker_;
-  std::atomic<uint32_t> priority_;
   std::reference_wrapper<Network::UpstreamTransportSocketFactory>
       socket_factory_ ABSL_GUARDED_BY(metadata_mutex_);
   const MonotonicTime creation_time_;
   absl::optional<MonotonicTime> last_hc_pass_time_;
+  std::atomic<uint32_t> priority_;
+  std::atomic<bool> canary_;
 };
 
 /**
@@ -332,8 +384,16 @@ public:
            const envoy::config::endpoint::v3::Endpoint::HealthCheckConfig& health_check_config,
            uint32_t priority, const envoy::config::core::v3::HealthStatus health_status,
            TimeSource& time_source)
-      : HostDescriptionImpl(cluster, hostname, address, metadata, locality, health_check_config,
-                            priority, time_source),
+      : HostImpl(cluster, hostname, address, metadata, initial_weight, makeLocality(locality),
+                 health_check_config, priority, health_status, time_source) {}
+  HostImpl(ClusterInfoConstSharedPtr cluster, const std::string& hostname,
+           Network::Address::InstanceConstSharedPtr address, MetadataConstSharedPtr metadata,
+           uint32_t initial_weight, LocalityConstSharedPtr locality,
+           const envoy::config::endpoint::v3::Endpoint::HealthCheckConfig& health_check_config,
+           uint32_t priority, const envoy::config::core::v3::HealthStatus health_status,
+           TimeSource& time_source)
+      : HostDescriptionImpl(cluster, hostname, address, metadata, std::move(locality),
+                            health_check_config, priority, time_source),
         disable_active_health_check_(health_check_config.disable_active_health_check()) {
     // This EDS flags setting is still necessary for stats, configuration dump, canonical
     // coarseHealth() etc.
@@ -349,7 +409,7 @@ public:
   // Upstream::Host
   std::vector<std::pair<absl::string_view, Stats::PrimitiveCounterReference>>
   counters() const override {
-    return stats().counters();
+    return statsIfAllocated().counters();
   }
   CreateConnectionData createConnection(
       Event::Dispatcher& dispatcher, const Network::ConnectionSocket::OptionsSharedPtr& options,
@@ -361,7 +421,7 @@ public:
 
   std::vector<std::pair<absl::string_view, Stats::PrimitiveGaugeReference>>
   gauges() const override {
-    return stats().gauges();
+    return statsIfAllocated().gauges();
   }
   void healthFlagClear(HealthFlag flag) override { health_flags_ &= ~enumToInt(flag); }
   bool healthFlagGet(HealthFlag flag) const override { return health_flags_ & enumToInt(flag); }
@@ -837,8 +897,13 @@ public:
   // `OptionalTimeouts` manages various `optional` values. We pack them in a separate data
   // structure for memory efficiency -- avoiding overhead of `absl::optional` per variable, and
   // avoiding overhead of storing unset timeouts.
-  enum class OptionalTimeoutNames { IdleTimeout = 0, TcpPoolIdleTimeout, MaxConnectionDuration };
-  using OptionalTimeouts = PackedStruct<std::chrono::milliseconds, 3, OptionalTimeoutNames>;
+  enum class OptionalTimeoutNames {
+    IdleTimeout = 0,
+    TcpPoolIdleTimeout,
+    MaxConnectionDuration,
+    AdaptivePreconnectWindow
+  };
+  using OptionalTimeouts = PackedStruct<std::chrono::milliseconds, 4, OptionalTimeoutNames>;
 
   const absl::optional<std::chrono::milliseconds> idleTimeout() const override {
     auto timeout = optional_timeouts_.get<OptionalTimeoutNames::IdleTimeout>();
@@ -864,6 +929,13 @@ public:
 
   float perUpstreamPreconnectRatio() const override { return per_upstream_preconnect_ratio_; }
   float peekaheadRatio() const override { return peekahead_ratio_; }
+  const absl::optional<std::chrono::milliseconds> adaptivePreconnectWindow() const override {
+    auto window = optional_timeouts_.get<OptionalTimeoutNames::AdaptivePreconnectWindow>();
+    if (window.has_value()) {
+      return *window;
+    }
+    return absl::nullopt;
+  }
   uint32_t perConnectionBufferLimitBytes() const override {
     return per_connection_buffer_limit_bytes_;
   }
@@ -1008,6 +1080,9 @@ public:
   bool connectionPoolPerDownstreamConnection() const override {
     return connection_pool_per_downstream_connection_;
   }
+  bool shareConnectionPoolsAcrossWorkers() const override {
+    return share_connection_pools_across_workers_;
+  }
   bool warmHosts() const override { return warm_hosts_; }
   bool setLocalInterfaceNameOnUpstreamConnections() const override {
     return set_local_interface_name_on_upstream_connections_;
@@ -1147,6 +1222,7 @@ private:
   const envoy::config::cluster::v3::Cluster::DiscoveryType type_;
   const bool drain_connections_on_host_removal_ : 1;
   const bool connection_pool_per_downstream_connection_ : 1;
+  const bool share_connection_pools_across_workers_ : 1;
   const bool warm_hosts_ : 1;
   const bool set_local_interface_name_on_upstream_connections_ : 1;
   const bool added_via_api_ : 1;
@@ -1209,6 +1285,8 @@ public:
   Config::ConstMetadataSharedPoolSharedPtr constMetadataSharedPool() {
     return const_metadata_shared_pool_;
   }
+  // Interns the localities of the hosts, which the hosts of a locality share.
+  ConstLocalitySharedPoolSharedPtr constLocalitySharedPool() { return const_locality_shared_pool_; }
 
   // Upstream::Cluster
   HealthChecker* healthChecker() override { return health_checker_.get(); }
@@ -1241,7 +1319,11 @@ protected:
    */
   void onInitDone();
 
-  virtual void reloadHealthyHostsHelper(const HostSharedPtr& host);
+  /**
+   * Recomputes the healthy hosts of all the priorities with a single update.
+   * @param hosts supplies the hosts whose health changed, if any.
+   */
+  virtual void reloadHealthyHostsHelper(const HostVector& hosts);
 
   // This init manager is shared via TransportSocketFactoryContext. The initialization targets that
   // register with this init manager are expected to be for implementations of SdsApi (see
@@ -1272,13 +1354,14 @@ private:
   static const absl::string_view DoNotValidateAlpnRuntimeKey;
 
   void finishInitialization();
-  void reloadHealthyHosts(const HostSharedPtr& host);
+  void reloadHealthyHosts(const HostVector& hosts);
 
   bool initialization_started_{};
   std::function<void()> initialization_complete_callback_;
   uint64_t pending_initialize_health_checks_{};
   const bool local_cluster_;
   Config::ConstMetadataSharedPoolSharedPtr const_metadata_shared_pool_;
+  ConstLocalitySharedPoolSharedPtr const_locality_shared_pool_;
   Common::CallbackHandlePtr priority_update_cb_;
 };
 
@@ -1302,8 +1385,8 @@ public:
   // priority is specified by locality_lb_endpoint.priority()).
   //
   // The specified health_checker_flag is used to set the registered-host's health-flag when the
-  // lb_endpoint health status is unhealthy, draining or timeout.
-  void registerHostForPriority(
+  // lb_endpoint health status is unhealthy, draining or timeout. Returns the registered host.
+  HostSharedPtr registerHostForPriority(
       const std::string& hostname, Network::Address::InstanceConstSharedPtr address,
       const std::vector<Network::Address::InstanceConstSharedPtr>& address_list,
       const envoy::config::endpoint::v3::LocalityLbEndpoints& locality_lb_endpoint,
@@ -1386,5 +1469,11 @@ Network::Address::InstanceConstSharedPtr resolveHealthCheckAddress(
     const envoy::config::endpoint::v3::Endpoint::HealthCheckConfig& health_check_config,
     Network::Address::InstanceConstSharedPtr host_address);
 
+/**
+ * @return the pool interning the localities of the hosts of all the clusters.
+ */
+ConstLocalitySharedPoolSharedPtr getConstLocalitySharedPool(Singleton::Manager& manager,
+                                                            Event::Dispatcher& dispatcher);
+
 } // namespace Upstream
 } // namespace Envoy
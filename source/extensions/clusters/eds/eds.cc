@@ -1,5 +1,7 @@
 #include "source/extensions/clusters/eds/eds.h"
 
+#include <algorithm>
+
 #include "envoy/common/exception.h"
 #include "envoy/config/cluster/v3/cluster.pb.h"
 #include "envoy/config/core/v3/config_source.pb.h"
@@ -9,6 +11,11 @@
 #include "source/common/common/utility.h"
 #include "source/common/config/api_version.h"
 #include "source/common/config/decoded_resource_impl.h"
+#include "source/common/protobuf/utility.h"
+#include "source/common/runtime/runtime_features.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/hash/hash.h"
 
 namespace Envoy {
 namespace Upstream {
@@ -48,9 +55,22 @@ EdsClusterImpl::~EdsClusterImpl() {
 
 void EdsClusterImpl::startPreInit() { subscription_->start({edsServiceName()}); }
 
+EdsClusterImpl::BatchUpdateHelper::BatchUpdateHelper(
+    EdsClusterImpl& parent,
+    const envoy::config::endpoint::v3::ClusterLoadAssignment& cluster_load_assignment)
+    : parent_(parent), cluster_load_assignment_(cluster_load_assignment),
+      reuse_hosts_(Runtime::runtimeFeatureEnabled(
+          "envoy.reloadable_features.eds_reuse_unchanged_hosts")) {}
+
 void EdsClusterImpl::BatchUpdateHelper::batchUpdate(PrioritySet::HostUpdateCb& host_update_cb) {
   absl::flat_hash_set<std::string> all_new_hosts;
   PriorityStateManager priority_state_manager(parent_, parent_.local_info_, &host_update_cb);
+
+  // Get the map of all the latest existing hosts, which is used to filter out the existing
+  // hosts in the process of updating cluster memberships.
+  HostMapConstSharedPtr all_hosts = parent_.prioritySet().crossPriorityHostMap();
+  ASSERT(all_hosts != nullptr);
+
   for (const auto& locality_lb_endpoint : cluster_load_assignment_.endpoints()) {
     parent_.validateEndpointsForZoneAwareRouting(locality_lb_endpoint);
 
@@ -68,24 +88,47 @@ void EdsClusterImpl::BatchUpdateHelper::batchUpdate(PrioritySet::HostUpdateCb& h
       for (const auto& [_, lb_endpoint] :
            parent_.leds_localities_[leds_config]->getEndpointsMap()) {
         updateLocalityEndpoints(lb_endpoint, locality_lb_endpoint, priority_state_manager,
-                                all_new_hosts);
+                                all_new_hosts, *all_hosts, nullptr, nullptr);
       }
-    } else {
+      continue;
+    }
+
+    if (!reuse_hosts_) {
       for (const auto& lb_endpoint : locality_lb_endpoint.lb_endpoints()) {
         updateLocalityEndpoints(lb_endpoint, locality_lb_endpoint, priority_state_manager,
-                                all_new_hosts);
+                                all_new_hosts, *all_hosts, nullptr, nullptr);
       }
+      continue;
+    }
+
+    // The endpoints of a locality which did not change are not looked at again.
+    const uint64_t locality_hash = MessageUtil::hash(locality_lb_endpoint);
+    if (reuseLocalityHosts(locality_hash, locality_lb_endpoint, priority_state_manager,
+                           all_new_hosts, *all_hosts)) {
+      continue;
+    }
+    auto stored_locality =
+        std::make_shared<const envoy::config::endpoint::v3::LocalityLbEndpoints>(
+            locality_lb_endpoint);
+    EndpointHosts locality_hosts;
+    for (const auto& lb_endpoint : stored_locality->lb_endpoints()) {
+      updateLocalityEndpoints(
+          lb_endpoint, locality_lb_endpoint, priority_state_manager, all_new_hosts, *all_hosts,
+          &locality_hosts,
+          std::shared_ptr<const envoy::config::endpoint::v3::LbEndpoint>(stored_locality,
+                                                                          &lb_endpoint));
+    }
+    // A locality some endpoints of which duplicate the address of an endpoint of another locality
+    // is not reused, as its hosts depend on the other localities.
+    if (locality_hosts.size() == static_cast<size_t>(locality_lb_endpoint.lb_endpoints_size())) {
+      locality_hosts_.emplace(locality_hash,
+                              LocalityHosts{std::move(stored_locality), std::move(locality_hosts)});
     }
   }
 
   // Track whether we rebuilt any LB structures.
   bool cluster_rebuilt = false;
 
-  // Get the map of all the latest existing hosts, which is used to filter out the existing
-  // hosts in the process of updating cluster memberships.
-  HostMapConstSharedPtr all_hosts = parent_.prioritySet().crossPriorityHostMap();
-  ASSERT(all_hosts != nullptr);
-
   const uint32_t overprovisioning_factor = PROTOBUF_GET_WRAPPED_OR_DEFAULT(
       cluster_load_assignment_.policy(), overprovisioning_factor, kDefaultOverProvisioningFactor);
   const bool weighted_priority_health =
@@ -130,15 +173,98 @@ void EdsClusterImpl::BatchUpdateHelper::batchUpdate(PrioritySet::HostUpdateCb& h
     parent_.info_->configUpdateStats().update_no_rebuild_.inc();
   }
 
+  // The membership update keeps the existing host of an address in place of the host registered
+  // for it, so the next update reuses the hosts the cluster has.
+  HostMapConstSharedPtr updated_hosts = parent_.prioritySet().crossPriorityHostMap();
+  const auto current_host = [&updated_hosts](EndpointHost& endpoint_host) {
+    auto updated_host = updated_hosts->find(endpoint_host.host_->address()->asString());
+    if (updated_host == updated_hosts->end()) {
+      return false;
+    }
+    endpoint_host.host_ = updated_host->second;
+    return true;
+  };
+  absl::erase_if(endpoint_hosts_,
+                 [&current_host](auto& entry) { return !current_host(entry.second); });
+  absl::erase_if(locality_hosts_, [&current_host](auto& entry) {
+    return !std::all_of(entry.second.hosts_.begin(), entry.second.hosts_.end(), current_host);
+  });
+  parent_.locality_hosts_ = std::move(locality_hosts_);
+  parent_.endpoint_hosts_ = std::move(endpoint_hosts_);
+
   // If we didn't setup to initialize when our first round of health checking is complete, just
   // do it now.
   parent_.onPreInitComplete();
 }
 
+bool EdsClusterImpl::BatchUpdateHelper::reuseLocalityHosts(
+    uint64_t locality_hash,
+    const envoy::config::endpoint::v3::LocalityLbEndpoints& locality_lb_endpoint,
+    PriorityStateManager& priority_state_manager, absl::flat_hash_set<std::string>& all_new_hosts,
+    const HostMap& all_hosts) {
+  auto locality_hosts = parent_.locality_hosts_.find(locality_hash);
+  // The hash only tells which locality to compare with.
+  if (locality_hosts == parent_.locality_hosts_.end() ||
+      !Protobuf::util::MessageDifferencer::Equals(
+          *locality_hosts->second.locality_lb_endpoint_, locality_lb_endpoint)) {
+    return false;
+  }
+  // The hosts must still be the current hosts of their addresses, which they are not if e.g. they
+  // were removed after failing health checks.
+  for (const EndpointHost& endpoint_host : locality_hosts->second.hosts_) {
+    auto existing_host = all_hosts.find(endpoint_host.host_->address()->asString());
+    if (existing_host == all_hosts.end() || existing_host->second != endpoint_host.host_ ||
+        all_new_hosts.contains(existing_host->first)) {
+      return false;
+    }
+  }
+  for (const EndpointHost& endpoint_host : locality_hosts->second.hosts_) {
+    priority_state_manager.registerHostForPriority(endpoint_host.host_, locality_lb_endpoint);
+    all_new_hosts.emplace(endpoint_host.host_->address()->asString());
+    endpoint_hosts_.emplace(endpoint_host.endpoint_hash_, endpoint_host);
+  }
+  locality_hosts_.emplace(locality_hash, std::move(locality_hosts->second));
+  parent_.locality_hosts_.erase(locality_hosts);
+  return true;
+}
+
 void EdsClusterImpl::BatchUpdateHelper::updateLocalityEndpoints(
     const envoy::config::endpoint::v3::LbEndpoint& lb_endpoint,
     const envoy::config::endpoint::v3::LocalityLbEndpoints& locality_lb_endpoint,
-    PriorityStateManager& priority_state_manager, absl::flat_hash_set<std::string>& all_new_hosts) {
+    PriorityStateManager& priority_state_manager, absl::flat_hash_set<std::string>& all_new_hosts,
+    const HostMap& all_hosts, EndpointHosts* locality_hosts,
+    std::shared_ptr<const envoy::config::endpoint::v3::LbEndpoint> stored_lb_endpoint) {
+  uint64_t endpoint_hash = 0;
+  if (reuse_hosts_) {
+    // An endpoint which did not change since the previous update reuses its existing host, which
+    // the membership update would otherwise keep in place of a new one.
+    endpoint_hash = absl::HashOf(MessageUtil::hash(lb_endpoint),
+                                 LocalityHash()(locality_lb_endpoint.locality()),
+                                 locality_lb_endpoint.priority());
+    auto endpoint_host = parent_.endpoint_hosts_.find(endpoint_hash);
+    if (endpoint_host != parent_.endpoint_hosts_.end() &&
+        sameEndpoint(endpoint_host->second, lb_endpoint, locality_lb_endpoint)) {
+      const HostSharedPtr& host = endpoint_host->second.host_;
+      auto existing_host = all_hosts.find(host->address()->asString());
+      if (existing_host != all_hosts.end() && existing_host->second == host) {
+        if (all_new_hosts.contains(existing_host->first)) {
+          return;
+        }
+        priority_state_manager.registerHostForPriority(host, locality_lb_endpoint);
+        all_new_hosts.emplace(existing_host->first);
+        if (stored_lb_endpoint == nullptr) {
+          stored_lb_endpoint = endpoint_host->second.lb_endpoint_;
+        }
+        EndpointHost reused_host{endpoint_hash, std::move(stored_lb_endpoint), host};
+        if (locality_hosts != nullptr) {
+          locality_hosts->push_back(reused_host);
+        }
+        endpoint_hosts_.emplace(endpoint_hash, std::move(reused_host));
+        return;
+      }
+    }
+  }
+
   const auto address = parent_.resolveProtoAddress(lb_endpoint.endpoint().address());
   std::vector<Network::Address::InstanceConstSharedPtr> address_list;
   if (!lb_endpoint.endpoint().additional_addresses().empty()) {
@@ -154,10 +280,31 @@ void EdsClusterImpl::BatchUpdateHelper::updateLocalityEndpoints(
     return;
   }
 
-  priority_state_manager.registerHostForPriority(lb_endpoint.endpoint().hostname(), address,
-                                                 address_list, locality_lb_endpoint, lb_endpoint,
-                                                 parent_.time_source_);
+  HostSharedPtr host = priority_state_manager.registerHostForPriority(
+      lb_endpoint.endpoint().hostname(), address, address_list, locality_lb_endpoint, lb_endpoint,
+      parent_.time_source_);
   all_new_hosts.emplace(address_as_string);
+  if (reuse_hosts_) {
+    if (stored_lb_endpoint == nullptr) {
+      stored_lb_endpoint =
+          std::make_shared<const envoy::config::endpoint::v3::LbEndpoint>(lb_endpoint);
+    }
+    EndpointHost new_host{endpoint_hash, std::move(stored_lb_endpoint), std::move(host)};
+    if (locality_hosts != nullptr) {
+      locality_hosts->push_back(new_host);
+    }
+    endpoint_hosts_.emplace(endpoint_hash, std::move(new_host));
+  }
+}
+
+bool EdsClusterImpl::BatchUpdateHelper::sameEndpoint(
+    const EndpointHost& endpoint_host, const envoy::config::endpoint::v3::LbEndpoint& lb_endpoint,
+    const envoy::config::endpoint::v3::LocalityLbEndpoints& locality_lb_endpoint) {
+  // The hash only tells which endpoint to compare with.
+  return endpoint_host.host_->priority() == locality_lb_endpoint.priority() &&
+         Protobuf::util::MessageDifferencer::Equals(endpoint_host.host_->locality(),
+                                                    locality_lb_endpoint.locality()) &&
+         Protobuf::util::MessageDifferencer::Equals(*endpoint_host.lb_endpoint_, lb_endpoint);
 }
 
 absl::Status
@@ -329,40 +476,37 @@ void EdsClusterImpl::onCachedResourceRemoved(absl::string_view resource_name) {
   update(resource);
 }
 
-void EdsClusterImpl::reloadHealthyHostsHelper(const HostSharedPtr& host) {
-  // Here we will see if we have a host that has been marked for deletion by service discovery
-  // but has been stabilized due to passing active health checking. If such a host is now
-  // failing active health checking we can remove it during this health check update.
-  HostSharedPtr host_to_exclude = host;
-  if (host_to_exclude != nullptr &&
-      host_to_exclude->healthFlagGet(Host::HealthFlag::FAILED_ACTIVE_HC) &&
-      host_to_exclude->healthFlagGet(Host::HealthFlag::PENDING_DYNAMIC_REMOVAL)) {
-    // Empty for clarity.
-  } else {
-    // Do not exclude and remove the host during the update.
-    host_to_exclude = nullptr;
+void EdsClusterImpl::reloadHealthyHostsHelper(const HostVector& hosts) {
+  // Here we will see if we have hosts that have been marked for deletion by service discovery
+  // but have been stabilized due to passing active health checking. If such hosts are now
+  // failing active health checking we can remove them during this health check update.
+  absl::flat_hash_set<const Host*> hosts_to_exclude;
+  for (const HostSharedPtr& host : hosts) {
+    if (host->healthFlagGet(Host::HealthFlag::FAILED_ACTIVE_HC) &&
+        host->healthFlagGet(Host::HealthFlag::PENDING_DYNAMIC_REMOVAL)) {
+      hosts_to_exclude.insert(host.get());
+    }
   }
 
   const auto& host_sets = prioritySet().hostSetsPerPriority();
   for (size_t priority = 0; priority < host_sets.size(); ++priority) {
     const auto& host_set = host_sets[priority];
 
-    // Filter current hosts in case we need to exclude a host.
+    // Filter current hosts in case we need to exclude hosts, and setup a hosts to remove vector
+    // with the excluded ones.
     HostVectorSharedPtr hosts_copy(new HostVector());
-    std::copy_if(host_set->hosts().begin(), host_set->hosts().end(),
-                 std::back_inserter(*hosts_copy),
-                 [&host_to_exclude](const HostSharedPtr& host) { return host_to_exclude != host; });
-
-    // Setup a hosts to remove vector in case we need to exclude a host.
     HostVector hosts_to_remove;
-    if (hosts_copy->size() != host_set->hosts().size()) {
-      ASSERT(hosts_copy->size() == host_set->hosts().size() - 1);
-      hosts_to_remove.emplace_back(host_to_exclude);
+    for (const HostSharedPtr& host : host_set->hosts()) {
+      if (hosts_to_exclude.contains(host.get())) {
+        hosts_to_remove.emplace_back(host);
+      } else {
+        hosts_copy->emplace_back(host);
+      }
     }
 
-    // Filter hosts per locality in case we need to exclude a host.
+    // Filter hosts per locality in case we need to exclude hosts.
     HostsPerLocalityConstSharedPtr hosts_per_locality_copy = host_set->hostsPerLocality().filter(
-        {[&host_to_exclude](const Host& host) { return &host != host_to_exclude.get(); }})[0];
+        {[&hosts_to_exclude](const Host& host) { return !hosts_to_exclude.contains(&host); }})[0];
 
     prioritySet().updateHosts(
         priority, HostSetImpl::partitionHosts(hosts_copy, hosts_per_locality_copy),
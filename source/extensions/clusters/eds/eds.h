@@ -71,32 +71,68 @@ private:
   void onCachedResourceRemoved(absl::string_view resource_name) override;
 
   // ClusterImplBase
-  void reloadHealthyHostsHelper(const HostSharedPtr& host) override;
+  void reloadHealthyHostsHelper(const HostVector& hosts) override;
   void startPreInit() override;
   void onAssignmentTimeout();
 
   // Returns true iff all the LEDS based localities were updated.
   bool validateAllLedsUpdated() const;
 
+  // The host of an endpoint, along with the hash of the endpoint and the endpoint itself, which
+  // confirms that an endpoint with the same hash is the same endpoint.
+  struct EndpointHost {
+    uint64_t endpoint_hash_;
+    std::shared_ptr<const envoy::config::endpoint::v3::LbEndpoint> lb_endpoint_;
+    HostSharedPtr host_;
+  };
+  using EndpointHosts = std::vector<EndpointHost>;
+
+  // The hosts of the endpoints of a locality, along with the locality itself, which confirms that
+  // a locality with the same hash is the same locality. The endpoints point into the locality.
+  struct LocalityHosts {
+    std::shared_ptr<const envoy::config::endpoint::v3::LocalityLbEndpoints> locality_lb_endpoint_;
+    EndpointHosts hosts_;
+  };
+
   class BatchUpdateHelper : public PrioritySet::BatchUpdateCb {
   public:
     BatchUpdateHelper(
         EdsClusterImpl& parent,
-        const envoy::config::endpoint::v3::ClusterLoadAssignment& cluster_load_assignment)
-        : parent_(parent), cluster_load_assignment_(cluster_load_assignment) {}
+        const envoy::config::endpoint::v3::ClusterLoadAssignment& cluster_load_assignment);
 
     // Upstream::PrioritySet::BatchUpdateCb
     void batchUpdate(PrioritySet::HostUpdateCb& host_update_cb) override;
 
   private:
+    // Registers the hosts of a locality which did not change since the previous update, and
+    // returns false if the locality changed or any of its hosts was removed meanwhile.
+    bool reuseLocalityHosts(
+        uint64_t locality_hash,
+        const envoy::config::endpoint::v3::LocalityLbEndpoints& locality_lb_endpoint,
+        PriorityStateManager& priority_state_manager,
+        absl::flat_hash_set<std::string>& all_new_hosts, const HostMap& all_hosts);
+    // Registers the host of an endpoint, unless the endpoint duplicates the address of another.
+    // The registered host is also added to locality_hosts if not nullptr. stored_lb_endpoint is
+    // the copy of the endpoint kept for the next update, which is made here if nullptr.
     void updateLocalityEndpoints(
         const envoy::config::endpoint::v3::LbEndpoint& lb_endpoint,
         const envoy::config::endpoint::v3::LocalityLbEndpoints& locality_lb_endpoint,
         PriorityStateManager& priority_state_manager,
-        absl::flat_hash_set<std::string>& all_new_hosts);
+        absl::flat_hash_set<std::string>& all_new_hosts, const HostMap& all_hosts,
+        EndpointHosts* locality_hosts,
+        std::shared_ptr<const envoy::config::endpoint::v3::LbEndpoint> stored_lb_endpoint);
+    // Returns whether a host registered by the previous update is the host of the given endpoint.
+    static bool
+    sameEndpoint(const EndpointHost& endpoint_host,
+                 const envoy::config::endpoint::v3::LbEndpoint& lb_endpoint,
+                 const envoy::config::endpoint::v3::LocalityLbEndpoints& locality_lb_endpoint);
 
     EdsClusterImpl& parent_;
     const envoy::config::endpoint::v3::ClusterLoadAssignment& cluster_load_assignment_;
+    const bool reuse_hosts_;
+    // The hosts registered by this update, for the next update to reuse.
+    absl::flat_hash_map<uint64_t, LocalityHosts> locality_hosts_;
+    absl::flat_hash_map<uint64_t, EndpointHost> endpoint_hosts_;
   };
 
   Config::SubscriptionPtr subscription_;
@@ -116,6 +152,13 @@ private:
   // be set when LEDS is used.
   std::unique_ptr<envoy::config::endpoint::v3::ClusterLoadAssignment> cluster_load_assignment_;
 
+  // The hosts of the last update, which the next update reuses instead of creating new hosts for
+  // the localities and the endpoints it does not change. The localities are indexed by the hash of
+  // their LocalityLbEndpoints, and the endpoints by the hash of their LbEndpoint, locality and
+  // priority. A hash match is only reused if the locality or the endpoint is equal as well.
+  absl::flat_hash_map<uint64_t, LocalityHosts> locality_hosts_;
+  absl::flat_hash_map<uint64_t, EndpointHost> endpoint_hosts_;
+
   // An optional cache for the EDS resources.
   // Upon a (warming) timeout, a cached resource will be used.
   Config::EdsResourcesCacheOptRef eds_resources_cache_;
@@ -148,15 +148,18 @@ void RedisCluster::onClusterSlotUpdate(ClusterSlotsSharedPtr&& slots) {
   onPreInitComplete();
 }
 
-void RedisCluster::reloadHealthyHostsHelper(const Upstream::HostSharedPtr& host) {
+void RedisCluster::reloadHealthyHostsHelper(const Upstream::HostVector& hosts) {
   if (lb_factory_) {
     lb_factory_->onHostHealthUpdate();
   }
-  if (host && (host->coarseHealth() == Upstream::Host::Health::Degraded ||
-               host->coarseHealth() == Upstream::Host::Health::Unhealthy)) {
-    refresh_manager_->onHostDegraded(cluster_name_);
+  for (const Upstream::HostSharedPtr& host : hosts) {
+    if (host->coarseHealth() == Upstream::Host::Health::Degraded ||
+        host->coarseHealth() == Upstream::Host::Health::Unhealthy) {
+      refresh_manager_->onHostDegraded(cluster_name_);
+      break;
+    }
   }
-  ClusterImplBase::reloadHealthyHostsHelper(host);
+  ClusterImplBase::reloadHealthyHostsHelper(hosts);
 }
 
 // DnsDiscoveryResolveTarget
@@ -5,6 +5,14 @@
 #include "envoy/config/endpoint/v3/endpoint.pb.h"
 #include "envoy/config/endpoint/v3/endpoint_components.pb.h"
 
+#include "source/common/common/utility.h"
+#include "source/common/config/utility.h"
+#include "source/common/network/utility.h"
+
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_join.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -43,11 +51,23 @@ StrictDnsClusterImpl::StrictDnsClusterImpl(const envoy::config::cluster::v3::Clu
   overprovisioning_factor_ = PROTOBUF_GET_WRAPPED_OR_DEFAULT(
       load_assignment_.policy(), overprovisioning_factor, kDefaultOverProvisioningFactor);
   weighted_priority_health_ = load_assignment_.policy().weighted_priority_health();
+
+  if (cluster.has_dns_cache_config()) {
+    auto& factory = Config::Utility::getAndCheckFactory<KeyValueStoreFactory>(
+        cluster.dns_cache_config().config());
+    dns_cache_ = std::make_unique<DnsCache>(DnsCache{
+        factory.createStore(cluster.dns_cache_config(), context.messageValidationVisitor(),
+                            context.serverFactoryContext().mainThreadDispatcher(),
+                            context.serverFactoryContext().api().fileSystem()),
+        {ALL_STRICT_DNS_CACHE_STATS(POOL_COUNTER(info_->statsScope()))}});
+  }
 }
 
 void StrictDnsClusterImpl::startPreInit() {
   for (const ResolveTargetPtr& target : resolve_targets_) {
-    target->startResolve();
+    if (dns_cache_ == nullptr || !target->loadCachedHosts()) {
+      target->startResolve();
+    }
   }
   // If the config provides no endpoints, the cluster is initialized immediately as if all hosts are
   // resolved in failure.
@@ -116,63 +136,15 @@ void StrictDnsClusterImpl::ResolveTarget::startResolve() {
         if (status == Network::DnsResolver::ResolutionStatus::Success) {
           parent_.info_->configUpdateStats().update_success_.inc();
 
-          HostVector new_hosts;
-          std::chrono::seconds ttl_refresh_rate = std::chrono::seconds::max();
-          absl::flat_hash_set<std::string> all_new_hosts;
-          for (const auto& resp : response) {
-            const auto& addrinfo = resp.addrInfo();
-            // TODO(mattklein123): Currently the DNS interface does not consider port. We need to
-            // make a new address that has port in it. We need to both support IPv6 as well as
-            // potentially move port handling into the DNS interface itself, which would work better
-            // for SRV.
-            ASSERT(addrinfo.address_ != nullptr);
-            auto address = Network::Utility::getAddressWithPort(*(addrinfo.address_), port_);
-            if (all_new_hosts.count(address->asString()) > 0) {
-              continue;
-            }
-
-            new_hosts.emplace_back(new HostImpl(
-                parent_.info_, hostname_, address,
-                // TODO(zyfjeff): Created through metadata shared pool
-                std::make_shared<const envoy::config::core::v3::Metadata>(lb_endpoint_.metadata()),
-                lb_endpoint_.load_balancing_weight().value(), locality_lb_endpoints_.locality(),
-                lb_endpoint_.endpoint().health_check_config(), locality_lb_endpoints_.priority(),
-                lb_endpoint_.health_status(), parent_.time_source_));
-            all_new_hosts.emplace(address->asString());
-            ttl_refresh_rate = min(ttl_refresh_rate, addrinfo.ttl_);
-          }
-
-          HostVector hosts_added;
-          HostVector hosts_removed;
-          if (parent_.updateDynamicHostList(new_hosts, hosts_, hosts_added, hosts_removed,
-                                            all_hosts_, all_new_hosts)) {
-            ENVOY_LOG(debug, "DNS hosts have changed for {}", dns_address_);
-            ASSERT(std::all_of(hosts_.begin(), hosts_.end(), [&](const auto& host) {
-              return host->priority() == locality_lb_endpoints_.priority();
-            }));
-
-            // Update host map for current resolve target.
-            for (const auto& host : hosts_removed) {
-              all_hosts_.erase(host->address()->asString());
-            }
-            for (const auto& host : hosts_added) {
-              all_hosts_.insert({host->address()->asString(), host});
-            }
-
-            parent_.updateAllHosts(hosts_added, hosts_removed, locality_lb_endpoints_.priority());
-          } else {
-            parent_.info_->configUpdateStats().update_no_rebuild_.inc();
+          const std::chrono::seconds ttl_refresh_rate = updateHosts(response);
+          if (parent_.dns_cache_ != nullptr) {
+            cacheHosts(response);
           }
 
           // reset failure backoff strategy because there was a success.
           parent_.failure_backoff_strategy_->reset();
 
-          if (!response.empty() && parent_.respect_dns_ttl_ &&
-              ttl_refresh_rate != std::chrono::seconds(0)) {
-            final_refresh_rate = ttl_refresh_rate;
-            ASSERT(ttl_refresh_rate != std::chrono::seconds::max() &&
-                   final_refresh_rate.count() > 0);
-          }
+          final_refresh_rate = refreshRate(ttl_refresh_rate);
           ENVOY_LOG(debug, "DNS refresh rate reset for {}, refresh rate {} ms", dns_address_,
                     final_refresh_rate.count());
         } else {
@@ -193,6 +165,139 @@ void StrictDnsClusterImpl::ResolveTarget::startResolve() {
       });
 }
 
+std::chrono::seconds StrictDnsClusterImpl::ResolveTarget::updateHosts(
+    const std::list<Network::DnsResponse>& response) {
+  HostVector new_hosts;
+  std::chrono::seconds ttl_refresh_rate = std::chrono::seconds::max();
+  absl::flat_hash_set<std::string> all_new_hosts;
+  for (const auto& resp : response) {
+    const auto& addrinfo = resp.addrInfo();
+    // TODO(mattklein123): Currently the DNS interface does not consider port. We need to
+    // make a new address that has port in it. We need to both support IPv6 as well as
+    // potentially move port handling into the DNS interface itself, which would work better
+    // for SRV.
+    ASSERT(addrinfo.address_ != nullptr);
+    auto address = Network::Utility::getAddressWithPort(*(addrinfo.address_), port_);
+    if (all_new_hosts.count(address->asString()) > 0) {
+      continue;
+    }
+
+    new_hosts.emplace_back(new HostImpl(
+        parent_.info_, hostname_, address,
+        // TODO(zyfjeff): Created through metadata shared pool
+        std::make_shared<const envoy::config::core::v3::Metadata>(lb_endpoint_.metadata()),
+        lb_endpoint_.load_balancing_weight().value(),
+        parent_.constLocalitySharedPool()->getObject(locality_lb_endpoints_.locality()),
+        lb_endpoint_.endpoint().health_check_config(), locality_lb_endpoints_.priority(),
+        lb_endpoint_.health_status(), parent_.time_source_));
+    all_new_hosts.emplace(address->asString());
+    ttl_refresh_rate = min(ttl_refresh_rate, addrinfo.ttl_);
+  }
+
+  HostVector hosts_added;
+  HostVector hosts_removed;
+  if (parent_.updateDynamicHostList(new_hosts, hosts_, hosts_added, hosts_removed, all_hosts_,
+                                    all_new_hosts)) {
+    ENVOY_LOG(debug, "DNS hosts have changed for {}", dns_address_);
+    ASSERT(std::all_of(hosts_.begin(), hosts_.end(), [&](const auto& host) {
+      return host->priority() == locality_lb_endpoints_.priority();
+    }));
+
+    // Update host map for current resolve target.
+    for (const auto& host : hosts_removed) {
+      all_hosts_.erase(host->address()->asString());
+    }
+    for (const auto& host : hosts_added) {
+      all_hosts_.insert({host->address()->asString(), host});
+    }
+
+    parent_.updateAllHosts(hosts_added, hosts_removed, locality_lb_endpoints_.priority());
+  } else {
+    parent_.info_->configUpdateStats().update_no_rebuild_.inc();
+  }
+  return ttl_refresh_rate;
+}
+
+std::chrono::milliseconds
+StrictDnsClusterImpl::ResolveTarget::refreshRate(std::chrono::seconds ttl) const {
+  if (parent_.respect_dns_ttl_ && ttl != std::chrono::seconds(0) &&
+      ttl != std::chrono::seconds::max()) {
+    return ttl;
+  }
+  return parent_.dns_refresh_rate_ms_;
+}
+
+// The resolution of a DNS name is persisted as one line per address, made of the address, its TTL
+// in seconds and the system time of the resolution in seconds since the epoch, separated by '|'.
+// The time is the system time rather than the monotonic time, so that it can be compared with the
+// time of a later process.
+void StrictDnsClusterImpl::ResolveTarget::cacheHosts(
+    const std::list<Network::DnsResponse>& response) {
+  if (response.empty()) {
+    parent_.dns_cache_->store_->remove(dns_address_);
+    return;
+  }
+  const uint64_t seconds_since_epoch = std::chrono::duration_cast<std::chrono::seconds>(
+                                           parent_.time_source_.systemTime().time_since_epoch())
+                                           .count();
+  const std::string value =
+      absl::StrJoin(response, "\n", [&](std::string* out, const Network::DnsResponse& resp) {
+        absl::StrAppend(out, resp.addrInfo().address_->ip()->addressAsString(), "|",
+                        resp.addrInfo().ttl_.count(), "|", seconds_since_epoch);
+      });
+  parent_.dns_cache_->store_->addOrUpdate(dns_address_, value, absl::nullopt);
+}
+
+bool StrictDnsClusterImpl::ResolveTarget::loadCachedHosts() {
+  const absl::optional<absl::string_view> value = parent_.dns_cache_->store_->get(dns_address_);
+  if (!value.has_value()) {
+    return false;
+  }
+  StrictDnsCacheStats& stats = parent_.dns_cache_->stats_;
+
+  std::list<Network::DnsResponse> response;
+  uint64_t resolution_seconds = 0;
+  for (absl::string_view line : StringUtil::splitToken(value.value(), "\n")) {
+    const auto parts = StringUtil::splitToken(line, "|", true);
+    uint64_t ttl = 0;
+    Network::Address::InstanceConstSharedPtr address;
+    if (parts.size() == 3) {
+      address = Network::Utility::parseInternetAddressNoThrow(std::string(parts[0]));
+    }
+    if (address == nullptr || !absl::SimpleAtoi(parts[1], &ttl) ||
+        !absl::SimpleAtoi(parts[2], &resolution_seconds)) {
+      ENVOY_LOG(warn, "unable to parse the cached DNS resolution of {}: '{}'", dns_address_,
+                value.value());
+      stats.dns_cache_load_failure_.inc();
+      return false;
+    }
+    response.emplace_back(address, std::chrono::seconds(ttl));
+  }
+  if (response.empty()) {
+    return false;
+  }
+
+  const std::chrono::seconds ttl_refresh_rate = updateHosts(response);
+  parent_.onPreInitComplete();
+
+  const std::chrono::milliseconds refresh_rate = refreshRate(ttl_refresh_rate);
+  const auto age = parent_.time_source_.systemTime() -
+                   SystemTime(std::chrono::seconds(resolution_seconds));
+  // The age of a resolution from the future, e.g. after the system clock moved back, is unknown.
+  if (age >= refresh_rate || age < SystemTime::duration::zero()) {
+    // The stale hosts are used until the name is resolved again.
+    ENVOY_LOG(debug, "loaded stale DNS resolution of {}", dns_address_);
+    stats.dns_cache_load_stale_.inc();
+    return false;
+  }
+  const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(refresh_rate - age);
+  ENVOY_LOG(debug, "loaded DNS resolution of {}, refresh in {} ms", dns_address_,
+            remaining.count());
+  stats.dns_cache_load_.inc();
+  resolve_timer_->enableTimer(remaining);
+  return true;
+}
+
 absl::StatusOr<std::pair<ClusterImplBaseSharedPtr, ThreadAwareLoadBalancerPtr>>
 StrictDnsClusterFactory::createClusterImpl(const envoy::config::cluster::v3::Cluster& cluster,
                                            ClusterFactoryContext& context) {
@@ -1,7 +1,9 @@
 #pragma once
 
+#include "envoy/common/key_value_store.h"
 #include "envoy/config/cluster/v3/cluster.pb.h"
 #include "envoy/config/endpoint/v3/endpoint_components.pb.h"
+#include "envoy/stats/stats_macros.h"
 
 #include "source/common/upstream/cluster_factory_impl.h"
 #include "source/common/upstream/upstream_impl.h"
@@ -9,6 +11,21 @@
 namespace Envoy {
 namespace Upstream {
 
+/**
+ * All the stats of the persistent DNS cache of a strict DNS cluster. @see stats_macros.h
+ */
+#define ALL_STRICT_DNS_CACHE_STATS(COUNTER)                                                        \
+  COUNTER(dns_cache_load)                                                                          \
+  COUNTER(dns_cache_load_failure)                                                                  \
+  COUNTER(dns_cache_load_stale)
+
+/**
+ * Struct definition for the stats of the persistent DNS cache. @see stats_macros.h
+ */
+struct StrictDnsCacheStats {
+  ALL_STRICT_DNS_CACHE_STATS(GENERATE_COUNTER_STRUCT)
+};
+
 /**
  * Implementation of Upstream::Cluster that does periodic DNS resolution and updates the host
  * member set if the DNS members change.
@@ -29,6 +46,14 @@ private:
                   const envoy::config::endpoint::v3::LbEndpoint& lb_endpoint);
     ~ResolveTarget();
     void startResolve();
+    // Updates the hosts of the target from a successful resolution, and returns the lowest TTL of
+    // the resolved addresses.
+    std::chrono::seconds updateHosts(const std::list<Network::DnsResponse>& response);
+    // Updates the hosts of the target from the persistent DNS cache, and returns true if the
+    // cached resolution is recent enough to defer the next resolution until it is due.
+    bool loadCachedHosts();
+    void cacheHosts(const std::list<Network::DnsResponse>& response);
+    std::chrono::milliseconds refreshRate(std::chrono::seconds ttl) const;
 
     StrictDnsClusterImpl& parent_;
     Network::ActiveDnsQuery* active_query_{};
@@ -51,6 +76,12 @@ private:
 
   using ResolveTargetPtr = std::unique_ptr<ResolveTarget>;
 
+  // The store to which the resolutions are persisted. @see Cluster.dns_cache_config.
+  struct DnsCache {
+    KeyValueStorePtr store_;
+    StrictDnsCacheStats stats_;
+  };
+
   void updateAllHosts(const HostVector& hosts_added, const HostVector& hosts_removed,
                       uint32_t priority);
 
@@ -69,6 +100,7 @@ private:
   Network::DnsLookupFamily dns_lookup_family_;
   uint32_t overprovisioning_factor_;
   bool weighted_priority_health_;
+  std::unique_ptr<DnsCache> dns_cache_;
 };
 
 /**
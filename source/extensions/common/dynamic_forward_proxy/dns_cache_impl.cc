@@ -1,5 +1,7 @@
 #include "source/extensions/common/dynamic_forward_proxy/dns_cache_impl.h"
 
+#include <algorithm>
+
 #include "envoy/extensions/common/dynamic_forward_proxy/v3/dns_cache.pb.h"
 
 #include "source/common/common/dns_utils.h"
@@ -418,9 +420,19 @@ void DnsCacheImpl::finishResolve(const std::string& host,
   if (status == Network::DnsResolver::ResolutionStatus::Success) {
     primary_host_info->failure_backoff_strategy_->reset(
         std::chrono::duration_cast<std::chrono::milliseconds>(dns_ttl).count());
-    primary_host_info->refresh_timer_->enableTimer(dns_ttl);
+    std::chrono::milliseconds refresh_rate = dns_ttl;
+    if (from_cache) {
+      // A resolution loaded from the cache is refreshed once its TTL expires, which is right away
+      // if it already has.
+      const auto age =
+          main_thread_dispatcher_.timeSource().monotonicTime() - resolution_time.value();
+      refresh_rate =
+          std::clamp(std::chrono::duration_cast<std::chrono::milliseconds>(dns_ttl - age),
+                     std::chrono::milliseconds(0), refresh_rate);
+    }
+    primary_host_info->refresh_timer_->enableTimer(refresh_rate);
     ENVOY_LOG(debug, "DNS refresh rate reset for host '{}', refresh rate {} ms", host,
-              dns_ttl.count() * 1000);
+              refresh_rate.count());
   } else {
     const uint64_t refresh_interval = primary_host_info->failure_backoff_strategy_->nextBackOffMs();
     primary_host_info->refresh_timer_->enableTimer(std::chrono::milliseconds(refresh_interval));
@@ -7,6 +7,8 @@
 #include "source/common/protobuf/utility.h"
 #include "source/common/runtime/runtime_features.h"
 
+#include "absl/container/inlined_vector.h"
+
 namespace Envoy {
 namespace Extensions {
 namespace Filters {
@@ -18,13 +20,15 @@ LocalRateLimiterImpl::LocalRateLimiterImpl(
     const uint32_t tokens_per_fill, Event::Dispatcher& dispatcher,
     const Protobuf::RepeatedPtrField<
         envoy::extensions::common::ratelimit::v3::LocalRateLimitDescriptor>& descriptors,
-    bool always_consume_default_token_bucket)
-    : fill_timer_(fill_interval > std::chrono::milliseconds(0)
+    bool always_consume_default_token_bucket, bool lazy_refill)
+    : fill_timer_(fill_interval > std::chrono::milliseconds(0) && !lazy_refill
                       ? dispatcher.createTimer([this] { onFillTimer(); })
                       : nullptr),
       time_source_(dispatcher.timeSource()),
-      always_consume_default_token_bucket_(always_consume_default_token_bucket) {
-  if (fill_timer_ && fill_interval < std::chrono::milliseconds(50)) {
+      always_consume_default_token_bucket_(always_consume_default_token_bucket),
+      lazy_refill_(lazy_refill) {
+  if (fill_interval > std::chrono::milliseconds(0) &&
+      fill_interval < std::chrono::milliseconds(50)) {
     throw EnvoyException("local rate limit token bucket fill timer must be >= 50ms");
   }
 
@@ -38,6 +42,8 @@ LocalRateLimiterImpl::LocalRateLimiterImpl(
     fill_timer_->enableTimer(fill_interval);
   }
 
+  std::vector<LocalDescriptorImpl> sorted_descriptors;
+  sorted_descriptors.reserve(descriptors.size());
   for (const auto& descriptor : descriptors) {
     LocalDescriptorImpl new_descriptor;
     for (const auto& entry : descriptor.entries()) {
@@ -64,24 +70,26 @@ LocalRateLimiterImpl::LocalRateLimiterImpl(
     token_state->fill_time_ = time_source_.monotonicTime();
     new_descriptor.token_state_ = token_state;
 
-    auto result = descriptors_.emplace(new_descriptor);
-    if (!result.second) {
-      throw EnvoyException(absl::StrCat("duplicate descriptor in the local rate descriptor: ",
-                                        result.first->toString()));
-    }
-    sorted_descriptors_.push_back(new_descriptor);
+    sorted_descriptors.push_back(std::move(new_descriptor));
   }
   // If a request is limited by a descriptor, it should not consume tokens from the remaining
   // matched descriptors, so we sort the descriptors by tokens per second, as a result, in most
   // cases the strictest descriptor will be consumed first. However, it can not solve the
   // problem perfectly.
-  if (!sorted_descriptors_.empty()) {
-    std::sort(sorted_descriptors_.begin(), sorted_descriptors_.end(),
-              [this](LocalDescriptorImpl a, LocalDescriptorImpl b) -> bool {
-                const int a_token_fill_per_second = tokensFillPerSecond(a);
-                const int b_token_fill_per_second = tokensFillPerSecond(b);
-                return a_token_fill_per_second < b_token_fill_per_second;
-              });
+  std::sort(sorted_descriptors.begin(), sorted_descriptors.end(),
+            [](const LocalDescriptorImpl& a, const LocalDescriptorImpl& b) -> bool {
+              const int a_token_fill_per_second = tokensFillPerSecond(a);
+              const int b_token_fill_per_second = tokensFillPerSecond(b);
+              return a_token_fill_per_second < b_token_fill_per_second;
+            });
+  descriptors_.reserve(sorted_descriptors.size());
+  for (uint32_t i = 0; i < sorted_descriptors.size(); ++i) {
+    sorted_descriptors[i].order_ = i;
+    auto result = descriptors_.emplace(std::move(sorted_descriptors[i]));
+    if (!result.second) {
+      throw EnvoyException(absl::StrCat("duplicate descriptor in the local rate descriptor: ",
+                                        result.first->toString()));
+    }
   }
 }
 
@@ -136,6 +144,38 @@ void LocalRateLimiterImpl::onFillTimerDescriptorHelper() {
   }
 }
 
+void LocalRateLimiterImpl::refillLazily(const TokenState& tokens,
+                                        const RateLimit::TokenBucket& bucket,
+                                        MonotonicTime now) const {
+  const auto fill_interval = absl::ToChronoNanoseconds(bucket.fill_interval_);
+  if (fill_interval <= std::chrono::nanoseconds(0)) {
+    return;
+  }
+  MonotonicTime fill_time = tokens.fill_time_.load(std::memory_order_relaxed);
+  if (now - fill_time < fill_interval) {
+    return;
+  }
+
+  // The fill time is advanced by whole fill intervals, so the tokens are added at the same times
+  // as with the fill timer. Only the thread advancing the fill time adds the tokens.
+  const uint64_t fills = (now - fill_time) / fill_interval;
+  if (!tokens.fill_time_.compare_exchange_strong(
+          fill_time, fill_time + fill_interval * static_cast<int64_t>(fills),
+          std::memory_order_relaxed)) {
+    return;
+  }
+  // Each fill adds at least one token, the bucket is full after max_tokens_ fills.
+  const uint64_t added_tokens =
+      std::min<uint64_t>(fills, bucket.max_tokens_) * bucket.tokens_per_fill_;
+  uint32_t expected_tokens = tokens.tokens_.load(std::memory_order_relaxed);
+  uint32_t new_tokens_value;
+  do {
+    new_tokens_value = std::min<uint64_t>(bucket.max_tokens_,
+                                          static_cast<uint64_t>(expected_tokens) + added_tokens);
+  } while (!tokens.tokens_.compare_exchange_weak(expected_tokens, new_tokens_value,
+                                                 std::memory_order_relaxed));
+}
+
 bool LocalRateLimiterImpl::requestAllowedHelper(const TokenState& tokens) const {
   // Relaxed consistency is used for all operations because we don't care about ordering, just the
   // final atomic correctness.
@@ -174,33 +214,49 @@ OptRef<const LocalRateLimiterImpl::LocalDescriptorImpl> LocalRateLimiterImpl::de
 
 bool LocalRateLimiterImpl::requestAllowed(
     absl::Span<const RateLimit::LocalDescriptor> request_descriptors) const {
+  const MonotonicTime now = lazy_refill_ ? time_source_.monotonicTime() : MonotonicTime();
   // Matched descriptors will be sorted by tokens per second and tokens consumed in order.
   // In most cases, if one of them is limited the remaining descriptors will not consume
   // their tokens.
   bool matched_descriptor = false;
   if (!descriptors_.empty() && !request_descriptors.empty()) {
-    for (const auto& descriptor : sorted_descriptors_) {
-      for (const auto& request_descriptor : request_descriptors) {
-        if (descriptor == request_descriptor) {
-          matched_descriptor = true;
-          // Descriptor token is not enough.
-          if (!requestAllowedHelper(*descriptor.token_state_)) {
-            return false;
-          }
-          break;
-        }
+    absl::InlinedVector<const LocalDescriptorImpl*, 8> matched_descriptors;
+    for (const auto& request_descriptor : request_descriptors) {
+      auto it = descriptors_.find(request_descriptor);
+      if (it != descriptors_.end()) {
+        matched_descriptors.push_back(&*it);
+      }
+    }
+    std::sort(matched_descriptors.begin(), matched_descriptors.end(),
+              [](const LocalDescriptorImpl* a, const LocalDescriptorImpl* b) {
+                return a->order_ < b->order_;
+              });
+    // A descriptor matched by several request descriptors only consumes one token.
+    matched_descriptors.erase(std::unique(matched_descriptors.begin(), matched_descriptors.end()),
+                              matched_descriptors.end());
+    for (const LocalDescriptorImpl* descriptor : matched_descriptors) {
+      matched_descriptor = true;
+      if (lazy_refill_) {
+        refillLazily(*descriptor->token_state_, descriptor->token_bucket_, now);
+      }
+      // Descriptor token is not enough.
+      if (!requestAllowedHelper(*descriptor->token_state_)) {
+        return false;
       }
     }
   }
 
   if (!matched_descriptor || always_consume_default_token_bucket_) {
+    if (lazy_refill_) {
+      refillLazily(tokens_, token_bucket_, now);
+    }
     // Since global tokens are not sorted, it should be larger than other descriptors.
     return requestAllowedHelper(tokens_);
   }
   return true;
 }
 
-int LocalRateLimiterImpl::tokensFillPerSecond(LocalDescriptorImpl& descriptor) {
+int LocalRateLimiterImpl::tokensFillPerSecond(const LocalDescriptorImpl& descriptor) {
   return descriptor.token_bucket_.tokens_per_fill_ /
          (absl::ToInt64Seconds(descriptor.token_bucket_.fill_interval_)
               ? absl::ToInt64Seconds(descriptor.token_bucket_.fill_interval_)
@@ -218,6 +274,11 @@ uint32_t LocalRateLimiterImpl::maxTokens(
 uint32_t LocalRateLimiterImpl::remainingTokens(
     absl::Span<const RateLimit::LocalDescriptor> request_descriptors) const {
   auto descriptor = descriptorHelper(request_descriptors);
+  if (lazy_refill_) {
+    refillLazily(descriptor.has_value() ? *descriptor.value().get().token_state_ : tokens_,
+                 descriptor.has_value() ? descriptor.value().get().token_bucket_ : token_bucket_,
+                 time_source_.monotonicTime());
+  }
 
   return descriptor.has_value()
              ? descriptor.value().get().token_state_->tokens_.load(std::memory_order_relaxed)
@@ -230,17 +291,21 @@ int64_t LocalRateLimiterImpl::remainingFillInterval(
 
   auto current_time = time_source_.monotonicTime();
   auto descriptor = descriptorHelper(request_descriptors);
+  if (lazy_refill_) {
+    refillLazily(descriptor.has_value() ? *descriptor.value().get().token_state_ : tokens_,
+                 descriptor.has_value() ? descriptor.value().get().token_bucket_ : token_bucket_,
+                 current_time);
+  }
   // Remaining time to next fill = fill interval - (current time - last fill time).
   if (descriptor.has_value()) {
-    ASSERT(std::chrono::duration_cast<std::chrono::milliseconds>(
-               current_time - descriptor.value().get().token_state_->fill_time_) <=
+    const MonotonicTime fill_time = descriptor.value().get().token_state_->fill_time_.load();
+    ASSERT(std::chrono::duration_cast<std::chrono::milliseconds>(current_time - fill_time) <=
            absl::ToChronoMilliseconds(descriptor.value().get().token_bucket_.fill_interval_));
-    return absl::ToInt64Seconds(
-        descriptor.value().get().token_bucket_.fill_interval_ -
-        absl::Seconds((current_time - descriptor.value().get().token_state_->fill_time_) / 1s));
+    return absl::ToInt64Seconds(descriptor.value().get().token_bucket_.fill_interval_ -
+                                absl::Seconds((current_time - fill_time) / 1s));
   }
   return absl::ToInt64Seconds(token_bucket_.fill_interval_ -
-                              absl::Seconds((current_time - tokens_.fill_time_) / 1s));
+                              absl::Seconds((current_time - tokens_.fill_time_.load()) / 1s));
 }
 
 } // namespace LocalRateLimit
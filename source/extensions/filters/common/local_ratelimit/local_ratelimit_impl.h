@@ -23,7 +23,7 @@ public:
       const uint32_t tokens_per_fill, Event::Dispatcher& dispatcher,
       const Protobuf::RepeatedPtrField<
           envoy::extensions::common::ratelimit::v3::LocalRateLimitDescriptor>& descriptors,
-      bool always_consume_default_token_bucket = true);
+      bool always_consume_default_token_bucket = true, bool lazy_refill = false);
   ~LocalRateLimiterImpl();
 
   bool requestAllowed(absl::Span<const RateLimit::LocalDescriptor> request_descriptors) const;
@@ -35,7 +35,7 @@ public:
 private:
   struct TokenState {
     mutable std::atomic<uint32_t> tokens_;
-    MonotonicTime fill_time_;
+    mutable std::atomic<MonotonicTime> fill_time_;
   };
   // Refill counter is incremented per each refill timer hit.
   uint64_t refill_counter_{0};
@@ -47,6 +47,9 @@ private:
     // refill interval is 50ms, the value is 3. Every 3rd invocation of
     // the global timer, the descriptor is refilled.
     uint64_t multiplier_;
+    // Position of the descriptor once sorted by tokens per second, the matched descriptors consume
+    // their tokens in this order.
+    uint32_t order_{};
     std::string toString() const {
       std::vector<std::string> entries;
       entries.reserve(entries_.size());
@@ -73,19 +76,23 @@ private:
   void onFillTimer();
   void onFillTimerHelper(TokenState& state, const RateLimit::TokenBucket& bucket);
   void onFillTimerDescriptorHelper();
+  void refillLazily(const TokenState& tokens, const RateLimit::TokenBucket& bucket,
+                    MonotonicTime now) const;
   OptRef<const LocalDescriptorImpl>
   descriptorHelper(absl::Span<const RateLimit::LocalDescriptor> request_descriptors) const;
   bool requestAllowedHelper(const TokenState& tokens) const;
-  int tokensFillPerSecond(LocalDescriptorImpl& descriptor);
+  static int tokensFillPerSecond(const LocalDescriptorImpl& descriptor);
 
   RateLimit::TokenBucket token_bucket_;
   const Event::TimerPtr fill_timer_;
   TimeSource& time_source_;
   TokenState tokens_;
   absl::flat_hash_set<LocalDescriptorImpl, LocalDescriptorHash, LocalDescriptorEqual> descriptors_;
-  std::vector<LocalDescriptorImpl> sorted_descriptors_;
   mutable Thread::ThreadSynchronizer synchronizer_; // Used for testing only.
   const bool always_consume_default_token_bucket_{};
+  // If set, the tokens are refilled from the time elapsed since the last fill when they are
+  // accessed instead of by the fill timer.
+  const bool lazy_refill_{};
 
   friend class LocalRateLimiterImplTest;
 };
@@ -37,9 +37,10 @@ FilterConfig::FilterConfig(
           config.has_always_consume_default_token_bucket()
               ? config.always_consume_default_token_bucket().value()
               : true),
+      lazy_token_refill_(config.lazy_token_refill()),
       rate_limiter_(new Filters::Common::LocalRateLimit::LocalRateLimiterImpl(
           fill_interval_, max_tokens_, tokens_per_fill_, dispatcher, descriptors_,
-          always_consume_default_token_bucket_)),
+          always_consume_default_token_bucket_, lazy_token_refill_)),
       local_info_(local_info), runtime_(runtime),
       filter_enabled_(
           config.has_filter_enabled()
@@ -214,7 +215,7 @@ const Filters::Common::LocalRateLimit::LocalRateLimiterImpl& Filter::getPerConne
     auto limiter = std::make_shared<PerConnectionRateLimiter>(
         config->fillInterval(), config->maxTokens(), config->tokensPerFill(),
         decoder_callbacks_->dispatcher(), config->descriptors(),
-        config->consumeDefaultTokenBucket());
+        config->consumeDefaultTokenBucket(), config->lazyTokenRefill());
 
     decoder_callbacks_->streamInfo().filterState()->setData(
         PerConnectionRateLimiter::key(), limiter, StreamInfo::FilterState::StateType::ReadOnly,
@@ -54,9 +54,9 @@ public:
       Envoy::Event::Dispatcher& dispatcher,
       const Protobuf::RepeatedPtrField<
           envoy::extensions::common::ratelimit::v3::LocalRateLimitDescriptor>& descriptor,
-      bool always_consume_default_token_bucket)
+      bool always_consume_default_token_bucket, bool lazy_token_refill)
       : rate_limiter_(fill_interval, max_tokens, tokens_per_fill, dispatcher, descriptor,
-                      always_consume_default_token_bucket) {}
+                      always_consume_default_token_bucket, lazy_token_refill) {}
   static const std::string& key();
   const Filters::Common::LocalRateLimit::LocalRateLimiterImpl& value() const {
     return rate_limiter_;
@@ -111,6 +111,7 @@ public:
     return vh_rate_limits_;
   }
   bool consumeDefaultTokenBucket() const { return always_consume_default_token_bucket_; }
+  bool lazyTokenRefill() const { return lazy_token_refill_; }
 
 private:
   friend class FilterTest;
@@ -136,6 +137,7 @@ private:
       descriptors_;
   const bool rate_limit_per_connection_;
   const bool always_consume_default_token_bucket_{};
+  const bool lazy_token_refill_{};
   std::unique_ptr<Filters::Common::LocalRateLimit::LocalRateLimiterImpl> rate_limiter_;
   const LocalInfo::LocalInfo& local_info_;
   Runtime::Loader& runtime_;
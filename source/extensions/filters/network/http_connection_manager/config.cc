@@ -402,6 +402,12 @@ HttpConnectionManagerConfig::HttpConnectionManagerConfig(
     idle_timeout_ = absl::nullopt;
   }
 
+  if (config.has_stream_arena()) {
+    stream_arena_config_ = ArenaConfig{
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.stream_arena(), block_size, 4096),
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(config.stream_arena(), max_blocks_per_stream, 4)};
+  }
+
   if (config.strip_any_host_port() && config.strip_matching_host_port()) {
     throw EnvoyException(fmt::format(
         "Error: Only one of `strip_matching_host_port` or `strip_any_host_port` can be set."));
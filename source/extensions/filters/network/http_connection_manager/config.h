@@ -267,6 +267,9 @@ public:
   bool addProxyProtocolConnectionState() const override {
     return add_proxy_protocol_connection_state_;
   }
+  const ArenaConfig* streamArenaConfig() const override {
+    return stream_arena_config_.has_value() ? &stream_arena_config_.value() : nullptr;
+  }
 
 private:
   enum class CodecType { HTTP1, HTTP2, HTTP3, AUTO };
@@ -361,6 +364,7 @@ private:
   const Http::HeaderValidatorFactoryPtr header_validator_factory_;
   const bool append_x_forwarded_port_;
   const bool add_proxy_protocol_connection_state_;
+  absl::optional<ArenaConfig> stream_arena_config_;
 };
 
 /**
@@ -8,6 +8,9 @@
 #include "source/common/network/utility.h"
 #include "source/common/router/router.h"
 
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/blocking_counter.h"
+
 namespace Envoy {
 namespace Upstream {
 
@@ -81,6 +84,32 @@ HealthCheckerImplBase::~HealthCheckerImplBase() {
   for (auto& session : active_sessions_) {
     session.second->onDeferredDeleteBase();
   }
+  if (!usesHealthCheckDispatchers()) {
+    return;
+  }
+
+  // The sessions run on the health check dispatchers and reference this health checker, so wait
+  // for each dispatcher to stop and destroy its sessions, including the ones removed before.
+  absl::flat_hash_map<Event::Dispatcher*, std::vector<ActiveHealthCheckSessionPtr>> sessions;
+  for (Event::Dispatcher* dispatcher : session_dispatchers_) {
+    sessions[dispatcher];
+  }
+  for (auto& session : active_sessions_) {
+    sessions[&session.second->dispatcher_].push_back(std::move(session.second));
+  }
+  active_sessions_.clear();
+  absl::BlockingCounter stopped(sessions.size());
+  for (auto& dispatcher_sessions : sessions) {
+    dispatcher_sessions.first->post(
+        [&stopped, sessions = std::move(dispatcher_sessions.second)]() mutable -> void {
+          for (ActiveHealthCheckSessionPtr& session : sessions) {
+            session->stopHealthChecks();
+          }
+          sessions.clear();
+          stopped.DecrementCount();
+        });
+  }
+  stopped.Wait();
 }
 
 void HealthCheckerImplBase::decHealthy() { stats_.healthy_.sub(1); }
@@ -164,6 +193,9 @@ void HealthCheckerImplBase::addHosts(const HostVector& hosts) {
       continue;
     }
     active_sessions_[host] = makeSession(host);
+    if (usesHealthCheckDispatchers()) {
+      session_dispatchers_.insert(&active_sessions_[host]->dispatcher_);
+    }
     host->setHealthChecker(
         HealthCheckHostMonitorPtr{new HealthCheckHostMonitorImpl(shared_from_this(), host)});
     active_sessions_[host]->start();
@@ -179,10 +211,91 @@ void HealthCheckerImplBase::onClusterMemberUpdate(const HostVector& hosts_added,
     }
     auto session_iter = active_sessions_.find(host);
     ASSERT(active_sessions_.end() != session_iter);
-    // This deletion can happen inline in response to a host failure, so we deferred delete.
     session_iter->second->onDeferredDeleteBase();
-    dispatcher_.deferredDelete(std::move(session_iter->second));
+    ActiveHealthCheckSessionPtr session = std::move(session_iter->second);
     active_sessions_.erase(session_iter);
+    deleteSession(std::move(session));
+  }
+}
+
+void HealthCheckerImplBase::deleteSession(ActiveHealthCheckSessionPtr&& session) {
+  if (!usesHealthCheckDispatchers()) {
+    // This deletion can happen inline in response to a host failure, so we deferred delete.
+    dispatcher_.deferredDelete(std::move(session));
+    return;
+  }
+
+  // Stop the session on its own dispatcher. The results it posted meanwhile are dropped by
+  // onSessionResults(), as the session is no longer active.
+  Event::Dispatcher& session_dispatcher = session->dispatcher_;
+  session_dispatcher.post([session = std::move(session)]() mutable -> void {
+    session->stopHealthChecks();
+    Event::Dispatcher& dispatcher = session->dispatcher_;
+    dispatcher.deferredDelete(std::move(session));
+  });
+}
+
+void HealthCheckerImplBase::postSessionResult(SessionResult&& result) {
+  bool first_result;
+  {
+    absl::MutexLock lock(&session_results_mutex_);
+    first_result = session_results_.empty();
+    session_results_.push_back(std::move(result));
+  }
+  // The results reported until the main thread gets to them are applied in a single batch.
+  if (first_result) {
+    dispatcher_.post([weak_this = weak_from_this()]() -> void {
+      std::shared_ptr<HealthCheckerImplBase> shared_this = weak_this.lock();
+      if (shared_this != nullptr) {
+        shared_this->onSessionResults();
+      }
+    });
+  }
+}
+
+void HealthCheckerImplBase::onSessionResults() {
+  std::vector<SessionResult> results;
+  {
+    absl::MutexLock lock(&session_results_mutex_);
+    results.swap(session_results_);
+  }
+
+  const auto find_session = [this](const SessionResult& result) -> ActiveHealthCheckSession* {
+    const auto session = active_sessions_.find(result.host_);
+    if (session == active_sessions_.end() || session->second->id_ != result.session_id_) {
+      return nullptr;
+    }
+    return session->second.get();
+  };
+
+  // The intervals to the next health checks, grouped by the dispatcher of the sessions.
+  absl::flat_hash_map<Event::Dispatcher*,
+                      std::vector<std::pair<ActiveHealthCheckSession*, std::chrono::milliseconds>>>
+      intervals;
+  for (const SessionResult& result : results) {
+    ActiveHealthCheckSession* session = find_session(result);
+    if (session == nullptr) {
+      continue;
+    }
+    const HealthState state = result.healthy_ ? HealthState::Healthy : HealthState::Unhealthy;
+    const HealthTransition changed_state =
+        result.healthy_ ? session->setHealthy(result.degraded_)
+                        : session->setUnhealthy(result.failure_type_, result.retriable_);
+    // The callbacks may have removed the host.
+    session = find_session(result);
+    if (session != nullptr) {
+      intervals[&session->dispatcher_].emplace_back(session, interval(state, changed_state));
+    }
+  }
+
+  // A session removed from now on is deleted by its dispatcher after these timers are enabled.
+  for (auto& dispatcher_intervals : intervals) {
+    dispatcher_intervals.first->post(
+        [session_intervals = std::move(dispatcher_intervals.second)]() -> void {
+          for (const auto& session_interval : session_intervals) {
+            session_interval.first->interval_timer_->enableTimer(session_interval.second);
+          }
+        });
   }
 }
 
@@ -237,10 +350,17 @@ void HealthCheckerImplBase::start() {
 
 HealthCheckerImplBase::ActiveHealthCheckSession::ActiveHealthCheckSession(
     HealthCheckerImplBase& parent, HostSharedPtr host)
-    : host_(host), parent_(parent),
-      interval_timer_(parent.dispatcher_.createTimer([this]() -> void { onIntervalBase(); })),
-      timeout_timer_(parent.dispatcher_.createTimer([this]() -> void { onTimeoutBase(); })),
+    : host_(host),
+      dispatcher_(parent.usesHealthCheckDispatchers()
+                      ? parent.health_check_dispatchers_->nextDispatcher()
+                      : parent.dispatcher_),
+      parent_(parent), id_(parent.next_session_id_++),
       time_source_(parent.dispatcher_.timeSource()) {
+  // The timers of a session running on a health check dispatcher are created by its thread, see
+  // start().
+  if (!parent.usesHealthCheckDispatchers()) {
+    createTimers();
+  }
 
   if (!host->healthFlagGet(Host::HealthFlag::FAILED_ACTIVE_HC)) {
     parent.incHealthy();
@@ -257,18 +377,46 @@ HealthCheckerImplBase::ActiveHealthCheckSession::~ActiveHealthCheckSession() {
   ASSERT(interval_timer_ == nullptr && timeout_timer_ == nullptr);
 }
 
-void HealthCheckerImplBase::ActiveHealthCheckSession::onDeferredDeleteBase() {
-  // The session is about to be deferred deleted. Make sure all timers are gone and any
-  // implementation specific state is destroyed.
+void HealthCheckerImplBase::ActiveHealthCheckSession::createTimers() {
+  interval_timer_ = dispatcher_.createTimer([this]() -> void { onIntervalBase(); });
+  timeout_timer_ = dispatcher_.createTimer([this]() -> void { onTimeoutBase(); });
+}
+
+void HealthCheckerImplBase::ActiveHealthCheckSession::start() {
+  const std::chrono::milliseconds initial_interval =
+      parent_.initial_jitter_.count() == 0
+          ? std::chrono::milliseconds(0)
+          : parent_.intervalWithJitter(0, parent_.initial_jitter_);
+  if (!parent_.usesHealthCheckDispatchers()) {
+    onInitialInterval(initial_interval);
+    return;
+  }
+
+  dispatcher_.post([this, initial_interval]() -> void {
+    createTimers();
+    onInitialInterval(initial_interval);
+  });
+}
+
+void HealthCheckerImplBase::ActiveHealthCheckSession::stopHealthChecks() {
   interval_timer_.reset();
   timeout_timer_.reset();
+  onDeferredDelete();
+}
+
+void HealthCheckerImplBase::ActiveHealthCheckSession::onDeferredDeleteBase() {
+  // The session is about to be deferred deleted. Make sure all timers are gone and any
+  // implementation specific state is destroyed. A session running on a health check dispatcher
+  // is stopped by its thread, see HealthCheckerImplBase::deleteSession().
+  if (!parent_.usesHealthCheckDispatchers()) {
+    stopHealthChecks();
+  }
   if (!host_->healthFlagGet(Host::HealthFlag::FAILED_ACTIVE_HC)) {
     parent_.decHealthy();
   }
   if (host_->healthFlagGet(Host::HealthFlag::DEGRADED_ACTIVE_HC)) {
     parent_.decDegraded();
   }
-  onDeferredDelete();
 
   // Run callbacks in case something is waiting for health checks to run which will now never run.
   if (first_check_) {
@@ -277,6 +425,20 @@ void HealthCheckerImplBase::ActiveHealthCheckSession::onDeferredDeleteBase() {
 }
 
 void HealthCheckerImplBase::ActiveHealthCheckSession::handleSuccess(bool degraded) {
+  if (parent_.usesHealthCheckDispatchers()) {
+    timeout_timer_->disableTimer();
+    // The next health check is scheduled once the main thread applied the result.
+    parent_.postSessionResult(
+        {host_, id_, /*healthy=*/true, degraded, envoy::data::core::v3::ACTIVE, false});
+    return;
+  }
+
+  const HealthTransition changed_state = setHealthy(degraded);
+  timeout_timer_->disableTimer();
+  interval_timer_->enableTimer(parent_.interval(HealthState::Healthy, changed_state));
+}
+
+HealthTransition HealthCheckerImplBase::ActiveHealthCheckSession::setHealthy(bool degraded) {
   // If we are healthy, reset the # of unhealthy to zero.
   num_unhealthy_ = 0;
 
@@ -332,9 +494,7 @@ void HealthCheckerImplBase::ActiveHealthCheckSession::handleSuccess(bool degrade
   parent_.stats_.success_.inc();
   first_check_ = false;
   parent_.runCallbacks(host_, changed_state);
-
-  timeout_timer_->disableTimer();
-  interval_timer_->enableTimer(parent_.interval(HealthState::Healthy, changed_state));
+  return changed_state;
 }
 
 namespace {
@@ -395,6 +555,16 @@ HealthTransition HealthCheckerImplBase::ActiveHealthCheckSession::setUnhealthy(
 
 void HealthCheckerImplBase::ActiveHealthCheckSession::handleFailure(
     envoy::data::core::v3::HealthCheckFailureType type, bool retriable) {
+  if (parent_.usesHealthCheckDispatchers()) {
+    // The session may already have been stopped, in which case the result is dropped.
+    if (timeout_timer_ != nullptr) {
+      timeout_timer_->disableTimer();
+    }
+    // The next health check is scheduled once the main thread applied the result.
+    parent_.postSessionResult({host_, id_, /*healthy=*/false, false, type, retriable});
+    return;
+  }
+
   HealthTransition changed_state = setUnhealthy(type, retriable);
   // It's possible that the previous call caused this session to be deferred deleted.
   if (timeout_timer_ != nullptr) {
@@ -429,12 +599,12 @@ void HealthCheckerImplBase::ActiveHealthCheckSession::onTimeoutBase() {
   handleFailure(envoy::data::core::v3::NETWORK_TIMEOUT);
 }
 
-void HealthCheckerImplBase::ActiveHealthCheckSession::onInitialInterval() {
-  if (parent_.initial_jitter_.count() == 0) {
+void HealthCheckerImplBase::ActiveHealthCheckSession::onInitialInterval(
+    std::chrono::milliseconds initial_interval) {
+  if (initial_interval.count() == 0) {
     onIntervalBase();
   } else {
-    interval_timer_->enableTimer(
-        std::chrono::milliseconds(parent_.intervalWithJitter(0, parent_.initial_jitter_)));
+    interval_timer_->enableTimer(initial_interval);
   }
 }
 
@@ -11,9 +11,14 @@
 #include "envoy/type/matcher/string.pb.h"
 #include "envoy/upstream/health_checker.h"
 
+#include "source/common/common/assert.h"
 #include "source/common/common/logger.h"
 #include "source/common/common/matchers.h"
 #include "source/common/network/transport_socket_options_impl.h"
+#include "source/common/upstream/health_check_thread_pool.h"
+
+#include "absl/container/flat_hash_set.h"
+#include "absl/synchronization/mutex.h"
 
 namespace Envoy {
 namespace Upstream {
@@ -54,6 +59,15 @@ public:
   MetadataConstSharedPtr transportSocketMatchMetadata() const {
     return transport_socket_match_metadata_;
   }
+  /**
+   * Runs the health check sessions on the given dispatchers instead of the main thread
+   * dispatcher. The hosts are still updated, and the callbacks run, on the main thread, which
+   * applies the results of the sessions in batches. Must be called before start().
+   */
+  void setHealthCheckDispatchers(HealthCheckDispatchersSharedPtr dispatchers) {
+    ASSERT(active_sessions_.empty());
+    health_check_dispatchers_ = std::move(dispatchers);
+  }
 
 protected:
   class ActiveHealthCheckSession : public Event::DeferredDeletable {
@@ -62,7 +76,7 @@ protected:
     HealthTransition setUnhealthy(envoy::data::core::v3::HealthCheckFailureType type,
                                   bool retriable);
     void onDeferredDeleteBase();
-    void start() { onInitialInterval(); }
+    void start();
 
   protected:
     ActiveHealthCheckSession(HealthCheckerImplBase& parent, HostSharedPtr host);
@@ -71,8 +85,14 @@ protected:
     void handleFailure(envoy::data::core::v3::HealthCheckFailureType type, bool retriable = false);
 
     HostSharedPtr host_;
+    // Runs the timers and the connections of the session: the main thread dispatcher, or one of
+    // the health check dispatchers.
+    Event::Dispatcher& dispatcher_;
 
   private:
+    friend class HealthCheckerImplBase;
+
+    HealthTransition setHealthy(bool degraded);
     // Clears the pending flag if it is set. By clearing this flag we're marking the host as having
     // been health checked.
     // Returns the changed state to use following the flag update.
@@ -82,9 +102,13 @@ protected:
     virtual void onTimeout() PURE;
     void onTimeoutBase();
     virtual void onDeferredDelete() PURE;
-    void onInitialInterval();
+    void onInitialInterval(std::chrono::milliseconds initial_interval);
+    void createTimers();
+    void stopHealthChecks();
 
     HealthCheckerImplBase& parent_;
+    // Identifies the session in the results it reports to the main thread.
+    const uint64_t id_;
     Event::TimerPtr interval_timer_;
     Event::TimerPtr timeout_timer_;
     uint32_t num_unhealthy_{};
@@ -102,6 +126,7 @@ protected:
 
   virtual ActiveHealthCheckSessionPtr makeSession(HostSharedPtr host) PURE;
   virtual envoy::data::core::v3::HealthCheckerType healthCheckerType() const PURE;
+  bool usesHealthCheckDispatchers() const { return health_check_dispatchers_ != nullptr; }
 
   const bool always_log_health_check_failures_;
   const Cluster& cluster_;
@@ -128,7 +153,18 @@ private:
     std::weak_ptr<Host> host_;
   };
 
+  // The result of a health check run on a health check dispatcher.
+  struct SessionResult {
+    HostSharedPtr host_;
+    uint64_t session_id_;
+    bool healthy_;
+    bool degraded_;
+    envoy::data::core::v3::HealthCheckFailureType failure_type_;
+    bool retriable_;
+  };
+
   void addHosts(const HostVector& hosts);
+  void deleteSession(ActiveHealthCheckSessionPtr&& session);
   void decHealthy();
   void decDegraded();
   HealthCheckerStats generateStats(Stats::Scope& scope);
@@ -138,6 +174,8 @@ private:
   std::chrono::milliseconds intervalWithJitter(uint64_t base_time_ms,
                                                std::chrono::milliseconds interval_jitter) const;
   void onClusterMemberUpdate(const HostVector& hosts_added, const HostVector& hosts_removed);
+  void onSessionResults();
+  void postSessionResult(SessionResult&& result);
   void runCallbacks(HostSharedPtr host, HealthTransition changed_state);
   void setUnhealthyCrossThread(const HostSharedPtr& host,
                                HealthCheckHostMonitor::UnhealthyType type);
@@ -160,6 +198,13 @@ private:
   const std::shared_ptr<const Network::TransportSocketOptionsImpl> transport_socket_options_;
   const MetadataConstSharedPtr transport_socket_match_metadata_;
   const Common::CallbackHandlePtr member_update_cb_;
+  HealthCheckDispatchersSharedPtr health_check_dispatchers_;
+  // The health check dispatchers the sessions ever ran on.
+  absl::flat_hash_set<Event::Dispatcher*> session_dispatchers_;
+  uint64_t next_session_id_{};
+  absl::Mutex session_results_mutex_;
+  // Results posted by the health check dispatchers and not yet applied by the main thread.
+  std::vector<SessionResult> session_results_ ABSL_GUARDED_BY(session_results_mutex_);
 };
 
 } // namespace Upstream
@@ -48,9 +48,11 @@ getMethod(const envoy::config::core::v3::RequestMethod config_method) {
 Upstream::HealthCheckerSharedPtr HttpHealthCheckerFactory::createCustomHealthChecker(
     const envoy::config::core::v3::HealthCheck& config,
     Server::Configuration::HealthCheckerFactoryContext& context) {
-  return std::make_shared<ProdHttpHealthCheckerImpl>(
+  auto health_checker = std::make_shared<ProdHttpHealthCheckerImpl>(
       context.cluster(), config, context.mainThreadDispatcher(), context.runtime(),
       context.api().randomGenerator(), context.eventLogger());
+  health_checker->setHealthCheckDispatchers(Upstream::HealthCheckThreadPool::get(context));
+  return health_checker;
 }
 
 REGISTER_FACTORY(HttpHealthCheckerFactory, Server::Configuration::CustomHealthCheckerFactory);
@@ -237,7 +239,7 @@ void HttpHealthCheckerImpl::HttpActiveHealthCheckSession::onEvent(Network::Conne
     // timer. There is nothing to do here other than blow away the client.
     response_headers_.reset();
     response_body_->drain(response_body_->length());
-    parent_.dispatcher_.deferredDelete(std::move(client_));
+    dispatcher_.deferredDelete(std::move(client_));
   }
 }
 
@@ -245,7 +247,7 @@ void HttpHealthCheckerImpl::HttpActiveHealthCheckSession::onEvent(Network::Conne
 void HttpHealthCheckerImpl::HttpActiveHealthCheckSession::onInterval() {
   if (!client_) {
     Upstream::Host::CreateConnectionData conn =
-        host_->createHealthCheckConnection(parent_.dispatcher_, parent_.transportSocketOptions(),
+        host_->createHealthCheckConnection(dispatcher_, parent_.transportSocketOptions(),
                                            parent_.transportSocketMatchMetadata().get());
     client_.reset(parent_.createCodecClient(conn));
     client_->addConnectionCallbacks(connection_callback_impl_);
@@ -268,7 +270,7 @@ void HttpHealthCheckerImpl::HttpActiveHealthCheckSession::onInterval() {
       // Here there is no downstream connection so scheme will be based on
       // upstream crypto
       host_->transportSocketFactory().implementsSecureTransport());
-  StreamInfo::StreamInfoImpl stream_info(protocol_, parent_.dispatcher_.timeSource(),
+  StreamInfo::StreamInfoImpl stream_info(protocol_, dispatcher_.timeSource(),
                                          local_connection_info_provider_);
   stream_info.setUpstreamInfo(std::make_shared<StreamInfo::UpstreamInfoImpl>());
   stream_info.upstreamInfo()->setUpstreamHost(host_);
@@ -442,8 +444,11 @@ HttpHealthCheckerImpl::codecClientType(const envoy::type::v3::CodecClientType& t
 
 Http::CodecClient*
 ProdHttpHealthCheckerImpl::createCodecClient(Upstream::Host::CreateConnectionData& data) {
+  // The connection was created on the dispatcher of the session, which may not be the main thread
+  // dispatcher.
+  Event::Dispatcher& dispatcher = data.connection_->dispatcher();
   return new Http::CodecClientProd(codec_client_type_, std::move(data.connection_),
-                                   data.host_description_, dispatcher_, random_generator_,
+                                   data.host_description_, dispatcher, random_generator_,
                                    transportSocketOptions());
 }
 
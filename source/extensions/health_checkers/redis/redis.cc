@@ -66,14 +66,14 @@ void RedisHealthChecker::RedisActiveHealthCheckSession::onEvent(Network::Connect
       event == Network::ConnectionEvent::LocalClose) {
     // This should only happen after any active requests have been failed/cancelled.
     ASSERT(!current_request_);
-    parent_.dispatcher_.deferredDelete(std::move(client_));
+    dispatcher_.deferredDelete(std::move(client_));
   }
 }
 
 void RedisHealthChecker::RedisActiveHealthCheckSession::onInterval() {
   if (!client_) {
     client_ =
-        parent_.client_factory_.create(host_, parent_.dispatcher_, *this, redis_command_stats_,
+        parent_.client_factory_.create(host_, dispatcher_, *this, redis_command_stats_,
                                        parent_.cluster_.info()->statsScope(),
                                        parent_.auth_username_, parent_.auth_password_, false);
     client_->addConnectionCallbacks(*this);
@@ -94,7 +94,7 @@ void ThriftHealthChecker::ThriftActiveHealthCheckSession::onResponseResult(bool
 
 Upstream::Host::CreateConnectionData
 ThriftHealthChecker::ThriftActiveHealthCheckSession::createConnection() {
-  return host_->createHealthCheckConnection(parent_.dispatcher_, parent_.transportSocketOptions(),
+  return host_->createHealthCheckConnection(dispatcher_, parent_.transportSocketOptions(),
                                             parent_.transportSocketMatchMetadata().get());
 }
 
@@ -109,7 +109,7 @@ void ThriftHealthChecker::ThriftActiveHealthCheckSession::onEvent(Network::Conne
 
     if (client_) {
       // Report failure if the connection was closed without receiving a full response.
-      parent_.dispatcher_.deferredDelete(std::move(client_));
+      dispatcher_.deferredDelete(std::move(client_));
     }
   }
 }
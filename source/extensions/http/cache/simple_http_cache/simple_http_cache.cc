@@ -1,5 +1,8 @@
 #include "source/extensions/http/cache/simple_http_cache/simple_http_cache.h"
 
+#include <limits>
+
+#include "envoy/common/exception.h"
 #include "envoy/extensions/http/cache/simple_http_cache/v3/config.pb.h"
 #include "envoy/registry/registry.h"
 
@@ -31,6 +34,24 @@ absl::optional<Key> variedRequestKey(const LookupRequest& request,
   return varied_request_key;
 }
 
+SimpleHttpCacheStats generateStats(Stats::Scope& scope, uint32_t shard_index) {
+  const std::string prefix = absl::StrCat("simple_http_cache.shard_", shard_index, ".");
+  return {ALL_SIMPLE_HTTP_CACHE_STATS(POOL_COUNTER_PREFIX(scope, prefix),
+                                      POOL_GAUGE_PREFIX(scope, prefix))};
+}
+
+// Returns the number of bytes accounted for an entry in the budget of the cache.
+template <class EntryType> uint64_t entrySize(const Key& key, const EntryType& entry) {
+  uint64_t size = key.ByteSizeLong() + entry.body_.size();
+  if (entry.response_headers_) {
+    size += entry.response_headers_->byteSize();
+  }
+  if (entry.trailers_) {
+    size += entry.trailers_->byteSize();
+  }
+  return size;
+}
+
 class SimpleLookupContext : public LookupContext {
 public:
   SimpleLookupContext(SimpleHttpCache& cache, LookupRequest&& request)
@@ -137,6 +158,144 @@ private:
 };
 } // namespace
 
+SimpleHttpCache::Shard::Shard(uint64_t max_size_bytes, Stats::Scope& scope, uint32_t index)
+    : max_size_bytes_(max_size_bytes), stats_(generateStats(scope, index)) {}
+
+SimpleHttpCache::Entry SimpleHttpCache::Shard::lookup(const Key& key) {
+  absl::ReaderMutexLock lock(&mutex_);
+  auto iter = map_.find(key);
+  if (iter == map_.end()) {
+    return Entry{};
+  }
+  const StoredEntry& stored = iter->second;
+  ASSERT(stored.entry_.response_headers_);
+  // Only the reference bit is written, so the lookups of a shard can run concurrently.
+  stored.referenced_.store(true, std::memory_order_relaxed);
+
+  Http::ResponseTrailerMapPtr trailers_map;
+  if (stored.entry_.trailers_) {
+    trailers_map = Http::createHeaderMap<Http::ResponseTrailerMapImpl>(*stored.entry_.trailers_);
+  }
+  return SimpleHttpCache::Entry{
+      Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*stored.entry_.response_headers_),
+      stored.entry_.metadata_, stored.entry_.body_, std::move(trailers_map)};
+}
+
+Http::ResponseHeaderMapPtr SimpleHttpCache::Shard::lookupHeaders(const Key& key) {
+  absl::ReaderMutexLock lock(&mutex_);
+  auto iter = map_.find(key);
+  if (iter == map_.end() || !iter->second.entry_.response_headers_) {
+    return nullptr;
+  }
+  return Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*iter->second.entry_.response_headers_);
+}
+
+bool SimpleHttpCache::Shard::insert(const Key& key, Entry&& entry) {
+  absl::WriterMutexLock lock(&mutex_);
+  return insertLocked(key, std::move(entry));
+}
+
+bool SimpleHttpCache::Shard::insertIfAbsent(const Key& key, Entry&& entry) {
+  absl::WriterMutexLock lock(&mutex_);
+  if (map_.contains(key)) {
+    return false;
+  }
+  return insertLocked(key, std::move(entry));
+}
+
+bool SimpleHttpCache::Shard::updateHeaders(const Key& key,
+                                           const Http::ResponseHeaderMap& response_headers,
+                                           const ResponseMetadata& metadata) {
+  absl::WriterMutexLock lock(&mutex_);
+  auto iter = map_.find(key);
+  if (iter == map_.end() || !iter->second.entry_.response_headers_) {
+    return false;
+  }
+  StoredEntry& stored = iter->second;
+  updateSizeLocked(stored, false);
+  applyHeaderUpdate(response_headers, *stored.entry_.response_headers_);
+  stored.entry_.metadata_ = metadata;
+  stored.size_bytes_ = entrySize(key, stored.entry_);
+  updateSizeLocked(stored, true);
+  evictLocked();
+  stats_.size_count_.set(map_.size());
+  return true;
+}
+
+bool SimpleHttpCache::Shard::insertLocked(const Key& key, Entry&& entry) {
+  const uint64_t size_bytes = entrySize(key, entry);
+  if (size_bytes > max_size_bytes_) {
+    stats_.insert_rejected_.inc();
+    return false;
+  }
+
+  auto [iter, inserted] = map_.try_emplace(key);
+  StoredEntry& stored = iter->second;
+  if (inserted) {
+    stored.clock_iter_ = clock_.insert(clock_.end(), &iter->first);
+  } else {
+    updateSizeLocked(stored, false);
+    clock_.splice(clock_.end(), clock_, stored.clock_iter_);
+  }
+  stored.entry_ = std::move(entry);
+  stored.size_bytes_ = size_bytes;
+  stored.referenced_.store(false, std::memory_order_relaxed);
+  updateSizeLocked(stored, true);
+  stats_.insert_.inc();
+
+  evictLocked();
+  stats_.size_count_.set(map_.size());
+  return true;
+}
+
+void SimpleHttpCache::Shard::evictLocked() {
+  // Terminates since the reference bit of a skipped entry is cleared. A newly inserted entry is at
+  // the back and fits in the budget by itself, so it is only evicted by a later insertion.
+  while (size_bytes_ > max_size_bytes_) {
+    ASSERT(!clock_.empty());
+    auto iter = map_.find(*clock_.front());
+    ASSERT(iter != map_.end());
+    StoredEntry& stored = iter->second;
+    if (stored.referenced_.load(std::memory_order_relaxed)) {
+      stored.referenced_.store(false, std::memory_order_relaxed);
+      clock_.splice(clock_.end(), clock_, stored.clock_iter_);
+      continue;
+    }
+    updateSizeLocked(stored, false);
+    clock_.erase(stored.clock_iter_);
+    map_.erase(iter);
+    stats_.eviction_.inc();
+  }
+}
+
+void SimpleHttpCache::Shard::updateSizeLocked(const StoredEntry& stored, bool add) {
+  if (add) {
+    size_bytes_ += stored.size_bytes_;
+    stats_.size_bytes_.add(stored.size_bytes_);
+  } else {
+    size_bytes_ -= stored.size_bytes_;
+    stats_.size_bytes_.sub(stored.size_bytes_);
+  }
+}
+
+SimpleHttpCache::SimpleHttpCache(
+    const envoy::extensions::http::cache::simple_http_cache::v3::SimpleHttpCacheConfig& config,
+    Stats::Scope& scope)
+    : config_(config) {
+  const uint32_t num_shards = PROTOBUF_GET_WRAPPED_OR_DEFAULT(config, num_shards, DefaultNumShards);
+  const uint64_t max_size_bytes = PROTOBUF_GET_WRAPPED_OR_DEFAULT(
+      config, max_cache_size_bytes, std::numeric_limits<uint64_t>::max());
+  shards_.reserve(num_shards);
+  for (uint32_t i = 0; i < num_shards; i++) {
+    shards_.push_back(std::make_unique<Shard>(max_size_bytes / num_shards, scope, i));
+  }
+}
+
+SimpleHttpCache::Shard& SimpleHttpCache::shardFor(const Key& key) {
+  // The high bits are used so the keys of a shard still differ in the low bits used by the map.
+  return *shards_[(MessageUtil::hash(key) >> 32) % shards_.size()];
+}
+
 LookupContextPtr SimpleHttpCache::makeLookupContext(LookupRequest&& request,
                                                     Http::StreamDecoderFilterCallbacks&) {
   return std::make_unique<SimpleLookupContext>(*this, std::move(request));
@@ -148,87 +307,57 @@ void SimpleHttpCache::updateHeaders(const LookupContext& lookup_context,
                                     std::function<void(bool)> on_complete) {
   const auto& simple_lookup_context = static_cast<const SimpleLookupContext&>(lookup_context);
   const Key& key = simple_lookup_context.request().key();
-  absl::WriterMutexLock lock(&mutex_);
-  auto iter = map_.find(key);
-  if (iter == map_.end() || !iter->second.response_headers_) {
+  Shard& shard = shardFor(key);
+  Http::ResponseHeaderMapPtr cached_headers = shard.lookupHeaders(key);
+  if (!cached_headers) {
     on_complete(false);
     return;
   }
-  if (VaryHeaderUtils::hasVary(*iter->second.response_headers_)) {
+  if (VaryHeaderUtils::hasVary(*cached_headers)) {
     absl::optional<Key> varied_key =
-        variedRequestKey(simple_lookup_context.request(), *iter->second.response_headers_);
+        variedRequestKey(simple_lookup_context.request(), *cached_headers);
     if (!varied_key.has_value()) {
       on_complete(false);
       return;
     }
-    iter = map_.find(varied_key.value());
-    if (iter == map_.end() || !iter->second.response_headers_) {
-      on_complete(false);
-      return;
-    }
+    on_complete(shardFor(varied_key.value())
+                    .updateHeaders(varied_key.value(), response_headers, metadata));
+    return;
   }
-  Entry& entry = iter->second;
-
-  applyHeaderUpdate(response_headers, *entry.response_headers_);
-  entry.metadata_ = metadata;
-  on_complete(true);
+  on_complete(shard.updateHeaders(key, response_headers, metadata));
 }
 
 SimpleHttpCache::Entry SimpleHttpCache::lookup(const LookupRequest& request) {
-  absl::ReaderMutexLock lock(&mutex_);
-  auto iter = map_.find(request.key());
-  if (iter == map_.end()) {
-    return Entry{};
+  Shard& shard = shardFor(request.key());
+  Entry entry = shard.lookup(request.key());
+  if (entry.response_headers_ && VaryHeaderUtils::hasVary(*entry.response_headers_)) {
+    entry = varyLookup(request, entry.response_headers_);
   }
-  ASSERT(iter->second.response_headers_);
-
-  if (VaryHeaderUtils::hasVary(*iter->second.response_headers_)) {
-    return varyLookup(request, iter->second.response_headers_);
+  if (entry.response_headers_) {
+    shard.stats().lookup_hit_.inc();
   } else {
-    Http::ResponseTrailerMapPtr trailers_map;
-    if (iter->second.trailers_) {
-      trailers_map = Http::createHeaderMap<Http::ResponseTrailerMapImpl>(*iter->second.trailers_);
-    }
-    return SimpleHttpCache::Entry{
-        Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*iter->second.response_headers_),
-        iter->second.metadata_, iter->second.body_, std::move(trailers_map)};
+    shard.stats().lookup_miss_.inc();
   }
+  return entry;
 }
 
 bool SimpleHttpCache::insert(const Key& key, Http::ResponseHeaderMapPtr&& response_headers,
                              ResponseMetadata&& metadata, std::string&& body,
                              Http::ResponseTrailerMapPtr&& trailers) {
-  absl::WriterMutexLock lock(&mutex_);
-  map_[key] = SimpleHttpCache::Entry{std::move(response_headers), std::move(metadata),
-                                     std::move(body), std::move(trailers)};
-  return true;
+  return shardFor(key).insert(key, SimpleHttpCache::Entry{std::move(response_headers),
+                                                          std::move(metadata), std::move(body),
+                                                          std::move(trailers)});
 }
 
 SimpleHttpCache::Entry
 SimpleHttpCache::varyLookup(const LookupRequest& request,
                             const Http::ResponseHeaderMapPtr& response_headers) {
-  // This method should be called from lookup, which holds the mutex for reading.
-  mutex_.AssertReaderHeld();
-
   absl::optional<Key> varied_key = variedRequestKey(request, *response_headers);
   if (!varied_key.has_value()) {
     return SimpleHttpCache::Entry{};
   }
-  Key& varied_request_key = varied_key.value();
-
-  auto iter = map_.find(varied_request_key);
-  if (iter == map_.end()) {
-    return SimpleHttpCache::Entry{};
-  }
-  ASSERT(iter->second.response_headers_);
-  Http::ResponseTrailerMapPtr trailers_map;
-  if (iter->second.trailers_) {
-    trailers_map = Http::createHeaderMap<Http::ResponseTrailerMapImpl>(*iter->second.trailers_);
-  }
-
-  return SimpleHttpCache::Entry{
-      Http::createHeaderMap<Http::ResponseHeaderMapImpl>(*iter->second.response_headers_),
-      iter->second.metadata_, iter->second.body_, std::move(trailers_map)};
+  // The varied response may live in another shard than the vary-only entry.
+  return shardFor(varied_key.value()).lookup(varied_key.value());
 }
 
 bool SimpleHttpCache::varyInsert(const Key& request_key,
@@ -237,8 +366,6 @@ bool SimpleHttpCache::varyInsert(const Key& request_key,
                                  const Http::RequestHeaderMap& request_headers,
                                  const VaryAllowList& vary_allow_list,
                                  Http::ResponseTrailerMapPtr&& trailers) {
-  absl::WriterMutexLock lock(&mutex_);
-
   absl::btree_set<absl::string_view> vary_header_values =
       VaryHeaderUtils::getVaryValues(*response_headers);
   ASSERT(!vary_header_values.empty());
@@ -252,25 +379,29 @@ bool SimpleHttpCache::varyInsert(const Key& request_key,
     return false;
   }
 
+  // Build the vary-only entry before the response headers are moved into the varied entry.
+  Envoy::Http::ResponseHeaderMapPtr vary_only_map =
+      Envoy::Http::createHeaderMap<Envoy::Http::ResponseHeaderMapImpl>({});
+  vary_only_map->setCopy(Envoy::Http::CustomHeaders::get().Vary,
+                         absl::StrJoin(vary_header_values, ","));
+
   varied_request_key.add_custom_fields(vary_identifier.value());
-  map_[varied_request_key] = SimpleHttpCache::Entry{
-      std::move(response_headers), std::move(metadata), std::move(body), std::move(trailers)};
+  if (!shardFor(varied_request_key)
+           .insert(varied_request_key,
+                   SimpleHttpCache::Entry{std::move(response_headers), std::move(metadata),
+                                          std::move(body), std::move(trailers)})) {
+    return false;
+  }
 
   // Add a special entry to flag that this request generates varied responses.
-  auto iter = map_.find(request_key);
-  if (iter == map_.end()) {
-    Envoy::Http::ResponseHeaderMapPtr vary_only_map =
-        Envoy::Http::createHeaderMap<Envoy::Http::ResponseHeaderMapImpl>({});
-    vary_only_map->setCopy(Envoy::Http::CustomHeaders::get().Vary,
-                           absl::StrJoin(vary_header_values, ","));
-    // TODO(cbdm): In a cache that evicts entries, we could maintain a list of the "varykey"s that
-    // we have inserted as the body for this first lookup. This way, we would know which keys we
-    // have inserted for that resource. For the first entry simply use vary_identifier as the
-    // entry_list; for future entries append vary_identifier to existing list.
-    std::string entry_list;
-    map_[request_key] =
-        SimpleHttpCache::Entry{std::move(vary_only_map), {}, std::move(entry_list), {}};
-  }
+  // TODO(cbdm): In a cache that evicts entries, we could maintain a list of the "varykey"s that
+  // we have inserted as the body for this first lookup. This way, we would know which keys we
+  // have inserted for that resource. For the first entry simply use vary_identifier as the
+  // entry_list; for future entries append vary_identifier to existing list.
+  std::string entry_list;
+  shardFor(request_key)
+      .insertIfAbsent(request_key,
+                      SimpleHttpCache::Entry{std::move(vary_only_map), {}, std::move(entry_list), {}});
   return true;
 }
 
@@ -301,15 +432,21 @@ public:
   }
   // From HttpCacheFactory
   std::shared_ptr<HttpCache>
-  getCache(const envoy::extensions::filters::http::cache::v3::CacheConfig&,
+  getCache(const envoy::extensions::filters::http::cache::v3::CacheConfig& filter_config,
            Server::Configuration::FactoryContext& context) override {
-    return context.singletonManager().getTyped<SimpleHttpCache>(
-        SINGLETON_MANAGER_REGISTERED_NAME(simple_http_cache_singleton), &createCache);
-  }
-
-private:
-  static std::shared_ptr<Singleton::Instance> createCache() {
-    return std::make_shared<SimpleHttpCache>();
+    envoy::extensions::http::cache::simple_http_cache::v3::SimpleHttpCacheConfig config;
+    MessageUtil::unpackTo(filter_config.typed_config(), config);
+    // The cache is shared by all the filters, so its stats are not tied to a listener's scope.
+    std::shared_ptr<SimpleHttpCache> cache = context.singletonManager().getTyped<SimpleHttpCache>(
+        SINGLETON_MANAGER_REGISTERED_NAME(simple_http_cache_singleton), [&config, &context] {
+          return std::make_shared<SimpleHttpCache>(config, context.serverScope());
+        });
+    if (!Protobuf::util::MessageDifferencer::Equals(cache->config(), config)) {
+      throw EnvoyException(
+          fmt::format("mismatched SimpleHttpCacheConfig for the shared cache\n{}\nvs.\n{}",
+                      cache->config().DebugString(), config.DebugString()));
+    }
+    return cache;
   }
 };
 
@@ -1,10 +1,20 @@
 #pragma once
 
+#include <atomic>
+#include <list>
+#include <memory>
+#include <vector>
+
+#include "envoy/extensions/http/cache/simple_http_cache/v3/config.pb.h"
+#include "envoy/stats/scope.h"
+#include "envoy/stats/stats_macros.h"
+
 #include "source/common/protobuf/utility.h"
 #include "source/extensions/filters/http/cache/http_cache.h"
 
 #include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/node_hash_map.h"
 #include "absl/synchronization/mutex.h"
 
 namespace Envoy {
@@ -12,7 +22,28 @@ namespace Extensions {
 namespace HttpFilters {
 namespace Cache {
 
-// Example cache backend that never evicts. Not suitable for production use.
+/**
+ * All stats of a SimpleHttpCache shard. @see stats_macros.h
+ */
+#define ALL_SIMPLE_HTTP_CACHE_STATS(COUNTER, GAUGE)                                                \
+  COUNTER(eviction)                                                                                \
+  COUNTER(insert)                                                                                  \
+  COUNTER(insert_rejected)                                                                         \
+  COUNTER(lookup_hit)                                                                              \
+  COUNTER(lookup_miss)                                                                             \
+  GAUGE(size_bytes, NeverImport)                                                                   \
+  GAUGE(size_count, NeverImport)
+
+/**
+ * Struct definition for the stats of a SimpleHttpCache shard. @see stats_macros.h
+ */
+struct SimpleHttpCacheStats {
+  ALL_SIMPLE_HTTP_CACHE_STATS(GENERATE_COUNTER_STRUCT, GENERATE_GAUGE_STRUCT)
+};
+
+// In-memory cache backend. The entries are sharded by the hash of the key, each shard has its own
+// lock and byte budget. Lookups only take the shard lock for reading; the recency of an entry is
+// tracked with an atomic reference bit, and entries are evicted in CLOCK (second chance) order.
 class SimpleHttpCache : public HttpCache, public Singleton::Instance {
 private:
   struct Entry {
@@ -22,6 +53,52 @@ private:
     Http::ResponseTrailerMapPtr trailers_;
   };
 
+  struct StoredEntry {
+    Entry entry_;
+    uint64_t size_bytes_{0};
+    // Position of the entry in the CLOCK queue of the shard.
+    std::list<const Key*>::iterator clock_iter_;
+    // Set by the lookups, which only hold the lock for reading.
+    mutable std::atomic<bool> referenced_{false};
+  };
+
+  class Shard {
+  public:
+    Shard(uint64_t max_size_bytes, Stats::Scope& scope, uint32_t index);
+
+    // Returns a copy of the entry of the key, or an empty entry if not found.
+    Entry lookup(const Key& key);
+    // Inserts or replaces the entry of the key, then evicts entries until the shard fits in its
+    // budget. Returns false if the entry alone is larger than the budget.
+    bool insert(const Key& key, Entry&& entry);
+    // Inserts the entry only if the key is not cached yet.
+    bool insertIfAbsent(const Key& key, Entry&& entry);
+    // Applies the header update to the entry of the key. Returns false if not found.
+    bool updateHeaders(const Key& key, const Http::ResponseHeaderMap& response_headers,
+                       const ResponseMetadata& metadata);
+    // Returns a copy of the response headers of the entry of the key, or nullptr if not found.
+    Http::ResponseHeaderMapPtr lookupHeaders(const Key& key);
+
+    SimpleHttpCacheStats& stats() { return stats_; }
+
+  private:
+    bool insertLocked(const Key& key, Entry&& entry) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+    void evictLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+    void updateSizeLocked(const StoredEntry& stored, bool add) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+    const uint64_t max_size_bytes_;
+    SimpleHttpCacheStats stats_;
+    absl::Mutex mutex_;
+    // node_hash_map keeps the entries at stable addresses, so the CLOCK queue can refer to the
+    // keys and the reference bits are never moved.
+    absl::node_hash_map<Key, StoredEntry, MessageUtil, MessageUtil> map_ ABSL_GUARDED_BY(mutex_);
+    // The front is the next eviction candidate, new and re-referenced entries go to the back.
+    std::list<const Key*> clock_ ABSL_GUARDED_BY(mutex_);
+    uint64_t size_bytes_ ABSL_GUARDED_BY(mutex_){0};
+  };
+
+  Shard& shardFor(const Key& key);
+
   // Looks for a response that has been varied. Only called from lookup.
   Entry varyLookup(const LookupRequest& request,
                    const Http::ResponseHeaderMapPtr& response_headers);
@@ -32,7 +109,16 @@ private:
   // https://www.ietf.org/archive/id/draft-ietf-httpbis-cache-18.html s3.2
   static const absl::flat_hash_set<Http::LowerCaseString> headersNotToUpdate();
 
+  static constexpr uint32_t DefaultNumShards = 16;
+
+  const envoy::extensions::http::cache::simple_http_cache::v3::SimpleHttpCacheConfig config_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+
 public:
+  SimpleHttpCache(
+      const envoy::extensions::http::cache::simple_http_cache::v3::SimpleHttpCacheConfig& config,
+      Stats::Scope& scope);
+
   // HttpCache
   LookupContextPtr makeLookupContext(LookupRequest&& request,
                                      Http::StreamDecoderFilterCallbacks& callbacks) override;
@@ -55,8 +141,12 @@ public:
                   const Http::RequestHeaderMap& request_headers,
                   const VaryAllowList& vary_allow_list, Http::ResponseTrailerMapPtr&& trailers);
 
-  absl::Mutex mutex_;
-  absl::flat_hash_map<Key, Entry, MessageUtil, MessageUtil> map_ ABSL_GUARDED_BY(mutex_);
+  const envoy::extensions::http::cache::simple_http_cache::v3::SimpleHttpCacheConfig&
+  config() const {
+    return config_;
+  }
+  uint32_t numShards() const { return shards_.size(); }
+  SimpleHttpCacheStats& shardStats(uint32_t index) { return shards_[index]->stats(); }
 };
 
 } // namespace Cache
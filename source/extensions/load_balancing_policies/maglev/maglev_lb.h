@@ -188,6 +188,8 @@ public:
                      uint32_t healthy_panic_threshold,
                      const envoy::extensions::load_balancing_policies::maglev::v3::Maglev& config);
 
+  ~MaglevLoadBalancer() override { stopBackgroundBuilds(); }
+
   const MaglevLoadBalancerStats& stats() const { return stats_; }
   uint64_t tableSize() const { return table_size_; }
 
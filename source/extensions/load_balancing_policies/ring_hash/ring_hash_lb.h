@@ -84,6 +84,8 @@ public:
       Runtime::Loader& runtime, Random::RandomGenerator& random, uint32_t healthy_panic_threshold,
       const envoy::extensions::load_balancing_policies::ring_hash::v3::RingHash& config);
 
+  ~RingHashLoadBalancer() override { stopBackgroundBuilds(); }
+
   const RingHashLoadBalancerStats& stats() const { return stats_; }
 
 private:
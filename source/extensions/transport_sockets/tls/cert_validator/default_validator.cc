@@ -189,6 +189,21 @@ int DefaultCertValidator::initializeSslContexts(std::vector<SSL_CTX*> contexts,
       }
       verify_mode = verify_mode_validation_context;
     }
+
+    // Only the verification against the trusted CA is worth moving off the worker threads.
+    if (cert_validation_config->asyncValidation() != nullptr && verify_trusted_ca_) {
+      const auto& async_validation = *cert_validation_config->asyncValidation();
+      verification_pool_ = std::make_unique<VerificationPool>(
+          cert_validation_config->api().threadFactory(),
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(async_validation, num_threads, 1),
+          PROTOBUF_GET_WRAPPED_OR_DEFAULT(async_validation, max_pending, 1024));
+      if (async_validation.has_cache_ttl()) {
+        verified_cert_cache_ = std::make_unique<VerifiedCertCache>(
+            time_source_,
+            std::chrono::milliseconds(PROTOBUF_GET_MS_REQUIRED(async_validation, cache_ttl)),
+            PROTOBUF_GET_WRAPPED_OR_DEFAULT(async_validation, max_cached_certificates, 10000));
+      }
+    }
   }
 
   return verify_mode;
@@ -280,7 +295,7 @@ DefaultCertValidator::verifyCertificate(X509* cert, const std::vector<std::strin
 }
 
 ValidationResults DefaultCertValidator::doVerifyCertChain(
-    STACK_OF(X509)& cert_chain, Ssl::ValidateResultCallbackPtr /*callback*/,
+    STACK_OF(X509)& cert_chain, Ssl::ValidateResultCallbackPtr callback,
     const Network::TransportSocketOptionsConstSharedPtr& transport_socket_options, SSL_CTX& ssl_ctx,
     const CertValidator::ExtraValidationContext& /*validation_context*/, bool is_server,
     absl::string_view /*host_name*/) {
@@ -291,11 +306,48 @@ ValidationResults DefaultCertValidator::doVerifyCertChain(
     return {ValidationResults::ValidationStatus::Failed,
             Envoy::Ssl::ClientValidationStatus::NoClientCertificate, absl::nullopt, error};
   }
+  X509* leaf_cert = sk_X509_value(&cert_chain, 0);
+  ASSERT(leaf_cert);
+  bool chain_verified = false;
+  if (verified_cert_cache_ != nullptr && verified_cert_cache_->contains(*leaf_cert)) {
+    stats_.verify_cache_hit_.inc();
+    chain_verified = true;
+  }
+  if (!chain_verified && verification_pool_ != nullptr && callback != nullptr) {
+    // The verification may outlive the connection, so it holds its own references to the chain
+    // and to the context.
+    bssl::UniquePtr<STACK_OF(X509)> chain(X509_chain_up_ref(&cert_chain));
+    SSL_CTX_up_ref(&ssl_ctx);
+    bssl::UniquePtr<SSL_CTX> ssl_ctx_ref(&ssl_ctx);
+    const bool enqueued = verification_pool_->enqueue(
+        [this, chain = std::move(chain), ssl_ctx_ref = std::move(ssl_ctx_ref),
+         transport_socket_options, is_server]() {
+          return verifyChain(*chain, transport_socket_options.get(), *ssl_ctx_ref, is_server,
+                             false);
+        },
+        callback);
+    if (enqueued) {
+      stats_.verify_offloaded_.inc();
+      return {ValidationResults::ValidationStatus::Pending,
+              Envoy::Ssl::ClientValidationStatus::NotValidated, absl::nullopt, absl::nullopt};
+    }
+    stats_.verify_queue_full_.inc();
+  }
+  return verifyChain(cert_chain, transport_socket_options.get(), ssl_ctx, is_server,
+                     chain_verified);
+}
+
+ValidationResults
+DefaultCertValidator::verifyChain(STACK_OF(X509)& cert_chain,
+                                  const Network::TransportSocketOptions* transport_socket_options,
+                                  SSL_CTX& ssl_ctx, bool is_server, bool chain_verified) {
   Envoy::Ssl::ClientValidationStatus detailed_status =
       Envoy::Ssl::ClientValidationStatus::NotValidated;
   X509* leaf_cert = sk_X509_value(&cert_chain, 0);
   ASSERT(leaf_cert);
-  if (verify_trusted_ca_) {
+  if (chain_verified) {
+    detailed_status = Envoy::Ssl::ClientValidationStatus::Validated;
+  } else if (verify_trusted_ca_) {
     X509_STORE* verify_store = SSL_CTX_get_cert_store(&ssl_ctx);
     ASSERT(verify_store);
     bssl::UniquePtr<X509_STORE_CTX> ctx(X509_STORE_CTX_new());
@@ -331,10 +383,13 @@ ValidationResults DefaultCertValidator::doVerifyCertChain(
               SSL_alert_from_verify_result(X509_STORE_CTX_get_error(ctx.get())), error};
     }
     detailed_status = Envoy::Ssl::ClientValidationStatus::Validated;
+    if (verified_cert_cache_ != nullptr) {
+      verified_cert_cache_->insert(*leaf_cert);
+    }
   }
   std::string error_details;
   uint8_t tls_alert = SSL_AD_CERTIFICATE_UNKNOWN;
-  const bool succeeded = verifyCertAndUpdateStatus(leaf_cert, transport_socket_options.get(),
+  const bool succeeded = verifyCertAndUpdateStatus(leaf_cert, transport_socket_options,
                                                    detailed_status, &error_details, &tls_alert);
   return succeeded ? ValidationResults{ValidationResults::ValidationStatus::Successful,
                                        detailed_status, absl::nullopt, absl::nullopt}
@@ -21,6 +21,8 @@
 #include "source/common/stats/symbol_table.h"
 #include "source/extensions/transport_sockets/tls/cert_validator/cert_validator.h"
 #include "source/extensions/transport_sockets/tls/cert_validator/san_matcher.h"
+#include "source/extensions/transport_sockets/tls/cert_validator/verification_pool.h"
+#include "source/extensions/transport_sockets/tls/cert_validator/verified_cert_cache.h"
 #include "source/extensions/transport_sockets/tls/stats.h"
 
 #include "absl/synchronization/mutex.h"
@@ -103,6 +105,12 @@ public:
                                   const std::vector<SanMatcherPtr>& subject_alt_name_matchers);
 
 private:
+  // Verifies the chain against the trusted CA, unless chain_verified is set, and then the leaf
+  // certificate against the rest of the configuration. This may run on any thread.
+  ValidationResults verifyChain(STACK_OF(X509)& cert_chain,
+                                const Network::TransportSocketOptions* transport_socket_options,
+                                SSL_CTX& ssl_ctx, bool is_server, bool chain_verified);
+
   bool verifyCertAndUpdateStatus(X509* leaf_cert,
                                  const Network::TransportSocketOptions* transport_socket_options,
                                  Envoy::Ssl::ClientValidationStatus& detailed_status,
@@ -119,6 +127,10 @@ private:
   std::vector<std::vector<uint8_t>> verify_certificate_hash_list_;
   std::vector<std::vector<uint8_t>> verify_certificate_spki_list_;
   bool verify_trusted_ca_{false};
+  VerifiedCertCachePtr verified_cert_cache_;
+  // Declared last, so that the pending verifications, which use the members above, complete
+  // before they are destroyed.
+  VerificationPoolPtr verification_pool_;
 };
 
 DECLARE_FACTORY(DefaultCertValidatorFactory);
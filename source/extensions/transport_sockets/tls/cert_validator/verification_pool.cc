@@ -0,0 +1,75 @@
+#include "source/extensions/transport_sockets/tls/cert_validator/verification_pool.h"
+
+#include <utility>
+
+#include "source/common/common/assert.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+VerificationPool::VerificationPool(Thread::ThreadFactory& thread_factory, uint32_t num_threads,
+                                   uint32_t max_pending)
+    : max_pending_(max_pending) {
+  ASSERT(num_threads > 0);
+  threads_.reserve(num_threads);
+  for (uint32_t i = 0; i < num_threads; ++i) {
+    threads_.push_back(
+        thread_factory.createThread([this]() { worker(); }, Thread::Options{"tls_verify"}));
+  }
+}
+
+VerificationPool::~VerificationPool() {
+  {
+    absl::MutexLock lock(&mutex_);
+    terminate_ = true;
+  }
+  for (Thread::ThreadPtr& thread : threads_) {
+    thread->join();
+  }
+}
+
+bool VerificationPool::enqueue(Verification verification,
+                               Ssl::ValidateResultCallbackPtr& callback) {
+  absl::MutexLock lock(&mutex_);
+  if (queue_.size() >= max_pending_) {
+    return false;
+  }
+  queue_.push_back({std::move(verification), std::move(callback)});
+  return true;
+}
+
+void VerificationPool::worker() {
+  while (true) {
+    PendingVerification pending;
+    {
+      const auto condition = [this]() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+        return !queue_.empty() || terminate_;
+      };
+      absl::MutexLock lock(&mutex_);
+      mutex_.Await(absl::Condition(&condition));
+      // The verifications still pending on termination are completed first, so that every
+      // callback is called.
+      if (queue_.empty()) {
+        return;
+      }
+      pending = std::move(queue_.front());
+      queue_.pop_front();
+    }
+
+    ValidationResults result = pending.verification_();
+    Event::Dispatcher& dispatcher = pending.callback_->dispatcher();
+    dispatcher.post([callback = std::move(pending.callback_), result = std::move(result)]() {
+      callback->onCertValidationResult(
+          result.status == ValidationResults::ValidationStatus::Successful,
+          result.detailed_status, result.error_details.value_or(""),
+          result.tls_alert.value_or(SSL_AD_CERTIFICATE_UNKNOWN));
+    });
+  }
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "envoy/ssl/ssl_socket_extended_info.h"
+#include "envoy/thread/thread.h"
+
+#include "source/common/common/logger.h"
+#include "source/extensions/transport_sockets/tls/cert_validator/cert_validator.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/functional/any_invocable.h"
+#include "absl/synchronization/mutex.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * A pool of threads verifying the certificate chains presented by the peers, so that the worker
+ * threads do not block on it during the handshakes. The number of pending verifications is
+ * bounded. Each thread takes one pending verification at a time, so that a slow verification only
+ * delays its own handshake, and posts its result to the dispatcher of the worker as soon as it
+ * completes.
+ */
+class VerificationPool : Logger::Loggable<Logger::Id::connection> {
+public:
+  // Runs on a thread of the pool.
+  using Verification = absl::AnyInvocable<ValidationResults()>;
+
+  VerificationPool(Thread::ThreadFactory& thread_factory, uint32_t num_threads,
+                   uint32_t max_pending);
+
+  /**
+   * Waits for the pending verifications to complete.
+   */
+  ~VerificationPool() ABSL_LOCKS_EXCLUDED(mutex_);
+
+  /**
+   * Queues a verification.
+   * @param verification the verification, which must not use anything owned by the connection.
+   * @param callback receives the result of the verification on the thread of its dispatcher. It
+   *        is moved from only if the verification is queued.
+   * @return false if the maximum number of verifications are already pending, in which case
+   *         the verification is not queued.
+   */
+  bool enqueue(Verification verification, Ssl::ValidateResultCallbackPtr& callback)
+      ABSL_LOCKS_EXCLUDED(mutex_);
+
+private:
+  struct PendingVerification {
+    Verification verification_;
+    Ssl::ValidateResultCallbackPtr callback_;
+  };
+
+  void worker() ABSL_LOCKS_EXCLUDED(mutex_);
+
+  const uint32_t max_pending_;
+  absl::Mutex mutex_;
+  std::deque<PendingVerification> queue_ ABSL_GUARDED_BY(mutex_);
+  bool terminate_ ABSL_GUARDED_BY(mutex_){false};
+  std::vector<Thread::ThreadPtr> threads_;
+};
+
+using VerificationPoolPtr = std::unique_ptr<VerificationPool>;
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
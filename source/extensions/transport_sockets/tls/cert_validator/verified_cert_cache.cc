@@ -0,0 +1,77 @@
+#include "source/extensions/transport_sockets/tls/cert_validator/verified_cert_cache.h"
+
+#include <algorithm>
+
+#include "source/common/common/assert.h"
+#include "source/extensions/transport_sockets/tls/utility.h"
+
+#include "openssl/digest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+VerifiedCertCache::VerifiedCertCache(TimeSource& time_source, std::chrono::milliseconds ttl,
+                                     uint32_t max_size)
+    : time_source_(time_source), ttl_(ttl), max_size_(max_size) {
+  ASSERT(max_size_ > 0);
+}
+
+std::string VerifiedCertCache::digest(X509& cert) {
+  uint8_t md[EVP_MAX_MD_SIZE];
+  unsigned int md_length = 0;
+  RELEASE_ASSERT(X509_digest(&cert, EVP_sha256(), md, &md_length) == 1, "");
+  return {reinterpret_cast<const char*>(md), md_length};
+}
+
+bool VerifiedCertCache::contains(X509& leaf_cert) {
+  const std::string key = digest(leaf_cert);
+  absl::MutexLock lock(&mutex_);
+  auto it = expiries_.find(key);
+  if (it == expiries_.end()) {
+    return false;
+  }
+  if (it->second <= time_source_.monotonicTime()) {
+    expiries_.erase(it);
+    return false;
+  }
+  return true;
+}
+
+void VerifiedCertCache::insert(X509& leaf_cert) {
+  const auto remaining_validity = std::chrono::duration_cast<std::chrono::milliseconds>(
+      Utility::getExpirationTime(leaf_cert) - time_source_.systemTime());
+  if (remaining_validity.count() <= 0) {
+    // Accepted because expired certificates are allowed, but not worth remembering.
+    return;
+  }
+  const MonotonicTime now = time_source_.monotonicTime();
+  const MonotonicTime expiry = now + std::min(ttl_, remaining_validity);
+  std::string key = digest(leaf_cert);
+
+  absl::MutexLock lock(&mutex_);
+  if (expiries_.size() >= max_size_ && !expiries_.contains(key)) {
+    for (auto it = expiries_.begin(); it != expiries_.end();) {
+      if (it->second <= now) {
+        expiries_.erase(it++);
+      } else {
+        ++it;
+      }
+    }
+    if (expiries_.size() >= max_size_) {
+      expiries_.erase(expiries_.begin());
+    }
+  }
+  expiries_.insert_or_assign(std::move(key), expiry);
+}
+
+size_t VerifiedCertCache::size() {
+  absl::MutexLock lock(&mutex_);
+  return expiries_.size();
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "envoy/common/time.h"
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "openssl/x509.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * Remembers the leaf certificates whose chain was verified successfully, keyed by the SHA-256 of
+ * the certificate, so that the chains presented again along with them need not be verified. The
+ * entries expire after a TTL, or when the certificate expires if it is sooner. Once the cache is
+ * full, the expired entries are evicted, and then arbitrary ones. It may be used by any thread.
+ */
+class VerifiedCertCache {
+public:
+  VerifiedCertCache(TimeSource& time_source, std::chrono::milliseconds ttl, uint32_t max_size);
+
+  /**
+   * @param leaf_cert the leaf certificate of a chain.
+   * @return whether the chain of the certificate was verified successfully, and the entry has not
+   *         expired.
+   */
+  bool contains(X509& leaf_cert) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  /**
+   * Records that the chain of a leaf certificate was verified successfully.
+   * @param leaf_cert the leaf certificate of the chain.
+   */
+  void insert(X509& leaf_cert) ABSL_LOCKS_EXCLUDED(mutex_);
+
+  size_t size() ABSL_LOCKS_EXCLUDED(mutex_);
+
+private:
+  static std::string digest(X509& cert);
+
+  TimeSource& time_source_;
+  const std::chrono::milliseconds ttl_;
+  const uint32_t max_size_;
+  absl::Mutex mutex_;
+  absl::flat_hash_map<std::string, MonotonicTime> expiries_ ABSL_GUARDED_BY(mutex_);
+};
+
+using VerifiedCertCachePtr = std::unique_ptr<VerifiedCertCache>;
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -186,7 +186,8 @@ ContextConfigImpl::ContextConfigImpl(
                                                 default_max_protocol_version)),
       factory_context_(factory_context), tls_keylog_path_(config.key_log().path()),
       tls_keylog_local_(config.key_log().local_address_range()),
-      tls_keylog_remote_(config.key_log().remote_address_range()) {
+      tls_keylog_remote_(config.key_log().remote_address_range()),
+      kernel_tls_offload_(config.kernel_tls_offload()) {
   if (certificate_validation_context_provider_ != nullptr) {
     if (default_cvc_) {
       // We need to validate combined certificate validation context.
@@ -402,6 +403,7 @@ ServerContextConfigImpl::ServerContextConfigImpl(
       session_ticket_keys_provider_(getTlsSessionTicketKeysConfigProvider(factory_context, config)),
       disable_stateless_session_resumption_(getStatelessSessionResumptionDisabled(config)),
       disable_stateful_session_resumption_(config.disable_stateful_session_resumption()),
+      shared_session_cache_(config.shared_session_cache()),
       full_scan_certs_on_sni_mismatch_(PROTOBUF_GET_WRAPPED_OR_DEFAULT(
           config, full_scan_certs_on_sni_mismatch,
           !Runtime::runtimeFeatureEnabled(
@@ -433,6 +435,15 @@ ServerContextConfigImpl::ServerContextConfigImpl(
     session_timeout_ =
         std::chrono::seconds(DurationUtil::durationToSeconds(config.session_timeout()));
   }
+
+  if (config.has_dynamic_record_sizing()) {
+    const auto& dynamic_record_sizing = config.dynamic_record_sizing();
+    dynamic_record_sizing_ = DynamicRecordSizing{
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(dynamic_record_sizing, small_record_size, 1300),
+        PROTOBUF_GET_WRAPPED_OR_DEFAULT(dynamic_record_sizing, small_record_bytes, 64 * 1024),
+        std::chrono::milliseconds(
+            PROTOBUF_GET_MS_OR_DEFAULT(dynamic_record_sizing, idle_timeout, 1000))};
+  }
 }
 
 void ServerContextConfigImpl::setSecretUpdateCallback(std::function<void()> callback) {
@@ -45,6 +45,7 @@ public:
   const Network::Address::IpList& tlsKeyLogLocal() const override { return tls_keylog_local_; };
   const Network::Address::IpList& tlsKeyLogRemote() const override { return tls_keylog_remote_; };
   const std::string& tlsKeyLogPath() const override { return tls_keylog_path_; };
+  bool kernelTlsOffload() const override { return kernel_tls_offload_; }
   AccessLog::AccessLogManager& accessLogManager() const override {
     return factory_context_.serverFactoryContext().accessLogManager();
   }
@@ -113,6 +114,7 @@ private:
   const std::string tls_keylog_path_;
   const Network::Address::IpList tls_keylog_local_;
   const Network::Address::IpList tls_keylog_remote_;
+  const bool kernel_tls_offload_;
 };
 
 class ClientContextConfigImpl : public ContextConfigImpl, public Envoy::Ssl::ClientContextConfig {
@@ -168,9 +170,14 @@ public:
   bool disableStatefulSessionResumption() const override {
     return disable_stateful_session_resumption_;
   }
+  bool sharedSessionCache() const override { return shared_session_cache_; }
 
   bool fullScanCertsOnSNIMismatch() const override { return full_scan_certs_on_sni_mismatch_; }
 
+  absl::optional<DynamicRecordSizing> dynamicRecordSizing() const override {
+    return dynamic_record_sizing_;
+  }
+
 private:
   static const unsigned DEFAULT_MIN_VERSION;
   static const unsigned DEFAULT_MAX_VERSION;
@@ -194,7 +201,9 @@ private:
   absl::optional<std::chrono::seconds> session_timeout_;
   const bool disable_stateless_session_resumption_;
   const bool disable_stateful_session_resumption_;
+  const bool shared_session_cache_;
   bool full_scan_certs_on_sni_mismatch_;
+  absl::optional<DynamicRecordSizing> dynamic_record_sizing_;
 };
 
 } // namespace Tls
@@ -92,7 +92,8 @@ ContextImpl::ContextImpl(Stats::Scope& scope, const Envoy::Ssl::ContextConfig& c
       ssl_versions_(stat_name_set_->add("ssl.versions")),
       ssl_curves_(stat_name_set_->add("ssl.curves")),
       ssl_sigalgs_(stat_name_set_->add("ssl.sigalgs")), capabilities_(config.capabilities()),
-      tls_keylog_local_(config.tlsKeyLogLocal()), tls_keylog_remote_(config.tlsKeyLogRemote()) {
+      tls_keylog_local_(config.tlsKeyLogLocal()), tls_keylog_remote_(config.tlsKeyLogRemote()),
+      kernel_tls_offload_(config.kernelTlsOffload()) {
 
   auto cert_validator_name = getCertValidatorName(config.certificateValidationContext());
   auto cert_validator_factory =
@@ -779,10 +780,15 @@ int ClientContextImpl::newSessionKey(SSL_SESSION* session) {
 ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
                                      const Envoy::Ssl::ServerContextConfig& config,
                                      const std::vector<std::string>& server_names,
-                                     TimeSource& time_source)
+                                     TimeSource& time_source, SessionCacheSharedPtr session_cache)
     : ContextImpl(scope, config, time_source), session_ticket_keys_(config.sessionTicketKeys()),
       ocsp_staple_policy_(config.ocspStaplePolicy()),
-      full_scan_certs_on_sni_mismatch_(config.fullScanCertsOnSNIMismatch()) {
+      full_scan_certs_on_sni_mismatch_(config.fullScanCertsOnSNIMismatch()),
+      session_cache_(config.sharedSessionCache() && !config.disableStatefulSessionResumption() &&
+                             !config.capabilities().handles_session_resumption
+                         ? std::move(session_cache)
+                         : nullptr),
+      dynamic_record_sizing_(config.dynamicRecordSizing()) {
   if (config.tlsCertificates().empty() && !config.capabilities().provides_certificates) {
     throw EnvoyException("Server TlsCertificates must have a certificate specified");
   }
@@ -856,6 +862,26 @@ ServerContextImpl::ServerContextImpl(Stats::Scope& scope,
 
     if (config.disableStatefulSessionResumption()) {
       SSL_CTX_set_session_cache_mode(ctx.ssl_ctx_.get(), SSL_SESS_CACHE_OFF);
+    } else if (session_cache_ != nullptr) {
+      // BoringSSL stores the sessions in, and looks them up from, the shared cache only.
+      SSL_CTX_set_session_cache_mode(ctx.ssl_ctx_.get(),
+                                     SSL_SESS_CACHE_SERVER | SSL_SESS_CACHE_NO_INTERNAL);
+      SSL_CTX_sess_set_new_cb(ctx.ssl_ctx_.get(), [](SSL* ssl, SSL_SESSION* session) -> int {
+        auto* server_context_impl =
+            static_cast<ServerContextImpl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+        server_context_impl->session_cache_->insert(bssl::UniquePtr<SSL_SESSION>(session));
+        return 1; // Tell BoringSSL that we took ownership of the session.
+      });
+      SSL_CTX_sess_set_get_cb(
+          ctx.ssl_ctx_.get(),
+          [](SSL* ssl, const uint8_t* id, int id_len, int* out_copy) -> SSL_SESSION* {
+            auto* server_context_impl =
+                static_cast<ServerContextImpl*>(SSL_CTX_get_app_data(SSL_get_SSL_CTX(ssl)));
+            // The returned reference is handed over to BoringSSL.
+            *out_copy = 0;
+            return server_context_impl->lookupSession(
+                absl::string_view(reinterpret_cast<const char*>(id), id_len));
+          });
     }
 
     if (config.sessionTimeout() && !config.capabilities().handles_session_resumption) {
@@ -942,6 +968,16 @@ void ServerContextImpl::populateServerNamesMap(TlsContext& ctx, int pkey_id) {
   }
 }
 
+SSL_SESSION* ServerContextImpl::lookupSession(absl::string_view id) {
+  bssl::UniquePtr<SSL_SESSION> session = session_cache_->lookup(id);
+  if (session == nullptr) {
+    stats_.session_cache_miss_.inc();
+    return nullptr;
+  }
+  stats_.session_cache_hit_.inc();
+  return session.release();
+}
+
 ServerContextImpl::SessionContextID
 ServerContextImpl::generateHashForSessionContextId(const std::vector<std::string>& server_names) {
   uint8_t hash_buffer[EVP_MAX_MD_SIZE];
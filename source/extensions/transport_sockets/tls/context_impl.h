@@ -22,6 +22,7 @@
 #include "source/extensions/transport_sockets/tls/cert_validator/cert_validator.h"
 #include "source/extensions/transport_sockets/tls/context_manager_impl.h"
 #include "source/extensions/transport_sockets/tls/ocsp/ocsp.h"
+#include "source/extensions/transport_sockets/tls/session_cache.h"
 #include "source/extensions/transport_sockets/tls/stats.h"
 
 #include "absl/synchronization/mutex.h"
@@ -76,6 +77,21 @@ public:
 
   SslStats& stats() { return stats_; }
 
+  /**
+   * @return whether the encryption of the records sent is handed over to the kernel once the
+   *         handshake completes.
+   */
+  bool kernelTlsOffload() const { return kernel_tls_offload_; }
+
+  /**
+   * @return the sizes of the records sent with dynamic record sizing, or absl::nullopt if the
+   *         records sent are as large as the data written allows.
+   */
+  virtual absl::optional<Ssl::ServerContextConfig::DynamicRecordSizing>
+  dynamicRecordSizing() const {
+    return absl::nullopt;
+  }
+
   /**
    * The global SSL-library index used for storing a pointer to the SslExtendedSocketInfo
    * class in the SSL instance, for retrieval in callbacks.
@@ -154,6 +170,7 @@ protected:
   const Network::Address::IpList tls_keylog_local_;
   const Network::Address::IpList tls_keylog_remote_;
   AccessLog::AccessLogFileSharedPtr tls_keylog_file_;
+  const bool kernel_tls_offload_;
 };
 
 using ContextImplSharedPtr = std::shared_ptr<ContextImpl>;
@@ -183,13 +200,20 @@ enum class OcspStapleAction { Staple, NoStaple, Fail, ClientNotCapable };
 class ServerContextImpl : public ContextImpl, public Envoy::Ssl::ServerContext {
 public:
   ServerContextImpl(Stats::Scope& scope, const Envoy::Ssl::ServerContextConfig& config,
-                    const std::vector<std::string>& server_names, TimeSource& time_source);
+                    const std::vector<std::string>& server_names, TimeSource& time_source,
+                    SessionCacheSharedPtr session_cache);
 
   // Select the TLS certificate context in SSL_CTX_set_select_certificate_cb() callback with
   // ClientHello details. This is made public for use by custom TLS extensions who want to
   // manually create and use this as a client hello callback.
   enum ssl_select_cert_result_t selectTlsContext(const SSL_CLIENT_HELLO* ssl_client_hello);
 
+  // ContextImpl
+  absl::optional<Ssl::ServerContextConfig::DynamicRecordSizing>
+  dynamicRecordSizing() const override {
+    return dynamic_record_sizing_;
+  }
+
 private:
   // Currently, at most one certificate of a given key type may be specified for each exact
   // server name or wildcard domain name.
@@ -207,6 +231,7 @@ private:
                          unsigned int inlen);
   int sessionTicketProcess(SSL* ssl, uint8_t* key_name, uint8_t* iv, EVP_CIPHER_CTX* ctx,
                            HMAC_CTX* hmac_ctx, int encrypt);
+  SSL_SESSION* lookupSession(absl::string_view id);
   bool isClientEcdsaCapable(const SSL_CLIENT_HELLO* ssl_client_hello);
   bool isClientOcspCapable(const SSL_CLIENT_HELLO* ssl_client_hello);
   OcspStapleAction ocspStapleAction(const TlsContext& ctx, bool client_ocsp_capable);
@@ -218,6 +243,9 @@ private:
   ServerNamesMap server_names_map_;
   bool has_rsa_{false};
   bool full_scan_certs_on_sni_mismatch_;
+  // The cache shared by the server contexts, if the sessions are cached there.
+  const SessionCacheSharedPtr session_cache_;
+  const absl::optional<Ssl::ServerContextConfig::DynamicRecordSizing> dynamic_record_sizing_;
 };
 
 } // namespace Tls
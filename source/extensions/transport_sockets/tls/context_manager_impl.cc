@@ -15,7 +15,8 @@ namespace Extensions {
 namespace TransportSockets {
 namespace Tls {
 
-ContextManagerImpl::ContextManagerImpl(TimeSource& time_source) : time_source_(time_source) {}
+ContextManagerImpl::ContextManagerImpl(TimeSource& time_source)
+    : time_source_(time_source), session_cache_(std::make_shared<SessionCache>(time_source)) {}
 
 Envoy::Ssl::ClientContextSharedPtr
 ContextManagerImpl::createSslClientContext(Stats::Scope& scope,
@@ -38,8 +39,8 @@ ContextManagerImpl::createSslServerContext(Stats::Scope& scope,
     return nullptr;
   }
 
-  Envoy::Ssl::ServerContextSharedPtr context =
-      std::make_shared<ServerContextImpl>(scope, config, server_names, time_source_);
+  Envoy::Ssl::ServerContextSharedPtr context = std::make_shared<ServerContextImpl>(
+      scope, config, server_names, time_source_, session_cache_);
   contexts_.insert(context);
   return context;
 }
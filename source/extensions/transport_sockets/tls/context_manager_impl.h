@@ -10,6 +10,7 @@
 #include "envoy/stats/scope.h"
 
 #include "source/extensions/transport_sockets/tls/private_key/private_key_manager_impl.h"
+#include "source/extensions/transport_sockets/tls/session_cache.h"
 
 namespace Envoy {
 namespace Extensions {
@@ -47,6 +48,8 @@ private:
   TimeSource& time_source_;
   absl::flat_hash_set<Envoy::Ssl::ContextSharedPtr> contexts_;
   PrivateKeyMethodManagerImpl private_key_method_manager_{};
+  // Shared by the server contexts configured with a shared session cache.
+  const SessionCacheSharedPtr session_cache_;
 };
 
 } // namespace Tls
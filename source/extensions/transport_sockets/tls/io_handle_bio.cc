@@ -13,6 +13,9 @@ namespace Tls {
 
 namespace {
 
+// The value of bio->num once writes are disabled; it is otherwise unused, and -1.
+constexpr int WriteDisabled = 1;
+
 // NOLINTNEXTLINE(readability-identifier-naming)
 inline Envoy::Network::IoHandle* bio_io_handle(BIO* bio) {
   return reinterpret_cast<Envoy::Network::IoHandle*>(bio->ptr);
@@ -68,6 +71,12 @@ int io_handle_read(BIO* b, char* out, int outl) {
 
 // NOLINTNEXTLINE(readability-identifier-naming)
 int io_handle_write(BIO* b, const char* in, int inl) {
+  if (b->num == WriteDisabled) {
+    BIO_clear_retry_flags(b);
+    ERR_put_error(ERR_LIB_SYS, 0, EPIPE, __FILE__, __LINE__);
+    return -1;
+  }
+
   Envoy::Buffer::RawSlice slice;
   slice.mem_ = const_cast<char*>(in);
   slice.len_ = inl;
@@ -141,6 +150,9 @@ BIO* BIO_new_io_handle(Envoy::Network::IoHandle* io_handle) {
   return b;
 }
 
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BIO_io_handle_disable_write(BIO* bio) { bio->num = WriteDisabled; }
+
 } // namespace Tls
 } // namespace TransportSockets
 } // namespace Extensions
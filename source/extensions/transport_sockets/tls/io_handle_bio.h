@@ -16,6 +16,14 @@ namespace Tls {
 // NOLINTNEXTLINE(readability-identifier-naming)
 BIO* BIO_new_io_handle(Envoy::Network::IoHandle* io_handle);
 
+/**
+ * Makes every later write to a BIO created by BIO_new_io_handle() fail. This is used once the
+ * kernel encrypts the records sent on the connection, after which records encrypted by BoringSSL,
+ * such as a TLS 1.2 alert, cannot be sent anymore.
+ */
+// NOLINTNEXTLINE(readability-identifier-naming)
+void BIO_io_handle_disable_write(BIO* bio);
+
 } // namespace Tls
 } // namespace TransportSockets
 } // namespace Extensions
@@ -0,0 +1,207 @@
+#include "source/extensions/transport_sockets/tls/kernel_tls.h"
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "envoy/common/platform.h"
+
+#include "source/common/api/os_sys_calls_impl.h"
+#include "source/common/common/logger.h"
+
+#include "openssl/mem.h"
+
+#if defined(__linux__)
+#include <linux/tls.h>
+#include <netinet/tcp.h>
+
+#ifndef TCP_ULP
+#define TCP_ULP 31
+#endif
+#ifndef SOL_TLS
+#define SOL_TLS 282
+#endif
+#endif
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace KernelTls {
+
+#if defined(__linux__) && defined(TLS_TX)
+
+namespace {
+
+// The key and fixed part of the nonce of the records sent on a connection, and the sequence number
+// of the next record.
+struct WriteKeys {
+  ~WriteKeys() {
+    OPENSSL_cleanse(key_.data(), key_.size());
+    OPENSSL_cleanse(iv_.data(), iv_.size());
+  }
+
+  std::vector<uint8_t> key_;
+  std::vector<uint8_t> iv_;
+  uint64_t seq_{};
+};
+
+void putSequenceNumber(uint64_t seq, unsigned char* out) {
+  for (size_t i = 0; i < 8; ++i) {
+    out[i] = static_cast<unsigned char>(seq >> (56 - 8 * i));
+  }
+}
+
+// Extracts the write keys of a TLS 1.2 connection. iv_len is the length of the fixed part of the
+// nonce.
+bool getWriteKeys(SSL* ssl, size_t key_len, size_t iv_len, WriteKeys& keys) {
+  // The key block holds the client and server MAC keys, which AEAD ciphers do not have, then the
+  // client and server keys, and then the client and server IVs.
+  const size_t block_len = SSL_get_key_block_len(ssl);
+  if (block_len != 2 * (key_len + iv_len)) {
+    return false;
+  }
+  std::vector<uint8_t> block(block_len);
+  if (!SSL_generate_key_block(ssl, block.data(), block.size())) {
+    return false;
+  }
+  const size_t side = SSL_is_server(ssl) ? 1 : 0;
+  const auto key = block.begin() + side * key_len;
+  const auto iv = block.begin() + 2 * key_len + side * iv_len;
+  keys.key_.assign(key, key + key_len);
+  keys.iv_.assign(iv, iv + iv_len);
+  OPENSSL_cleanse(block.data(), block.size());
+  keys.seq_ = SSL_get_write_sequence(ssl);
+  return true;
+}
+
+template <class CryptoInfo>
+bool fillAesGcm(SSL* ssl, uint16_t cipher_type, CryptoInfo& crypto_info) {
+  WriteKeys keys;
+  if (!getWriteKeys(ssl, sizeof(crypto_info.key), sizeof(crypto_info.salt), keys)) {
+    return false;
+  }
+  crypto_info.info.cipher_type = cipher_type;
+  memcpy(crypto_info.key, keys.key_.data(), sizeof(crypto_info.key));
+  memcpy(crypto_info.salt, keys.iv_.data(), sizeof(crypto_info.salt));
+  // BoringSSL uses the sequence number as the explicit part of the nonce, and so does the kernel
+  // once given it.
+  putSequenceNumber(keys.seq_, crypto_info.iv);
+  putSequenceNumber(keys.seq_, crypto_info.rec_seq);
+  return true;
+}
+
+} // namespace
+
+bool enableTx(SSL* ssl, Network::IoHandle& io_handle) {
+  union {
+    tls_crypto_info info;
+    tls12_crypto_info_aes_gcm_128 aes_gcm_128;
+    tls12_crypto_info_aes_gcm_256 aes_gcm_256;
+#ifdef TLS_CIPHER_CHACHA20_POLY1305
+    tls12_crypto_info_chacha20_poly1305 chacha20_poly1305;
+#endif
+  } crypto_info;
+  memset(&crypto_info, 0, sizeof(crypto_info));
+
+  // In TLS 1.3, a KeyUpdate requested by the peer makes BoringSSL rotate the write keys and send
+  // its own KeyUpdate, which it cannot do once the kernel owns the write keys.
+  if (SSL_version(ssl) != TLS1_2_VERSION) {
+    ENVOY_LOG_MISC(debug, "kTLS: unsupported TLS version {}", SSL_get_version(ssl));
+    return false;
+  }
+  crypto_info.info.version = TLS_1_2_VERSION;
+
+  bool filled = false;
+  socklen_t crypto_info_len = 0;
+  const SSL_CIPHER* cipher = SSL_get_current_cipher(ssl);
+  switch (SSL_CIPHER_get_cipher_nid(cipher)) {
+  case NID_aes_128_gcm:
+    filled = fillAesGcm(ssl, TLS_CIPHER_AES_GCM_128, crypto_info.aes_gcm_128);
+    crypto_info_len = sizeof(crypto_info.aes_gcm_128);
+    break;
+  case NID_aes_256_gcm:
+    filled = fillAesGcm(ssl, TLS_CIPHER_AES_GCM_256, crypto_info.aes_gcm_256);
+    crypto_info_len = sizeof(crypto_info.aes_gcm_256);
+    break;
+#ifdef TLS_CIPHER_CHACHA20_POLY1305
+  case NID_chacha20_poly1305: {
+    // The whole 12 byte IV is fixed.
+    WriteKeys keys;
+    auto& chacha = crypto_info.chacha20_poly1305;
+    filled = getWriteKeys(ssl, sizeof(chacha.key), sizeof(chacha.iv), keys);
+    if (filled) {
+      chacha.info.cipher_type = TLS_CIPHER_CHACHA20_POLY1305;
+      memcpy(chacha.key, keys.key_.data(), sizeof(chacha.key));
+      memcpy(chacha.iv, keys.iv_.data(), sizeof(chacha.iv));
+      putSequenceNumber(keys.seq_, chacha.rec_seq);
+    }
+    crypto_info_len = sizeof(chacha);
+    break;
+  }
+#endif
+  default:
+    ENVOY_LOG_MISC(debug, "kTLS: unsupported cipher {}", SSL_CIPHER_get_name(cipher));
+    return false;
+  }
+  if (!filled) {
+    ENVOY_LOG_MISC(debug, "kTLS: failed to extract the keys of cipher {}",
+                   SSL_CIPHER_get_name(cipher));
+    OPENSSL_cleanse(&crypto_info, sizeof(crypto_info));
+    return false;
+  }
+
+  static constexpr char Ulp[] = "tls";
+  Api::SysCallIntResult result = io_handle.setOption(IPPROTO_TCP, TCP_ULP, Ulp, sizeof(Ulp));
+  if (result.return_value_ == 0) {
+    // Without keys, a socket with the TLS upper layer protocol keeps sending its data as is.
+    result = io_handle.setOption(SOL_TLS, TLS_TX, &crypto_info, crypto_info_len);
+  }
+  OPENSSL_cleanse(&crypto_info, sizeof(crypto_info));
+  if (result.return_value_ != 0) {
+    ENVOY_LOG_MISC(debug, "kTLS: the kernel does not support cipher {}: errno {}",
+                   SSL_CIPHER_get_name(cipher), result.errno_);
+    return false;
+  }
+  return true;
+}
+
+void sendCloseNotify(Network::IoHandle& io_handle) {
+  uint8_t alert[] = {SSL3_AL_WARNING, SSL_AD_CLOSE_NOTIFY};
+  iovec iov;
+  iov.iov_base = alert;
+  iov.iov_len = sizeof(alert);
+  // The record type of data sent on a kTLS socket defaults to application data, and is otherwise
+  // given in a control message.
+  char control[CMSG_SPACE(sizeof(uint8_t))];
+  memset(control, 0, sizeof(control));
+  msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = &iov;
+  msg.msg_iovlen = 1;
+  msg.msg_control = control;
+  msg.msg_controllen = sizeof(control);
+  cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+  cmsg->cmsg_level = SOL_TLS;
+  cmsg->cmsg_type = TLS_SET_RECORD_TYPE;
+  cmsg->cmsg_len = CMSG_LEN(sizeof(uint8_t));
+  *CMSG_DATA(cmsg) = SSL3_RT_ALERT;
+  Api::OsSysCallsSingleton::get().sendmsg(io_handle.fdDoNotUse(), &msg, 0);
+}
+
+#else
+
+bool enableTx(SSL*, Network::IoHandle&) {
+  ENVOY_LOG_MISC(debug, "kTLS: not supported on this platform");
+  return false;
+}
+
+void sendCloseNotify(Network::IoHandle&) {}
+
+#endif
+
+} // namespace KernelTls
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "envoy/network/io_handle.h"
+
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace KernelTls {
+
+/**
+ * Hands the encryption of the records sent on a connection over to the kernel (kTLS), by
+ * installing the write keys and sequence number negotiated by BoringSSL on the socket. Afterwards,
+ * plaintext written to the socket is sent as TLS records, and nothing may be written with
+ * SSL_write() anymore. Records received on the connection are still decrypted by BoringSSL.
+ *
+ * This is supported on Linux, for TLS 1.2 with the AES-GCM and ChaCha20-Poly1305 ciphers, as far
+ * as the kernel supports them. TLS 1.3 is not, since BoringSSL must be able to send with new write
+ * keys when the peer requests a KeyUpdate.
+ *
+ * @param ssl the connection, which must have completed its handshake and have nothing buffered.
+ * @param io_handle the TCP socket of the connection.
+ * @return whether the kernel encrypts the records sent on the connection. If not, the connection
+ *         is left as it was and BoringSSL keeps encrypting the records sent.
+ */
+bool enableTx(SSL* ssl, Network::IoHandle& io_handle);
+
+/**
+ * Sends a close_notify alert on a connection whose records are encrypted by the kernel. This is
+ * best effort, like SSL_shutdown().
+ * @param io_handle the TCP socket of the connection.
+ */
+void sendCloseNotify(Network::IoHandle& io_handle);
+
+} // namespace KernelTls
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,78 @@
+#include "source/extensions/transport_sockets/tls/session_cache.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "source/common/common/assert.h"
+#include "source/common/common/hash.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+SessionCache::SessionCache(TimeSource& time_source, uint32_t capacity, uint32_t num_shards)
+    : time_source_(time_source), shard_capacity_(std::max<uint32_t>(1, capacity / num_shards)),
+      shards_(num_shards) {
+  ASSERT(num_shards > 0);
+}
+
+SessionCache::Shard& SessionCache::shard(absl::string_view id) {
+  return shards_[HashUtil::xxHash64(id) % shards_.size()];
+}
+
+void SessionCache::insert(bssl::UniquePtr<SSL_SESSION> session) {
+  unsigned int id_length;
+  const uint8_t* id_data = SSL_SESSION_get_id(session.get(), &id_length);
+  ASSERT(id_length > 0);
+  std::string id(reinterpret_cast<const char*>(id_data), id_length);
+  const MonotonicTime expiry =
+      time_source_.monotonicTime() + std::chrono::seconds(SSL_SESSION_get_timeout(session.get()));
+
+  Shard& s = shard(id);
+  absl::MutexLock lock(&s.mutex_);
+  if (auto it = s.index_.find(id); it != s.index_.end()) {
+    auto entry = it->second;
+    s.index_.erase(it);
+    s.entries_.erase(entry);
+  }
+  while (s.entries_.size() >= shard_capacity_) {
+    s.index_.erase(s.entries_.back().id_);
+    s.entries_.pop_back();
+  }
+  s.entries_.push_front({std::move(id), std::move(session), expiry});
+  s.index_.emplace(s.entries_.front().id_, s.entries_.begin());
+}
+
+bssl::UniquePtr<SSL_SESSION> SessionCache::lookup(absl::string_view id) {
+  Shard& s = shard(id);
+  absl::MutexLock lock(&s.mutex_);
+  auto it = s.index_.find(id);
+  if (it == s.index_.end()) {
+    return nullptr;
+  }
+  auto entry = it->second;
+  if (entry->expiry_ <= time_source_.monotonicTime()) {
+    s.index_.erase(it);
+    s.entries_.erase(entry);
+    return nullptr;
+  }
+  s.entries_.splice(s.entries_.begin(), s.entries_, entry);
+  // The reference is taken under the lock, so that an eviction cannot free the session meanwhile.
+  SSL_SESSION_up_ref(entry->session_.get());
+  return bssl::UniquePtr<SSL_SESSION>(entry->session_.get());
+}
+
+size_t SessionCache::size() const {
+  size_t size = 0;
+  for (const Shard& s : shards_) {
+    absl::MutexLock lock(&s.mutex_);
+    size += s.entries_.size();
+  }
+  return size;
+}
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
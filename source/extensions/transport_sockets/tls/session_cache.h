@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "envoy/common/time.h"
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+
+/**
+ * A process-wide cache of the TLS sessions established by servers, keyed by session ID, with which
+ * the clients that do not support session tickets resume their sessions on any worker, and across
+ * the updates of the server contexts. It is split into shards, each with its own lock, least
+ * recently used list and share of the capacity, so that the workers rarely contend.
+ *
+ * Sessions expire after their timeout, and the least recently used session of a full shard is
+ * evicted to make room for a new one.
+ */
+class SessionCache {
+public:
+  static constexpr uint32_t DefaultCapacity = 64 * 1024;
+  static constexpr uint32_t DefaultNumShards = 16;
+
+  SessionCache(TimeSource& time_source, uint32_t capacity = DefaultCapacity,
+               uint32_t num_shards = DefaultNumShards);
+
+  /**
+   * Stores a session, replacing any session with the same ID.
+   * @param session the session, which must have a session ID.
+   */
+  void insert(bssl::UniquePtr<SSL_SESSION> session);
+
+  /**
+   * @param id the session ID.
+   * @return a new reference to the session with that ID, or nullptr if there is none or it
+   *         expired.
+   */
+  bssl::UniquePtr<SSL_SESSION> lookup(absl::string_view id);
+
+  /**
+   * @return the number of sessions cached, including the expired ones not evicted yet.
+   */
+  size_t size() const;
+
+private:
+  struct Entry {
+    std::string id_;
+    bssl::UniquePtr<SSL_SESSION> session_;
+    MonotonicTime expiry_;
+  };
+
+  struct Shard {
+    mutable absl::Mutex mutex_;
+    // Most recently used first.
+    std::list<Entry> entries_ ABSL_GUARDED_BY(mutex_);
+    // Keyed by views of the IDs of the entries.
+    absl::flat_hash_map<absl::string_view, std::list<Entry>::iterator>
+        index_ ABSL_GUARDED_BY(mutex_);
+  };
+
+  Shard& shard(absl::string_view id);
+
+  TimeSource& time_source_;
+  const uint32_t shard_capacity_;
+  std::vector<Shard> shards_;
+};
+
+using SessionCacheSharedPtr = std::shared_ptr<SessionCache>;
+
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
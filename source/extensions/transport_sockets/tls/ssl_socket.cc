@@ -8,6 +8,7 @@
 #include "source/common/http/headers.h"
 #include "source/common/runtime/runtime_features.h"
 #include "source/extensions/transport_sockets/tls/io_handle_bio.h"
+#include "source/extensions/transport_sockets/tls/kernel_tls.h"
 #include "source/extensions/transport_sockets/tls/ssl_handshaker.h"
 #include "source/extensions/transport_sockets/tls/utility.h"
 
@@ -52,6 +53,7 @@ SslSocket::SslSocket(Envoy::Ssl::ContextSharedPtr ctx, InitialState state,
                      Ssl::HandshakerFactoryCb handshaker_factory_cb)
     : transport_socket_options_(transport_socket_options),
       ctx_(std::dynamic_pointer_cast<ContextImpl>(ctx)),
+      dynamic_record_sizing_(ctx_->dynamicRecordSizing()),
       info_(std::dynamic_pointer_cast<SslHandshakerImpl>(handshaker_factory_cb(
           ctx_->newSsl(transport_socket_options_), ctx_->sslExtendedSocketInfoIndex(), this))) {
   if (state == InitialState::Client) {
@@ -184,6 +186,10 @@ Network::Connection& SslSocket::connection() const { return callbacks_->connecti
 
 void SslSocket::onSuccess(SSL* ssl) {
   ctx_->logHandshake(ssl);
+  if (ctx_->kernelTlsOffload()) {
+    kernel_tls_tx_pending_ = true;
+    enableKernelTlsTx();
+  }
   if (callbacks_->connection().streamInfo().upstreamInfo()) {
     callbacks_->connection()
         .streamInfo()
@@ -201,6 +207,38 @@ void SslSocket::onFailure() { drainErrorQueue(); }
 
 PostIoAction SslSocket::doHandshake() { return info_->doHandshake(); }
 
+void SslSocket::enableKernelTlsTx() {
+  ASSERT(kernel_tls_tx_pending_);
+  // BoringSSL may still hold records it could not send yet. They are sent first, or the records of
+  // the kernel would not follow the write sequence number it is given.
+  const int rc = SSL_write(rawSsl(), nullptr, 0);
+  if (rc < 0) {
+    const int err = SSL_get_error(rawSsl(), rc);
+    ENVOY_CONN_LOG(trace, "ssl error occurred while flushing before kTLS: {}",
+                   callbacks_->connection(), Utility::getErrorDescription(err));
+    if (err == SSL_ERROR_WANT_WRITE) {
+      // Retried on the next write, before anything else is sent.
+      return;
+    }
+    // The connection is left to BoringSSL, whose next write fails as well.
+    drainErrorQueue();
+    kernel_tls_tx_pending_ = false;
+    return;
+  }
+  kernel_tls_tx_pending_ = false;
+
+  if (!KernelTls::enableTx(rawSsl(), callbacks_->ioHandle())) {
+    ENVOY_CONN_LOG(debug, "kTLS is not supported, records are encrypted by BoringSSL",
+                   callbacks_->connection());
+    ctx_->stats().ktls_tx_unsupported_.inc();
+    return;
+  }
+  // From now on, whatever BoringSSL would send is encrypted with keys the kernel no longer follows.
+  BIO_io_handle_disable_write(SSL_get_wbio(rawSsl()));
+  kernel_tls_tx_ = true;
+  ctx_->stats().ktls_tx_enabled_.inc();
+}
+
 void SslSocket::drainErrorQueue() {
   bool saw_error = false;
   bool saw_counted_error = false;
@@ -250,12 +288,31 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
     }
   }
 
+  if (kernel_tls_tx_pending_) {
+    enableKernelTlsTx();
+    if (kernel_tls_tx_pending_) {
+      return {PostIoAction::KeepOpen, 0, false};
+    }
+  }
+  if (kernel_tls_tx_) {
+    return doKernelTlsWrite(write_buffer, end_stream);
+  }
+
+  if (dynamic_record_sizing_.has_value() && write_buffer.length() > 0) {
+    const MonotonicTime now = callbacks_->connection().dispatcher().approximateMonotonicTime();
+    if (now - last_write_time_ >= dynamic_record_sizing_->idle_timeout_) {
+      // The congestion window may have shrunk meanwhile, so the records are small again.
+      small_record_bytes_sent_ = 0;
+    }
+    last_write_time_ = now;
+  }
+
   uint64_t bytes_to_write;
   if (bytes_to_retry_) {
     bytes_to_write = bytes_to_retry_;
     bytes_to_retry_ = 0;
   } else {
-    bytes_to_write = std::min(write_buffer.length(), static_cast<uint64_t>(16384));
+    bytes_to_write = std::min(write_buffer.length(), maxRecordSize());
   }
 
   uint64_t total_bytes_written = 0;
@@ -273,7 +330,8 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
       ASSERT(rc == static_cast<int>(bytes_to_write));
       total_bytes_written += rc;
       write_buffer.drain(rc);
-      bytes_to_write = std::min(write_buffer.length(), static_cast<uint64_t>(16384));
+      onRecordWritten(rc);
+      bytes_to_write = std::min(write_buffer.length(), maxRecordSize());
     } else {
       int err = SSL_get_error(rawSsl(), rc);
       ENVOY_CONN_LOG(trace, "ssl error occurred while write: {}", callbacks_->connection(),
@@ -300,6 +358,52 @@ Network::IoResult SslSocket::doWrite(Buffer::Instance& write_buffer, bool end_st
   return {PostIoAction::KeepOpen, total_bytes_written, false};
 }
 
+uint64_t SslSocket::maxRecordSize() const {
+  if (dynamic_record_sizing_.has_value() &&
+      small_record_bytes_sent_ < dynamic_record_sizing_->small_record_bytes_) {
+    return dynamic_record_sizing_->small_record_size_;
+  }
+  return SSL3_RT_MAX_PLAIN_LENGTH;
+}
+
+void SslSocket::onRecordWritten(uint64_t bytes) {
+  if (!dynamic_record_sizing_.has_value()) {
+    return;
+  }
+  // Each SSL_write() sends a single record, as no more than a record is written at once.
+  if (small_record_bytes_sent_ < dynamic_record_sizing_->small_record_bytes_) {
+    small_record_bytes_sent_ += bytes;
+    ctx_->stats().small_records_sent_.inc();
+  } else {
+    ctx_->stats().large_records_sent_.inc();
+  }
+}
+
+Network::IoResult SslSocket::doKernelTlsWrite(Buffer::Instance& write_buffer, bool end_stream) {
+  // The kernel splits the data into records, so it is written as is, without being linearized.
+  uint64_t total_bytes_written = 0;
+  while (write_buffer.length() > 0) {
+    Api::IoCallUint64Result result = callbacks_->ioHandle().write(write_buffer);
+    if (!result.ok()) {
+      ENVOY_CONN_LOG(trace, "kTLS write error: {}", callbacks_->connection(),
+                     result.err_->getErrorDetails());
+      if (result.err_->getErrorCode() == Api::IoError::IoErrorCode::Again) {
+        return {PostIoAction::KeepOpen, total_bytes_written, false};
+      }
+      return {PostIoAction::Close, total_bytes_written, false};
+    }
+    ENVOY_CONN_LOG(trace, "kTLS write returns: {}", callbacks_->connection(),
+                   result.return_value_);
+    total_bytes_written += result.return_value_;
+  }
+
+  if (end_stream) {
+    shutdownSsl();
+  }
+
+  return {PostIoAction::KeepOpen, total_bytes_written, false};
+}
+
 void SslSocket::onConnected() { ASSERT(info_->state() == Ssl::SocketState::PreHandshake); }
 
 Ssl::ConnectionInfoConstSharedPtr SslSocket::ssl() const { return info_; }
@@ -308,6 +412,15 @@ void SslSocket::shutdownSsl() {
   ASSERT(info_->state() != Ssl::SocketState::PreHandshake);
   if (info_->state() != Ssl::SocketState::ShutdownSent &&
       callbacks_->connection().state() != Network::Connection::State::Closed) {
+    if (kernel_tls_tx_) {
+      // BoringSSL can no longer send records, so the kernel sends the close_notify alert.
+      KernelTls::sendCloseNotify(callbacks_->ioHandle());
+      ENVOY_CONN_LOG(debug, "SSL shutdown: sent by the kernel", callbacks_->connection());
+      info_->setState(Ssl::SocketState::ShutdownSent);
+      return;
+    }
+    // The kernel does not take over after the close_notify alert of BoringSSL.
+    kernel_tls_tx_pending_ = false;
     int rc = SSL_shutdown(rawSsl());
     if constexpr (Event::PlatformDefaultTriggerType == Event::FileTriggerType::EmulatedEdge) {
       // Windows operate under `EmulatedEdge`. These are level events that are artificially
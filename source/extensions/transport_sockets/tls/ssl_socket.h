@@ -86,6 +86,10 @@ private:
   ReadResult sslReadIntoSlice(Buffer::RawSlice& slice);
 
   Network::PostIoAction doHandshake();
+  void enableKernelTlsTx();
+  Network::IoResult doKernelTlsWrite(Buffer::Instance& write_buffer, bool end_stream);
+  uint64_t maxRecordSize() const;
+  void onRecordWritten(uint64_t bytes);
   void drainErrorQueue();
   void shutdownSsl();
   void shutdownBasic();
@@ -96,6 +100,14 @@ private:
   ContextImplSharedPtr ctx_;
   uint64_t bytes_to_retry_{};
   std::string failure_reason_;
+  // Whether the kernel encrypts the records sent, in which case SSL_write() must not be used.
+  bool kernel_tls_tx_{};
+  // Whether the kernel takes over once BoringSSL has sent the records it still holds.
+  bool kernel_tls_tx_pending_{};
+  const absl::optional<Ssl::ServerContextConfig::DynamicRecordSizing> dynamic_record_sizing_;
+  // The bytes sent in small records since the handshake or the last idle period.
+  uint64_t small_record_bytes_sent_{};
+  MonotonicTime last_write_time_;
 
   SslHandshakerImplSharedPtr info_;
 };
@@ -21,7 +21,16 @@ namespace Tls {
   COUNTER(ocsp_staple_omitted)                                                                     \
   COUNTER(ocsp_staple_responses)                                                                   \
   COUNTER(ocsp_staple_requests)                                                                    \
-  COUNTER(was_key_usage_invalid)
+  COUNTER(was_key_usage_invalid)                                                                   \
+  COUNTER(ktls_tx_enabled)                                                                         \
+  COUNTER(ktls_tx_unsupported)                                                                     \
+  COUNTER(session_cache_hit)                                                                       \
+  COUNTER(session_cache_miss)                                                                      \
+  COUNTER(verify_offloaded)                                                                        \
+  COUNTER(verify_queue_full)                                                                       \
+  COUNTER(verify_cache_hit)                                                                        \
+  COUNTER(small_records_sent)                                                                      \
+  COUNTER(large_records_sent)
 
 /**
  * Wrapper struct for SSL stats. @see stats_macros.h
@@ -236,6 +236,7 @@ public:
   }
   bool appendXForwardedPort() const override { return false; }
   bool addProxyProtocolConnectionState() const override { return true; }
+  const ArenaConfig* streamArenaConfig() const override { return nullptr; }
 
 private:
   friend class AdminTestingPeer;
@@ -95,7 +95,7 @@ InstanceImpl::InstanceImpl(
           watermark_factory)),
       dispatcher_(api_->allocateDispatcher("main_thread")),
       access_log_manager_(options.fileFlushIntervalMsec(), *api_, *dispatcher_, access_log_lock,
-                          store),
+                          store, options.fileFlushSharedThread()),
       singleton_manager_(new Singleton::ManagerImpl(api_->threadFactory())),
       handler_(getHandler(*dispatcher_)), worker_factory_(thread_local_, *api_, hooks),
       mutex_tracer_(options.mutexTracingEnabled() ? &Envoy::MutexTracerImpl::getOrCreateTracer()
@@ -648,6 +648,11 @@ void InstanceImpl::initialize(Network::Address::InstanceConstSharedPtr local_add
   listener_manager_ = listener_manager_factory->createListenerManager(
       *this, nullptr, worker_factory_, bootstrap_.enable_dispatcher_stats(), quic_stat_names_);
 
+  // The health check threads are registered for thread local updates as well.
+  health_check_thread_pool_ =
+      Upstream::HealthCheckThreadPool::create(singletonManager(), *api_, thread_local_,
+                                              bootstrap_.cluster_manager().health_check_threads());
+
   // The main thread is also registered for thread local updates so that code that does not care
   // whether it runs on the main thread or on workers can still use TLS.
   thread_local_.registerThread(*dispatcher_, true);
@@ -991,6 +996,13 @@ void InstanceImpl::terminate() {
   if (config_.clusterManager() != nullptr) {
     config_.clusterManager()->shutdown();
   }
+  // The HDS clusters run their health checkers on the health check threads as well, and the
+  // health checkers need the threads to stop their sessions when they are destroyed.
+  hds_delegate_.reset();
+  // The health checkers of the clusters are gone, so their sessions are stopped.
+  if (health_check_thread_pool_ != nullptr) {
+    health_check_thread_pool_->shutdown();
+  }
   handler_.reset();
   thread_local_.shutdownThread();
   restarter_.shutdown();
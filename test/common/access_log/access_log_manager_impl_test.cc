@@ -29,9 +29,11 @@ namespace {
 
 class AccessLogManagerImplTest : public testing::Test {
 protected:
-  AccessLogManagerImplTest()
+  AccessLogManagerImplTest(bool shared_flush_thread = false,
+                           std::chrono::milliseconds flush_interval = std::chrono::milliseconds(40))
       : file_(new NiceMock<Filesystem::MockFile>), thread_factory_(Thread::threadFactoryForTest()),
-        access_log_manager_(timeout_40ms_, api_, dispatcher_, lock_, store_) {
+        access_log_manager_(flush_interval, api_, dispatcher_, lock_, store_,
+                            shared_flush_thread) {
     EXPECT_CALL(file_system_,
                 createFile(testing::Matcher<const Envoy::Filesystem::FilePathAndType&>(
                     Filesystem::FilePathAndType{Filesystem::DestinationType::File, "foo"})))
@@ -501,6 +503,198 @@ TEST_F(AccessLogManagerImplTest, ReopenAllFiles) {
       .WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
 }
 
+class AccessLogManagerImplSharedFlushThreadTest : public AccessLogManagerImplTest {
+protected:
+  // The flush interval is long enough for the flush thread to only flush when requested.
+  AccessLogManagerImplSharedFlushThreadTest()
+      : AccessLogManagerImplTest(true, std::chrono::hours(1)) {}
+
+  void expectWrites() {
+    EXPECT_CALL(*file_, write_(_))
+        .WillRepeatedly(Invoke([this](absl::string_view data) -> Api::IoCallSizeResult {
+          written_.append(data.data(), data.size());
+          return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+        }));
+  }
+
+  // Only accessed under the lock of the mock file, or once the writes are complete.
+  std::string written_;
+};
+
+TEST_F(AccessLogManagerImplSharedFlushThreadTest, FlushBuffersOfAllThreads) {
+  EXPECT_CALL(dispatcher_, createTimer_(_)).Times(0);
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file = access_log_manager_.createAccessLog(
+      Filesystem::FilePathAndType{Filesystem::DestinationType::File, "foo"});
+  expectWrites();
+
+  log_file->write("test");
+  Thread::ThreadPtr thread = thread_factory_.createThread([&]() -> void {
+    log_file->write("test2");
+    log_file->write("test3");
+  });
+  thread->join();
+  EXPECT_EQ(3UL, store_.counter("filesystem.write_buffered").value());
+  EXPECT_EQ(3UL, store_.counter("filesystem.write_buffered_per_thread").value());
+  EXPECT_EQ(14UL,
+            store_.gauge("filesystem.write_total_buffered", Stats::Gauge::ImportMode::Accumulate)
+                .value());
+  {
+    absl::MutexLock lock(&file_->mutex_);
+    EXPECT_EQ(0UL, file_->num_writes_);
+  }
+
+  // The buffers are flushed in the order of the first write of each thread.
+  log_file->flush();
+  EXPECT_EQ("testtest2test3", written_);
+  EXPECT_EQ(1UL, store_.counter("filesystem.flush_batches").value());
+  EXPECT_EQ(14UL, store_.counter("filesystem.flush_batch_bytes").value());
+  EXPECT_EQ(0UL,
+            store_.gauge("filesystem.write_total_buffered", Stats::Gauge::ImportMode::Accumulate)
+                .value());
+
+  // Nothing is written when the buffers are empty.
+  log_file->flush();
+  EXPECT_EQ(1UL, store_.counter("filesystem.flush_batches").value());
+
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
+TEST_F(AccessLogManagerImplSharedFlushThreadTest, BigDataChunkShouldBeFlushed) {
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file = access_log_manager_.createAccessLog(
+      Filesystem::FilePathAndType{Filesystem::DestinationType::File, "foo"});
+  expectWrites();
+
+  log_file->write("a");
+  std::string big_string(1024 * 64 + 1, 'b');
+  log_file->write(big_string);
+
+  waitForCounterEq("filesystem.flush_batches", 1);
+  EXPECT_EQ(1024UL * 64 + 2, store_.counter("filesystem.flush_batch_bytes").value());
+  EXPECT_EQ(0UL, store_.counter("filesystem.flushed_by_timer").value());
+  {
+    absl::MutexLock lock(&file_->mutex_);
+    EXPECT_EQ("a" + big_string, written_);
+  }
+
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
+TEST_F(AccessLogManagerImplTest, SharedFlushThreadFlushesRemainingDataOnDestruction) {
+  std::string written;
+  {
+    AccessLogManagerImpl access_log_manager(std::chrono::hours(1), api_, dispatcher_, lock_, store_,
+                                            true);
+    EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+    AccessLogFileSharedPtr log_file = access_log_manager.createAccessLog(
+        Filesystem::FilePathAndType{Filesystem::DestinationType::File, "foo"});
+    EXPECT_CALL(*file_, write_(_))
+        .WillOnce(Invoke([&](absl::string_view data) -> Api::IoCallSizeResult {
+          written = std::string(data);
+          return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+        }));
+    EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+    log_file->write("test");
+  }
+  EXPECT_EQ("test", written);
+}
+
+TEST_F(AccessLogManagerImplSharedFlushThreadTest, ReopenFile) {
+  Sequence sq;
+  EXPECT_CALL(*file_, open_(_))
+      .InSequence(sq)
+      .WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file = access_log_manager_.createAccessLog(
+      Filesystem::FilePathAndType{Filesystem::DestinationType::File, "foo"});
+  expectWrites();
+
+  log_file->write("before");
+  EXPECT_CALL(*file_, close_())
+      .InSequence(sq)
+      .WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  EXPECT_CALL(*file_, open_(_))
+      .InSequence(sq)
+      .WillOnce(Return(ByMove(Filesystem::resultFailure<bool>(false, 0))))
+      .WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+
+  // The first reopen fails, the data is dropped, and the reopen is retried on the next flush.
+  log_file->reopen();
+  waitForCounterEq("filesystem.reopen_failed", 1);
+  EXPECT_TRUE(file_->waitForEventCount(file_->num_opens_, 2));
+
+  log_file->write("after");
+  log_file->reopen();
+  EXPECT_TRUE(file_->waitForEventCount(file_->num_opens_, 3));
+  EXPECT_TRUE(file_->waitForEventCount(file_->num_writes_, 1));
+  {
+    absl::MutexLock lock(&file_->mutex_);
+    EXPECT_EQ("after", written_);
+  }
+
+  EXPECT_CALL(*file_, close_())
+      .InSequence(sq)
+      .WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
+TEST_F(AccessLogManagerImplTest, SharedFlushThreadFlushesByTimer) {
+  AccessLogManagerImpl access_log_manager(timeout_40ms_, api_, dispatcher_, lock_, store_, true);
+  EXPECT_CALL(dispatcher_, createTimer_(_)).Times(0);
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  AccessLogFileSharedPtr log_file = access_log_manager.createAccessLog(
+      Filesystem::FilePathAndType{Filesystem::DestinationType::File, "foo"});
+
+  EXPECT_CALL(*file_, write_(_))
+      .WillOnce(Invoke([](absl::string_view data) -> Api::IoCallSizeResult {
+        EXPECT_EQ(0, data.compare("test"));
+        return Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(data.length()));
+      }));
+  log_file->write("test");
+
+  EXPECT_TRUE(file_->waitForEventCount(file_->num_writes_, 1));
+  waitForCounterEq("filesystem.write_completed", 1);
+  EXPECT_LE(1UL, store_.counter("filesystem.flushed_by_timer").value());
+
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+}
+
+TEST_F(AccessLogManagerImplTest, SharedFlushThreadForgetsBuffersOfDestroyedFiles) {
+  EXPECT_CALL(*file_, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  EXPECT_CALL(*file_, write_(_))
+      .WillOnce(Return(ByMove(Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(4)))));
+  EXPECT_CALL(*file_, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+  const Filesystem::FilePathAndType file_info{Filesystem::DestinationType::File, "foo"};
+
+  // A new thread starts with an empty map.
+  Thread::ThreadPtr thread = thread_factory_.createThread([&]() -> void {
+    {
+      AccessLogManagerImpl access_log_manager(std::chrono::hours(1), api_, dispatcher_, lock_,
+                                              store_, true);
+      AccessLogFileSharedPtr log_file = access_log_manager.createAccessLog(file_info);
+      log_file->write("test");
+      EXPECT_EQ(1, AccessLogFileImpl::threadBufferCountForTest());
+    }
+
+    NiceMock<Filesystem::MockFile>* file2 = new NiceMock<Filesystem::MockFile>;
+    EXPECT_CALL(*file2, path()).WillRepeatedly(Return("foo"));
+    EXPECT_CALL(*file2, open_(_)).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+    EXPECT_CALL(*file2, write_(_))
+        .WillOnce(Return(ByMove(Filesystem::resultSuccess<ssize_t>(static_cast<ssize_t>(4)))));
+    EXPECT_CALL(*file2, close_()).WillOnce(Return(ByMove(Filesystem::resultSuccess<bool>(true))));
+    EXPECT_CALL(file_system_,
+                createFile(testing::Matcher<const Envoy::Filesystem::FilePathAndType&>(_)))
+        .WillOnce(Return(ByMove(std::unique_ptr<NiceMock<Filesystem::MockFile>>(file2))));
+
+    // The buffer of the destroyed file is dropped once the thread writes to another file.
+    AccessLogManagerImpl access_log_manager(std::chrono::hours(1), api_, dispatcher_, lock_,
+                                            store_, true);
+    AccessLogFileSharedPtr log_file = access_log_manager.createAccessLog(file_info);
+    log_file->write("test");
+    EXPECT_EQ(1, AccessLogFileImpl::threadBufferCountForTest());
+  });
+  thread->join();
+}
+
 } // namespace
 } // namespace AccessLog
 } // namespace Envoy
@@ -0,0 +1,96 @@
+#include <list>
+
+#include "source/common/common/arena.h"
+#include "source/common/common/linked_object.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace {
+
+class TestObject : public LinkedObject<TestObject, ArenaDeleter<TestObject>> {
+public:
+  TestObject(int value, int& destroyed) : value_(value), destroyed_(destroyed) {}
+  ~TestObject() { destroyed_++; }
+
+  const int value_;
+  int& destroyed_;
+  char padding_[40];
+};
+
+TEST(ArenaTest, Allocate) {
+  ArenaBlockPool pool(256);
+  {
+    Arena arena(pool, 2);
+    void* first = arena.allocate(10, 1);
+    void* second = arena.allocate(8, 8);
+    ASSERT_NE(nullptr, first);
+    ASSERT_NE(nullptr, second);
+    // The second allocation is aligned past the first one in the same block.
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(second) % 8);
+    EXPECT_EQ(16, static_cast<char*>(second) - static_cast<char*>(first));
+    EXPECT_EQ(18, arena.bytesUsed());
+
+    // Allocations larger than a block always fall back to the heap.
+    EXPECT_EQ(nullptr, arena.allocate(257, 1));
+    EXPECT_EQ(1, arena.heapFallbacks());
+
+    // The second block is allocated once the first one is full, and there is no third block.
+    EXPECT_NE(nullptr, arena.allocate(240, 8));
+    EXPECT_NE(nullptr, arena.allocate(16, 8));
+    EXPECT_EQ(nullptr, arena.allocate(8, 8));
+    EXPECT_EQ(2, arena.heapFallbacks());
+    EXPECT_EQ(0, pool.freeBlocks());
+  }
+  // The blocks are returned to the pool and reused by the next arena.
+  EXPECT_EQ(2, pool.freeBlocks());
+  Arena arena(pool, 2);
+  EXPECT_NE(nullptr, arena.allocate(8, 8));
+  EXPECT_EQ(1, pool.freeBlocks());
+}
+
+TEST(ArenaTest, OverAligned) {
+  ArenaBlockPool pool(256);
+  Arena arena(pool, 1);
+  EXPECT_EQ(nullptr, arena.allocate(8, 2 * alignof(std::max_align_t)));
+  EXPECT_EQ(1, arena.heapFallbacks());
+}
+
+TEST(ArenaTest, ThreadLocalPool) {
+  ArenaBlockPool& pool = ArenaBlockPool::threadLocal(512);
+  EXPECT_EQ(&pool, &ArenaBlockPool::threadLocal(512));
+  EXPECT_NE(&pool, &ArenaBlockPool::threadLocal(1024));
+  EXPECT_EQ(512, pool.blockSize());
+}
+
+TEST(ArenaTest, LinkedObjects) {
+  ArenaBlockPool pool(128);
+  int destroyed = 0;
+  {
+    Arena arena(pool, 1);
+    std::list<ArenaPtr<TestObject>> list;
+    for (int i = 0; i < 4; i++) {
+      LinkedList::moveIntoListBack(makeArenaPtr<TestObject>(&arena, i, destroyed), list);
+    }
+    // Only two objects fit in the block, the others are on the heap.
+    EXPECT_EQ(2, arena.heapFallbacks());
+    int value = 0;
+    for (const auto& object : list) {
+      EXPECT_EQ(value++, object->value_);
+    }
+
+    ArenaPtr<TestObject> removed = list.front()->removeFromList(list);
+    EXPECT_EQ(0, removed->value_);
+    removed.reset();
+    EXPECT_EQ(1, destroyed);
+  }
+  EXPECT_EQ(4, destroyed);
+
+  // Without an arena the objects are always allocated on the heap.
+  ArenaPtr<TestObject> object = makeArenaPtr<TestObject>(nullptr, 0, destroyed);
+  object.reset();
+  EXPECT_EQ(5, destroyed);
+}
+
+} // namespace
+} // namespace Envoy
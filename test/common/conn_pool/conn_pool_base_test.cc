@@ -671,5 +671,69 @@ TEST_F(ConnPoolImplDispatcherBaseTest, PoolDrainsWithEarlyDataStreams) {
   closeStream();
 }
 
+// A burst of streams is provisioned for ahead of its demand, by as many connections as streams are
+// expected to arrive while a connection is established.
+TEST_F(ConnPoolImplDispatcherBaseTest, AdaptivePreconnect) {
+  max_connection_duration_opt_ = absl::nullopt;
+  ON_CALL(*cluster_, adaptivePreconnectWindow)
+      .WillByDefault(Return(absl::optional<std::chrono::milliseconds>(1000)));
+  EXPECT_CALL(pool_, instantiateActiveClient).Times(AnyNumber());
+  Upstream::ClusterTrafficStats& stats = *cluster_->trafficStats();
+
+  // The first connection takes 100ms to be established. Without an observed connect latency,
+  // nothing is preconnected.
+  pool_.newStreamImpl(context_, /*can_send_early_data=*/false);
+  ASSERT_EQ(1, clients_.size());
+  time_system_.advanceTimeAsync(std::chrono::milliseconds(100));
+  EXPECT_CALL(pool_, onPoolReady);
+  clients_[0]->onEvent(Network::ConnectionEvent::Connected);
+  EXPECT_FALSE(clients_[0]->preconnected_);
+
+  // 20 streams arrive within 20ms, each of which needs a connection. As the burst is observed,
+  // connections are preconnected for the streams expected while a connection is established.
+  for (uint32_t i = 0; i < 20; ++i) {
+    time_system_.advanceTimeAsync(std::chrono::milliseconds(1));
+    pool_.newStreamImpl(context_, /*can_send_early_data=*/false);
+  }
+  ASSERT_GT(clients_.size(), 21);
+
+  // Once connected, the connections serve the pending streams, and the connections left idle were
+  // preconnected ahead of the burst.
+  time_system_.advanceTimeAsync(std::chrono::milliseconds(100));
+  EXPECT_CALL(pool_, onPoolReady).Times(AnyNumber());
+  for (uint32_t i = 1; i < clients_.size(); ++i) {
+    clients_[i]->onEvent(Network::ConnectionEvent::Connected);
+  }
+  EXPECT_FALSE(pool_.hasPendingStreams());
+  uint32_t num_idle = 0;
+  for (const TestActiveClient* client : clients_) {
+    if (client->active_streams_ == 0) {
+      ++num_idle;
+      EXPECT_TRUE(client->preconnected_);
+    }
+  }
+  EXPECT_EQ(clients_.size() - 21, num_idle);
+  const uint64_t used = stats.upstream_cx_preconnect_used_.value();
+  EXPECT_EQ(0, stats.upstream_cx_preconnect_setup_avoided_ms_.value());
+
+  // The next stream is served by an idle preconnected connection without waiting for it.
+  const size_t num_clients = clients_.size();
+  pool_.newStreamImpl(context_, /*can_send_early_data=*/false);
+  EXPECT_EQ(used + 1, stats.upstream_cx_preconnect_used_.value());
+  EXPECT_GE(stats.upstream_cx_preconnect_setup_avoided_ms_.value(), 100);
+
+  // Once the streams complete, the preconnected connections left unused are accounted for when
+  // they close.
+  for (TestActiveClient* client : clients_) {
+    while (client->active_streams_ > 0) {
+      --client->active_streams_;
+      pool_.onStreamClosed(*client, false);
+    }
+  }
+  pool_.destructAllConnections();
+  EXPECT_EQ(num_idle - 1 + clients_.size() - num_clients,
+            stats.upstream_cx_preconnect_unused_.value());
+}
+
 } // namespace ConnectionPool
 } // namespace Envoy
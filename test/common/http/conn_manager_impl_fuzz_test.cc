@@ -241,6 +241,7 @@ public:
   }
   bool appendXForwardedPort() const override { return false; }
   bool addProxyProtocolConnectionState() const override { return true; }
+  const ArenaConfig* streamArenaConfig() const override { return nullptr; }
 
   const envoy::extensions::filters::network::http_connection_manager::v3::HttpConnectionManager
       config_;
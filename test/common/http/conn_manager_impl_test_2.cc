@@ -146,6 +146,21 @@ TEST_F(HttpConnectionManagerImplTest, DownstreamDisconnect) {
   conn_manager_->onEvent(Network::ConnectionEvent::RemoteClose);
 }
 
+TEST_F(HttpConnectionManagerImplTest, StreamArena) {
+  stream_arena_config_ = ArenaConfig{4096, 1};
+  setup(false, "");
+  setupFilterChain(2, 2);
+
+  EXPECT_CALL(*decoder_filters_[0], decodeHeaders(_, true))
+      .WillOnce(Return(FilterHeadersStatus::StopIteration));
+  startRequest(true);
+
+  doRemoteClose();
+  // The wrappers of the filters fit in a single block.
+  EXPECT_LT(0U, stats_.named_.downstream_rq_arena_bytes_.value());
+  EXPECT_EQ(0U, stats_.named_.downstream_rq_arena_heap_fallback_.value());
+}
+
 TEST_F(HttpConnectionManagerImplTest, DownstreamProtocolError) {
   InSequence s;
   setup(false, "");
@@ -176,6 +176,9 @@ public:
   bool addProxyProtocolConnectionState() const override {
     return add_proxy_protocol_connection_state_;
   }
+  const ArenaConfig* streamArenaConfig() const override {
+    return stream_arena_config_.has_value() ? &stream_arena_config_.value() : nullptr;
+  }
 
   // Simple helper to wrapper filter to the factory function.
   FilterFactoryCb createDecoderFilterFactoryCb(StreamDecoderFilterSharedPtr filter) {
@@ -281,6 +284,7 @@ public:
   std::vector<Http::OriginalIPDetectionSharedPtr> ip_detection_extensions_{};
   std::vector<Http::EarlyHeaderMutationPtr> early_header_mutations_{};
   bool add_proxy_protocol_connection_state_ = true;
+  absl::optional<ArenaConfig> stream_arena_config_;
 
   const LocalReply::LocalReplyPtr local_reply_;
 
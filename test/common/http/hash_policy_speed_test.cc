@@ -0,0 +1,79 @@
+// Note: this should be run with --compilation_mode=opt, and would benefit from a
+// quiescent system with disabled cstate power management.
+
+#include <string>
+#include <vector>
+
+#include "envoy/config/route/v3/route_components.pb.h"
+
+#include "source/common/http/hash_policy.h"
+#include "source/common/network/address_impl.h"
+
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+enum PolicyMask : uint32_t { Header = 1, Cookie = 2, QueryParameter = 4, SourceIp = 8 };
+
+/**
+ * Measure the speed of HashPolicyImpl::generateHash(). The first Arg is a mask of the hash
+ * policies to configure, in the order header, cookie, query parameter and source IP. The second
+ * Arg is the number of other cookies and query parameters in the request, which the cookie and
+ * query parameter policies have to skip over.
+ */
+static void hashPolicyGenerateHash(benchmark::State& state) {
+  const uint32_t mask = state.range(0);
+  const uint32_t num_others = state.range(1);
+
+  std::vector<envoy::config::route::v3::RouteAction::HashPolicy> policies;
+  if (mask & Header) {
+    policies.emplace_back().mutable_header()->set_header_name("x-user-id");
+  }
+  if (mask & Cookie) {
+    policies.emplace_back().mutable_cookie()->set_name("session");
+  }
+  if (mask & QueryParameter) {
+    policies.emplace_back().mutable_query_parameter()->set_name("shard");
+  }
+  if (mask & SourceIp) {
+    policies.emplace_back().mutable_connection_properties()->set_source_ip(true);
+  }
+  std::vector<const envoy::config::route::v3::RouteAction::HashPolicy*> policy_ptrs;
+  for (const auto& policy : policies) {
+    policy_ptrs.push_back(&policy);
+  }
+  HashPolicyImpl hash_policy(policy_ptrs);
+
+  std::string cookie;
+  std::string path = "/some/path?";
+  for (uint32_t i = 0; i < num_others; ++i) {
+    absl::StrAppend(&cookie, "other", i, "=0123456789abcdef; ");
+    absl::StrAppend(&path, "other", i, "=0123456789abcdef&");
+  }
+  absl::StrAppend(&cookie, "session=4f2f8a9e-3c6d-4a2b-9d1e-7a5c3b8e6f10");
+  absl::StrAppend(&path, "shard=42");
+  TestRequestHeaderMapImpl headers{
+      {":path", path}, {"x-user-id", "user-1234567890"}, {"cookie", cookie}};
+  const Network::Address::Ipv4Instance downstream_addr("10.0.0.1", 443);
+  const HashPolicy::AddCookieCallback add_cookie =
+      [](const std::string&, const std::string&, std::chrono::seconds,
+         const CookieAttributeRefVector) { return std::string(); };
+  const StreamInfo::FilterStateSharedPtr filter_state;
+
+  for (auto _ : state) { // NOLINT
+    benchmark::DoNotOptimize(
+        hash_policy.generateHash(&downstream_addr, headers, add_cookie, filter_state));
+  }
+}
+BENCHMARK(hashPolicyGenerateHash)
+    ->ArgsProduct({{Header, Cookie, QueryParameter, SourceIp,
+                    Header | Cookie | QueryParameter | SourceIp},
+                   {0, 10}});
+
+} // namespace
+} // namespace Http
+} // namespace Envoy
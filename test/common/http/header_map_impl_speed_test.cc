@@ -1,5 +1,6 @@
 #include "source/common/http/header_map_impl.h"
 #include "source/common/http/headers.h"
+#include "source/common/runtime/runtime_features.h"
 
 #include "benchmark/benchmark.h"
 
@@ -69,6 +70,65 @@ static void headerMapImplGet(benchmark::State& state) {
 }
 BENCHMARK(headerMapImplGet)->Arg(0)->Arg(1)->Arg(5)->Arg(10)->Arg(50);
 
+/**
+ * Measure the speed of retrieving non-inline headers, as done by filters matching custom headers.
+ * The first Arg is the number of dummy headers. The second Arg selects the lookup structure: 0
+ * for the hash index, 1 for the lazy map, which is used past 3 headers without the hash index.
+ */
+static void headerMapImplGetCustom(benchmark::State& state) {
+  Runtime::maybeSetRuntimeGuard("envoy.reloadable_features.header_map_hash_index",
+                                state.range(1) == 0);
+  HeaderMapImpl::reloadMinHeadersForLazyMapForTest();
+  const std::vector<LowerCaseString> keys{LowerCaseString("dummy-key-1"),
+                                          LowerCaseString("dummy-key-17"),
+                                          LowerCaseString("dummy-key-33"),
+                                          LowerCaseString("x-missing-key")};
+  auto headers = Http::RequestHeaderMapImpl::create();
+  addDummyHeaders(*headers, state.range(0));
+  size_t successes = 0;
+  for (auto _ : state) { // NOLINT
+    for (const LowerCaseString& key : keys) {
+      successes += !headers->get(key).empty();
+    }
+  }
+  benchmark::DoNotOptimize(successes);
+  Runtime::maybeSetRuntimeGuard("envoy.reloadable_features.header_map_hash_index", true);
+  HeaderMapImpl::reloadMinHeadersForLazyMapForTest();
+}
+BENCHMARK(headerMapImplGetCustom)->ArgsProduct({{5, 20, 40, 60, 100}, {0, 1}});
+
+/**
+ * Same as headerMapImplGetCustom, but with a new header map for each iteration, so that the cost
+ * of populating the lookup structure on the first lookup is included.
+ */
+static void headerMapImplPopulateAndGetCustom(benchmark::State& state) {
+  Runtime::maybeSetRuntimeGuard("envoy.reloadable_features.header_map_hash_index",
+                                state.range(1) == 0);
+  HeaderMapImpl::reloadMinHeadersForLazyMapForTest();
+  const std::vector<LowerCaseString> keys{LowerCaseString("dummy-key-1"),
+                                          LowerCaseString("dummy-key-17"),
+                                          LowerCaseString("dummy-key-33"),
+                                          LowerCaseString("x-missing-key")};
+  std::vector<LowerCaseString> dummy_keys;
+  for (int64_t i = 0; i < state.range(0); i++) {
+    dummy_keys.emplace_back(absl::StrCat("dummy-key-", i));
+  }
+  size_t successes = 0;
+  for (auto _ : state) { // NOLINT
+    auto headers = Http::RequestHeaderMapImpl::create();
+    for (const LowerCaseString& key : dummy_keys) {
+      headers->addReference(key, "abcd");
+    }
+    for (const LowerCaseString& key : keys) {
+      successes += !headers->get(key).empty();
+    }
+  }
+  benchmark::DoNotOptimize(successes);
+  Runtime::maybeSetRuntimeGuard("envoy.reloadable_features.header_map_hash_index", true);
+  HeaderMapImpl::reloadMinHeadersForLazyMapForTest();
+}
+BENCHMARK(headerMapImplPopulateAndGetCustom)->ArgsProduct({{5, 20, 40, 60, 100}, {0, 1}});
+
 /**
  * Measure the retrieval speed of a header for which HeaderMapImpl is expected to
  * provide special optimizations.
@@ -671,6 +671,122 @@ TEST(HeaderMapImplTest, Get) {
   }
 }
 
+// Runs the lookups with both the hash index and the lazy map, which is used from 3 headers on
+// when the hash index is disabled.
+class HeaderMapImplLookupTest : public testing::TestWithParam<bool> {
+protected:
+  HeaderMapImplLookupTest() {
+    scoped_runtime_.mergeValues(
+        {{"envoy.reloadable_features.header_map_hash_index", GetParam() ? "true" : "false"}});
+    HeaderMapImpl::reloadMinHeadersForLazyMapForTest();
+  }
+  ~HeaderMapImplLookupTest() override {
+    scoped_runtime_.mergeValues({{"envoy.reloadable_features.header_map_hash_index", "true"}});
+    HeaderMapImpl::reloadMinHeadersForLazyMapForTest();
+  }
+
+  TestScopedRuntime scoped_runtime_;
+
+  // Adds 50 headers, x-key-<i % 10> having the value <i>.
+  void addHeaders(TestRequestHeaderMapImpl& headers) {
+    for (int i = 0; i < 50; i++) {
+      headers.addCopy(LowerCaseString(absl::StrCat("x-key-", i % 10)), absl::StrCat(i));
+    }
+  }
+};
+
+INSTANTIATE_TEST_SUITE_P(HashIndex, HeaderMapImplLookupTest, testing::Bool());
+
+TEST_P(HeaderMapImplLookupTest, Get) {
+  TestRequestHeaderMapImpl headers{{":path", "/"}};
+  addHeaders(headers);
+
+  const auto result = headers.get(LowerCaseString("x-key-3"));
+  ASSERT_EQ(5UL, result.size());
+  for (size_t i = 0; i < result.size(); i++) {
+    EXPECT_EQ(absl::StrCat(3 + i * 10), result[i]->value().getStringView());
+  }
+  EXPECT_TRUE(headers.get(LowerCaseString("x-key-10")).empty());
+
+  // Headers added after the first lookup are found as well.
+  headers.addCopy(LowerCaseString("x-key-3"), "50");
+  headers.addCopy(LowerCaseString("x-new"), "51");
+  EXPECT_EQ(6UL, headers.get(LowerCaseString("x-key-3")).size());
+  EXPECT_EQ("50", headers.get(LowerCaseString("x-key-3"))[5]->value().getStringView());
+  EXPECT_EQ("51", headers.get_("x-new"));
+  EXPECT_EQ("/", headers.get_(":path"));
+}
+
+TEST_P(HeaderMapImplLookupTest, Remove) {
+  TestRequestHeaderMapImpl headers;
+  addHeaders(headers);
+  headers.setContentLength(5);
+  EXPECT_EQ(5UL, headers.get(LowerCaseString("x-key-0")).size());
+
+  EXPECT_EQ(5UL, headers.remove(LowerCaseString("x-key-0")));
+  EXPECT_TRUE(headers.get(LowerCaseString("x-key-0")).empty());
+  EXPECT_EQ(0UL, headers.remove(LowerCaseString("x-key-0")));
+  EXPECT_EQ(1UL, headers.removeContentLength());
+  EXPECT_EQ(45UL, headers.size());
+  headers.verifyByteSizeInternalForTest();
+
+  EXPECT_EQ(10UL, headers.removeIf([](const HeaderEntry& entry) -> bool {
+    return entry.key() == "x-key-1" || entry.key() == "x-key-2";
+  }));
+  EXPECT_TRUE(headers.get(LowerCaseString("x-key-1")).empty());
+  EXPECT_TRUE(headers.get(LowerCaseString("x-key-2")).empty());
+  EXPECT_EQ(5UL, headers.get(LowerCaseString("x-key-3")).size());
+  EXPECT_EQ(35UL, headers.size());
+  headers.verifyByteSizeInternalForTest();
+
+  headers.addCopy(LowerCaseString("x-key-1"), "new");
+  EXPECT_EQ("new", headers.get_("x-key-1"));
+
+  headers.clear();
+  EXPECT_TRUE(headers.get(LowerCaseString("x-key-3")).empty());
+  headers.addCopy(LowerCaseString("x-key-3"), "cleared");
+  EXPECT_EQ("cleared", headers.get_("x-key-3"));
+}
+
+TEST_P(HeaderMapImplLookupTest, RemoveInlineRepeatedly) {
+  TestRequestHeaderMapImpl headers;
+  addHeaders(headers);
+  EXPECT_EQ(5UL, headers.get(LowerCaseString("x-key-0")).size());
+
+  // The removed inline headers leave empty slots in the hash index until it is compacted.
+  for (int i = 0; i < 200; i++) {
+    headers.setContentLength(i);
+    EXPECT_EQ(absl::StrCat(i), headers.get_("content-length"));
+    EXPECT_EQ(1UL, headers.removeContentLength());
+    EXPECT_TRUE(headers.get(LowerCaseString("content-length")).empty());
+    EXPECT_EQ(5UL, headers.get(LowerCaseString("x-key-3")).size());
+  }
+  EXPECT_EQ(50UL, headers.size());
+  EXPECT_EQ(5UL, headers.remove(LowerCaseString("x-key-1")));
+  const auto result = headers.get(LowerCaseString("x-key-2"));
+  ASSERT_EQ(5UL, result.size());
+  for (size_t i = 0; i < result.size(); i++) {
+    EXPECT_EQ(absl::StrCat(2 + i * 10), result[i]->value().getStringView());
+  }
+  headers.verifyByteSizeInternalForTest();
+}
+
+// The hash index is replaced by the lazy map once there are enough headers.
+TEST(HeaderMapImplTest, HashIndexToLazyMap) {
+  TestRequestHeaderMapImpl headers{{"x-foo", "0"}, {"x-bar", "1"}};
+  EXPECT_EQ("0", headers.get_("x-foo"));
+
+  const size_t count = HeaderMapImpl::DefaultMinHeadersForLazyMap;
+  for (size_t i = 0; i < count; i++) {
+    headers.addCopy(LowerCaseString("x-foo"), absl::StrCat(i + 1));
+  }
+  const auto result = headers.get(LowerCaseString("x-foo"));
+  ASSERT_EQ(count + 1, result.size());
+  EXPECT_EQ(absl::StrCat(count), result[count]->value().getStringView());
+  EXPECT_EQ(count + 1, headers.remove(LowerCaseString("x-foo")));
+  EXPECT_EQ("1", headers.get_("x-bar"));
+}
+
 TEST(HeaderMapImplTest, CreateHeaderMapFromIterator) {
   std::vector<std::pair<LowerCaseString, std::string>> iter_headers{
       {LowerCaseString(Headers::get().Path), "/"}, {LowerCaseString("hello"), "world"}};
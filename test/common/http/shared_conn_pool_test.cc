@@ -0,0 +1,275 @@
+#include <list>
+#include <memory>
+
+#include "source/common/http/shared_conn_pool.h"
+
+#include "test/mocks/buffer/mocks.h"
+#include "test/mocks/common.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/http/conn_pool.h"
+#include "test/mocks/http/mocks.h"
+#include "test/mocks/http/stream_decoder.h"
+#include "test/mocks/http/stream_encoder.h"
+#include "test/mocks/stream_info/mocks.h"
+#include "test/mocks/upstream/host.h"
+#include "test/test_common/utility.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+using testing::Return;
+
+namespace Envoy {
+namespace Http {
+namespace {
+
+class SharedConnPoolTest : public testing::Test {
+public:
+  SharedConnPoolTest() {
+    // Queue the posts of both workers so that the tests control when the other worker runs.
+    for (Event::MockDispatcher* dispatcher : {&dispatcher_a_, &dispatcher_b_}) {
+      ON_CALL(*dispatcher, post(_)).WillByDefault(Invoke([this](Event::PostCb cb) {
+        posted_.push_back(std::move(cb));
+      }));
+    }
+  }
+
+  std::unique_ptr<SharedConnPool> createPool(Event::Dispatcher& dispatcher,
+                                             ConnectionPool::MockInstance*& pool) {
+    SharedConnPoolRegistry::Key key{host_.get(), Upstream::ResourcePriority::Default, {1}};
+    return std::make_unique<SharedConnPool>(
+        registry_, std::move(key), dispatcher, host_, [this, &pool]() {
+          auto mock_pool = std::make_unique<NiceMock<ConnectionPool::MockInstance>>();
+          ON_CALL(*mock_pool, newStream(_, _, _))
+              .WillByDefault(Invoke([this](ResponseDecoder& decoder,
+                                           ConnectionPool::Callbacks& callbacks,
+                                           const ConnectionPool::Instance::StreamOptions&) {
+                owner_decoder_ = &decoder;
+                owner_callbacks_ = &callbacks;
+                return &owner_cancellable_;
+              }));
+          pool = mock_pool.get();
+          return mock_pool;
+        });
+  }
+
+  void runPosts() {
+    while (!posted_.empty()) {
+      Event::PostCb cb = std::move(posted_.front());
+      posted_.pop_front();
+      cb();
+    }
+  }
+
+  // Makes worker A the owner and hands a stream of worker B off to it.
+  void handOff() {
+    pool_a_ = createPool(dispatcher_a_, mock_pool_a_);
+    NiceMock<ConnectionPool::MockCallbacks> callbacks_a;
+    NiceMock<MockResponseDecoder> decoder_a;
+    EXPECT_FALSE(pool_a_->isOwner());
+    // The first stream makes worker A the owner.
+    pool_a_->newStream(decoder_a, callbacks_a, {false, true});
+    ASSERT_TRUE(pool_a_->isOwner());
+
+    pool_b_ = createPool(dispatcher_b_, mock_pool_b_);
+    owner_callbacks_ = nullptr;
+    handle_b_ = pool_b_->newStream(decoder_b_, callbacks_b_, {false, true});
+    EXPECT_NE(nullptr, handle_b_);
+    EXPECT_FALSE(pool_b_->isOwner());
+    EXPECT_EQ(nullptr, mock_pool_b_);
+    EXPECT_EQ(1, host_->cluster_.traffic_stats_->upstream_rq_cross_worker_.value());
+    EXPECT_EQ(1, host_->cluster_.traffic_stats_->upstream_rq_cross_worker_hops_.value());
+    runPosts();
+    ASSERT_NE(nullptr, owner_callbacks_);
+  }
+
+  // Makes the stream of worker B ready.
+  void ready() {
+    EXPECT_CALL(callbacks_b_, onPoolReady(_, _, _, absl::optional<Protocol>(Protocol::Http2)))
+        .WillOnce(Invoke([this](RequestEncoder& encoder, Upstream::HostDescriptionConstSharedPtr,
+                                StreamInfo::StreamInfo&, absl::optional<Protocol>) {
+          request_encoder_ = &encoder;
+        }));
+    owner_callbacks_->onPoolReady(encoder_a_, host_, stream_info_, Protocol::Http2);
+    runPosts();
+    ASSERT_NE(nullptr, request_encoder_);
+  }
+
+  NiceMock<Event::MockDispatcher> dispatcher_a_;
+  NiceMock<Event::MockDispatcher> dispatcher_b_;
+  std::list<Event::PostCb> posted_;
+  std::shared_ptr<NiceMock<Upstream::MockHost>> host_{
+      std::make_shared<NiceMock<Upstream::MockHost>>()};
+  SharedConnPoolRegistrySharedPtr registry_{std::make_shared<SharedConnPoolRegistry>()};
+  ConnectionPool::MockInstance* mock_pool_a_{};
+  ConnectionPool::MockInstance* mock_pool_b_{};
+  NiceMock<ConnectionPool::MockCallbacks> callbacks_b_;
+  NiceMock<MockResponseDecoder> decoder_b_;
+  ConnectionPool::Cancellable* handle_b_{};
+  ResponseDecoder* owner_decoder_{};
+  ConnectionPool::Callbacks* owner_callbacks_{};
+  NiceMock<Envoy::ConnectionPool::MockCancellable> owner_cancellable_;
+  NiceMock<MockRequestEncoder> encoder_a_;
+  NiceMock<StreamInfo::MockStreamInfo> stream_info_;
+  RequestEncoder* request_encoder_{};
+  std::unique_ptr<SharedConnPool> pool_a_;
+  std::unique_ptr<SharedConnPool> pool_b_;
+};
+
+// The streams of the owner are created on its own pool.
+TEST_F(SharedConnPoolTest, OwnerCreatesStreamsLocally) {
+  pool_a_ = createPool(dispatcher_a_, mock_pool_a_);
+  NiceMock<ConnectionPool::MockCallbacks> callbacks;
+  NiceMock<MockResponseDecoder> decoder;
+  NiceMock<Envoy::ConnectionPool::MockCancellable> cancellable;
+
+  EXPECT_EQ(nullptr, mock_pool_a_);
+  pool_a_->newStream(decoder, callbacks, {false, true});
+  ASSERT_NE(nullptr, mock_pool_a_);
+  EXPECT_CALL(*mock_pool_a_, newStream(_, _, _)).WillOnce(Return(&cancellable));
+  EXPECT_EQ(&cancellable, pool_a_->newStream(decoder, callbacks, {false, true}));
+  EXPECT_TRUE(posted_.empty());
+  EXPECT_EQ(0, host_->cluster_.traffic_stats_->upstream_rq_cross_worker_.value());
+}
+
+// A request and its response are relayed between the workers.
+TEST_F(SharedConnPoolTest, HandOffRequestAndResponse) {
+  handOff();
+  ready();
+
+  TestRequestHeaderMapImpl request_headers{
+      {":method", "GET"}, {":path", "/"}, {":authority", "host"}};
+  EXPECT_TRUE(request_encoder_->encodeHeaders(request_headers, false).ok());
+  Buffer::OwnedImpl request_body("hello");
+  request_encoder_->encodeData(request_body, true);
+  EXPECT_EQ(0, request_body.length());
+
+  EXPECT_CALL(encoder_a_, encodeHeaders(HeaderMapEqualRef(&request_headers), false));
+  EXPECT_CALL(encoder_a_, encodeData(BufferStringEqual("hello"), true));
+  runPosts();
+
+  owner_decoder_->decodeHeaders(
+      ResponseHeaderMapPtr{new TestResponseHeaderMapImpl{{":status", "200"}}}, false);
+  Buffer::OwnedImpl response_body("world");
+  owner_decoder_->decodeData(response_body, true);
+
+  EXPECT_CALL(decoder_b_, decodeHeaders_(_, false));
+  EXPECT_CALL(decoder_b_, decodeData(BufferStringEqual("world"), true));
+  runPosts();
+  EXPECT_TRUE(pool_b_->isIdle());
+}
+
+// Cancelling a stream before it is ready cancels it on the owner.
+TEST_F(SharedConnPoolTest, CancelBeforeReady) {
+  handOff();
+
+  EXPECT_CALL(owner_cancellable_, cancel(Envoy::ConnectionPool::CancelPolicy::Default));
+  handle_b_->cancel(Envoy::ConnectionPool::CancelPolicy::Default);
+  EXPECT_TRUE(pool_b_->isIdle());
+  runPosts();
+}
+
+// An upstream reset is relayed to the stream callbacks of the requesting worker.
+TEST_F(SharedConnPoolTest, UpstreamReset) {
+  handOff();
+  ready();
+
+  NiceMock<MockStreamCallbacks> stream_callbacks;
+  request_encoder_->getStream().addCallbacks(stream_callbacks);
+  encoder_a_.stream_.resetStream(StreamResetReason::RemoteReset);
+
+  EXPECT_CALL(stream_callbacks, onResetStream(StreamResetReason::RemoteReset, _));
+  runPosts();
+  EXPECT_TRUE(pool_b_->isIdle());
+}
+
+// A local reset is relayed to the owner.
+TEST_F(SharedConnPoolTest, LocalReset) {
+  handOff();
+  ready();
+
+  request_encoder_->getStream().resetStream(StreamResetReason::LocalReset);
+  EXPECT_CALL(encoder_a_.stream_, resetStream(StreamResetReason::LocalReset));
+  runPosts();
+}
+
+// Destroying the requesting pool resets its ready streams, also on the owner.
+TEST_F(SharedConnPoolTest, DestroyResetsReadyStreams) {
+  handOff();
+  ready();
+
+  NiceMock<MockStreamCallbacks> stream_callbacks;
+  request_encoder_->getStream().addCallbacks(stream_callbacks);
+  EXPECT_CALL(stream_callbacks, onResetStream(StreamResetReason::LocalReset, _));
+  pool_b_.reset();
+
+  EXPECT_CALL(encoder_a_.stream_, resetStream(StreamResetReason::LocalReset));
+  runPosts();
+}
+
+// Destroying the requesting pool fails its streams which are not ready yet, and cancels them on
+// the owner.
+TEST_F(SharedConnPoolTest, DestroyFailsPendingStreams) {
+  handOff();
+
+  EXPECT_CALL(callbacks_b_, onPoolFailure(ConnectionPool::PoolFailureReason::LocalConnectionFailure,
+                                          "shared connection pool destroyed", _));
+  pool_b_.reset();
+
+  EXPECT_CALL(owner_cancellable_, cancel(Envoy::ConnectionPool::CancelPolicy::Default));
+  runPosts();
+}
+
+// A pool failure of the owner fails the stream of the requesting worker.
+TEST_F(SharedConnPoolTest, PoolFailure) {
+  handOff();
+
+  owner_callbacks_->onPoolFailure(ConnectionPool::PoolFailureReason::Overflow, "overflow", host_);
+  EXPECT_CALL(callbacks_b_,
+              onPoolFailure(ConnectionPool::PoolFailureReason::Overflow, "overflow", _));
+  runPosts();
+  EXPECT_TRUE(pool_b_->isIdle());
+}
+
+// A stream handed off to an owner which went away meanwhile makes the requesting worker the owner.
+TEST_F(SharedConnPoolTest, OwnerClosedBeforeHandOff) {
+  pool_a_ = createPool(dispatcher_a_, mock_pool_a_);
+  NiceMock<ConnectionPool::MockCallbacks> callbacks_a;
+  NiceMock<MockResponseDecoder> decoder_a;
+  pool_a_->newStream(decoder_a, callbacks_a, {false, true});
+
+  pool_b_ = createPool(dispatcher_b_, mock_pool_b_);
+  pool_b_->newStream(decoder_b_, callbacks_b_, {false, true});
+  pool_a_.reset();
+
+  owner_callbacks_ = nullptr;
+  runPosts();
+  EXPECT_TRUE(pool_b_->isOwner());
+  ASSERT_NE(nullptr, mock_pool_b_);
+  EXPECT_EQ(1, host_->cluster_.traffic_stats_->upstream_rq_cross_worker_hops_.value());
+
+  // The stream is created on the pool of worker B, and still relayed through the posts.
+  ASSERT_NE(nullptr, owner_callbacks_);
+  ready();
+}
+
+// A worker which does not own the connections is idle once drained and its streams are done.
+TEST_F(SharedConnPoolTest, DrainAndDeleteWaitsForStreams) {
+  handOff();
+  ready();
+  testing::MockFunction<void()> idle_cb;
+  pool_b_->addIdleCallback(idle_cb.AsStdFunction());
+
+  EXPECT_CALL(idle_cb, Call()).Times(0);
+  pool_b_->drainConnections(Envoy::ConnectionPool::DrainBehavior::DrainAndDelete);
+
+  EXPECT_CALL(idle_cb, Call());
+  request_encoder_->getStream().resetStream(StreamResetReason::LocalReset);
+}
+
+} // namespace
+} // namespace Http
+} // namespace Envoy
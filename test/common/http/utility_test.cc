@@ -198,6 +198,21 @@ TEST(HttpUtility, parseQueryString) {
   EXPECT_EQ(expected, Utility::QueryParamsMulti::parseAndDecodeQueryString(input).data());
 }
 
+// findQueryParameter() agrees with the first value found by parseQueryString().
+TEST(HttpUtility, findQueryParameter) {
+  EXPECT_EQ(absl::nullopt, Utility::findQueryParameter("/hello", "hello"));
+  EXPECT_EQ(absl::nullopt, Utility::findQueryParameter("/hello?", "hello"));
+  EXPECT_EQ(absl::nullopt, Utility::findQueryParameter("/hello?hello2=world", "hello"));
+  EXPECT_EQ("", Utility::findQueryParameter("/hello?hello", "hello"));
+  EXPECT_EQ("", Utility::findQueryParameter("/hello?hello=", "hello"));
+  EXPECT_EQ("", Utility::findQueryParameter("/hello?a=1&&b=2", ""));
+  EXPECT_EQ("world", Utility::findQueryParameter("/hello?hello=world", "hello"));
+  EXPECT_EQ("a=b", Utility::findQueryParameter("/hello?hello=a=b&x=y", "hello"));
+  EXPECT_EQ("3%264", Utility::findQueryParameter("/hello?b=2&a=3%264&a=5", "a"));
+  EXPECT_EQ(absl::nullopt, Utility::findQueryParameter("/hello?a%26=1", "a&"));
+  EXPECT_EQ("1?y=2", Utility::findQueryParameter("/hello?y=1?y=2&y=3", "y"));
+}
+
 TEST(HttpUtility, stripQueryString) {
   EXPECT_EQ(Utility::stripQueryString(HeaderString("/")), "/");
   EXPECT_EQ(Utility::stripQueryString(HeaderString("/?")), "/");
@@ -1016,6 +1031,26 @@ TEST(HttpUtility, TestParseCookiesDuplicates) {
   EXPECT_EQ(cookies.at("b"), "1");
 }
 
+// findCookieValue() agrees with parseCookieValue(), without copying the value.
+TEST(HttpUtility, TestFindCookieValue) {
+  TestRequestHeaderMapImpl headers{{"someheader", "10.0.0.1"},
+                                   {"cookie", "a=; b=1; a=2"},
+                                   {"cookie", ";;  token=\"abc123\"; c"},
+                                   {"cookie", "b=3"}};
+
+  EXPECT_EQ(Utility::findCookieValue(headers, "a"), "");
+  EXPECT_EQ(Utility::findCookieValue(headers, "b"), "1");
+  EXPECT_EQ(Utility::findCookieValue(headers, "token"), "abc123");
+  EXPECT_EQ(Utility::findCookieValue(headers, "c"), "");
+  EXPECT_EQ(Utility::findCookieValue(headers, "missing"), "");
+
+  const absl::string_view value = Utility::findCookieValue(headers, "token");
+  const absl::string_view header_value =
+      headers.get(Headers::get().Cookie)[1]->value().getStringView();
+  EXPECT_GE(value.data(), header_value.data());
+  EXPECT_LE(value.data() + value.size(), header_value.data() + header_value.size());
+}
+
 TEST(HttpUtility, TestParseSetCookieWithQuotes) {
   TestRequestHeaderMapImpl headers{
       {"someheader", "10.0.0.1"},
@@ -18,6 +18,10 @@ namespace {
 class IoUringSocketTestImpl : public IoUringSocketEntry {
 public:
   IoUringSocketTestImpl(os_fd_t fd, IoUringWorkerImpl& parent) : IoUringSocketEntry(fd, parent) {}
+  void connect(const Network::Address::InstanceConstSharedPtr&) override {}
+  uint64_t write(Buffer::Instance&) override { return 0; }
+  uint64_t write(const Buffer::RawSlice*, uint64_t) override { return 0; }
+  void shutdown(int) override {}
 
   void onAccept(Request* req, int32_t result, bool injected) override {
     IoUringSocketEntry::onAccept(req, result, injected);
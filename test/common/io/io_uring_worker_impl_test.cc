@@ -1,3 +1,4 @@
+#include "source/common/buffer/buffer_impl.h"
 #include "source/common/io/io_uring_worker_impl.h"
 #include "source/common/network/address_impl.h"
 
@@ -7,9 +8,11 @@
 
 #include "gtest/gtest.h"
 
+using testing::_;
 using testing::DoAll;
 using testing::Invoke;
 using testing::NiceMock;
+using testing::Return;
 using testing::ReturnNew;
 using testing::SaveArg;
 
@@ -20,6 +23,10 @@ namespace {
 class IoUringSocketTestImpl : public IoUringSocketEntry {
 public:
   IoUringSocketTestImpl(os_fd_t fd, IoUringWorkerImpl& parent) : IoUringSocketEntry(fd, parent) {}
+  void connect(const Network::Address::InstanceConstSharedPtr&) override {}
+  uint64_t write(Buffer::Instance&) override { return 0; }
+  uint64_t write(const Buffer::RawSlice*, uint64_t) override { return 0; }
+  void shutdown(int) override {}
   void cleanupForTest() { cleanup(); }
 };
 
@@ -93,6 +100,305 @@ TEST(IoUringWorkerImplTest, DelaySubmit) {
   EXPECT_CALL(dispatcher, clearDeferredDeleteList());
 }
 
+class IoUringWorkerSocketTest : public testing::Test {
+protected:
+  IoUringWorkerSocketTest() {
+    IoUringPtr io_uring_instance = std::make_unique<NiceMock<MockIoUring>>();
+    mock_io_uring_ = dynamic_cast<MockIoUring*>(io_uring_instance.get());
+    EXPECT_CALL(dispatcher_, createFileEvent_(_, _, Event::PlatformDefaultTriggerType,
+                                              Event::FileReadyType::Read))
+        .WillOnce(
+            DoAll(SaveArg<1>(&file_event_callback_), ReturnNew<NiceMock<Event::MockFileEvent>>()));
+    worker_ = std::make_unique<IoUringWorkerTestImpl>(std::move(io_uring_instance), dispatcher_);
+  }
+
+  ~IoUringWorkerSocketTest() override {
+    EXPECT_CALL(dispatcher_, clearDeferredDeleteList());
+    worker_.reset();
+  }
+
+  // Emulate the completions of the given requests.
+  void complete(const std::vector<std::pair<Request*, int32_t>>& completions) {
+    EXPECT_CALL(*mock_io_uring_, forEveryCompletion(_))
+        .WillOnce(Invoke([completions](const CompletionCb& cb) {
+          for (const auto& completion : completions) {
+            cb(completion.first, completion.second, false);
+          }
+        }));
+    file_event_callback_(Event::FileReadyType::Read);
+  }
+
+  // Close the socket and complete the close request.
+  void closeSocket(IoUringSocket& socket) {
+    Request* close_req = nullptr;
+    EXPECT_CALL(*mock_io_uring_, prepareClose(socket.fd(), _))
+        .WillOnce(DoAll(SaveArg<1>(&close_req), Return(IoUringResult::Ok)));
+    socket.close(false);
+    ASSERT_NE(nullptr, close_req);
+
+    const os_fd_t fd = socket.fd();
+    EXPECT_CALL(*mock_io_uring_, removeInjectedCompletion(fd));
+    EXPECT_CALL(dispatcher_, deferredDelete_);
+    complete({{close_req, 0}});
+    EXPECT_EQ(0, worker_->getNumOfSockets());
+  }
+
+  Event::MockDispatcher dispatcher_;
+  MockIoUring* mock_io_uring_;
+  Event::FileReadyCb file_event_callback_;
+  std::unique_ptr<IoUringWorkerTestImpl> worker_;
+};
+
+TEST_F(IoUringWorkerSocketTest, ServerSocketRead) {
+  uint32_t events = 0;
+  IoUringSocket& socket = worker_->addServerSocket(10, [&events](uint32_t e) { events |= e; });
+
+  Request* read_req = nullptr;
+  EXPECT_CALL(*mock_io_uring_, prepareReadv(10, _, 1, 0, _))
+      .WillOnce(DoAll(SaveArg<4>(&read_req), Return(IoUringResult::Ok)));
+  socket.enableRead();
+  ASSERT_NE(nullptr, read_req);
+
+  // Emulate the kernel filling the buffer of the request.
+  memcpy(static_cast<ReadRequest*>(read_req)->iov_->iov_base, "hello", 5); // NOLINT(safe-memcpy)
+  Request* next_read_req = nullptr;
+  EXPECT_CALL(*mock_io_uring_, prepareReadv(10, _, 1, 0, _))
+      .WillOnce(DoAll(SaveArg<4>(&next_read_req), Return(IoUringResult::Ok)));
+  complete({{read_req, 5}});
+  EXPECT_EQ(Event::FileReadyType::Read, events);
+  EXPECT_EQ("hello", socket.getReadParam()->buf_.toString());
+  EXPECT_EQ(5, socket.getReadParam()->result_);
+
+  // The inflight read request is canceled before closing the socket.
+  Request* cancel_req = nullptr;
+  EXPECT_CALL(*mock_io_uring_, prepareCancel(next_read_req, _))
+      .WillOnce(DoAll(SaveArg<1>(&cancel_req), Return(IoUringResult::Ok)));
+  EXPECT_CALL(*mock_io_uring_, prepareClose(10, _)).Times(0);
+  socket.close(false);
+  testing::Mock::VerifyAndClearExpectations(mock_io_uring_);
+
+  Request* close_req = nullptr;
+  EXPECT_CALL(*mock_io_uring_, prepareClose(10, _))
+      .WillOnce(DoAll(SaveArg<1>(&close_req), Return(IoUringResult::Ok)));
+  complete({{next_read_req, -ECANCELED}, {cancel_req, 0}});
+  ASSERT_NE(nullptr, close_req);
+
+  EXPECT_CALL(*mock_io_uring_, removeInjectedCompletion(10));
+  EXPECT_CALL(dispatcher_, deferredDelete_);
+  complete({{close_req, 0}});
+  EXPECT_EQ(0, worker_->getNumOfSockets());
+}
+
+TEST_F(IoUringWorkerSocketTest, ServerSocketRemoteCloseWhenDisabled) {
+  uint32_t events = 0;
+  IoUringSocket& socket = worker_->addServerSocket(10, [&events](uint32_t e) { events |= e; });
+  socket.enableCloseEvent(true);
+
+  Request* read_req = nullptr;
+  EXPECT_CALL(*mock_io_uring_, prepareReadv(10, _, 1, 0, _))
+      .WillOnce(DoAll(SaveArg<4>(&read_req), Return(IoUringResult::Ok)));
+  socket.enableRead();
+  socket.disableRead();
+
+  // No more read requests after the remote closed the connection.
+  EXPECT_CALL(*mock_io_uring_, prepareReadv(_, _, _, _, _)).Times(0);
+  complete({{read_req, 0}});
+  EXPECT_EQ(Event::FileReadyType::Closed, events);
+  EXPECT_EQ(0, socket.getReadParam()->result_);
+
+  closeSocket(socket);
+}
+
+TEST_F(IoUringWorkerSocketTest, ServerSocketWriteAndShutdown) {
+  uint32_t events = 0;
+  IoUringSocket& socket = worker_->addServerSocket(10, [&events](uint32_t e) { events |= e; });
+
+  Request* write_req = nullptr;
+  EXPECT_CALL(*mock_io_uring_, prepareWritev(10, _, 1, 0, _))
+      .WillOnce(DoAll(SaveArg<4>(&write_req), Return(IoUringResult::Ok)));
+  Buffer::OwnedImpl data("hello");
+  socket.write(data);
+  EXPECT_EQ(0, data.length());
+
+  // The shutdown waits for the pending data.
+  EXPECT_CALL(*mock_io_uring_, prepareShutdown(_, _, _)).Times(0);
+  socket.shutdown(SHUT_WR);
+  testing::Mock::VerifyAndClearExpectations(mock_io_uring_);
+
+  // Partial write, the rest of the data is submitted again.
+  Request* next_write_req = nullptr;
+  EXPECT_CALL(*mock_io_uring_, prepareWritev(10, _, 1, 0, _))
+      .WillOnce(DoAll(SaveArg<4>(&next_write_req), Return(IoUringResult::Ok)));
+  complete({{write_req, 3}});
+  EXPECT_EQ(2, static_cast<WriteRequest*>(next_write_req)->iov_[0].iov_len);
+
+  Request* shutdown_req = nullptr;
+  EXPECT_CALL(*mock_io_uring_, prepareShutdown(10, SHUT_WR, _))
+      .WillOnce(DoAll(SaveArg<2>(&shutdown_req), Return(IoUringResult::Ok)));
+  complete({{next_write_req, 2}});
+  complete({{shutdown_req, 0}});
+
+  // The write event is only delivered on the error.
+  EXPECT_EQ(0, events);
+  EXPECT_FALSE(socket.getWriteParam().has_value());
+
+  closeSocket(socket);
+}
+
+TEST_F(IoUringWorkerSocketTest, ServerSocketWriteBufferLimit) {
+  uint32_t events = 0;
+  IoUringSocket& socket = worker_->addServerSocket(10, [&events](uint32_t e) { events |= e; });
+  const uint64_t limit = IoUringWorkerImpl::DefaultWriteBufferLimit;
+
+  Request* write_req = nullptr;
+  EXPECT_CALL(*mock_io_uring_, prepareWritev(10, _, _, 0, _))
+      .WillOnce(DoAll(SaveArg<4>(&write_req), Return(IoUringResult::Ok)));
+  Buffer::OwnedImpl data(std::string(limit + 100, 'a'));
+  EXPECT_EQ(limit, socket.write(data));
+  EXPECT_EQ(100, data.length());
+
+  // Nothing is buffered while the buffer is full.
+  EXPECT_EQ(0, socket.write(data));
+  Buffer::RawSlice slice{const_cast<char*>("hello"), 5};
+  EXPECT_EQ(0, socket.write(&slice, 1));
+  testing::Mock::VerifyAndClearExpectations(mock_io_uring_);
+
+  // Freeing a little room doesn't wake up the owner.
+  Request* next_write_req = nullptr;
+  EXPECT_CALL(*mock_io_uring_, prepareWritev(10, _, _, 0, _))
+      .WillOnce(DoAll(SaveArg<4>(&next_write_req), Return(IoUringResult::Ok)));
+  complete({{write_req, 10}});
+  EXPECT_EQ(0, events);
+  testing::Mock::VerifyAndClearExpectations(mock_io_uring_);
+
+  // The owner is told to write again once half of the buffer is free.
+  EXPECT_CALL(*mock_io_uring_, prepareWritev(10, _, _, 0, _))
+      .WillOnce(DoAll(SaveArg<4>(&write_req), Return(IoUringResult::Ok)));
+  complete({{next_write_req, static_cast<int32_t>(limit / 2)}});
+  EXPECT_EQ(Event::FileReadyType::Write, events);
+  EXPECT_EQ(5, socket.write(&slice, 1));
+
+  // Drop the rest of the data when handing over the fd.
+  Request* cancel_req = nullptr;
+  EXPECT_CALL(*mock_io_uring_, prepareCancel(write_req, _))
+      .WillOnce(DoAll(SaveArg<1>(&cancel_req), Return(IoUringResult::Ok)));
+  socket.close(true);
+
+  EXPECT_CALL(*mock_io_uring_, prepareClose(_, _)).Times(0);
+  EXPECT_CALL(*mock_io_uring_, removeInjectedCompletion(10));
+  EXPECT_CALL(dispatcher_, deferredDelete_);
+  complete({{write_req, -ECANCELED}, {cancel_req, 0}});
+  EXPECT_EQ(0, worker_->getNumOfSockets());
+}
+
+TEST_F(IoUringWorkerSocketTest, ServerSocketWriteError) {
+  uint32_t events = 0;
+  IoUringSocket& socket = worker_->addServerSocket(10, [&events](uint32_t e) { events |= e; });
+
+  Request* write_req = nullptr;
+  EXPECT_CALL(*mock_io_uring_, prepareWritev(10, _, 1, 0, _))
+      .WillOnce(DoAll(SaveArg<4>(&write_req), Return(IoUringResult::Ok)));
+  Buffer::OwnedImpl data("hello");
+  socket.write(data);
+
+  complete({{write_req, -EPIPE}});
+  EXPECT_EQ(Event::FileReadyType::Write, events);
+  EXPECT_EQ(-EPIPE, socket.getWriteParam()->result_);
+
+  closeSocket(socket);
+}
+
+TEST_F(IoUringWorkerSocketTest, AcceptSocket) {
+  os_fd_t accepted_fd = INVALID_SOCKET;
+  IoUringSocket* accept_socket = nullptr;
+  accept_socket = &worker_->addAcceptSocket(10, [&accepted_fd, &accept_socket](uint32_t events) {
+    EXPECT_EQ(Event::FileReadyType::Read, events);
+    auto param = accept_socket->getAcceptedSocketParam();
+    ASSERT_TRUE(param.has_value());
+    accepted_fd = param->fd_;
+    SET_SOCKET_INVALID(param->fd_);
+  });
+
+  Request* accept_req = nullptr;
+  EXPECT_CALL(*mock_io_uring_, prepareAccept(10, _, _, _))
+      .WillOnce(DoAll(SaveArg<3>(&accept_req), Return(IoUringResult::Ok)));
+  accept_socket->enableRead();
+
+  Request* next_accept_req = nullptr;
+  EXPECT_CALL(*mock_io_uring_, prepareAccept(10, _, _, _))
+      .WillOnce(DoAll(SaveArg<3>(&next_accept_req), Return(IoUringResult::Ok)));
+  complete({{accept_req, 11}});
+  EXPECT_EQ(11, accepted_fd);
+  EXPECT_FALSE(accept_socket->getAcceptedSocketParam().has_value());
+
+  // Stop accepting without closing the fd.
+  Request* cancel_req = nullptr;
+  EXPECT_CALL(*mock_io_uring_, prepareCancel(next_accept_req, _))
+      .WillOnce(DoAll(SaveArg<1>(&cancel_req), Return(IoUringResult::Ok)));
+  accept_socket->close(true);
+
+  EXPECT_CALL(*mock_io_uring_, prepareClose(_, _)).Times(0);
+  EXPECT_CALL(*mock_io_uring_, removeInjectedCompletion(10));
+  EXPECT_CALL(dispatcher_, deferredDelete_);
+  complete({{next_accept_req, -ECANCELED}, {cancel_req, 0}});
+  EXPECT_EQ(0, worker_->getNumOfSockets());
+}
+
+TEST_F(IoUringWorkerSocketTest, ClientSocketConnectFailure) {
+  uint32_t events = 0;
+  IoUringSocket& socket = worker_->addClientSocket(10, [&events](uint32_t e) { events |= e; });
+
+  // No read request until the socket is connected.
+  EXPECT_CALL(*mock_io_uring_, prepareReadv(_, _, _, _, _)).Times(0);
+  socket.enableRead();
+
+  Request* connect_req = nullptr;
+  auto address = std::make_shared<Network::Address::Ipv4Instance>("127.0.0.1", 80);
+  EXPECT_CALL(*mock_io_uring_, prepareConnect(10, _, _))
+      .WillOnce(DoAll(SaveArg<2>(&connect_req), Return(IoUringResult::Ok)));
+  socket.connect(address);
+
+  complete({{connect_req, -ECONNREFUSED}});
+  EXPECT_EQ(Event::FileReadyType::Write, events);
+  EXPECT_EQ(-ECONNREFUSED, socket.getWriteParam()->result_);
+
+  closeSocket(socket);
+}
+
+TEST_F(IoUringWorkerSocketTest, ClientSocketConnected) {
+  uint32_t events = 0;
+  IoUringSocket& socket = worker_->addClientSocket(10, [&events](uint32_t e) { events |= e; });
+  socket.enableRead();
+
+  Request* connect_req = nullptr;
+  auto address = std::make_shared<Network::Address::Ipv4Instance>("127.0.0.1", 80);
+  EXPECT_CALL(*mock_io_uring_, prepareConnect(10, _, _))
+      .WillOnce(DoAll(SaveArg<2>(&connect_req), Return(IoUringResult::Ok)));
+  socket.connect(address);
+
+  Request* read_req = nullptr;
+  EXPECT_CALL(*mock_io_uring_, prepareReadv(10, _, 1, 0, _))
+      .WillOnce(DoAll(SaveArg<4>(&read_req), Return(IoUringResult::Ok)));
+  complete({{connect_req, 0}});
+  EXPECT_EQ(Event::FileReadyType::Write, events);
+  EXPECT_FALSE(socket.getWriteParam().has_value());
+
+  Request* cancel_req = nullptr;
+  EXPECT_CALL(*mock_io_uring_, prepareCancel(read_req, _))
+      .WillOnce(DoAll(SaveArg<1>(&cancel_req), Return(IoUringResult::Ok)));
+  socket.close(false);
+
+  Request* close_req = nullptr;
+  EXPECT_CALL(*mock_io_uring_, prepareClose(10, _))
+      .WillOnce(DoAll(SaveArg<1>(&close_req), Return(IoUringResult::Ok)));
+  complete({{read_req, -ECANCELED}, {cancel_req, 0}});
+
+  EXPECT_CALL(*mock_io_uring_, removeInjectedCompletion(10));
+  EXPECT_CALL(dispatcher_, deferredDelete_);
+  complete({{close_req, 0}});
+  EXPECT_EQ(0, worker_->getNumOfSockets());
+}
+
 } // namespace
 } // namespace Io
 } // namespace Envoy
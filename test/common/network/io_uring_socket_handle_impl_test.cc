@@ -0,0 +1,204 @@
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/network/address_impl.h"
+#include "source/common/network/io_uring_socket_handle_impl.h"
+
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/io/mocks.h"
+#include "test/test_common/utility.h"
+
+#include "gtest/gtest.h"
+
+using testing::_;
+using testing::NiceMock;
+using testing::Return;
+using testing::ReturnRef;
+
+namespace Envoy {
+namespace Network {
+namespace {
+
+class IoUringSocketHandleTest : public testing::Test {
+protected:
+  IoUringSocketHandleTest() {
+    ON_CALL(worker_factory_, getIoUringWorker())
+        .WillByDefault(Return(OptRef<Io::IoUringWorker>(worker_)));
+    ON_CALL(worker_, dispatcher()).WillByDefault(ReturnRef(dispatcher_));
+  }
+
+  // Create a handle whose fd is never touched by the syscalls since all the operations go
+  // through the mock io_uring socket.
+  std::unique_ptr<IoUringSocketHandleImpl> createHandle(bool is_server_socket) {
+    auto handle = std::make_unique<IoUringSocketHandleImpl>(worker_factory_, 10, false,
+                                                            absl::nullopt, is_server_socket);
+    if (is_server_socket) {
+      EXPECT_CALL(worker_, addServerSocket(10, _)).WillOnce(ReturnRef(socket_));
+    } else {
+      EXPECT_CALL(worker_, addClientSocket(10, _)).WillOnce(ReturnRef(socket_));
+    }
+    EXPECT_CALL(socket_, enableRead());
+    EXPECT_CALL(socket_, enableCloseEvent(false));
+    handle->initializeFileEvent(
+        dispatcher_, [](uint32_t) {}, Event::PlatformDefaultTriggerType,
+        Event::FileReadyType::Read | Event::FileReadyType::Write);
+    return handle;
+  }
+
+  void closeHandle(std::unique_ptr<IoUringSocketHandleImpl>& handle) {
+    EXPECT_CALL(socket_, close(false, _));
+    EXPECT_TRUE(handle->close().ok());
+    EXPECT_FALSE(handle->isOpen());
+    handle.reset();
+  }
+
+  NiceMock<Io::MockIoUringWorkerFactory> worker_factory_;
+  NiceMock<Io::MockIoUringWorker> worker_;
+  NiceMock<Io::MockIoUringSocket> socket_;
+  NiceMock<Event::MockDispatcher> dispatcher_;
+};
+
+TEST_F(IoUringSocketHandleTest, FallbackWithoutWorker) {
+  EXPECT_CALL(worker_factory_, getIoUringWorker()).WillOnce(Return(absl::nullopt));
+  EXPECT_CALL(worker_, addClientSocket(_, _)).Times(0);
+
+  const os_fd_t fd = ::socket(AF_INET, SOCK_STREAM, 0);
+  ASSERT_TRUE(SOCKET_VALID(fd));
+  EXPECT_CALL(dispatcher_, createFileEvent_(fd, _, _, _));
+
+  // The fd is closed by the syscall on destruction.
+  IoUringSocketHandleImpl handle(worker_factory_, fd);
+  handle.initializeFileEvent(
+      dispatcher_, [](uint32_t) {}, Event::PlatformDefaultTriggerType,
+      Event::FileReadyType::Read);
+  handle.resetFileEvents();
+}
+
+TEST_F(IoUringSocketHandleTest, Read) {
+  auto handle = createHandle(true);
+
+  Buffer::OwnedImpl read_buf("hello");
+  Io::ReadParam read_param{read_buf, 5};
+  EXPECT_CALL(socket_, getReadParam()).WillRepeatedly(Return(OptRef<Io::ReadParam>(read_param)));
+
+  // Peeking doesn't drain the data.
+  char peek_buf[3];
+  auto result = handle->recv(peek_buf, sizeof(peek_buf), MSG_PEEK);
+  EXPECT_EQ(3, result.return_value_);
+  EXPECT_EQ("hel", absl::string_view(peek_buf, sizeof(peek_buf)));
+  EXPECT_EQ(5, read_buf.length());
+
+  Buffer::OwnedImpl buf;
+  result = handle->read(buf, absl::nullopt);
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(5, result.return_value_);
+  EXPECT_EQ("hello", buf.toString());
+  EXPECT_EQ(0, read_buf.length());
+
+  // The buffer is drained and no error happened.
+  result = handle->read(buf, absl::nullopt);
+  EXPECT_EQ(Api::IoError::IoErrorCode::Again, result.err_->getErrorCode());
+
+  // The remote closed the connection.
+  read_param.result_ = 0;
+  result = handle->read(buf, absl::nullopt);
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(0, result.return_value_);
+
+  read_param.result_ = -ECONNRESET;
+  result = handle->read(buf, absl::nullopt);
+  EXPECT_EQ(ECONNRESET, result.err_->getSystemErrorCode());
+
+  closeHandle(handle);
+}
+
+TEST_F(IoUringSocketHandleTest, Write) {
+  auto handle = createHandle(true);
+
+  Buffer::OwnedImpl buf("hello");
+  EXPECT_CALL(socket_, getWriteParam()).WillOnce(Return(absl::nullopt));
+  EXPECT_CALL(socket_, write(testing::Matcher<Buffer::Instance&>(_)))
+      .WillOnce([](Buffer::Instance& data) -> uint64_t {
+        data.drain(data.length());
+        return 5;
+      });
+  auto result = handle->write(buf);
+  EXPECT_TRUE(result.ok());
+  EXPECT_EQ(5, result.return_value_);
+  EXPECT_EQ(0, buf.length());
+
+  // The write buffer of the socket is full.
+  buf.add("world");
+  EXPECT_CALL(socket_, getWriteParam()).WillOnce(Return(absl::nullopt));
+  EXPECT_CALL(socket_, write(testing::Matcher<Buffer::Instance&>(_))).WillOnce(Return(0));
+  result = handle->write(buf);
+  EXPECT_EQ(Api::IoError::IoErrorCode::Again, result.err_->getErrorCode());
+  EXPECT_EQ(5, buf.length());
+  buf.drain(buf.length());
+
+  // The error of the previous write is reported.
+  Io::WriteParam write_param{-EPIPE};
+  EXPECT_CALL(socket_, getWriteParam()).WillOnce(Return(OptRef<Io::WriteParam>(write_param)));
+  buf.add("world");
+  result = handle->write(buf);
+  EXPECT_EQ(EPIPE, result.err_->getSystemErrorCode());
+  EXPECT_EQ(5, buf.length());
+
+  EXPECT_CALL(socket_, shutdown(SHUT_WR));
+  EXPECT_EQ(0, handle->shutdown(SHUT_WR).return_value_);
+
+  closeHandle(handle);
+}
+
+TEST_F(IoUringSocketHandleTest, Connect) {
+  auto handle = createHandle(false);
+
+  auto address = std::make_shared<Address::Ipv4Instance>("127.0.0.1", 80);
+  EXPECT_CALL(socket_, connect(_));
+  auto result = handle->connect(address);
+  EXPECT_EQ(-1, result.return_value_);
+  EXPECT_EQ(SOCKET_ERROR_IN_PROGRESS, result.errno_);
+
+  // The connect result is reported by SO_ERROR.
+  Io::WriteParam write_param{-ECONNREFUSED};
+  EXPECT_CALL(socket_, getWriteParam()).WillOnce(Return(OptRef<Io::WriteParam>(write_param)));
+  int error = 0;
+  socklen_t error_size = sizeof(error);
+  EXPECT_EQ(0, handle->getOption(SOL_SOCKET, SO_ERROR, &error, &error_size).return_value_);
+  EXPECT_EQ(ECONNREFUSED, error);
+
+  EXPECT_CALL(socket_, getWriteParam()).WillOnce(Return(absl::nullopt));
+  EXPECT_EQ(0, handle->getOption(SOL_SOCKET, SO_ERROR, &error, &error_size).return_value_);
+  EXPECT_EQ(0, error);
+
+  closeHandle(handle);
+}
+
+TEST_F(IoUringSocketHandleTest, FileEvents) {
+  auto handle = createHandle(true);
+
+  EXPECT_CALL(socket_, disableRead());
+  EXPECT_CALL(socket_, enableCloseEvent(true));
+  handle->enableFileEvents(Event::FileReadyType::Closed);
+
+  EXPECT_CALL(socket_, injectCompletion(Io::Request::RequestType::Read));
+  EXPECT_CALL(socket_, injectCompletion(Io::Request::RequestType::Write));
+  handle->activateFileEvents(Event::FileReadyType::Read | Event::FileReadyType::Write);
+
+  // The io_uring socket is kept after resetting the file events.
+  EXPECT_CALL(socket_, disableRead());
+  EXPECT_CALL(socket_, enableCloseEvent(false));
+  EXPECT_CALL(socket_, setFileReadyCb(_));
+  handle->resetFileEvents();
+
+  EXPECT_CALL(socket_, setFileReadyCb(_));
+  EXPECT_CALL(socket_, enableRead());
+  EXPECT_CALL(socket_, enableCloseEvent(false));
+  handle->initializeFileEvent(
+      dispatcher_, [](uint32_t) {}, Event::PlatformDefaultTriggerType,
+      Event::FileReadyType::Read);
+
+  closeHandle(handle);
+}
+
+} // namespace
+} // namespace Network
+} // namespace Envoy
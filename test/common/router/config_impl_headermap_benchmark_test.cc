@@ -82,5 +82,70 @@ BENCHMARK(manyCountryRoutesLongHeaders)
     ->Arg(5000)
     ->Arg(10000);
 
+/**
+ * Measure the time it takes to select a route in a virtual host with many prefix, exact path and
+ * regex routes, with and without the route index. The requests match one of the last routes, so
+ * all the preceding routes are evaluated without the index.
+ *
+ * The first argument is the number of routes, the second one enables the route index.
+ * */
+static void manyPathRoutes(benchmark::State& state) {
+  const size_t routes_num = state.range(0);
+  const bool index_routes = state.range(1) != 0;
+  envoy::config::route::v3::RouteConfiguration proto_config;
+  auto main_virtual_host = proto_config.mutable_virtual_hosts()->Add();
+  main_virtual_host->set_name("default");
+  main_virtual_host->mutable_domains()->Add("*");
+  main_virtual_host->set_index_routes(index_routes);
+  // Paths matching the last prefix, exact path and regex routes, and the default route.
+  std::vector<std::string> paths(3);
+  paths.push_back("/unknown");
+  for (size_t i = 0; i < routes_num; i++) {
+    auto route = main_virtual_host->mutable_routes()->Add();
+    switch (i % 3) {
+    case 0:
+      route->mutable_match()->set_prefix(absl::StrCat("/service", i, "/"));
+      paths[0] = absl::StrCat("/service", i, "/resource");
+      break;
+    case 1:
+      route->mutable_match()->set_path(absl::StrCat("/exact/service", i));
+      paths[1] = absl::StrCat("/exact/service", i);
+      break;
+    default:
+      route->mutable_match()->mutable_safe_regex()->set_regex(
+          absl::StrCat("/regex/service", i, "/[a-z]+"));
+      paths[2] = absl::StrCat("/regex/service", i, "/resource");
+      break;
+    }
+    route->mutable_route()->set_cluster(absl::StrCat("cluster", i));
+  }
+  // Add the default route.
+  auto default_route = main_virtual_host->mutable_routes()->Add();
+  default_route->mutable_match()->set_prefix("/");
+  default_route->mutable_route()->set_cluster("default");
+
+  Api::ApiPtr api(Api::createApiForTest());
+  NiceMock<Server::Configuration::MockServerFactoryContext> factory_context;
+  ON_CALL(factory_context, api()).WillByDefault(ReturnRef(*api));
+  ConfigImpl config(proto_config, OptionalHttpFilters(), factory_context,
+                    ProtobufMessage::getNullValidationVisitor(), true);
+
+  const auto stream_info = NiceMock<Envoy::StreamInfo::MockStreamInfo>();
+  std::vector<Http::TestRequestHeaderMapImpl> requests;
+  for (const std::string& path : paths) {
+    requests.push_back(Http::TestRequestHeaderMapImpl{
+        {":authority", "www.lyft.com"}, {":path", path}, {":method", "GET"}, {":scheme", "http"}});
+  }
+  size_t request = 0;
+  for (auto _ : state) { // NOLINT
+    const auto& headers = requests[request++ % requests.size()];
+    auto& result = config.route(headers, stream_info, 0)->routeEntry()->clusterName();
+    benchmark::DoNotOptimize(result);
+  }
+}
+BENCHMARK(manyPathRoutes)
+    ->ArgsProduct({{10, 100, 1000, 5000}, {0, 1}})
+    ->Unit(benchmark::kNanosecond);
+
 } // namespace Router
 } // namespace Envoy
@@ -8707,6 +8707,102 @@ virtual_hosts:
                 ->clusterName());
 }
 
+// The index only changes which routes are evaluated, so the selected routes must be the same as
+// without it.
+TEST_F(RouteMatcherTest, IndexedRoutes) {
+  const std::string yaml = R"EOF(
+virtual_hosts:
+  - name: indexed
+    domains: ["*"]
+    routes:
+      - match:
+          prefix: "/foo"
+          headers:
+          - name: x-route
+            string_match:
+              exact: "header"
+        route: { cluster: header-cluster }
+      - match:
+          path: "/foo/exact"
+        route: { cluster: exact-cluster }
+      - match:
+          path: "/Foo/Insensitive"
+          case_sensitive: false
+        route: { cluster: exact-insensitive-cluster }
+      - match:
+          safe_regex:
+            regex: "/foo/[0-9]+"
+        route: { cluster: regex-cluster }
+      - match:
+          path_separated_prefix: "/foo/api"
+        route: { cluster: path-separated-cluster }
+      - match:
+          prefix: "/FOO/prefix"
+          case_sensitive: false
+        route: { cluster: prefix-insensitive-cluster }
+      - match:
+          prefix: "/foo"
+        route: { cluster: prefix-cluster }
+      - match:
+          safe_regex:
+            regex: ".*"
+        route: { cluster: catch-all-regex-cluster }
+      - match:
+          prefix: "/"
+        route: { cluster: default-cluster }
+  )EOF";
+
+  factory_context_.cluster_manager_.initializeClusters(
+      {"header-cluster", "exact-cluster", "exact-insensitive-cluster", "regex-cluster",
+       "path-separated-cluster", "prefix-insensitive-cluster", "prefix-cluster",
+       "catch-all-regex-cluster", "default-cluster"},
+      {});
+  envoy::config::route::v3::RouteConfiguration route_config = parseRouteConfigurationFromYaml(yaml);
+  TestConfigImpl config(route_config, factory_context_, true);
+  route_config.mutable_virtual_hosts(0)->set_index_routes(true);
+  TestConfigImpl indexed_config(route_config, factory_context_, true);
+
+  const std::vector<std::pair<std::string, std::string>> expected_clusters = {
+      {"/foo/exact", "exact-cluster"},
+      {"/foo/exact?query=true", "exact-cluster"},
+      {"/foo/exact#fragment", "exact-cluster"},
+      {"/foo/exact/", "prefix-cluster"},
+      {"/foo/insensitive", "exact-insensitive-cluster"},
+      {"/foo/123", "regex-cluster"},
+      {"/foo/123/", "prefix-cluster"},
+      {"/foo/api", "path-separated-cluster"},
+      {"/foo/api/v1", "path-separated-cluster"},
+      {"/foo/apis", "prefix-cluster"},
+      {"/foo/Prefix/thing", "prefix-insensitive-cluster"},
+      {"/fo", "catch-all-regex-cluster"},
+      {"/bar", "catch-all-regex-cluster"},
+  };
+  for (const auto& [path, cluster] : expected_clusters) {
+    SCOPED_TRACE(path);
+    Http::TestRequestHeaderMapImpl headers = genHeaders("www.lyft.com", path, "GET");
+    EXPECT_EQ(cluster, config.route(headers, 0)->routeEntry()->clusterName());
+    EXPECT_EQ(cluster, indexed_config.route(headers, 0)->routeEntry()->clusterName());
+  }
+
+  // The other match criteria of the candidates are still evaluated in order.
+  Http::TestRequestHeaderMapImpl headers = genHeaders("www.lyft.com", "/foo/exact", "GET");
+  headers.addCopy("x-route", "header");
+  EXPECT_EQ("header-cluster", config.route(headers, 0)->routeEntry()->clusterName());
+  EXPECT_EQ("header-cluster", indexed_config.route(headers, 0)->routeEntry()->clusterName());
+
+  // The route callback walks every route.
+  std::vector<std::string> accepted_clusters;
+  indexed_config.route(
+      [&accepted_clusters](RouteConstSharedPtr route, RouteEvalStatus) -> RouteMatchStatus {
+        accepted_clusters.push_back(route->routeEntry()->clusterName());
+        return RouteMatchStatus::Continue;
+      },
+      genHeaders("www.lyft.com", "/foo/exact", "GET"));
+  EXPECT_EQ((std::vector<std::string>{"exact-cluster", "prefix-cluster", "catch-all-regex-cluster",
+                                      "default-cluster"}),
+            accepted_clusters);
+}
+
 TEST_F(RouteMatcherTest, PathSeparatedPrefixMatchRewrite) {
 
   const std::string yaml = R"EOF(
@@ -0,0 +1,87 @@
+#include "source/common/router/route_index.h"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+using testing::ElementsAre;
+using testing::IsEmpty;
+
+namespace Envoy {
+namespace Router {
+namespace {
+
+RouteIndex::Candidates candidates(const RouteIndex& index, absl::string_view path) {
+  RouteIndex::Candidates result;
+  index.candidates(path, result);
+  return result;
+}
+
+TEST(RouteIndexTest, Prefix) {
+  RouteIndex index;
+  index.addPrefix("/foo/bar", true);
+  index.addPrefix("/foo", true);
+  index.addPrefix("/", true);
+  index.addPrefix("/baz", true);
+  index.addPrefix("", true);
+  index.finalize();
+  EXPECT_EQ(5, index.size());
+
+  EXPECT_THAT(candidates(index, "/foo/bar/baz"), ElementsAre(0, 1, 2, 4));
+  EXPECT_THAT(candidates(index, "/foo"), ElementsAre(1, 2, 4));
+  EXPECT_THAT(candidates(index, "/FOO"), ElementsAre(2, 4));
+  EXPECT_THAT(candidates(index, "/ba"), ElementsAre(2, 4));
+  EXPECT_THAT(candidates(index, ""), ElementsAre(4));
+}
+
+TEST(RouteIndexTest, PrefixIgnoreCase) {
+  RouteIndex index;
+  index.addPrefix("/Foo", false);
+  index.addPrefix("/foo", true);
+  index.finalize();
+
+  EXPECT_THAT(candidates(index, "/fOo/bar"), ElementsAre(0));
+  EXPECT_THAT(candidates(index, "/foo/bar"), ElementsAre(0, 1));
+}
+
+TEST(RouteIndexTest, Exact) {
+  RouteIndex index;
+  index.addExact("/foo", true);
+  index.addExact("/Foo", false);
+  index.addExact("/foo", true);
+  index.finalize();
+
+  EXPECT_THAT(candidates(index, "/foo"), ElementsAre(0, 1, 2));
+  EXPECT_THAT(candidates(index, "/FOO"), ElementsAre(1));
+  EXPECT_THAT(candidates(index, "/foo/"), IsEmpty());
+}
+
+TEST(RouteIndexTest, Regex) {
+  RouteIndex index;
+  index.addRegex("/foo/[0-9]+");
+  index.addPrefix("/foo", true);
+  index.addRegex("/foo/.*");
+  // Invalid regexes are always candidates.
+  index.addRegex("(");
+  index.finalize();
+
+  EXPECT_THAT(candidates(index, "/foo/123"), ElementsAre(0, 1, 2, 3));
+  EXPECT_THAT(candidates(index, "/foo/abc"), ElementsAre(1, 2, 3));
+  // The regexes must match the whole path.
+  EXPECT_THAT(candidates(index, "/bar/foo/123"), ElementsAre(3));
+}
+
+TEST(RouteIndexTest, Unindexed) {
+  RouteIndex index;
+  index.addPrefix("/foo", true);
+  index.addUnindexed();
+  index.addExact("/foo", true);
+  index.addUnindexed();
+  index.finalize();
+
+  EXPECT_THAT(candidates(index, "/foo"), ElementsAre(0, 1, 2, 3));
+  EXPECT_THAT(candidates(index, "/bar"), ElementsAre(1, 3));
+}
+
+} // namespace
+} // namespace Router
+} // namespace Envoy
@@ -57,6 +57,7 @@ using ::testing::Invoke;
 using ::testing::InvokeWithoutArgs;
 using ::testing::Mock;
 using ::testing::NiceMock;
+using ::testing::NotNull;
 using ::testing::Return;
 using ::testing::ReturnNew;
 using ::testing::ReturnRef;
@@ -1024,6 +1025,40 @@ TEST_F(ClusterManagerImplTest, ClusterProvidedLbNotConfigured) {
                             "'cluster_0' provided one. Check cluster documentation.");
 }
 
+// Verify that the thread aware load balancers are given the build pool when load balancer build
+// threads are configured.
+TEST_F(ClusterManagerImplTest, LoadBalancerBuildThreads) {
+  const std::string json = fmt::sprintf(
+      "{\"cluster_manager\":{\"load_balancer_build_threads\":2},\"static_resources\":{%s}}",
+      clustersJson({defaultStaticClusterJson("cluster_0")}));
+
+  std::shared_ptr<MockClusterMockPrioritySet> cluster1(new NiceMock<MockClusterMockPrioritySet>());
+  cluster1->info_->name_ = "cluster_0";
+  cluster1->info_->lb_type_ = LoadBalancerType::ClusterProvided;
+  auto* lb = new NiceMock<MockThreadAwareLoadBalancer>();
+  EXPECT_CALL(*lb, setBuildPool(NotNull()));
+  EXPECT_CALL(factory_, clusterFromProto_(_, _, _, _))
+      .WillOnce(Return(std::make_pair(cluster1, lb)));
+  ON_CALL(*cluster1, initializePhase()).WillByDefault(Return(Cluster::InitializePhase::Primary));
+  create(parseBootstrapFromV3Json(json));
+}
+
+// Verify that the thread aware load balancers build synchronously by default.
+TEST_F(ClusterManagerImplTest, NoLoadBalancerBuildThreads) {
+  const std::string json = fmt::sprintf("{\"static_resources\":{%s}}",
+                                        clustersJson({defaultStaticClusterJson("cluster_0")}));
+
+  std::shared_ptr<MockClusterMockPrioritySet> cluster1(new NiceMock<MockClusterMockPrioritySet>());
+  cluster1->info_->name_ = "cluster_0";
+  cluster1->info_->lb_type_ = LoadBalancerType::ClusterProvided;
+  auto* lb = new NiceMock<MockThreadAwareLoadBalancer>();
+  EXPECT_CALL(*lb, setBuildPool(_)).Times(0);
+  EXPECT_CALL(factory_, clusterFromProto_(_, _, _, _))
+      .WillOnce(Return(std::make_pair(cluster1, lb)));
+  ON_CALL(*cluster1, initializePhase()).WillByDefault(Return(Cluster::InitializePhase::Primary));
+  create(parseBootstrapFromV3Json(json));
+}
+
 // Verify that multiple load balancing policies can be specified, and Envoy selects the first
 // policy that it has a factory for.
 TEST_F(ClusterManagerImplTest, LbPolicyConfig) {
@@ -134,6 +134,68 @@ TEST(EdfSchedulerTest, ManyPeekahead) {
   }
 }
 
+// Validate that removed entries are no longer picked, and that an entry added again after being
+// removed is picked once per round.
+TEST(EdfSchedulerTest, Remove) {
+  EdfScheduler<uint32_t> sched;
+  constexpr uint32_t num_entries = 8;
+  std::shared_ptr<uint32_t> entries[num_entries];
+
+  for (uint32_t i = 0; i < num_entries; ++i) {
+    entries[i] = std::make_shared<uint32_t>(i);
+    sched.add(1, entries[i]);
+  }
+  sched.remove(entries[2]);
+  sched.remove(entries[5]);
+
+  std::vector<uint32_t> picks;
+  for (uint32_t i = 0; i < 12; ++i) {
+    picks.push_back(*sched.pickAndAdd([](const double&) { return 1; }));
+  }
+  EXPECT_EQ(std::vector<uint32_t>({0, 1, 3, 4, 6, 7, 0, 1, 3, 4, 6, 7}), picks);
+
+  sched.add(1, entries[2]);
+  uint32_t pick_count[num_entries] = {};
+  for (uint32_t i = 0; i < 70; ++i) {
+    ++pick_count[*sched.pickAndAdd([](const double&) { return 1; })];
+  }
+  for (uint32_t i = 0; i < num_entries; ++i) {
+    EXPECT_EQ(i == 5 ? 0 : 10, pick_count[i]);
+  }
+}
+
+// Validate that a removed entry is not picked after being peeked.
+TEST(EdfSchedulerTest, RemovePeeked) {
+  EdfScheduler<uint32_t> sched;
+  auto first_entry = std::make_shared<uint32_t>(37);
+  auto second_entry = std::make_shared<uint32_t>(42);
+  sched.add(2, first_entry);
+  sched.add(1, second_entry);
+
+  EXPECT_EQ(37, *sched.peekAgain([](const double&) { return 2; }));
+  sched.remove(first_entry);
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_EQ(42, *sched.pickAndAdd([](const double&) { return 1; }));
+  }
+}
+
+// Validate that removing every entry leaves the schedule empty.
+TEST(EdfSchedulerTest, RemoveAll) {
+  EdfScheduler<uint32_t> sched;
+  constexpr uint32_t num_entries = 128;
+  std::shared_ptr<uint32_t> entries[num_entries];
+
+  for (uint32_t i = 0; i < num_entries; ++i) {
+    entries[i] = std::make_shared<uint32_t>(i);
+    sched.add(i + 1, entries[i]);
+  }
+  for (uint32_t i = 0; i < num_entries; ++i) {
+    sched.remove(entries[i]);
+  }
+  EXPECT_TRUE(sched.empty());
+  EXPECT_EQ(nullptr, sched.pickAndAdd([](const double&) { return 1; }));
+}
+
 } // namespace
 } // namespace Upstream
 } // namespace Envoy
@@ -0,0 +1,89 @@
+#include <memory>
+#include <string>
+
+#include "source/common/singleton/manager_impl.h"
+#include "source/common/thread_local/thread_local_impl.h"
+#include "source/common/upstream/health_check_thread_pool.h"
+
+#include "test/test_common/utility.h"
+
+#include "absl/synchronization/notification.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+class NamedThreadLocalObject : public ThreadLocal::ThreadLocalObject {
+public:
+  explicit NamedThreadLocalObject(const std::string& name) : name_(name) {}
+
+  const std::string name_;
+};
+
+class HealthCheckThreadPoolTest : public testing::Test {
+public:
+  HealthCheckThreadPoolTest()
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher("main")),
+        singleton_manager_(api_->threadFactory()) {
+    tls_.registerThread(*dispatcher_, true);
+  }
+
+  ~HealthCheckThreadPoolTest() override {
+    tls_.shutdownGlobalThreading();
+    if (pool_ != nullptr) {
+      pool_->shutdown();
+    }
+    tls_.shutdownThread();
+  }
+
+  // Runs the callback on the dispatcher and waits for it.
+  void runOn(Event::Dispatcher& dispatcher, std::function<void()> cb) {
+    absl::Notification done;
+    dispatcher.post([&cb, &done]() {
+      cb();
+      done.Notify();
+    });
+    done.WaitForNotification();
+  }
+
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  Singleton::ManagerImpl singleton_manager_;
+  ThreadLocal::InstanceImpl tls_;
+  std::shared_ptr<HealthCheckThreadPool> pool_;
+};
+
+// No thread pool is created if the health checks run on the main thread.
+TEST_F(HealthCheckThreadPoolTest, NoThreads) {
+  EXPECT_EQ(nullptr, HealthCheckThreadPool::create(singleton_manager_, *api_, tls_, 0));
+}
+
+// The threads are registered with the thread local instance, so the slots set once the pool is
+// created have data there, as the codec clients and the stats of the sessions need.
+TEST_F(HealthCheckThreadPoolTest, ThreadLocalData) {
+  pool_ = HealthCheckThreadPool::create(singleton_manager_, *api_, tls_, 2);
+  ASSERT_NE(nullptr, pool_);
+  EXPECT_EQ(pool_, HealthCheckThreadPool::create(singleton_manager_, *api_, tls_, 2));
+
+  auto slot = ThreadLocal::TypedSlot<NamedThreadLocalObject>::makeUnique(tls_);
+  slot->set([](Event::Dispatcher& dispatcher) {
+    return std::make_shared<NamedThreadLocalObject>(dispatcher.name());
+  });
+  EXPECT_EQ("main", (*slot)->name_);
+
+  // The sessions are spread across the threads.
+  for (const char* expected_name : {"health_check_0", "health_check_1", "health_check_0"}) {
+    Event::Dispatcher& dispatcher = pool_->nextDispatcher();
+    std::string name;
+    runOn(dispatcher, [&slot, &name]() {
+      ASSERT_TRUE(slot->currentThreadRegistered());
+      name = (*slot)->name_;
+    });
+    EXPECT_EQ(expected_name, name);
+  }
+}
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
@@ -0,0 +1,151 @@
+// Usage: bazel run //test/common/upstream:health_checker_benchmark
+
+#include <time.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "source/common/common/random_generator.h"
+#include "source/common/thread_local/thread_local_impl.h"
+#include "source/common/upstream/health_check_thread_pool.h"
+#include "source/extensions/health_checkers/tcp/health_checker_impl.h"
+
+#include "test/benchmark/main.h"
+#include "test/common/upstream/utility.h"
+#include "test/mocks/runtime/mocks.h"
+#include "test/mocks/upstream/cluster_priority_set.h"
+#include "test/test_common/network_utility.h"
+#include "test/test_common/utility.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+// A loopback upstream accepting the health check connections and closing them.
+class LoopbackUpstream {
+public:
+  LoopbackUpstream(Api::Api& api) {
+    auto bound = Network::Test::bindFreeLoopbackPort(Network::Address::IpVersion::v4,
+                                                     Network::Socket::Type::Stream);
+    address_ = std::move(bound.first);
+    socket_ = std::move(bound.second);
+    RELEASE_ASSERT(socket_->ioHandle().listen(4096).return_value_ == 0, "listen failed");
+    socket_->ioHandle().setBlocking(false);
+    thread_ = api.threadFactory().createThread([this]() -> void { acceptLoop(); });
+  }
+
+  ~LoopbackUpstream() {
+    stop_ = true;
+    thread_->join();
+  }
+
+  const Network::Address::InstanceConstSharedPtr& address() const { return address_; }
+
+private:
+  void acceptLoop() {
+    while (!stop_) {
+      Network::IoHandlePtr connection = socket_->ioHandle().accept(nullptr, nullptr);
+      if (connection == nullptr) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        continue;
+      }
+      connection->close();
+    }
+  }
+
+  Network::Address::InstanceConstSharedPtr address_;
+  Network::SocketPtr socket_;
+  std::atomic<bool> stop_{};
+  Thread::ThreadPtr thread_;
+};
+
+std::chrono::nanoseconds threadCpuTime() {
+  struct timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec);
+}
+
+// Measures the CPU time the main thread spends on the TCP health checks of a cluster against a
+// loopback upstream, with the health checks running on the main thread or on health check threads.
+// Each iteration runs the main thread for a few health check intervals; the reported time is the
+// CPU time of the main thread, and checks_per_main_cpu_ms the health checks completed meanwhile
+// per millisecond of it.
+void benchmarkHealthCheckMainThreadCpu(::benchmark::State& state) {
+  const uint32_t num_hosts = state.range(0);
+  const uint32_t num_threads = state.range(1);
+  if (benchmark::skipExpensiveBenchmarks() && num_hosts > 1000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  Api::ApiPtr api = Api::createApiForTest();
+  Event::DispatcherPtr dispatcher = api->allocateDispatcher("main");
+  ThreadLocal::InstanceImpl tls;
+  tls.registerThread(*dispatcher, true);
+  std::shared_ptr<HealthCheckThreadPool> pool;
+  if (num_threads > 0) {
+    pool = std::make_shared<HealthCheckThreadPool>(*api, tls, num_threads);
+  }
+  LoopbackUpstream upstream(*api);
+
+  testing::NiceMock<MockClusterMockPrioritySet> cluster;
+  testing::NiceMock<Runtime::MockLoader> runtime;
+  Random::RandomGeneratorImpl random;
+  const std::string url = fmt::format("tcp://127.0.0.1:{}", upstream.address()->ip()->port());
+  for (uint32_t i = 0; i < num_hosts; ++i) {
+    cluster.prioritySet().getMockHostSet(0)->hosts_.push_back(
+        makeTestHost(cluster.info_, url, api->timeSource()));
+  }
+
+  const std::string yaml = R"EOF(
+    timeout: 1s
+    interval: 0.05s
+    unhealthy_threshold: 2
+    healthy_threshold: 2
+    tcp_health_check: {}
+    )EOF";
+  auto health_checker = std::make_shared<TcpHealthCheckerImpl>(
+      cluster, parseHealthCheckFromV3Yaml(yaml), *dispatcher, runtime, random, nullptr);
+  health_checker->setHealthCheckDispatchers(pool);
+  health_checker->start();
+
+  Stats::Counter& attempts = cluster.info_->stats_store_.counter("health_check.attempt");
+  Event::TimerPtr exit_timer = dispatcher->createTimer([&dispatcher]() { dispatcher->exit(); });
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    const uint64_t start_attempts = attempts.value();
+    const std::chrono::nanoseconds start_cpu = threadCpuTime();
+    exit_timer->enableTimer(std::chrono::milliseconds(500));
+    dispatcher->run(Event::Dispatcher::RunType::RunUntilExit);
+    const std::chrono::nanoseconds cpu = threadCpuTime() - start_cpu;
+    state.SetIterationTime(std::chrono::duration<double>(cpu).count());
+    state.counters["checks_per_main_cpu_ms"] =
+        (attempts.value() - start_attempts) /
+        std::max(std::chrono::duration<double, std::milli>(cpu).count(), 0.001);
+  }
+
+  // The health checker waits for its sessions to stop on the health check threads.
+  health_checker.reset();
+  dispatcher->run(Event::Dispatcher::RunType::NonBlock);
+  tls.shutdownGlobalThreading();
+  if (pool != nullptr) {
+    pool->shutdown();
+  }
+  tls.shutdownThread();
+}
+BENCHMARK(benchmarkHealthCheckMainThreadCpu)
+    ->Args({100, 0})
+    ->Args({100, 2})
+    ->Args({1000, 0})
+    ->Args({1000, 2})
+    ->Args({5000, 0})
+    ->Args({5000, 2})
+    ->UseManualTime()
+    ->Unit(::benchmark::kMillisecond);
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
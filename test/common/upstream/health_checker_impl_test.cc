@@ -1,4 +1,5 @@
 #include <chrono>
+#include <list>
 #include <memory>
 #include <ostream>
 #include <string>
@@ -4678,6 +4679,169 @@ TEST_F(TcpHealthCheckerImplTest, ConnectionLocalFailure) {
   EXPECT_EQ(0UL, cluster_->info_->stats_store_.counter("health_check.passive_failure").value());
 }
 
+class TestHealthCheckDispatchers : public HealthCheckDispatchers {
+public:
+  TestHealthCheckDispatchers(Event::Dispatcher& dispatcher) : dispatcher_(dispatcher) {}
+
+  // Upstream::HealthCheckDispatchers
+  Event::Dispatcher& nextDispatcher() override { return dispatcher_; }
+
+  Event::Dispatcher& dispatcher_;
+};
+
+class TcpHealthCheckerDispatchersTest : public TcpHealthCheckerImplTest {
+public:
+  TcpHealthCheckerDispatchersTest() {
+    // Queue the posts of both threads so that the tests control when each of them runs.
+    ON_CALL(dispatcher_, post(_)).WillByDefault(Invoke([this](Event::PostCb cb) {
+      main_posted_.push_back(std::move(cb));
+    }));
+    ON_CALL(hc_dispatcher_, post(_)).WillByDefault(Invoke([this](Event::PostCb cb) {
+      if (queue_hc_posts_) {
+        hc_posted_.push_back(std::move(cb));
+      } else {
+        cb();
+      }
+    }));
+  }
+
+  ~TcpHealthCheckerDispatchersTest() override {
+    // The health checker waits for its sessions to be stopped by their dispatcher.
+    queue_hc_posts_ = false;
+    health_checker_.reset();
+  }
+
+  void setup(uint32_t num_hosts, bool with_data = false) {
+    if (with_data) {
+      setupData();
+    } else {
+      setupNoData();
+    }
+    health_checker_->setHealthCheckDispatchers(
+        std::make_shared<TestHealthCheckDispatchers>(hc_dispatcher_));
+    health_checker_->addHostCheckCompleteCb(
+        [this](HostSharedPtr, HealthTransition) -> void { ++host_check_completions_; });
+    for (uint32_t i = 0; i < num_hosts; ++i) {
+      cluster_->prioritySet().getMockHostSet(0)->hosts_.push_back(makeTestHost(
+          cluster_->info_, fmt::format("tcp://127.0.0.{}:80", i + 1), simTime()));
+    }
+  }
+
+  // Starts the sessions on the health check dispatcher.
+  void start(uint32_t num_hosts) {
+    health_checker_->start();
+    ASSERT_EQ(num_hosts, hc_posted_.size());
+    for (uint32_t i = 0; i < num_hosts; ++i) {
+      TestSession& session = sessions_.emplace_back();
+      session.interval_timer_ = new Event::MockTimer(&hc_dispatcher_);
+      session.timeout_timer_ = new Event::MockTimer(&hc_dispatcher_);
+      session.connection_ = new NiceMock<Network::MockClientConnection>();
+      EXPECT_CALL(hc_dispatcher_, createClientConnection_(_, _, _, _))
+          .WillOnce(Return(session.connection_));
+      EXPECT_CALL(*session.connection_, addReadFilter(_))
+          .WillOnce(SaveArg<0>(&session.read_filter_));
+      EXPECT_CALL(*session.timeout_timer_, enableTimer(_, _));
+      Event::PostCb cb = std::move(hc_posted_.front());
+      hc_posted_.pop_front();
+      cb();
+    }
+  }
+
+  void runPosts(std::list<Event::PostCb>& posted) {
+    while (!posted.empty()) {
+      Event::PostCb cb = std::move(posted.front());
+      posted.pop_front();
+      cb();
+    }
+  }
+
+  struct TestSession {
+    Event::MockTimer* interval_timer_{};
+    Event::MockTimer* timeout_timer_{};
+    Network::MockClientConnection* connection_{};
+    Network::ReadFilterSharedPtr read_filter_;
+  };
+
+  NiceMock<Event::MockDispatcher> hc_dispatcher_{"health_check"};
+  std::list<Event::PostCb> main_posted_;
+  std::list<Event::PostCb> hc_posted_;
+  bool queue_hc_posts_{true};
+  std::list<TestSession> sessions_;
+  uint32_t host_check_completions_{};
+};
+
+// The results of the sessions are applied by the main thread in a single batch, and the next
+// health checks are scheduled by the health check dispatcher.
+TEST_F(TcpHealthCheckerDispatchersTest, ResultsAppliedInBatch) {
+  setup(2);
+  start(2);
+
+  for (TestSession& session : sessions_) {
+    EXPECT_CALL(*session.timeout_timer_, disableTimer());
+    EXPECT_CALL(*session.interval_timer_, enableTimer(_, _)).Times(0);
+    session.connection_->raiseEvent(Network::ConnectionEvent::Connected);
+  }
+  EXPECT_EQ(1, main_posted_.size());
+  EXPECT_EQ(0UL, cluster_->info_->stats_store_.counter("health_check.success").value());
+  EXPECT_EQ(0, host_check_completions_);
+
+  runPosts(main_posted_);
+  EXPECT_EQ(2UL, cluster_->info_->stats_store_.counter("health_check.success").value());
+  EXPECT_EQ(2, host_check_completions_);
+  EXPECT_EQ(1, hc_posted_.size());
+
+  for (TestSession& session : sessions_) {
+    EXPECT_CALL(*session.interval_timer_, enableTimer(_, _));
+  }
+  runPosts(hc_posted_);
+}
+
+// A failure is applied by the main thread, which then schedules the next health check.
+TEST_F(TcpHealthCheckerDispatchersTest, Failure) {
+  setup(1);
+  start(1);
+
+  TestSession& session = sessions_.front();
+  EXPECT_CALL(*session.timeout_timer_, disableTimer());
+  session.connection_->raiseEvent(Network::ConnectionEvent::RemoteClose);
+  EXPECT_EQ(0UL, cluster_->info_->stats_store_.counter("health_check.failure").value());
+
+  EXPECT_CALL(event_logger_, logUnhealthy(_, _, _, true));
+  runPosts(main_posted_);
+  EXPECT_EQ(1UL, cluster_->info_->stats_store_.counter("health_check.failure").value());
+  EXPECT_EQ(1UL, cluster_->info_->stats_store_.counter("health_check.network_failure").value());
+
+  EXPECT_CALL(*session.interval_timer_, enableTimer(_, _));
+  runPosts(hc_posted_);
+}
+
+// The result of a session whose host was removed before the main thread got to it is dropped, and
+// the session is stopped by its dispatcher.
+TEST_F(TcpHealthCheckerDispatchersTest, RemoveHostWithPendingResult) {
+  setup(1, true);
+  start(1);
+
+  TestSession& session = sessions_.front();
+  session.connection_->raiseEvent(Network::ConnectionEvent::Connected);
+  EXPECT_CALL(*session.timeout_timer_, disableTimer());
+  Buffer::OwnedImpl response;
+  addUint8(response, 2);
+  session.read_filter_->onData(response, false);
+
+  HostVector old_hosts = std::move(cluster_->prioritySet().getMockHostSet(0)->hosts_);
+  cluster_->prioritySet().getMockHostSet(0)->runCallbacks({}, old_hosts);
+  EXPECT_EQ(1, hc_posted_.size());
+  // The removal of the host runs the callbacks, as the session never completed a health check.
+  EXPECT_EQ(1, host_check_completions_);
+
+  runPosts(main_posted_);
+  EXPECT_EQ(0UL, cluster_->info_->stats_store_.counter("health_check.success").value());
+  EXPECT_EQ(1, hc_posted_.size());
+
+  EXPECT_CALL(*session.connection_, close(Network::ConnectionCloseType::Abort));
+  runPosts(hc_posted_);
+}
+
 class TestGrpcHealthCheckerImpl : public GrpcHealthCheckerImpl {
 public:
   using GrpcHealthCheckerImpl::GrpcHealthCheckerImpl;
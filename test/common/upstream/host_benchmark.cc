@@ -0,0 +1,85 @@
+// Usage: bazel run //test/common/upstream:host_benchmark
+
+#include <memory>
+
+#include "envoy/config/core/v3/base.pb.h"
+#include "envoy/config/endpoint/v3/endpoint_components.pb.h"
+
+#include "source/common/memory/stats.h"
+#include "source/common/network/utility.h"
+#include "source/common/upstream/upstream_impl.h"
+
+#include "test/benchmark/main.h"
+#include "test/mocks/event/mocks.h"
+#include "test/mocks/upstream/cluster_info.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+// Measures the memory of the hosts of a large cluster, spread across 10 localities. The hosts are
+// created the way EDS creates them, including their addresses.
+void benchmarkHostMemory(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const bool intern_localities = state.range(1) != 0;
+  const bool use_stats = state.range(2) != 0;
+  if (benchmark::skipExpensiveBenchmarks() && num_hosts > 10000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  Event::SimulatedTimeSystem time_system;
+  testing::NiceMock<Event::MockDispatcher> dispatcher;
+  auto locality_pool = std::make_shared<SharedPool::ObjectSharedPool<
+      const envoy::config::core::v3::Locality, LocalityHash, LocalityEqualTo>>(dispatcher);
+  std::shared_ptr<MockClusterInfo> info{new testing::NiceMock<MockClusterInfo>()};
+  std::vector<envoy::config::core::v3::Locality> localities(10);
+  for (uint32_t i = 0; i < localities.size(); ++i) {
+    localities[i].set_region("us-east-1");
+    localities[i].set_zone(fmt::format("us-east-1{}", static_cast<char>('a' + i)));
+    localities[i].set_sub_zone(fmt::format("rack-{}", i));
+  }
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    HostVector hosts;
+    hosts.reserve(num_hosts);
+    const size_t start_mem = Memory::Stats::totalCurrentlyAllocated();
+    for (uint64_t i = 0; i < num_hosts; ++i) {
+      const auto& locality = localities[i % localities.size()];
+      auto address = Network::Utility::parseInternetAddress(
+          fmt::format("10.{}.{}.{}", i / 65536, (i / 256) % 256, i % 256), 8080);
+      if (intern_localities) {
+        hosts.push_back(std::make_shared<HostImpl>(
+            info, "", std::move(address), nullptr, 1, locality_pool->getObject(locality),
+            envoy::config::endpoint::v3::Endpoint::HealthCheckConfig::default_instance(), 0,
+            envoy::config::core::v3::UNKNOWN, time_system));
+      } else {
+        hosts.push_back(std::make_shared<HostImpl>(
+            info, "", std::move(address), nullptr, 1, locality,
+            envoy::config::endpoint::v3::Endpoint::HealthCheckConfig::default_instance(), 0,
+            envoy::config::core::v3::UNKNOWN, time_system));
+      }
+      if (use_stats) {
+        hosts.back()->stats().rq_total_.inc();
+      }
+    }
+    const size_t end_mem = Memory::Stats::totalCurrentlyAllocated();
+    state.counters["memory"] = end_mem - start_mem;
+    state.counters["memory_per_host"] = (end_mem - start_mem) / num_hosts;
+  }
+}
+BENCHMARK(benchmarkHostMemory)
+    ->Args({1000, 0, 0})
+    ->Args({1000, 1, 0})
+    ->Args({1000, 1, 1})
+    ->Args({50000, 0, 0})
+    ->Args({50000, 1, 0})
+    ->Args({50000, 1, 1})
+    ->Unit(::benchmark::kMillisecond);
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
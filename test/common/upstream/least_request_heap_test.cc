@@ -0,0 +1,116 @@
+#include <memory>
+#include <vector>
+
+#include "source/common/upstream/least_request_heap.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Upstream {
+namespace {
+
+struct TestEntry {
+  TestEntry(uint32_t id, double weight) : id_(id), weight_(weight) {}
+  const uint32_t id_;
+  const double weight_;
+  uint64_t active_requests_{};
+};
+
+class LeastRequestHeapTest : public testing::Test {
+public:
+  void addEntries(const std::vector<double>& weights, uint32_t refresh_count = 0) {
+    heap_ = std::make_unique<LeastRequestHeap<TestEntry>>(
+        [](const TestEntry& entry) { return entry.active_requests_; },
+        [](const TestEntry& entry, uint64_t active_requests) {
+          return entry.weight_ / (active_requests + 1);
+        },
+        refresh_count);
+    for (uint32_t i = 0; i < weights.size(); ++i) {
+      entries_.push_back(std::make_shared<TestEntry>(i, weights[i]));
+      heap_->add(entries_.back());
+    }
+  }
+
+  std::vector<std::shared_ptr<TestEntry>> entries_;
+  std::unique_ptr<LeastRequestHeap<TestEntry>> heap_;
+};
+
+TEST_F(LeastRequestHeapTest, Empty) {
+  addEntries({});
+  EXPECT_TRUE(heap_->empty());
+  EXPECT_EQ(nullptr, heap_->pick());
+}
+
+// Entries of equal weight are picked in round robin order, also when the requests they are picked
+// for complete before the next pick.
+TEST_F(LeastRequestHeapTest, EqualWeightsRoundRobin) {
+  addEntries({1, 1, 1, 1}, 1);
+  EXPECT_EQ(4, heap_->size());
+  for (uint32_t round = 0; round < 8; ++round) {
+    for (uint32_t i = 0; i < entries_.size(); ++i) {
+      EXPECT_EQ(i, heap_->pick()->id_);
+    }
+  }
+}
+
+TEST_F(LeastRequestHeapTest, Rotate) {
+  addEntries({1, 1, 1, 1});
+  heap_->rotate(6);
+  EXPECT_EQ(2, heap_->pick()->id_);
+  EXPECT_EQ(3, heap_->pick()->id_);
+  EXPECT_EQ(0, heap_->pick()->id_);
+  EXPECT_EQ(1, heap_->pick()->id_);
+}
+
+// The picks spread the outstanding requests across the entries in proportion to their weights.
+TEST_F(LeastRequestHeapTest, OutstandingRequestsFollowWeights) {
+  addEntries({1, 2, 3}, 1);
+  for (uint32_t i = 0; i < 597; ++i) {
+    ++heap_->pick()->active_requests_;
+  }
+  EXPECT_EQ(99, entries_[0]->active_requests_);
+  EXPECT_EQ(199, entries_[1]->active_requests_);
+  EXPECT_EQ(299, entries_[2]->active_requests_);
+}
+
+// Back to back picks, whose requests are not accounted for by the entries yet, are spread across
+// the entries.
+TEST_F(LeastRequestHeapTest, PicksAccountedBeforeRequestsStart) {
+  addEntries({1, 1, 2});
+  std::vector<uint32_t> picks(entries_.size());
+  for (uint32_t i = 0; i < 40; ++i) {
+    ++picks[heap_->pick()->id_];
+  }
+  EXPECT_EQ(10, picks[0]);
+  EXPECT_EQ(10, picks[1]);
+  EXPECT_EQ(20, picks[2]);
+}
+
+// The requests started by other pickers and the completed requests are observed in turn.
+TEST_F(LeastRequestHeapTest, ObservesOutstandingRequests) {
+  addEntries({1, 1, 1, 1}, 1);
+  // Load all the entries but the last one.
+  for (uint32_t i = 0; i < 3; ++i) {
+    entries_[i]->active_requests_ = 10;
+  }
+  // Every entry is observed within as many picks as there are entries, after which only the idle
+  // entry is picked.
+  for (uint32_t i = 0; i < entries_.size(); ++i) {
+    heap_->pick();
+  }
+  for (uint32_t i = 0; i < 4; ++i) {
+    EXPECT_EQ(3, heap_->pick()->id_);
+  }
+
+  // The requests of the first entry complete, and it is picked once observed.
+  entries_[0]->active_requests_ = 0;
+  bool picked = false;
+  for (uint32_t i = 0; i < entries_.size() && !picked; ++i) {
+    picked = heap_->pick()->id_ == 0;
+  }
+  EXPECT_TRUE(picked);
+}
+
+} // namespace
+} // namespace Upstream
+} // namespace Envoy
@@ -1,8 +1,10 @@
 // Usage: bazel run //test/common/upstream:load_balancer_benchmark
 
+#include <deque>
 #include <memory>
 
 #include "envoy/config/cluster/v3/cluster.pb.h"
+#include "envoy/extensions/load_balancing_policies/least_request/v3/least_request.pb.h"
 
 #include "source/common/common/random_generator.h"
 #include "source/common/memory/stats.h"
@@ -14,6 +16,7 @@
 #include "test/common/upstream/utility.h"
 #include "test/mocks/upstream/cluster_info.h"
 #include "test/test_common/simulated_time_system.h"
+#include "test/test_common/test_runtime.h"
 
 #include "absl/types/optional.h"
 #include "benchmark/benchmark.h"
@@ -107,6 +110,25 @@ public:
   std::unique_ptr<LeastRequestLoadBalancer> lb_;
 };
 
+class WeightedLeastRequestTester : public BaseTester {
+public:
+  // Half of the hosts are weighted 2.
+  WeightedLeastRequestTester(uint64_t num_hosts, bool least_outstanding_requests)
+      : BaseTester(num_hosts, 50, 2) {
+    envoy::extensions::load_balancing_policies::least_request::v3::LeastRequest lr_lb_config;
+    if (least_outstanding_requests) {
+      lr_lb_config.set_weighted_selection_method(
+          envoy::extensions::load_balancing_policies::least_request::v3::LeastRequest::
+              LEAST_OUTSTANDING_REQUESTS);
+    }
+    lb_ = std::make_unique<LeastRequestLoadBalancer>(priority_set_, &local_priority_set_, stats_,
+                                                     runtime_, random_, 50, lr_lb_config,
+                                                     simTime());
+  }
+
+  std::unique_ptr<LeastRequestLoadBalancer> lb_;
+};
+
 void benchmarkRoundRobinLoadBalancerBuild(::benchmark::State& state) {
   const uint64_t num_hosts = state.range(0);
   const uint64_t weighted_subset_percent = state.range(1);
@@ -154,6 +176,59 @@ BENCHMARK(benchmarkRoundRobinLoadBalancerBuild)
     ->Args({50000, 100, 50})
     ->Unit(::benchmark::kMillisecond);
 
+// Measures the cost of an update removing and then adding back delta_hosts hosts on a weighted
+// round robin load balancer, with the delta applied to the schedulers or with the schedulers
+// rebuilt.
+void benchmarkRoundRobinLoadBalancerHostDelta(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const uint64_t delta_hosts = state.range(1);
+  const bool delta_updates = state.range(2) != 0;
+
+  if (benchmark::skipExpensiveBenchmarks() && num_hosts > 10000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues({{"envoy.reloadable_features.edf_lb_host_delta_updates",
+                               delta_updates ? "true" : "false"}});
+  RoundRobinTester tester(num_hosts, 50, 50);
+  tester.initialize();
+
+  const HostVector& all_hosts = tester.priority_set_.hostSetsPerPriority()[0]->hosts();
+  const HostVector delta(all_hosts.end() - delta_hosts, all_hosts.end());
+  const auto make_params = [](const HostVector& hosts) {
+    auto hosts_ptr = std::make_shared<HostVector>(hosts);
+    return HostSetImpl::partitionHosts(hosts_ptr, makeHostsPerLocality({hosts}));
+  };
+  const PrioritySet::UpdateHostsParams all_params = make_params(all_hosts);
+  const PrioritySet::UpdateHostsParams remaining_params =
+      make_params(HostVector(all_hosts.begin(), all_hosts.end() - delta_hosts));
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    tester.priority_set_.updateHosts(0, PrioritySet::UpdateHostsParams(remaining_params), {}, {},
+                                     delta, absl::nullopt);
+    tester.priority_set_.updateHosts(0, PrioritySet::UpdateHostsParams(all_params), {}, delta, {},
+                                     absl::nullopt);
+  }
+}
+BENCHMARK(benchmarkRoundRobinLoadBalancerHostDelta)
+    ->Args({500, 1, 0})
+    ->Args({500, 1, 1})
+    ->Args({2500, 1, 0})
+    ->Args({2500, 1, 1})
+    ->Args({10000, 1, 0})
+    ->Args({10000, 1, 1})
+    ->Args({10000, 100, 0})
+    ->Args({10000, 100, 1})
+    ->Args({20000, 1, 0})
+    ->Args({20000, 1, 1})
+    ->Args({20000, 100, 0})
+    ->Args({20000, 100, 1})
+    ->Args({50000, 1, 0})
+    ->Args({50000, 1, 1})
+    ->Unit(::benchmark::kMicrosecond);
+
 class RingHashTester : public BaseTester {
 public:
   RingHashTester(uint64_t num_hosts, uint64_t min_ring_size) : BaseTester(num_hosts) {
@@ -315,6 +390,68 @@ BENCHMARK(benchmarkLeastRequestLoadBalancerChooseHost)
     ->Args({100, 100, 1000000})
     ->Unit(::benchmark::kMillisecond);
 
+// Compares the EDF scheduler (0) with the least outstanding requests heap (1) when the host weights
+// are not equal. Every pick starts a request on the picked host, and the requests complete in the
+// order they started, with 4 requests outstanding per host on average. The fairness is reported as
+// the relative standard deviation of the outstanding requests per unit of weight across the hosts.
+void benchmarkWeightedLeastRequestLoadBalancerChooseHost(::benchmark::State& state) {
+  const uint64_t num_hosts = state.range(0);
+  const bool least_outstanding_requests = state.range(1);
+  const uint64_t picks = state.range(2);
+
+  if (benchmark::skipExpensiveBenchmarks() && num_hosts > 1000) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    state.PauseTiming();
+    WeightedLeastRequestTester tester(num_hosts, least_outstanding_requests);
+    std::deque<HostConstSharedPtr> outstanding;
+    const uint64_t max_outstanding = num_hosts * 4;
+    state.ResumeTiming();
+
+    for (uint64_t i = 0; i < picks; ++i) {
+      HostConstSharedPtr host = tester.lb_->chooseHost(nullptr);
+      host->stats().rq_active_.inc();
+      outstanding.push_back(std::move(host));
+      if (outstanding.size() > max_outstanding) {
+        outstanding.front()->stats().rq_active_.dec();
+        outstanding.pop_front();
+      }
+    }
+
+    // Do not time computation of the fairness.
+    state.PauseTiming();
+    const HostVector& hosts = tester.priority_set_.hostSetsPerPriority()[0]->hosts();
+    double mean = 0;
+    for (const auto& host : hosts) {
+      mean += static_cast<double>(host->stats().rq_active_.value()) / host->weight();
+    }
+    mean /= hosts.size();
+    double variance = 0;
+    for (const auto& host : hosts) {
+      const double deviation =
+          static_cast<double>(host->stats().rq_active_.value()) / host->weight() - mean;
+      variance += deviation * deviation;
+    }
+    variance /= hosts.size();
+    state.counters["mean_load_per_weight"] = mean;
+    state.counters["relative_stddev_load_per_weight"] = std::sqrt(variance) / mean;
+    state.ResumeTiming();
+  }
+}
+BENCHMARK(benchmarkWeightedLeastRequestLoadBalancerChooseHost)
+    ->Args({100, 0, 100000})
+    ->Args({100, 1, 100000})
+    ->Args({1000, 0, 100000})
+    ->Args({1000, 1, 100000})
+    ->Args({10000, 0, 100000})
+    ->Args({10000, 1, 100000})
+    ->Args({50000, 0, 500000})
+    ->Args({50000, 1, 500000})
+    ->Unit(::benchmark::kMillisecond);
+
 void benchmarkRingHashLoadBalancerChooseHost(::benchmark::State& state) {
   for (auto _ : state) { // NOLINT: Silences warning about dead store
     // Do not time the creation of the ring.
@@ -1080,6 +1080,9 @@ TEST_P(RoundRobinLoadBalancerTest, DegradedLocality) {
 }
 
 TEST_P(RoundRobinLoadBalancerTest, Weighted) {
+  // The pick order below is the one of schedulers that are rebuilt on every update.
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues({{"envoy.reloadable_features.edf_lb_host_delta_updates", "false"}});
   hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime(), 1),
                               makeTestHost(info_, "tcp://127.0.0.1:81", simTime(), 2)};
   hostSet().hosts_ = hostSet().healthy_hosts_;
@@ -1156,6 +1159,61 @@ TEST_P(RoundRobinLoadBalancerTest, WeightedSeed) {
   EXPECT_EQ(hostSet().healthy_hosts_[1], lb_->chooseHost(nullptr));
 }
 
+// Validate that hosts added and removed by an update are applied to the weighted schedule.
+TEST_P(RoundRobinLoadBalancerTest, WeightedHostDelta) {
+  hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime(), 1),
+                              makeTestHost(info_, "tcp://127.0.0.1:81", simTime(), 2),
+                              makeTestHost(info_, "tcp://127.0.0.1:82", simTime(), 3)};
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  init(false);
+
+  const auto pick_counts = [this](uint32_t picks) {
+    absl::flat_hash_map<HostConstSharedPtr, uint32_t> counts;
+    for (uint32_t i = 0; i < picks; ++i) {
+      ++counts[lb_->chooseHost(nullptr)];
+    }
+    return counts;
+  };
+  auto counts = pick_counts(60);
+  EXPECT_EQ(10, counts[hostSet().hosts_[0]]);
+  EXPECT_EQ(20, counts[hostSet().hosts_[1]]);
+  EXPECT_EQ(30, counts[hostSet().hosts_[2]]);
+
+  // Add a host.
+  hostSet().healthy_hosts_.push_back(makeTestHost(info_, "tcp://127.0.0.1:83", simTime(), 4));
+  hostSet().hosts_.push_back(hostSet().healthy_hosts_.back());
+  hostSet().runCallbacks({hostSet().hosts_.back()}, {});
+  counts = pick_counts(100);
+  EXPECT_EQ(10, counts[hostSet().hosts_[0]]);
+  EXPECT_EQ(20, counts[hostSet().hosts_[1]]);
+  EXPECT_EQ(30, counts[hostSet().hosts_[2]]);
+  EXPECT_EQ(40, counts[hostSet().hosts_[3]]);
+
+  // Remove a host.
+  const HostSharedPtr removed_host = hostSet().hosts_[1];
+  hostSet().healthy_hosts_.erase(hostSet().healthy_hosts_.begin() + 1);
+  hostSet().hosts_.erase(hostSet().hosts_.begin() + 1);
+  hostSet().runCallbacks({}, {removed_host});
+  counts = pick_counts(80);
+  EXPECT_EQ(0, counts[removed_host]);
+  EXPECT_EQ(10, counts[hostSet().hosts_[0]]);
+  EXPECT_EQ(30, counts[hostSet().hosts_[1]]);
+  EXPECT_EQ(40, counts[hostSet().hosts_[2]]);
+
+  // A host becoming unhealthy in the same update as a host is added is not part of the delta, the
+  // healthy hosts schedule is then rebuilt.
+  const HostSharedPtr unhealthy_host = hostSet().healthy_hosts_[0];
+  hostSet().healthy_hosts_.erase(hostSet().healthy_hosts_.begin());
+  hostSet().healthy_hosts_.push_back(makeTestHost(info_, "tcp://127.0.0.1:84", simTime(), 1));
+  hostSet().hosts_.push_back(hostSet().healthy_hosts_.back());
+  hostSet().runCallbacks({hostSet().hosts_.back()}, {});
+  counts = pick_counts(80);
+  EXPECT_EQ(0, counts[unhealthy_host]);
+  EXPECT_EQ(30, counts[hostSet().healthy_hosts_[0]]);
+  EXPECT_EQ(40, counts[hostSet().healthy_hosts_[1]]);
+  EXPECT_EQ(10, counts[hostSet().healthy_hosts_[2]]);
+}
+
 TEST_P(RoundRobinLoadBalancerTest, MaxUnhealthyPanic) {
   hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime()),
                               makeTestHost(info_, "tcp://127.0.0.1:81", simTime())};
@@ -3004,6 +3062,43 @@ TEST_P(LeastRequestLoadBalancerTest, WeightImbalanceWithCustomActiveRequestBias)
   EXPECT_EQ(hostSet().healthy_hosts_[1], lb_2.chooseHost(nullptr));
 }
 
+// With the least outstanding requests selection, the active requests are spread across the hosts
+// in proportion to their weights.
+TEST_P(LeastRequestLoadBalancerTest, WeightImbalanceLeastOutstandingRequests) {
+  envoy::extensions::load_balancing_policies::least_request::v3::LeastRequest lr_lb_config;
+  lr_lb_config.set_weighted_selection_method(
+      envoy::extensions::load_balancing_policies::least_request::v3::LeastRequest::
+          LEAST_OUTSTANDING_REQUESTS);
+  LeastRequestLoadBalancer lb_2{priority_set_, nullptr, stats_,       runtime_,
+                                random_,       50,      lr_lb_config, simTime()};
+
+  hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime(), 1),
+                              makeTestHost(info_, "tcp://127.0.0.1:81", simTime(), 2),
+                              makeTestHost(info_, "tcp://127.0.0.1:82", simTime(), 3)};
+  hostSet().hosts_ = hostSet().healthy_hosts_;
+  hostSet().runCallbacks({}, {}); // Trigger callbacks. The added/removed lists are not relevant.
+
+  // The picks are not deterministic.
+  EXPECT_EQ(nullptr, lb_2.peekAnotherHost(nullptr));
+
+  // Start a request on every picked host.
+  for (uint32_t i = 0; i < 600; ++i) {
+    lb_2.chooseHost(nullptr)->stats().rq_active_.inc();
+  }
+  EXPECT_NEAR(100, hostSet().healthy_hosts_[0]->stats().rq_active_.value(), 1);
+  EXPECT_NEAR(200, hostSet().healthy_hosts_[1]->stats().rq_active_.value(), 1);
+  EXPECT_NEAR(300, hostSet().healthy_hosts_[2]->stats().rq_active_.value(), 1);
+
+  // The host whose requests complete is picked until it catches up with the others.
+  hostSet().healthy_hosts_[0]->stats().rq_active_.set(0);
+  for (uint32_t i = 0; i < 100; ++i) {
+    lb_2.chooseHost(nullptr)->stats().rq_active_.inc();
+  }
+  EXPECT_NEAR(100, hostSet().healthy_hosts_[0]->stats().rq_active_.value(), 1);
+  EXPECT_NEAR(200, hostSet().healthy_hosts_[1]->stats().rq_active_.value(), 1);
+  EXPECT_NEAR(300, hostSet().healthy_hosts_[2]->stats().rq_active_.value(), 1);
+}
+
 TEST_P(LeastRequestLoadBalancerTest, WeightImbalanceCallbacks) {
   hostSet().healthy_hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime(), 1),
                               makeTestHost(info_, "tcp://127.0.0.1:81", simTime(), 2)};
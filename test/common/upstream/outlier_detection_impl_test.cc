@@ -23,6 +23,7 @@
 #include "test/mocks/upstream/host.h"
 #include "test/mocks/upstream/host_set.h"
 #include "test/test_common/simulated_time_system.h"
+#include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
 
 #include "absl/types/optional.h"
@@ -1612,6 +1613,123 @@ TEST_F(OutlierDetectorImplTest, BasicFlowFailurePercentageLocalOrigin) {
                     DetectorHostMonitor::SuccessRateMonitorType::LocalOrigin));
 }
 
+// The hosts changing state during the same interval are passed to a single call of the changed
+// states callbacks, while the hosts ejected outside of the interval are passed right away.
+TEST_F(OutlierDetectorImplTest, ChangedStatesCoalescedPerInterval) {
+  ON_CALL(runtime_.snapshot_, getInteger(MaxEjectionPercentRuntime, _)).WillByDefault(Return(100));
+  EXPECT_CALL(cluster_.prioritySet(), addMemberUpdateCb(_));
+  addHosts({
+      "tcp://127.0.0.1:80",
+      "tcp://127.0.0.1:81",
+      "tcp://127.0.0.1:82",
+      "tcp://127.0.0.1:83",
+      "tcp://127.0.0.1:84",
+      "tcp://127.0.0.1:85",
+  });
+
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000), _));
+  std::shared_ptr<DetectorImpl> detector(DetectorImpl::create(
+      cluster_, empty_outlier_detection_, dispatcher_, runtime_, time_system_, nullptr, random_));
+  detector->addChangedStateCb([&](HostSharedPtr host) -> void { checker_.check(host); });
+  std::vector<HostVector> changed_states;
+  detector->addChangedStatesCb(
+      [&](const HostVector& hosts) -> void { changed_states.push_back(hosts); });
+
+  // A consecutive 5xx ejection is passed on right away.
+  time_system_.setMonotonicTime(std::chrono::milliseconds(0));
+  EXPECT_CALL(checker_, check(hosts_[0]));
+  loadRq(hosts_[0], 5, 503);
+  EXPECT_TRUE(hosts_[0]->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK));
+  ASSERT_EQ(1UL, changed_states.size());
+  EXPECT_EQ(HostVector{hosts_[0]}, changed_states[0]);
+  changed_states.clear();
+
+  // Eject two hosts by failure percentage in the same interval.
+  ON_CALL(runtime_.snapshot_, featureEnabled(EnforcingConsecutive5xxRuntime, 100))
+      .WillByDefault(Return(false));
+  ON_CALL(runtime_.snapshot_, featureEnabled(EnforcingConsecutiveGatewayFailureRuntime, 100))
+      .WillByDefault(Return(false));
+  ON_CALL(runtime_.snapshot_, featureEnabled(EnforcingSuccessRateRuntime, 100))
+      .WillByDefault(Return(false));
+  ON_CALL(runtime_.snapshot_, featureEnabled(EnforcingFailurePercentageRuntime, 0))
+      .WillByDefault(Return(true));
+  loadRq(hosts_, 50, 200);
+  loadRq(hosts_[4], 300, 503);
+  loadRq(hosts_[5], 300, 503);
+
+  time_system_.setMonotonicTime(std::chrono::milliseconds(10000));
+  EXPECT_CALL(checker_, check(hosts_[4]));
+  EXPECT_CALL(checker_, check(hosts_[5]));
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000), _));
+  interval_timer_->invokeCallback();
+  EXPECT_TRUE(hosts_[4]->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK));
+  EXPECT_TRUE(hosts_[5]->healthFlagGet(Host::HealthFlag::FAILED_OUTLIER_CHECK));
+  EXPECT_EQ(3UL, outlier_detection_ejections_active_.value());
+  ASSERT_EQ(1UL, changed_states.size());
+  EXPECT_THAT(changed_states[0], testing::UnorderedElementsAre(hosts_[4], hosts_[5]));
+  changed_states.clear();
+
+  // An interval without state changes does not call the changed states callbacks.
+  time_system_.setMonotonicTime(std::chrono::milliseconds(20000));
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000), _));
+  interval_timer_->invokeCallback();
+  EXPECT_TRUE(changed_states.empty());
+
+  // All the hosts are brought back in by the same interval.
+  time_system_.setMonotonicTime(std::chrono::milliseconds(40001));
+  EXPECT_CALL(checker_, check(hosts_[0]));
+  EXPECT_CALL(checker_, check(hosts_[4]));
+  EXPECT_CALL(checker_, check(hosts_[5]));
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000), _));
+  interval_timer_->invokeCallback();
+  EXPECT_EQ(0UL, outlier_detection_ejections_active_.value());
+  ASSERT_EQ(1UL, changed_states.size());
+  EXPECT_THAT(changed_states[0], testing::UnorderedElementsAre(hosts_[0], hosts_[4], hosts_[5]));
+}
+
+// With the runtime guard disabled, every state change is passed on separately.
+TEST_F(OutlierDetectorImplTest, ChangedStatesNotCoalescedWithRuntimeGuardDisabled) {
+  TestScopedRuntime scoped_runtime;
+  scoped_runtime.mergeValues(
+      {{"envoy.reloadable_features.outlier_detection_coalesce_updates", "false"}});
+  ON_CALL(runtime_.snapshot_, getInteger(MaxEjectionPercentRuntime, _)).WillByDefault(Return(100));
+  EXPECT_CALL(cluster_.prioritySet(), addMemberUpdateCb(_));
+  addHosts({
+      "tcp://127.0.0.1:80",
+      "tcp://127.0.0.1:81",
+      "tcp://127.0.0.1:82",
+      "tcp://127.0.0.1:83",
+      "tcp://127.0.0.1:84",
+  });
+
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000), _));
+  std::shared_ptr<DetectorImpl> detector(DetectorImpl::create(
+      cluster_, empty_outlier_detection_, dispatcher_, runtime_, time_system_, nullptr, random_));
+  std::vector<HostVector> changed_states;
+  detector->addChangedStatesCb(
+      [&](const HostVector& hosts) -> void { changed_states.push_back(hosts); });
+
+  ON_CALL(runtime_.snapshot_, featureEnabled(EnforcingConsecutive5xxRuntime, 100))
+      .WillByDefault(Return(false));
+  ON_CALL(runtime_.snapshot_, featureEnabled(EnforcingConsecutiveGatewayFailureRuntime, 100))
+      .WillByDefault(Return(false));
+  ON_CALL(runtime_.snapshot_, featureEnabled(EnforcingSuccessRateRuntime, 100))
+      .WillByDefault(Return(false));
+  ON_CALL(runtime_.snapshot_, featureEnabled(EnforcingFailurePercentageRuntime, 0))
+      .WillByDefault(Return(true));
+  loadRq(hosts_, 50, 200);
+  loadRq(hosts_[3], 300, 503);
+  loadRq(hosts_[4], 300, 503);
+
+  time_system_.setMonotonicTime(std::chrono::milliseconds(10000));
+  EXPECT_CALL(*interval_timer_, enableTimer(std::chrono::milliseconds(10000), _));
+  interval_timer_->invokeCallback();
+  EXPECT_EQ(2UL, outlier_detection_ejections_active_.value());
+  ASSERT_EQ(2UL, changed_states.size());
+  EXPECT_EQ(1UL, changed_states[0].size());
+  EXPECT_EQ(1UL, changed_states[1].size());
+}
+
 TEST_F(OutlierDetectorImplTest, RemoveWhileEjected) {
   ON_CALL(runtime_.snapshot_, getInteger(MaxEjectionPercentRuntime, _)).WillByDefault(Return(100));
   EXPECT_CALL(cluster_.prioritySet(), addMemberUpdateCb(_));
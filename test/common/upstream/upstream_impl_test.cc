@@ -50,6 +50,7 @@
 #include "test/mocks/upstream/typed_load_balancer_factory.h"
 #include "test/test_common/environment.h"
 #include "test/test_common/registry.h"
+#include "test/test_common/simulated_time_system.h"
 #include "test/test_common/utility.h"
 
 #include "gmock/gmock.h"
@@ -58,10 +59,13 @@
 using testing::_;
 using testing::AnyNumber;
 using testing::ContainerEq;
+using testing::DoAll;
+using testing::Eq;
 using testing::Invoke;
 using testing::NiceMock;
 using testing::Return;
 using testing::ReturnRef;
+using testing::SaveArg;
 
 namespace Envoy {
 namespace Upstream {
@@ -1270,6 +1274,140 @@ TEST_F(StrictDnsClusterImplTest, TtlAsDnsRefreshRate) {
                          TestUtility::makeDnsResponse({}, std::chrono::seconds(5)));
 }
 
+class StrictDnsClusterImplCacheTest : public Event::TestUsingSimulatedTime,
+                                      public StrictDnsClusterImplTest {
+protected:
+  StrictDnsClusterImplCacheTest() {
+    EXPECT_CALL(factory_, createEmptyConfigProto()).WillRepeatedly(Invoke([]() {
+      return std::make_unique<ProtobufWkt::Struct>();
+    }));
+    EXPECT_CALL(factory_, createStore(_, _, _, _)).WillOnce(Invoke([this]() {
+      auto store = std::make_unique<NiceMock<MockKeyValueStore>>();
+      store_ = store.get();
+      return store;
+    }));
+    simTime().setSystemTime(SystemTime(std::chrono::seconds(1000)));
+  }
+
+  std::unique_ptr<StrictDnsClusterImpl> createCluster() {
+    const std::string yaml = R"EOF(
+    name: name
+    connect_timeout: 0.25s
+    type: STRICT_DNS
+    lb_policy: ROUND_ROBIN
+    dns_refresh_rate: 60s
+    dns_cache_config:
+      config:
+        name: mock_key_value_store_factory
+        typed_config:
+          "@type": type.googleapis.com/google.protobuf.Struct
+    load_assignment:
+        endpoints:
+          - lb_endpoints:
+            - endpoint:
+                address:
+                  socket_address:
+                    address: foo.com
+                    port_value: 443
+  )EOF";
+    envoy::config::cluster::v3::Cluster cluster_config = parseClusterFromV3Yaml(yaml);
+    Envoy::Upstream::ClusterFactoryContextImpl factory_context(
+        server_context_, server_context_.cluster_manager_, nullptr, ssl_context_manager_, nullptr,
+        false);
+    auto cluster =
+        std::make_unique<StrictDnsClusterImpl>(cluster_config, factory_context, dns_resolver_);
+    EXPECT_NE(nullptr, store_);
+    return cluster;
+  }
+
+  MockKeyValueStoreFactory factory_;
+  Registry::InjectFactory<KeyValueStoreFactory> injector_{factory_};
+  MockKeyValueStore* store_{};
+};
+
+// A recent cached resolution is used as is, and the name is resolved again once it is due.
+TEST_F(StrictDnsClusterImplCacheTest, LoadCachedResolution) {
+  Event::MockTimer* timer = new Event::MockTimer(&server_context_.dispatcher_);
+  auto cluster = createCluster();
+  EXPECT_CALL(*store_, get(Eq("foo.com")))
+      .WillOnce(Return(absl::optional<absl::string_view>("127.0.0.1|30|990\n127.0.0.2|30|990")));
+
+  // The cluster is initialized without resolving the name.
+  ReadyWatcher initialized;
+  EXPECT_CALL(initialized, ready());
+  EXPECT_CALL(*dns_resolver_, resolve(_, _, _)).Times(0);
+  EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(50000), _));
+  cluster->initialize([&]() -> void { initialized.ready(); });
+  EXPECT_THAT(std::list<std::string>({"127.0.0.1:443", "127.0.0.2:443"}),
+              ContainerEq(hostListToAddresses(
+                  cluster->prioritySet().hostSetsPerPriority()[0]->hosts())));
+  EXPECT_EQ(1UL, stats_.counter("cluster.name.dns_cache_load").value());
+  testing::Mock::VerifyAndClearExpectations(dns_resolver_.get());
+
+  // The next resolution updates the hosts and the cache.
+  Network::DnsResolver::ResolveCb dns_callback;
+  Network::MockActiveDnsQuery active_dns_query;
+  EXPECT_CALL(*dns_resolver_, resolve("foo.com", _, _))
+      .WillOnce(DoAll(SaveArg<2>(&dns_callback), Return(&active_dns_query)));
+  timer->invokeCallback();
+  simTime().setSystemTime(SystemTime(std::chrono::seconds(1050)));
+  EXPECT_CALL(*store_, addOrUpdate(Eq("foo.com"), Eq("127.0.0.3|5|1050"), Eq(absl::nullopt)));
+  EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(60000), _));
+  dns_callback(Network::DnsResolver::ResolutionStatus::Success,
+               TestUtility::makeDnsResponse({"127.0.0.3"}, std::chrono::seconds(5)));
+  EXPECT_THAT(std::list<std::string>({"127.0.0.3:443"}),
+              ContainerEq(hostListToAddresses(
+                  cluster->prioritySet().hostSetsPerPriority()[0]->hosts())));
+
+  // An empty resolution removes the cached resolution.
+  EXPECT_CALL(*dns_resolver_, resolve("foo.com", _, _))
+      .WillOnce(DoAll(SaveArg<2>(&dns_callback), Return(&active_dns_query)));
+  timer->invokeCallback();
+  EXPECT_CALL(*store_, remove(Eq("foo.com")));
+  EXPECT_CALL(*timer, enableTimer(std::chrono::milliseconds(60000), _));
+  dns_callback(Network::DnsResolver::ResolutionStatus::Success, {});
+  EXPECT_EQ(0UL, cluster->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+}
+
+// A stale cached resolution is used until the name is resolved again, which starts right away.
+TEST_F(StrictDnsClusterImplCacheTest, LoadStaleCachedResolution) {
+  ResolverData resolver(*dns_resolver_, server_context_.dispatcher_);
+  auto cluster = createCluster();
+  EXPECT_CALL(*store_, get(Eq("foo.com")))
+      .WillOnce(Return(absl::optional<absl::string_view>("127.0.0.1|30|900")));
+
+  ReadyWatcher initialized;
+  EXPECT_CALL(initialized, ready());
+  cluster->initialize([&]() -> void { initialized.ready(); });
+  EXPECT_EQ(1UL, cluster->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+  EXPECT_EQ(1UL, stats_.counter("cluster.name.dns_cache_load_stale").value());
+
+  // The stale hosts are kept when the resolution fails.
+  EXPECT_CALL(*resolver.timer_, enableTimer(_, _));
+  resolver.dns_callback_(Network::DnsResolver::ResolutionStatus::Failure, {});
+  EXPECT_EQ(1UL, cluster->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+}
+
+// A cached resolution which cannot be parsed is ignored.
+TEST_F(StrictDnsClusterImplCacheTest, LoadMalformedCachedResolution) {
+  ResolverData resolver(*dns_resolver_, server_context_.dispatcher_);
+  auto cluster = createCluster();
+  EXPECT_CALL(*store_, get(Eq("foo.com")))
+      .WillOnce(Return(absl::optional<absl::string_view>("127.0.0.1|30")));
+
+  ReadyWatcher initialized;
+  cluster->initialize([&]() -> void { initialized.ready(); });
+  EXPECT_EQ(0UL, cluster->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+  EXPECT_EQ(1UL, stats_.counter("cluster.name.dns_cache_load_failure").value());
+
+  EXPECT_CALL(initialized, ready());
+  EXPECT_CALL(*store_, addOrUpdate(Eq("foo.com"), Eq("127.0.0.1|6|1000"), Eq(absl::nullopt)));
+  EXPECT_CALL(*resolver.timer_, enableTimer(std::chrono::milliseconds(60000), _));
+  resolver.dns_callback_(Network::DnsResolver::ResolutionStatus::Success,
+                         TestUtility::makeDnsResponse({"127.0.0.1"}));
+  EXPECT_EQ(1UL, cluster->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+}
+
 // Ensures that HTTP/2 user defined SETTINGS parameter validation is enforced on clusters.
 TEST_F(StrictDnsClusterImplTest, Http2UserDefinedSettingsParametersValidation) {
   const std::string yaml = R"EOF(
@@ -1382,6 +1520,52 @@ TEST_F(HostImplTest, HostnameCanaryAndLocality) {
   EXPECT_EQ(1, host.priority());
 }
 
+// The stats of a host are allocated on first use, and read as zero before.
+TEST_F(HostImplTest, StatsAllocatedOnFirstUse) {
+  MockClusterMockPrioritySet cluster;
+  HostSharedPtr host = makeTestHost(cluster.info_, "tcp://10.0.0.1:1234", simTime());
+  for (const auto& [name, counter] : host->counters()) {
+    EXPECT_EQ(0, counter.get().value()) << name;
+  }
+  for (const auto& [name, gauge] : host->gauges()) {
+    EXPECT_EQ(0, gauge.get().value()) << name;
+  }
+
+  host->stats().rq_total_.inc();
+  host->stats().rq_active_.inc();
+  EXPECT_EQ(1, host->stats().rq_total_.value());
+  for (const auto& [name, counter] : host->counters()) {
+    EXPECT_EQ(name == "rq_total" ? 1 : 0, counter.get().value()) << name;
+  }
+  for (const auto& [name, gauge] : host->gauges()) {
+    EXPECT_EQ(name == "rq_active" ? 1 : 0, gauge.get().value()) << name;
+  }
+}
+
+TEST_F(HostImplTest, HealthCheckOverrides) {
+  MockClusterMockPrioritySet cluster;
+  HostSharedPtr host = makeTestHost(cluster.info_, "tcp://10.0.0.1:1234", simTime());
+  EXPECT_EQ("", host->hostnameForHealthChecks());
+  EXPECT_EQ(host->address(), host->healthCheckAddress());
+
+  envoy::config::endpoint::v3::Endpoint::HealthCheckConfig health_check_config;
+  health_check_config.set_hostname("foo.com");
+  health_check_config.set_port_value(8000);
+  host = makeTestHost(cluster.info_, "tcp://10.0.0.1:1234", health_check_config, simTime());
+  EXPECT_EQ("foo.com", host->hostnameForHealthChecks());
+  EXPECT_EQ("10.0.0.1:8000", host->healthCheckAddress()->asString());
+  EXPECT_EQ("10.0.0.1:1234", host->address()->asString());
+}
+
+// Hosts without a locality do not allocate one.
+TEST_F(HostImplTest, EmptyLocalityShared) {
+  MockClusterMockPrioritySet cluster;
+  HostSharedPtr host1 = makeTestHost(cluster.info_, "tcp://10.0.0.1:1234", simTime());
+  HostSharedPtr host2 = makeTestHost(cluster.info_, "tcp://10.0.0.2:1234", simTime());
+  EXPECT_EQ(&envoy::config::core::v3::Locality::default_instance(), &host1->locality());
+  EXPECT_EQ(&host1->locality(), &host2->locality());
+}
+
 TEST_F(HostImplTest, CreateConnection) {
   MockClusterMockPrioritySet cluster;
   envoy::config::core::v3::Metadata metadata;
@@ -1885,6 +2069,8 @@ TEST_F(StaticClusterImplTest, LoadAssignmentLocality) {
     EXPECT_EQ("hello", locality.zone());
     EXPECT_EQ("world", locality.sub_zone());
   }
+  // The hosts of a locality share it.
+  EXPECT_EQ(&hosts[0]->locality(), &hosts[1]->locality());
   EXPECT_NE(nullptr, cluster->prioritySet().hostSetsPerPriority()[0]->localityWeights());
   EXPECT_FALSE(cluster->info()->addedViaApi());
 }
@@ -2111,7 +2297,7 @@ TEST_F(StaticClusterImplTest, OutlierDetector) {
   std::shared_ptr<StaticClusterImpl> cluster = createCluster(cluster_config, factory_context);
 
   Outlier::MockDetector* detector = new Outlier::MockDetector();
-  EXPECT_CALL(*detector, addChangedStateCb(_));
+  EXPECT_CALL(*detector, addChangedStatesCb(_));
   cluster->setOutlierDetector(Outlier::DetectorSharedPtr{detector});
   cluster->initialize([] {});
 
@@ -2139,6 +2325,20 @@ TEST_F(StaticClusterImplTest, OutlierDetector) {
   detector->runCallbacks(cluster->prioritySet().hostSetsPerPriority()[0]->hosts()[0]);
   EXPECT_EQ(2UL, cluster->prioritySet().hostSetsPerPriority()[0]->healthyHosts().size());
   EXPECT_EQ(2UL, cluster->info()->endpointStats().membership_healthy_.value());
+
+  // Hosts changing state together are reloaded by a single update.
+  const HostVector hosts = cluster->prioritySet().hostSetsPerPriority()[0]->hosts();
+  for (const HostSharedPtr& host : hosts) {
+    host->healthFlagSet(Host::HealthFlag::FAILED_OUTLIER_CHECK);
+  }
+  uint32_t updates = 0;
+  auto priority_update_cb = cluster->prioritySet().addPriorityUpdateCb(
+      [&updates](uint32_t, const HostVector&, const HostVector&) -> void { ++updates; });
+  ASSERT_EQ(1UL, detector->states_callbacks_.size());
+  detector->states_callbacks_.front()(hosts);
+  EXPECT_EQ(1UL, updates);
+  EXPECT_EQ(0UL, cluster->prioritySet().hostSetsPerPriority()[0]->healthyHosts().size());
+  EXPECT_EQ(0UL, cluster->info()->endpointStats().membership_healthy_.value());
 }
 
 TEST_F(StaticClusterImplTest, HealthyStat) {
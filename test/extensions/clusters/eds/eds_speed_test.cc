@@ -163,6 +163,54 @@ public:
            num_hosts);
   }
 
+  // Set up an EDS config with the hosts spread across 10 localities, the first changed_hosts of
+  // which move to another port on every update, so that the other hosts stay unchanged.
+  void smallDeltaUpdateHelper(size_t num_hosts, size_t changed_hosts, bool timed) {
+    state_.PauseTiming();
+
+    envoy::config::endpoint::v3::ClusterLoadAssignment cluster_load_assignment;
+    cluster_load_assignment.set_cluster_name("fare");
+    const size_t num_localities = 10;
+    for (size_t i = 0; i < num_localities; ++i) {
+      auto* endpoints = cluster_load_assignment.add_endpoints();
+      auto* locality = endpoints->mutable_locality();
+      locality->set_region("region");
+      locality->set_zone(fmt::format("zone-{}", i));
+      endpoints->mutable_load_balancing_weight()->set_value(1);
+    }
+    for (size_t i = 0; i < num_hosts; ++i) {
+      auto* lb_endpoint =
+          cluster_load_assignment.mutable_endpoints(i % num_localities)->add_lb_endpoints();
+      lb_endpoint->set_health_status(envoy::config::core::v3::HEALTHY);
+      auto* socket_address =
+          lb_endpoint->mutable_endpoint()->mutable_address()->mutable_socket_address();
+      socket_address->set_address(fmt::format("10.{}.{}.{}", i / 65536, (i / 256) % 256, i % 256));
+      socket_address->set_port_value(i < changed_hosts ? 1000 + version_ % 2 : 1000);
+    }
+
+    auto response = std::make_unique<envoy::service::discovery::v3::DiscoveryResponse>();
+    response->set_type_url(type_url_);
+    response->set_version_info(fmt::format("version-{}", version_++));
+    auto* resource = response->mutable_resources()->Add();
+    resource->PackFrom(cluster_load_assignment);
+    if (timed) {
+      state_.ResumeTiming();
+    }
+    if (use_unified_mux_) {
+      dynamic_cast<Config::XdsMux::GrpcMuxSotw&>(*grpc_mux_)
+          .grpcStreamForTest()
+          .onReceiveMessage(std::move(response));
+    } else {
+      dynamic_cast<Config::GrpcMuxImpl&>(*grpc_mux_)
+          .grpcStreamForTest()
+          .onReceiveMessage(std::move(response));
+    }
+    if (!timed) {
+      state_.ResumeTiming();
+    }
+    ASSERT(cluster_->prioritySet().hostSetsPerPriority()[0]->hosts().size() == num_hosts);
+  }
+
   NiceMock<Server::Configuration::MockServerFactoryContext> server_context_;
   Stats::TestUtil::TestStore& stats_ = server_context_.store_;
 
@@ -241,3 +289,26 @@ static void healthOnlyUpdate(State& state) {
 }
 
 BENCHMARK(healthOnlyUpdate)->Ranges({{1, 100000}, {false, true}})->Unit(benchmark::kMillisecond);
+
+// Measures an update which changes a few hosts of a large cluster, with or without reusing the
+// hosts of the unchanged localities and endpoints.
+static void smallDeltaUpdate(State& state) {
+  Envoy::Thread::MutexBasicLockable lock;
+  Envoy::Logger::Context logging_state(spdlog::level::warn,
+                                       Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock, false);
+  Envoy::TestScopedRuntime runtime;
+  runtime.mergeValues({{"envoy.reloadable_features.eds_reuse_unchanged_hosts",
+                        state.range(2) ? "true" : "false"}});
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    Envoy::Upstream::EdsSpeedTest speed_test(state, false);
+    uint32_t endpoints = skipExpensiveBenchmarks() ? 10 : state.range(0);
+    uint32_t changed_endpoints = std::min<uint32_t>(endpoints, state.range(1));
+
+    speed_test.smallDeltaUpdateHelper(endpoints, changed_endpoints, false);
+    speed_test.smallDeltaUpdateHelper(endpoints, changed_endpoints, true);
+  }
+}
+
+BENCHMARK(smallDeltaUpdate)
+    ->ArgsProduct({{10000, 100000}, {1, 100}, {false, true}})
+    ->Unit(benchmark::kMillisecond);
@@ -23,6 +23,7 @@
 #include "test/mocks/ssl/mocks.h"
 #include "test/mocks/upstream/cluster_manager.h"
 #include "test/mocks/upstream/health_checker.h"
+#include "test/mocks/upstream/host.h"
 #include "test/test_common/simulated_time_system.h"
 #include "test/test_common/test_runtime.h"
 #include "test/test_common/utility.h"
@@ -871,6 +872,76 @@ TEST_F(EdsTest, EndpointRemovalAfterHcFail) {
   }
 }
 
+// Verify that all the hosts pending removal and failing active HC are removed when the outlier
+// detector reports them in a single batch.
+TEST_F(EdsTest, EndpointRemovalAfterHcFailOutlierBatch) {
+  envoy::config::endpoint::v3::ClusterLoadAssignment cluster_load_assignment;
+  cluster_load_assignment.set_cluster_name("fare");
+
+  auto health_checker = std::make_shared<MockHealthChecker>();
+  EXPECT_CALL(*health_checker, start());
+  EXPECT_CALL(*health_checker, addHostCheckCompleteCb(_)).Times(2);
+  cluster_->setHealthChecker(health_checker);
+  Outlier::MockDetector* detector = new Outlier::MockDetector();
+  EXPECT_CALL(*detector, addChangedStatesCb(_));
+  cluster_->setOutlierDetector(Outlier::DetectorSharedPtr{detector});
+
+  auto add_endpoint = [&cluster_load_assignment](int port) {
+    auto* endpoints = cluster_load_assignment.add_endpoints();
+
+    auto* socket_address = endpoints->add_lb_endpoints()
+                               ->mutable_endpoint()
+                               ->mutable_address()
+                               ->mutable_socket_address();
+    socket_address->set_address("1.2.3.4");
+    socket_address->set_port_value(port);
+  };
+
+  add_endpoint(80);
+  add_endpoint(81);
+  add_endpoint(82);
+  doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+
+  {
+    auto& hosts = cluster_->prioritySet().hostSetsPerPriority()[0]->hosts();
+    EXPECT_EQ(hosts.size(), 3);
+    for (const HostSharedPtr& host : hosts) {
+      host->healthFlagClear(Host::HealthFlag::PENDING_ACTIVE_HC);
+      host->healthFlagClear(Host::HealthFlag::FAILED_ACTIVE_HC);
+    }
+  }
+
+  // Remove the port 81 and 82 endpoints. They stay present due to being stabilized, but are
+  // marked pending removal.
+  cluster_load_assignment.clear_endpoints();
+  add_endpoint(80);
+  doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+
+  HostSharedPtr not_removed_host;
+  {
+    auto& hosts = cluster_->prioritySet().hostSetsPerPriority()[0]->hosts();
+    EXPECT_EQ(hosts.size(), 3);
+    EXPECT_FALSE(hosts[0]->healthFlagGet(Host::HealthFlag::PENDING_DYNAMIC_REMOVAL));
+    EXPECT_TRUE(hosts[1]->healthFlagGet(Host::HealthFlag::PENDING_DYNAMIC_REMOVAL));
+    EXPECT_TRUE(hosts[2]->healthFlagGet(Host::HealthFlag::PENDING_DYNAMIC_REMOVAL));
+
+    // Both hosts fail active HC, and are then ejected by the same outlier detection interval.
+    not_removed_host = hosts[0];
+    const HostVector ejected_hosts{hosts[1], hosts[2]};
+    for (const HostSharedPtr& host : ejected_hosts) {
+      host->healthFlagSet(Host::HealthFlag::FAILED_ACTIVE_HC);
+      host->healthFlagSet(Host::HealthFlag::FAILED_OUTLIER_CHECK);
+    }
+    ASSERT_EQ(1UL, detector->states_callbacks_.size());
+    detector->states_callbacks_.front()(ejected_hosts);
+  }
+
+  EXPECT_EQ(1,
+            cluster_->prioritySet().hostSetsPerPriority()[0]->hostsPerLocality().get()[0].size());
+  ASSERT_EQ(1, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+  EXPECT_EQ(not_removed_host, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts()[0]);
+}
+
 // Verify that a host is removed when it is still passing active HC, but has been previously
 // told by the EDS server to fail health check.
 TEST_F(EdsTest, EndpointRemovalEdsFailButActiveHcSuccess) {
@@ -1928,6 +1999,101 @@ TEST_F(EdsTest, EndpointLocalityUpdated) {
   }
 }
 
+// Validate that the hosts of the localities and the endpoints an update does not change are kept,
+// with or without reusing the hosts of the previous update.
+TEST_F(EdsTest, EndpointUnchangedHostsKept) {
+  for (const std::string reuse_hosts : {"true", "false"}) {
+    TestScopedRuntime runtime;
+    runtime.mergeValues({{"envoy.reloadable_features.eds_reuse_unchanged_hosts", reuse_hosts}});
+    resetCluster();
+
+    envoy::config::endpoint::v3::ClusterLoadAssignment cluster_load_assignment;
+    cluster_load_assignment.set_cluster_name("fare");
+    for (const std::string zone : {"hello", "world"}) {
+      auto* endpoints = cluster_load_assignment.add_endpoints();
+      endpoints->mutable_locality()->set_zone(zone);
+      for (uint32_t port = 80; port < 83; ++port) {
+        auto* socket_address = endpoints->add_lb_endpoints()
+                                   ->mutable_endpoint()
+                                   ->mutable_address()
+                                   ->mutable_socket_address();
+        socket_address->set_address(zone == "hello" ? "1.2.3.4" : "2.3.4.5");
+        socket_address->set_port_value(port);
+      }
+    }
+
+    initialize();
+    doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+    EXPECT_TRUE(initialized_);
+    const HostVector hosts = cluster_->prioritySet().hostSetsPerPriority()[0]->hosts();
+    EXPECT_EQ(6, hosts.size());
+
+    // An unchanged update keeps all the hosts and does not rebuild the cluster.
+    const Stats::Counter& update_no_rebuild =
+        stats_.findCounterByString("cluster.name.update_no_rebuild").value().get();
+    const uint64_t no_rebuilds = update_no_rebuild.value();
+    doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+    EXPECT_EQ(no_rebuilds + 1, update_no_rebuild.value());
+    EXPECT_EQ(hosts, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts());
+
+    // A weight change updates the existing host in place.
+    cluster_load_assignment.mutable_endpoints(0)
+        ->mutable_lb_endpoints(1)
+        ->mutable_load_balancing_weight()
+        ->set_value(5);
+    doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+    EXPECT_EQ(hosts, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts());
+    EXPECT_EQ(5, hosts[1]->weight());
+
+    // Then an update of the other locality keeps the hosts of the endpoints it does not change.
+    auto* socket_address = cluster_load_assignment.mutable_endpoints(1)
+                               ->mutable_lb_endpoints(2)
+                               ->mutable_endpoint()
+                               ->mutable_address()
+                               ->mutable_socket_address();
+    socket_address->set_port_value(90);
+    doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+    const auto& updated_hosts = cluster_->prioritySet().hostSetsPerPriority()[0]->hosts();
+    EXPECT_EQ(6, updated_hosts.size());
+    for (uint32_t i = 0; i < 5; ++i) {
+      EXPECT_EQ(hosts[i], updated_hosts[i]);
+    }
+    EXPECT_EQ("2.3.4.5:90", updated_hosts[5]->address()->asString());
+    EXPECT_EQ(5, updated_hosts[1]->weight());
+
+    // Reverting the weight change restores the weight of the host.
+    cluster_load_assignment.mutable_endpoints(0)
+        ->mutable_lb_endpoints(1)
+        ->clear_load_balancing_weight();
+    doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+    EXPECT_EQ(1, hosts[1]->weight());
+    EXPECT_EQ(6, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+  }
+}
+
+// Validate that a locality listed twice in an update only adds its hosts once, also when the
+// hosts of the previous update are reused.
+TEST_F(EdsTest, EndpointDuplicateLocalityReused) {
+  envoy::config::endpoint::v3::ClusterLoadAssignment cluster_load_assignment;
+  cluster_load_assignment.set_cluster_name("fare");
+  for (uint32_t i = 0; i < 2; ++i) {
+    auto* endpoints = cluster_load_assignment.add_endpoints();
+    endpoints->mutable_locality()->set_zone("hello");
+    auto* socket_address = endpoints->add_lb_endpoints()
+                               ->mutable_endpoint()
+                               ->mutable_address()
+                               ->mutable_socket_address();
+    socket_address->set_address("1.2.3.4");
+    socket_address->set_port_value(80);
+  }
+
+  initialize();
+  for (uint32_t i = 0; i < 3; ++i) {
+    doOnConfigUpdateVerifyNoThrow(cluster_load_assignment);
+    EXPECT_EQ(1, cluster_->prioritySet().hostSetsPerPriority()[0]->hosts().size());
+  }
+}
+
 // Validate that onConfigUpdate() does not propagate locality weights to the host set when
 // locality weighted balancing isn't configured and the cluster does not use LB policy extensions.
 TEST_F(EdsTest, EndpointLocalityWeightsIgnored) {
@@ -22,6 +22,7 @@
 
 using testing::AtLeast;
 using testing::DoAll;
+using testing::ElementsAre;
 using testing::InSequence;
 using testing::Return;
 using testing::SaveArg;
@@ -1538,6 +1539,51 @@ TEST_F(DnsCacheImplTest, CacheLoad) {
   }
 }
 
+// A resolution loaded from the cache is refreshed once its TTL expires.
+TEST_F(DnsCacheImplTest, CacheLoadRefreshAtTtl) {
+  auto* time_source = new NiceMock<MockTimeSystem>();
+  context_.dispatcher_.time_system_.reset(time_source);
+  ON_CALL(*time_source, monotonicTime())
+      .WillByDefault(Return(MonotonicTime(std::chrono::seconds(100))));
+
+  MockKeyValueStoreFactory factory;
+  EXPECT_CALL(factory, createEmptyConfigProto()).WillRepeatedly(Invoke([]() {
+    return std::make_unique<
+        envoy::extensions::key_value::file_based::v3::FileBasedKeyValueStoreConfig>();
+  }));
+  EXPECT_CALL(factory, createStore(_, _, _, _)).WillOnce(Invoke([]() {
+    auto store = std::make_unique<NiceMock<MockKeyValueStore>>();
+    EXPECT_CALL(*store, iterate).WillOnce(Invoke([&](KeyValueStore::ConstIterateCb fn) {
+      fn("foo.com:80", "10.0.0.2:80|40|90");
+      fn("bar.com:80", "10.0.0.3:80|40|50");
+    }));
+    return store;
+  }));
+  Registry::InjectFactory<KeyValueStoreFactory> injector(factory);
+  auto* key_value_config = config_.mutable_key_value_config()->mutable_config();
+  key_value_config->set_name("mock_key_value_store_factory");
+  key_value_config->mutable_typed_config()->PackFrom(
+      envoy::extensions::key_value::file_based::v3::FileBasedKeyValueStoreConfig());
+
+  // Only the refresh timers of the loaded hosts are enabled.
+  std::vector<std::chrono::milliseconds> refresh_rates;
+  EXPECT_CALL(context_.dispatcher_, createTimer_(_))
+      .WillRepeatedly(Invoke([&refresh_rates](Event::TimerCb) {
+        auto* timer = new NiceMock<Event::MockTimer>();
+        ON_CALL(*timer, enableTimer(_, _))
+            .WillByDefault(Invoke([&refresh_rates](const std::chrono::milliseconds& ms,
+                                                   const ScopeTrackedObject*) {
+              refresh_rates.push_back(ms);
+            }));
+        return timer;
+      }));
+  initialize();
+  EXPECT_EQ(2, TestUtility::findCounter(context_.store_, "dns_cache.foo.cache_load")->value());
+  // The resolution of foo.com is 10s old and the one of bar.com has expired.
+  EXPECT_THAT(refresh_rates, ElementsAre(std::chrono::milliseconds(30000),
+                                         std::chrono::milliseconds(0)));
+}
+
 // Make sure the cache manager can handle the context going out of scope.
 TEST(DnsCacheManagerImplTest, TestLifetime) {
   NiceMock<Server::Configuration::MockFactoryContext> context;
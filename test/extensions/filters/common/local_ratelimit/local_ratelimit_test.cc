@@ -208,6 +208,45 @@ TEST_F(LocalRateLimiterImplTest, TokenBucketStatus) {
   EXPECT_EQ(rate_limiter_->remainingFillInterval(route_descriptors_), 3);
 }
 
+// Verify that the tokens are refilled from the elapsed time when lazy refill is enabled, without a
+// fill timer.
+TEST_F(LocalRateLimiterImplTest, LazyRefill) {
+  EXPECT_CALL(dispatcher_, createTimer_(_)).Times(0);
+  rate_limiter_ = std::make_shared<LocalRateLimiterImpl>(std::chrono::milliseconds(200), 2, 1,
+                                                         dispatcher_, descriptors_, true, true);
+
+  // 2 -> 0 tokens
+  EXPECT_TRUE(rate_limiter_->requestAllowed(route_descriptors_));
+  EXPECT_TRUE(rate_limiter_->requestAllowed(route_descriptors_));
+  EXPECT_FALSE(rate_limiter_->requestAllowed(route_descriptors_));
+
+  // No fill interval elapsed yet.
+  dispatcher_.globalTimeSystem().advanceTimeAndRun(std::chrono::milliseconds(199), dispatcher_,
+                                                   Envoy::Event::Dispatcher::RunType::NonBlock);
+  EXPECT_FALSE(rate_limiter_->requestAllowed(route_descriptors_));
+
+  // 0 -> 1 -> 0 tokens
+  dispatcher_.globalTimeSystem().advanceTimeAndRun(std::chrono::milliseconds(1), dispatcher_,
+                                                   Envoy::Event::Dispatcher::RunType::NonBlock);
+  EXPECT_TRUE(rate_limiter_->requestAllowed(route_descriptors_));
+  EXPECT_FALSE(rate_limiter_->requestAllowed(route_descriptors_));
+
+  // The next fill happens 200ms after the previous one, not after the last request.
+  dispatcher_.globalTimeSystem().advanceTimeAndRun(std::chrono::milliseconds(300), dispatcher_,
+                                                   Envoy::Event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(rate_limiter_->remainingTokens(route_descriptors_), 1);
+  dispatcher_.globalTimeSystem().advanceTimeAndRun(std::chrono::milliseconds(100), dispatcher_,
+                                                   Envoy::Event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(rate_limiter_->remainingTokens(route_descriptors_), 2);
+
+  // Several fills are capped to the max tokens.
+  dispatcher_.globalTimeSystem().advanceTimeAndRun(std::chrono::milliseconds(1000), dispatcher_,
+                                                   Envoy::Event::Dispatcher::RunType::NonBlock);
+  EXPECT_TRUE(rate_limiter_->requestAllowed(route_descriptors_));
+  EXPECT_TRUE(rate_limiter_->requestAllowed(route_descriptors_));
+  EXPECT_FALSE(rate_limiter_->requestAllowed(route_descriptors_));
+}
+
 class LocalRateLimiterDescriptorImplTest : public LocalRateLimiterImplTest {
 public:
   void initializeWithDescriptor(const std::chrono::milliseconds fill_interval,
@@ -463,6 +502,47 @@ TEST_F(LocalRateLimiterDescriptorImplTest,
   EXPECT_TRUE(rate_limiter_->requestAllowed(descriptor_));
 }
 
+// Verify that a descriptor matched by several request descriptors consumes a single token.
+TEST_F(LocalRateLimiterDescriptorImplTest, DescriptorMatchedTwice) {
+  TestUtility::loadFromYaml(fmt::format(fmt::runtime(single_descriptor_config_yaml), 2, 2, "1s"),
+                            *descriptors_.Add());
+  initializeWithDescriptor(std::chrono::milliseconds(50), 10, 10);
+  std::vector<RateLimit::LocalDescriptor> descriptors{{{{"foo2", "bar2"}}}, {{{"foo2", "bar2"}}}};
+
+  EXPECT_TRUE(rate_limiter_->requestAllowed(descriptors));
+  EXPECT_EQ(rate_limiter_->remainingTokens(descriptor_), 1);
+}
+
+// Verify descriptor token buckets with lazy refill.
+TEST_F(LocalRateLimiterDescriptorImplTest, LazyRefillDescriptor) {
+  TestUtility::loadFromYaml(multiple_descriptor_config_yaml, *descriptors_.Add());
+  TestUtility::loadFromYaml(fmt::format(fmt::runtime(single_descriptor_config_yaml), 1, 1, "1s"),
+                            *descriptors_.Add());
+  EXPECT_CALL(dispatcher_, createTimer_(_)).Times(0);
+  rate_limiter_ = std::make_shared<LocalRateLimiterImpl>(std::chrono::milliseconds(50), 10, 1,
+                                                         dispatcher_, descriptors_, true, true);
+
+  // 1 -> 0 tokens for descriptor_ and descriptor2_
+  EXPECT_TRUE(rate_limiter_->requestAllowed(descriptor2_));
+  EXPECT_FALSE(rate_limiter_->requestAllowed(descriptor2_));
+  EXPECT_TRUE(rate_limiter_->requestAllowed(descriptor_));
+  EXPECT_FALSE(rate_limiter_->requestAllowed(descriptor_));
+
+  // 0 -> 1 tokens for descriptor2_ only
+  dispatcher_.globalTimeSystem().advanceTimeAndRun(std::chrono::milliseconds(50), dispatcher_,
+                                                   Envoy::Event::Dispatcher::RunType::NonBlock);
+  EXPECT_TRUE(rate_limiter_->requestAllowed(descriptor2_));
+  EXPECT_FALSE(rate_limiter_->requestAllowed(descriptor_));
+  EXPECT_EQ(rate_limiter_->remainingTokens(descriptor_), 0);
+
+  // 0 -> 1 tokens for descriptor_
+  dispatcher_.globalTimeSystem().advanceTimeAndRun(std::chrono::milliseconds(950), dispatcher_,
+                                                   Envoy::Event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(rate_limiter_->remainingFillInterval(descriptor_), 1);
+  EXPECT_TRUE(rate_limiter_->requestAllowed(descriptor_));
+  EXPECT_FALSE(rate_limiter_->requestAllowed(descriptor_));
+}
+
 // Verify token bucket status of max tokens, remaining tokens and remaining fill interval.
 TEST_F(LocalRateLimiterDescriptorImplTest, TokenBucketDescriptorStatus) {
   TestUtility::loadFromYaml(fmt::format(fmt::runtime(single_descriptor_config_yaml), 2, 2, "3s"),
@@ -2,6 +2,7 @@
 #include "envoy/registry/registry.h"
 
 #include "source/common/buffer/buffer_impl.h"
+#include "source/common/stats/isolated_store_impl.h"
 #include "source/extensions/filters/http/cache/cache_entry_utils.h"
 #include "source/extensions/filters/http/cache/cache_headers_utils.h"
 #include "source/extensions/http/cache/simple_http_cache/simple_http_cache.h"
@@ -26,7 +27,10 @@ public:
   bool validationEnabled() const override { return true; }
 
 private:
-  std::shared_ptr<SimpleHttpCache> cache_ = std::make_shared<SimpleHttpCache>();
+  Stats::IsolatedStoreImpl stats_store_;
+  std::shared_ptr<SimpleHttpCache> cache_ = std::make_shared<SimpleHttpCache>(
+      envoy::extensions::http::cache::simple_http_cache::v3::SimpleHttpCacheConfig(),
+      *stats_store_.rootScope());
 };
 
 INSTANTIATE_TEST_SUITE_P(SimpleHttpCacheTest, HttpCacheImplementationTest,
@@ -46,6 +50,131 @@ TEST(Registration, GetFactory) {
             "envoy.extensions.http.cache.simple");
 }
 
+TEST(Registration, MismatchedConfig) {
+  HttpCacheFactory* factory = Registry::FactoryRegistry<HttpCacheFactory>::getFactoryByType(
+      "envoy.extensions.http.cache.simple_http_cache.v3.SimpleHttpCacheConfig");
+  ASSERT_NE(factory, nullptr);
+  testing::NiceMock<Server::Configuration::MockFactoryContext> factory_context;
+  envoy::extensions::filters::http::cache::v3::CacheConfig config;
+  config.mutable_typed_config()->PackFrom(*factory->createEmptyConfigProto());
+  std::shared_ptr<HttpCache> cache = factory->getCache(config, factory_context);
+
+  envoy::extensions::http::cache::simple_http_cache::v3::SimpleHttpCacheConfig simple_config;
+  simple_config.mutable_max_cache_size_bytes()->set_value(1024);
+  config.mutable_typed_config()->PackFrom(simple_config);
+  EXPECT_THROW_WITH_REGEX(factory->getCache(config, factory_context), EnvoyException,
+                          "mismatched SimpleHttpCacheConfig");
+}
+
+class SimpleHttpCacheEvictionTest : public testing::Test {
+protected:
+  SimpleHttpCacheEvictionTest() {
+    request_headers_.setMethod("GET");
+    request_headers_.setHost("example.com");
+    request_headers_.setScheme("https");
+  }
+
+  // Creates a cache with a single shard holding about three entries of entrySize().
+  void createCache() {
+    envoy::extensions::http::cache::simple_http_cache::v3::SimpleHttpCacheConfig config;
+    config.mutable_num_shards()->set_value(1);
+    config.mutable_max_cache_size_bytes()->set_value(3 * BodySize + 3 * 200);
+    cache_ = std::make_unique<SimpleHttpCache>(config, *stats_store_.rootScope());
+  }
+
+  LookupRequest makeLookupRequest(absl::string_view path) {
+    request_headers_.setPath(path);
+    return {request_headers_, time_system_.systemTime(), vary_allow_list_};
+  }
+
+  bool insert(absl::string_view path, uint64_t body_size = BodySize) {
+    return cache_->insert(
+        makeLookupRequest(path).key(),
+        Http::createHeaderMap<Http::ResponseHeaderMapImpl>(response_headers_), {},
+        std::string(body_size, 'a'), nullptr);
+  }
+
+  bool cached(absl::string_view path) {
+    return cache_->lookup(makeLookupRequest(path)).response_headers_ != nullptr;
+  }
+
+  uint64_t counter(absl::string_view name) {
+    return TestUtility::findCounter(stats_store_, absl::StrCat("simple_http_cache.shard_0.", name))
+        ->value();
+  }
+
+  static constexpr uint64_t BodySize = 1000;
+
+  Stats::IsolatedStoreImpl stats_store_;
+  Event::SimulatedTimeSystem time_system_;
+  Http::TestRequestHeaderMapImpl request_headers_;
+  Http::TestResponseHeaderMapImpl response_headers_{{":status", "200"}};
+  Protobuf::RepeatedPtrField<envoy::type::matcher::v3::StringMatcher> allow_list_;
+  VaryAllowList vary_allow_list_{allow_list_};
+  std::unique_ptr<SimpleHttpCache> cache_;
+};
+
+TEST_F(SimpleHttpCacheEvictionTest, EvictsOldestUnreferencedEntry) {
+  createCache();
+  EXPECT_TRUE(insert("/a"));
+  EXPECT_TRUE(insert("/b"));
+  EXPECT_TRUE(insert("/c"));
+  EXPECT_EQ(0, counter("eviction"));
+
+  // "/a" is referenced, so "/b" is evicted instead.
+  EXPECT_TRUE(cached("/a"));
+  EXPECT_TRUE(insert("/d"));
+  EXPECT_EQ(1, counter("eviction"));
+  EXPECT_TRUE(cached("/a"));
+  EXPECT_FALSE(cached("/b"));
+  EXPECT_TRUE(cached("/c"));
+  EXPECT_TRUE(cached("/d"));
+
+  EXPECT_EQ(4, counter("insert"));
+  EXPECT_EQ(4, counter("lookup_hit"));
+  EXPECT_EQ(1, counter("lookup_miss"));
+  EXPECT_EQ(3, TestUtility::findGauge(stats_store_, "simple_http_cache.shard_0.size_count")
+                   ->value());
+}
+
+TEST_F(SimpleHttpCacheEvictionTest, ReplacingEntryUpdatesSize) {
+  createCache();
+  EXPECT_TRUE(insert("/a"));
+  const uint64_t size_bytes =
+      TestUtility::findGauge(stats_store_, "simple_http_cache.shard_0.size_bytes")->value();
+  EXPECT_TRUE(insert("/a"));
+  EXPECT_EQ(size_bytes,
+            TestUtility::findGauge(stats_store_, "simple_http_cache.shard_0.size_bytes")->value());
+  EXPECT_EQ(1, TestUtility::findGauge(stats_store_, "simple_http_cache.shard_0.size_count")
+                   ->value());
+}
+
+TEST_F(SimpleHttpCacheEvictionTest, RejectsEntryLargerThanShard) {
+  createCache();
+  EXPECT_TRUE(insert("/a"));
+  EXPECT_FALSE(insert("/large", 4 * BodySize));
+  EXPECT_EQ(1, counter("insert_rejected"));
+  EXPECT_EQ(0, counter("eviction"));
+  EXPECT_TRUE(cached("/a"));
+  EXPECT_FALSE(cached("/large"));
+}
+
+TEST_F(SimpleHttpCacheEvictionTest, ShardsSplitTheBudget) {
+  envoy::extensions::http::cache::simple_http_cache::v3::SimpleHttpCacheConfig config;
+  config.mutable_num_shards()->set_value(4);
+  config.mutable_max_cache_size_bytes()->set_value(4 * BodySize);
+  cache_ = std::make_unique<SimpleHttpCache>(config, *stats_store_.rootScope());
+  EXPECT_EQ(4, cache_->numShards());
+
+  // Each shard only has room for less than one entry.
+  EXPECT_FALSE(insert("/a"));
+  uint64_t rejected = 0;
+  for (uint32_t i = 0; i < cache_->numShards(); i++) {
+    rejected += cache_->shardStats(i).insert_rejected_.value();
+  }
+  EXPECT_EQ(1, rejected);
+}
+
 } // namespace
 } // namespace Cache
 } // namespace HttpFilters
@@ -0,0 +1,367 @@
+// Usage: bazel run //test/extensions/load_balancing_policies/common:churn_benchmark
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "envoy/config/cluster/v3/cluster.pb.h"
+
+#include "source/common/common/hash.h"
+#include "source/common/common/random_generator.h"
+#include "source/common/config/well_known_names.h"
+#include "source/common/memory/stats.h"
+#include "source/common/router/metadatamatchcriteria_impl.h"
+#include "source/common/upstream/load_balancer_impl.h"
+#include "source/common/upstream/upstream_impl.h"
+#include "source/extensions/load_balancing_policies/maglev/maglev_lb.h"
+#include "source/extensions/load_balancing_policies/ring_hash/ring_hash_lb.h"
+#include "source/extensions/load_balancing_policies/subset/subset_lb.h"
+
+#include "test/benchmark/main.h"
+#include "test/common/upstream/utility.h"
+#include "test/mocks/upstream/cluster_info.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "benchmark/benchmark.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace LoadBalancingPolices {
+namespace Common {
+namespace {
+
+// Replays streams of host set changes against each load balancing policy, and reports the time
+// the load balancer takes to rebuild after each change, the latency percentiles of the picks in
+// between the changes, and the memory of the load balancer once built.
+
+enum class Policy : uint32_t { RoundRobin, LeastRequest, Random, RingHash, Maglev, Subset };
+
+enum class Scenario : uint32_t {
+  // 1% of the hosts of priority 0 flap their health with every change.
+  HealthFlap,
+  // 1% of the hosts of priority 0 change their weight with every change.
+  WeightChange,
+  // 1% of the hosts of priority 0 are removed or added back with every change.
+  Membership,
+  // 10% of the hosts of priority 0 fail with every change until they all failed, sending the
+  // traffic to priority 1, after which they recover at the same pace.
+  PriorityFailover,
+};
+
+constexpr uint32_t NumChanges = 100;
+constexpr uint32_t PicksPerChange = 100;
+constexpr uint32_t NumSubsets = 10;
+constexpr absl::string_view MetadataKey = "key";
+
+// A recorded change to the hosts of one priority.
+struct HostSetChange {
+  enum class Action { ToggleHealth, SetWeight, ToggleMembership };
+
+  Action action_;
+  uint32_t priority_;
+  std::vector<uint32_t> hosts_;
+  uint32_t weight_{1};
+};
+
+// Records the stream of changes of a scenario. The stream only depends on the scenario and the
+// number of hosts, so that every policy replays the same stream.
+std::vector<HostSetChange> recordChanges(Scenario scenario, uint32_t num_hosts) {
+  std::mt19937 random(42);
+  std::uniform_int_distribution<uint32_t> host_dist(0, num_hosts - 1);
+  std::uniform_int_distribution<uint32_t> weight_dist(1, 100);
+  const uint32_t hosts_per_change = std::max<uint32_t>(1, num_hosts / 100);
+
+  std::vector<HostSetChange> changes;
+  std::vector<uint32_t> removed;
+  for (uint32_t i = 0; i < NumChanges; ++i) {
+    HostSetChange change;
+    change.priority_ = 0;
+    switch (scenario) {
+    case Scenario::HealthFlap:
+      change.action_ = HostSetChange::Action::ToggleHealth;
+      for (uint32_t j = 0; j < hosts_per_change; ++j) {
+        change.hosts_.push_back(host_dist(random));
+      }
+      break;
+    case Scenario::WeightChange:
+      change.action_ = HostSetChange::Action::SetWeight;
+      change.weight_ = weight_dist(random);
+      for (uint32_t j = 0; j < hosts_per_change; ++j) {
+        change.hosts_.push_back(host_dist(random));
+      }
+      break;
+    case Scenario::Membership:
+      // Alternately remove hosts and add them back.
+      change.action_ = HostSetChange::Action::ToggleMembership;
+      if (removed.empty()) {
+        for (uint32_t j = 0; j < hosts_per_change; ++j) {
+          removed.push_back(host_dist(random));
+        }
+        std::sort(removed.begin(), removed.end());
+        removed.erase(std::unique(removed.begin(), removed.end()), removed.end());
+        change.hosts_ = removed;
+      } else {
+        change.hosts_ = std::move(removed);
+        removed.clear();
+      }
+      break;
+    case Scenario::PriorityFailover: {
+      change.action_ = HostSetChange::Action::ToggleHealth;
+      const uint32_t step = i % 10;
+      for (uint32_t j = step * num_hosts / 10; j < (step + 1) * num_hosts / 10; ++j) {
+        change.hosts_.push_back(j);
+      }
+      break;
+    }
+    }
+    changes.push_back(std::move(change));
+  }
+  return changes;
+}
+
+class TestLoadBalancerContext : public Upstream::LoadBalancerContextBase {
+public:
+  // Upstream::LoadBalancerContext
+  absl::optional<uint64_t> computeHashKey() override { return hash_key_; }
+  const Router::MetadataMatchCriteria* metadataMatchCriteria() override { return criteria_; }
+
+  absl::optional<uint64_t> hash_key_;
+  const Router::MetadataMatchCriteria* criteria_{};
+};
+
+class ChurnTester : public Event::TestUsingSimulatedTime {
+public:
+  // Priority 0 and priority 1 both have num_hosts hosts, spread across NumSubsets subsets.
+  ChurnTester(Policy policy, uint32_t num_hosts) : policy_(policy) {
+    for (uint32_t priority = 0; priority < 2; ++priority) {
+      PriorityHosts& priority_hosts = priorities_[priority];
+      for (uint32_t i = 0; i < num_hosts; ++i) {
+        envoy::config::core::v3::Metadata metadata;
+        ProtobufWkt::Value value;
+        value.set_number_value(i % NumSubsets);
+        ProtobufWkt::Struct& map =
+            (*metadata.mutable_filter_metadata())[Config::MetadataFilters::get().ENVOY_LB];
+        (*map.mutable_fields())[std::string(MetadataKey)] = value;
+        priority_hosts.all_.push_back(Upstream::makeTestHost(
+            info_, fmt::format("tcp://10.{}.{}.{}:6379", priority, i / 256, i % 256), metadata,
+            simTime()));
+      }
+      priority_hosts.present_.assign(num_hosts, true);
+      priority_set_.updateHosts(priority, makeParams(priority), nullptr, priority_hosts.all_, {},
+                                absl::nullopt);
+    }
+
+    for (uint32_t i = 0; i < NumSubsets; ++i) {
+      ProtobufWkt::Struct criteria;
+      (*criteria.mutable_fields())[std::string(MetadataKey)].set_number_value(i);
+      subset_criteria_.push_back(std::make_unique<Router::MetadataMatchCriteriaImpl>(criteria));
+    }
+  }
+
+  // Creates the load balancer, including the initial build of the tables of the hashing ones.
+  void initialize() {
+    switch (policy_) {
+    case Policy::RoundRobin:
+      lb_ = std::make_unique<Upstream::RoundRobinLoadBalancer>(
+          priority_set_, nullptr, stats_, runtime_, random_, common_config_,
+          envoy::config::cluster::v3::Cluster::RoundRobinLbConfig(), simTime());
+      break;
+    case Policy::LeastRequest:
+      lb_ = std::make_unique<Upstream::LeastRequestLoadBalancer>(
+          priority_set_, nullptr, stats_, runtime_, random_, common_config_,
+          envoy::config::cluster::v3::Cluster::LeastRequestLbConfig(), simTime());
+      break;
+    case Policy::Random:
+      lb_ = std::make_unique<Upstream::RandomLoadBalancer>(priority_set_, nullptr, stats_,
+                                                           runtime_, random_, common_config_);
+      break;
+    case Policy::RingHash:
+      thread_aware_lb_ = std::make_unique<Upstream::RingHashLoadBalancer>(
+          priority_set_, stats_, stats_scope_, runtime_, random_, absl::nullopt, common_config_);
+      break;
+    case Policy::Maglev:
+      thread_aware_lb_ = std::make_unique<Upstream::MaglevLoadBalancer>(
+          priority_set_, stats_, stats_scope_, runtime_, random_, absl::nullopt, common_config_);
+      break;
+    case Policy::Subset: {
+      envoy::config::cluster::v3::Cluster::LbSubsetConfig subset_config;
+      subset_config.set_fallback_policy(
+          envoy::config::cluster::v3::Cluster::LbSubsetConfig::ANY_ENDPOINT);
+      *subset_config.mutable_subset_selectors()->Add()->mutable_keys()->Add() =
+          std::string(MetadataKey);
+      subset_info_ = std::make_unique<Upstream::LoadBalancerSubsetInfoImpl>(subset_config);
+      lb_ = std::make_unique<Upstream::SubsetLoadBalancer>(
+          *subset_info_,
+          std::make_unique<Upstream::LegacyChildLoadBalancerCreatorImpl>(
+              Upstream::LoadBalancerType::Random, absl::nullopt, absl::nullopt, absl::nullopt,
+              absl::nullopt, common_config_),
+          priority_set_, nullptr, stats_, stats_scope_, runtime_, random_, simTime());
+      break;
+    }
+    }
+    if (thread_aware_lb_ != nullptr) {
+      thread_aware_lb_->initialize();
+      lb_ = thread_aware_lb_->factory()->create(lb_params_);
+    }
+  }
+
+  // Applies a change to the host sets, and returns how long the load balancer took to rebuild.
+  // The worker load balancers of the hashing policies are recreated, as the cluster manager does.
+  std::chrono::nanoseconds apply(const HostSetChange& change) {
+    PriorityHosts& priority_hosts = priorities_[change.priority_];
+    Upstream::HostVector added;
+    Upstream::HostVector removed;
+    for (const uint32_t i : change.hosts_) {
+      const Upstream::HostSharedPtr& host = priority_hosts.all_[i];
+      switch (change.action_) {
+      case HostSetChange::Action::ToggleHealth:
+        if (host->healthFlagGet(Upstream::Host::HealthFlag::FAILED_ACTIVE_HC)) {
+          host->healthFlagClear(Upstream::Host::HealthFlag::FAILED_ACTIVE_HC);
+        } else {
+          host->healthFlagSet(Upstream::Host::HealthFlag::FAILED_ACTIVE_HC);
+        }
+        break;
+      case HostSetChange::Action::SetWeight:
+        host->weight(change.weight_);
+        break;
+      case HostSetChange::Action::ToggleMembership:
+        priority_hosts.present_[i] = !priority_hosts.present_[i];
+        (priority_hosts.present_[i] ? added : removed).push_back(host);
+        break;
+      }
+    }
+    Upstream::PrioritySet::UpdateHostsParams params = makeParams(change.priority_);
+
+    const auto start = std::chrono::steady_clock::now();
+    priority_set_.updateHosts(change.priority_, std::move(params), nullptr, added, removed,
+                              absl::nullopt);
+    if (thread_aware_lb_ != nullptr) {
+      lb_ = thread_aware_lb_->factory()->create(lb_params_);
+    }
+    return std::chrono::steady_clock::now() - start;
+  }
+
+  // Picks a host, and returns how long the pick took.
+  std::chrono::nanoseconds pick(uint64_t i) {
+    context_.hash_key_ = HashUtil::xxHash64(absl::StrCat(i));
+    context_.criteria_ = subset_criteria_[i % NumSubsets].get();
+    const auto start = std::chrono::steady_clock::now();
+    Upstream::HostConstSharedPtr host = lb_->chooseHost(&context_);
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    ::benchmark::DoNotOptimize(host);
+    return elapsed;
+  }
+
+private:
+  struct PriorityHosts {
+    Upstream::HostVector all_;
+    std::vector<bool> present_;
+  };
+
+  Upstream::PrioritySet::UpdateHostsParams makeParams(uint32_t priority) const {
+    const PriorityHosts& priority_hosts = priorities_[priority];
+    auto hosts = std::make_shared<Upstream::HostVector>();
+    for (uint32_t i = 0; i < priority_hosts.all_.size(); ++i) {
+      if (priority_hosts.present_[i]) {
+        hosts->push_back(priority_hosts.all_[i]);
+      }
+    }
+    return Upstream::HostSetImpl::partitionHosts(hosts, Upstream::makeHostsPerLocality({*hosts}));
+  }
+
+  Envoy::Thread::MutexBasicLockable lock_;
+  // Reduce default log level to warn while running this benchmark to avoid problems due to
+  // excessive debug logging in upstream_impl.cc
+  Envoy::Logger::Context logging_context_{spdlog::level::warn,
+                                          Envoy::Logger::Logger::DEFAULT_LOG_FORMAT, lock_, false};
+
+  const Policy policy_;
+  PriorityHosts priorities_[2];
+  Upstream::PrioritySetImpl priority_set_;
+  Upstream::LoadBalancerParams lb_params_{priority_set_, nullptr};
+  Stats::IsolatedStoreImpl stats_store_;
+  Stats::Scope& stats_scope_{*stats_store_.rootScope()};
+  Upstream::ClusterLbStatNames stat_names_{stats_store_.symbolTable()};
+  Upstream::ClusterLbStats stats_{stat_names_, stats_scope_};
+  NiceMock<Runtime::MockLoader> runtime_;
+  Random::RandomGeneratorImpl random_;
+  envoy::config::cluster::v3::Cluster::CommonLbConfig common_config_;
+  std::shared_ptr<Upstream::MockClusterInfo> info_{new NiceMock<Upstream::MockClusterInfo>()};
+  std::unique_ptr<Upstream::LoadBalancerSubsetInfoImpl> subset_info_;
+  std::vector<std::unique_ptr<Router::MetadataMatchCriteriaImpl>> subset_criteria_;
+  TestLoadBalancerContext context_;
+  Upstream::ThreadAwareLoadBalancerPtr thread_aware_lb_;
+  Upstream::LoadBalancerPtr lb_;
+};
+
+// Reports the percentiles of the samples, in microseconds.
+void reportPercentiles(::benchmark::State& state, absl::string_view name,
+                       std::vector<std::chrono::nanoseconds>& samples) {
+  std::sort(samples.begin(), samples.end());
+  for (const double percentile : {50.0, 90.0, 99.0}) {
+    const size_t index = std::min(samples.size() - 1,
+                                  static_cast<size_t>(samples.size() * percentile / 100));
+    state.counters[absl::StrCat(name, "_p", percentile, "_us")] =
+        std::chrono::duration<double, std::micro>(samples[index]).count();
+  }
+}
+
+void benchmarkLoadBalancerHostChurn(::benchmark::State& state) {
+  const auto policy = static_cast<Policy>(state.range(0));
+  const auto scenario = static_cast<Scenario>(state.range(1));
+  const uint32_t num_hosts = state.range(2);
+
+  if (benchmark::skipExpensiveBenchmarks() && num_hosts > 100) {
+    state.SkipWithError("Skipping expensive benchmark");
+    return;
+  }
+
+  const std::vector<HostSetChange> changes = recordChanges(scenario, num_hosts);
+  for (auto _ : state) { // NOLINT: Silences warning about dead store
+    state.PauseTiming();
+    ChurnTester tester(policy, num_hosts);
+    const size_t start_mem = Memory::Stats::totalCurrentlyAllocated();
+    tester.initialize();
+    const size_t end_mem = Memory::Stats::totalCurrentlyAllocated();
+    std::vector<std::chrono::nanoseconds> rebuilds;
+    rebuilds.reserve(changes.size());
+    std::vector<std::chrono::nanoseconds> picks;
+    picks.reserve(changes.size() * PicksPerChange);
+    state.ResumeTiming();
+
+    uint64_t i = 0;
+    for (const HostSetChange& change : changes) {
+      rebuilds.push_back(tester.apply(change));
+      for (uint32_t j = 0; j < PicksPerChange; ++j) {
+        picks.push_back(tester.pick(i++));
+      }
+    }
+
+    // Do not time the computation of the percentiles.
+    state.PauseTiming();
+    state.counters["memory"] = end_mem - start_mem;
+    state.counters["memory_per_host"] = (end_mem - start_mem) / (2 * num_hosts);
+    reportPercentiles(state, "rebuild", rebuilds);
+    reportPercentiles(state, "pick", picks);
+    state.ResumeTiming();
+  }
+}
+BENCHMARK(benchmarkLoadBalancerHostChurn)
+    ->ArgsProduct({{static_cast<uint32_t>(Policy::RoundRobin),
+                    static_cast<uint32_t>(Policy::LeastRequest),
+                    static_cast<uint32_t>(Policy::Random), static_cast<uint32_t>(Policy::RingHash),
+                    static_cast<uint32_t>(Policy::Maglev), static_cast<uint32_t>(Policy::Subset)},
+                   {static_cast<uint32_t>(Scenario::HealthFlap),
+                    static_cast<uint32_t>(Scenario::WeightChange),
+                    static_cast<uint32_t>(Scenario::Membership),
+                    static_cast<uint32_t>(Scenario::PriorityFailover)},
+                   {100, 2000}})
+    ->Unit(::benchmark::kMillisecond);
+
+} // namespace
+} // namespace Common
+} // namespace LoadBalancingPolices
+} // namespace Extensions
+} // namespace Envoy
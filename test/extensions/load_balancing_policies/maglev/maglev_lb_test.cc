@@ -63,7 +63,8 @@ public:
         common_config_);
   }
 
-  void init(uint64_t table_size, bool locality_weighted_balancing = false) {
+  void init(uint64_t table_size, bool locality_weighted_balancing = false,
+            LoadBalancerBuildPoolSharedPtr build_pool = nullptr) {
     config_ = envoy::config::cluster::v3::Cluster::MaglevLbConfig();
     config_.value().mutable_table_size()->set_value(table_size);
 
@@ -72,6 +73,9 @@ public:
     }
 
     createLb();
+    if (build_pool != nullptr) {
+      lb_->setBuildPool(std::move(build_pool));
+    }
     lb_->initialize();
   }
 
@@ -167,6 +171,62 @@ TEST_P(MaglevLoadBalancerTest, Basic) {
   }
 }
 
+// Build pool running the posted builds when the test asks for it.
+class TestBuildPool : public LoadBalancerBuildPool {
+public:
+  // Upstream::LoadBalancerBuildPool
+  void post(std::function<void()> build) override { builds_.push_back(std::move(build)); }
+
+  void runBuilds() {
+    auto builds = std::move(builds_);
+    builds_.clear();
+    for (auto& build : builds) {
+      build();
+    }
+  }
+
+  std::vector<std::function<void()>> builds_;
+};
+
+// With a build pool, the table is rebuilt in the background and the workers keep using the
+// previous table until the build finishes.
+TEST_P(MaglevLoadBalancerTest, BackgroundBuild) {
+  host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:90", simTime())};
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+
+  auto build_pool = std::make_shared<TestBuildPool>();
+  init(7, false, build_pool);
+  EXPECT_TRUE(build_pool->builds_.empty());
+  LoadBalancerPtr lb = lb_->factory()->create(lb_params_);
+  TestLoadBalancerContext context(0);
+  EXPECT_EQ(host_set_.hosts_[0], lb->chooseHost(&context));
+  EXPECT_EQ(7, lb_->stats().max_entries_per_host_.value());
+
+  const HostVector old_hosts = host_set_.hosts_;
+  host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:91", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:92", simTime())};
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks({}, {});
+  EXPECT_EQ(1, build_pool->builds_.size());
+  EXPECT_EQ(old_hosts[0], lb->chooseHost(&context));
+  EXPECT_EQ(7, lb_->stats().max_entries_per_host_.value());
+
+  build_pool->runBuilds();
+  EXPECT_EQ(4, lb_->stats().max_entries_per_host_.value());
+  EXPECT_THAT(host_set_.hosts_, testing::Contains(lb->chooseHost(&context)));
+
+  // A build posted before the load balancer is destroyed does nothing.
+  auto factory = lb_->factory();
+  host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:93", simTime())};
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks({}, {});
+  EXPECT_EQ(1, build_pool->builds_.size());
+  const HostConstSharedPtr host = lb->chooseHost(&context);
+  lb_.reset();
+  build_pool->runBuilds();
+  EXPECT_EQ(host, factory->create(lb_params_)->chooseHost(&context));
+}
+
 // Basic with hostname.
 TEST_P(MaglevLoadBalancerTest, BasicWithHostName) {
   host_set_.hosts_ = {makeTestHost(info_, "90", "tcp://127.0.0.1:90", simTime()),
@@ -7,6 +7,7 @@
 #include "envoy/router/router.h"
 
 #include "source/common/network/utility.h"
+#include "source/common/upstream/load_balancer_build_pool.h"
 #include "source/common/upstream/upstream_impl.h"
 #include "source/extensions/load_balancing_policies/ring_hash/ring_hash_lb.h"
 
@@ -19,8 +20,10 @@
 #include "test/mocks/upstream/load_balancer_context.h"
 #include "test/mocks/upstream/priority_set.h"
 #include "test/test_common/simulated_time_system.h"
+#include "test/test_common/thread_factory_for_test.h"
 
 #include "absl/container/node_hash_map.h"
+#include "absl/synchronization/mutex.h"
 #include "absl/types/optional.h"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
@@ -61,7 +64,8 @@ public:
   RingHashLoadBalancerTest()
       : stat_names_(stats_store_.symbolTable()), stats_(stat_names_, *stats_store_.rootScope()) {}
 
-  void init(bool locality_weighted_balancing = false) {
+  void init(bool locality_weighted_balancing = false,
+            LoadBalancerBuildPoolSharedPtr build_pool = nullptr) {
     if (locality_weighted_balancing) {
       common_config_.mutable_locality_weighted_lb_config();
     }
@@ -73,6 +77,9 @@ public:
                   config_.value())
             : absl::nullopt,
         common_config_);
+    if (build_pool != nullptr) {
+      lb_->setBuildPool(std::move(build_pool));
+    }
     lb_->initialize();
   }
 
@@ -262,6 +269,218 @@ TEST_P(RingHashFailoverTest, BasicFailover) {
   EXPECT_EQ(failover_host_set_.healthy_hosts_[0], lb->chooseHost(nullptr));
 }
 
+// Build pool running the posted builds when the test asks for it.
+class TestBuildPool : public LoadBalancerBuildPool {
+public:
+  // Upstream::LoadBalancerBuildPool
+  void post(std::function<void()> build) override { builds_.push_back(std::move(build)); }
+
+  void runBuilds() {
+    auto builds = std::move(builds_);
+    builds_.clear();
+    for (auto& build : builds) {
+      build();
+    }
+  }
+
+  std::vector<std::function<void()>> builds_;
+};
+
+// With a build pool, the ring is rebuilt in the background and the workers keep using the previous
+// ring until the build finishes. The updates received meanwhile are collapsed.
+TEST_P(RingHashLoadBalancerTest, BackgroundBuild) {
+  hostSet().hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:90", simTime())};
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+
+  auto build_pool = std::make_shared<TestBuildPool>();
+  init(false, build_pool);
+  // The initial build is synchronous.
+  EXPECT_TRUE(build_pool->builds_.empty());
+  LoadBalancerPtr lb = lb_->factory()->create(lb_params_);
+  TestLoadBalancerContext context(0);
+  EXPECT_EQ(hostSet().hosts_[0], lb->chooseHost(&context));
+
+  const HostVector old_hosts = hostSet().hosts_;
+  hostSet().hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:91", simTime())};
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {});
+  hostSet().hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:92", simTime())};
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {});
+  EXPECT_EQ(1, build_pool->builds_.size());
+  EXPECT_EQ(old_hosts[0], lb->chooseHost(&context));
+  EXPECT_EQ(old_hosts[0], lb_->factory()->create(lb_params_)->chooseHost(&context));
+
+  // The existing worker load balancer picks up the result of the build.
+  build_pool->runBuilds();
+  EXPECT_EQ(hostSet().hosts_[0], lb->chooseHost(&context));
+  EXPECT_TRUE(build_pool->builds_.empty());
+
+  hostSet().healthy_hosts_.clear();
+  hostSet().runCallbacks({}, {});
+  EXPECT_EQ(1, build_pool->builds_.size());
+  EXPECT_EQ(0UL, stats_.lb_healthy_panic_.value());
+  build_pool->runBuilds();
+  EXPECT_EQ(hostSet().hosts_[0], lb->chooseHost(&context));
+  EXPECT_EQ(1UL, stats_.lb_healthy_panic_.value());
+}
+
+// A build posted before the load balancer is destroyed does nothing.
+TEST_P(RingHashLoadBalancerTest, BackgroundBuildAfterDestruction) {
+  hostSet().hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:90", simTime())};
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+
+  auto build_pool = std::make_shared<TestBuildPool>();
+  init(false, build_pool);
+  auto factory = lb_->factory();
+
+  const HostVector old_hosts = hostSet().hosts_;
+  hostSet().hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:91", simTime())};
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+  hostSet().runCallbacks({}, {});
+  EXPECT_EQ(1, build_pool->builds_.size());
+
+  lb_.reset();
+  build_pool->runBuilds();
+  TestLoadBalancerContext context(0);
+  EXPECT_EQ(old_hosts[0], factory->create(lb_params_)->chooseHost(&context));
+}
+
+// Build pool running the builds on real threads, which the test can wait for.
+class WaitableBuildPool : public LoadBalancerBuildPool {
+public:
+  WaitableBuildPool() : pool_(Thread::threadFactoryForTest(), 2) {}
+
+  // Upstream::LoadBalancerBuildPool
+  void post(std::function<void()> build) override {
+    {
+      absl::MutexLock lock(&mutex_);
+      posted_++;
+    }
+    pool_.post([this, build = std::move(build)]() {
+      build();
+      absl::MutexLock lock(&mutex_);
+      finished_++;
+    });
+  }
+
+  // Waits until all the posted builds finished.
+  void waitForBuilds() {
+    absl::MutexLock lock(&mutex_);
+    mutex_.Await(absl::Condition(this, &WaitableBuildPool::allFinished));
+  }
+
+private:
+  bool allFinished() const ABSL_EXCLUSIVE_LOCKS_REQUIRED(mutex_) { return finished_ == posted_; }
+
+  mutable absl::Mutex mutex_;
+  uint32_t posted_ ABSL_GUARDED_BY(mutex_){};
+  uint32_t finished_ ABSL_GUARDED_BY(mutex_){};
+  // Declared last so that the threads are joined before the counters are destroyed.
+  LoadBalancerBuildPoolImpl pool_;
+};
+
+// The builds run on the build threads while a worker keeps choosing hosts, and the worker load
+// balancer picks up the new ring once it is published.
+TEST_P(RingHashLoadBalancerTest, BackgroundBuildOnBuildThreads) {
+  hostSet().hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:90", simTime())};
+  hostSet().healthy_hosts_ = hostSet().hosts_;
+
+  auto build_pool = std::make_shared<WaitableBuildPool>();
+  init(false, build_pool);
+  LoadBalancerPtr lb = lb_->factory()->create(lb_params_);
+  TestLoadBalancerContext context(0);
+  EXPECT_EQ(hostSet().hosts_[0], lb->chooseHost(&context));
+
+  // A worker chooses hosts concurrently with the builds and always gets one of the hosts.
+  absl::Mutex worker_mutex;
+  bool stop_worker{};
+  uint32_t null_hosts{};
+  LoadBalancerPtr worker_lb = lb_->factory()->create(lb_params_);
+  Thread::ThreadPtr worker = Thread::threadFactoryForTest().createThread([&]() {
+    TestLoadBalancerContext worker_context(0);
+    while (true) {
+      if (worker_lb->chooseHost(&worker_context) == nullptr) {
+        null_hosts++;
+      }
+      absl::MutexLock lock(&worker_mutex);
+      if (stop_worker) {
+        return;
+      }
+    }
+  });
+
+  HostVector all_hosts = hostSet().hosts_;
+  for (uint32_t i = 1; i <= 10; ++i) {
+    hostSet().hosts_ = {makeTestHost(info_, fmt::format("tcp://127.0.0.1:{}", 90 + i), simTime())};
+    hostSet().healthy_hosts_ = hostSet().hosts_;
+    all_hosts.push_back(hostSet().hosts_[0]);
+    hostSet().runCallbacks({}, {});
+  }
+  {
+    absl::MutexLock lock(&worker_mutex);
+    stop_worker = true;
+  }
+  worker->join();
+  EXPECT_EQ(0, null_hosts);
+
+  // A build run only returns once no update is pending, so the last update has been built once
+  // all the posted runs finished.
+  build_pool->waitForBuilds();
+
+  // The generation changed, so the existing worker load balancer copies the new ring.
+  EXPECT_EQ(hostSet().hosts_[0], lb->chooseHost(&context));
+  EXPECT_EQ(hostSet().hosts_[0], worker_lb->chooseHost(&context));
+  EXPECT_EQ(hostSet().hosts_[0], lb_->factory()->create(lb_params_)->chooseHost(&context));
+}
+
+// An update of one priority only rebuilds the ring of this priority.
+TEST_P(RingHashFailoverTest, BackgroundBuildReusesOtherPriorities) {
+  host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:81", simTime())};
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  failover_host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:82", simTime()),
+                               makeTestHost(info_, "tcp://127.0.0.1:83", simTime()),
+                               makeTestHost(info_, "tcp://127.0.0.1:84", simTime())};
+  failover_host_set_.healthy_hosts_ = failover_host_set_.hosts_;
+
+  config_ = envoy::config::cluster::v3::Cluster::RingHashLbConfig();
+  config_.value().mutable_minimum_ring_size()->set_value(12);
+  auto build_pool = std::make_shared<TestBuildPool>();
+  init(false, build_pool);
+  // The ring of P=1 is built last and has 4 hashes per host, the one of P=0 has 6.
+  EXPECT_EQ(4, lb_->stats().min_hashes_per_host_.value());
+
+  // Only the ring of P=0 is rebuilt, so the stats are the ones of its ring.
+  host_set_.hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:85", simTime()),
+                      makeTestHost(info_, "tcp://127.0.0.1:86", simTime())};
+  host_set_.healthy_hosts_ = host_set_.hosts_;
+  host_set_.runCallbacks({}, {});
+  build_pool->runBuilds();
+  EXPECT_EQ(6, lb_->stats().min_hashes_per_host_.value());
+
+  // The reused ring of P=1 is still used for failover.
+  LoadBalancerPtr lb = lb_->factory()->create(lb_params_);
+  TestLoadBalancerContext context(0);
+  EXPECT_THAT(host_set_.hosts_, testing::Contains(lb->chooseHost(&context)));
+
+  // P=0 is in panic and its ring is rebuilt from all its hosts, while P=1 keeps its ring and gets
+  // all the load.
+  host_set_.healthy_hosts_.clear();
+  host_set_.runCallbacks({}, {});
+  build_pool->runBuilds();
+  EXPECT_EQ(6, lb_->stats().min_hashes_per_host_.value());
+  EXPECT_THAT(failover_host_set_.hosts_, testing::Contains(lb->chooseHost(&context)));
+
+  // An update of P=1 rebuilds its ring.
+  failover_host_set_.hosts_.push_back(makeTestHost(info_, "tcp://127.0.0.1:87", simTime()));
+  failover_host_set_.healthy_hosts_ = failover_host_set_.hosts_;
+  failover_host_set_.runCallbacks({}, {});
+  build_pool->runBuilds();
+  EXPECT_EQ(3, lb_->stats().min_hashes_per_host_.value());
+  EXPECT_THAT(failover_host_set_.hosts_, testing::Contains(lb->chooseHost(&context)));
+}
+
 // Expect reasonable results with Murmur2 hash.
 TEST_P(RingHashLoadBalancerTest, BasicWithMurmur2) {
   hostSet().hosts_ = {makeTestHost(info_, "tcp://127.0.0.1:80", simTime()),
@@ -283,6 +283,118 @@ TEST(DefaultCertValidatorTest, WithVerifyDepth) {
   EXPECT_EQ(X509_STORE_CTX_get_error(store_ctx.get()), X509_V_OK);
 }
 
+class DefaultCertValidatorAsyncTest : public testing::Test {
+protected:
+  DefaultCertValidatorAsyncTest()
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher("test_thread")),
+        stats_(generateSslStats(*test_store_.rootScope())),
+        config_(envoy::config::core::v3::TypedExtensionConfig(), false, {},
+                TestEnvironment::readFileToStringForTest(TestEnvironment::substitute(
+                    "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/"
+                    "ca_cert.pem"))),
+        ssl_ctx_(SSL_CTX_new(TLS_method())) {}
+
+  void initialize(
+      const envoy::extensions::transport_sockets::tls::v3::CertificateValidationContext::
+          AsyncValidation& async_validation) {
+    config_.setAsyncValidation(async_validation);
+    validator_ = std::make_unique<DefaultCertValidator>(&config_, stats_,
+                                                        Event::GlobalTimeSystem().timeSystem());
+    EXPECT_EQ(SSL_VERIFY_PEER, validator_->initializeSslContexts({ssl_ctx_.get()}, false));
+  }
+
+  static bssl::UniquePtr<STACK_OF(X509)> readChain(const std::string& name) {
+    return readCertChainFromFile(TestEnvironment::substitute(
+        "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/" + name));
+  }
+
+  // Verifies a chain, and waits for the result if the verification is asynchronous.
+  ValidationResults verify(STACK_OF(X509)& cert_chain) {
+    ValidationResults async_results{ValidationResults::ValidationStatus::Pending,
+                                    Ssl::ClientValidationStatus::NotValidated, absl::nullopt,
+                                    absl::nullopt};
+    auto callback = std::make_unique<TestValidateResultCallback>(
+        *dispatcher_, [&](bool succeeded, Ssl::ClientValidationStatus detailed_status) {
+          async_results.status = succeeded ? ValidationResults::ValidationStatus::Successful
+                                           : ValidationResults::ValidationStatus::Failed;
+          async_results.detailed_status = detailed_status;
+          dispatcher_->exit();
+        });
+    ValidationResults results =
+        validator_->doVerifyCertChain(cert_chain, std::move(callback),
+                                      /*transport_socket_options=*/nullptr, *ssl_ctx_, {},
+                                      /*is_server=*/true, "");
+    if (results.status != ValidationResults::ValidationStatus::Pending) {
+      return results;
+    }
+    dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+    return async_results;
+  }
+
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  Stats::TestUtil::TestStore test_store_;
+  SslStats stats_;
+  TestCertificateValidationContextConfig config_;
+  SSLContextPtr ssl_ctx_;
+  std::unique_ptr<DefaultCertValidator> validator_;
+};
+
+TEST_F(DefaultCertValidatorAsyncTest, VerifyOnThreadPool) {
+  initialize({});
+  bssl::UniquePtr<STACK_OF(X509)> trusted_chain = readChain("san_dns_cert.pem");
+  ValidationResults results = verify(*trusted_chain);
+  EXPECT_EQ(ValidationResults::ValidationStatus::Successful, results.status);
+  EXPECT_EQ(Ssl::ClientValidationStatus::Validated, results.detailed_status);
+
+  bssl::UniquePtr<STACK_OF(X509)> untrusted_chain = readChain("selfsigned_cert.pem");
+  results = verify(*untrusted_chain);
+  EXPECT_EQ(ValidationResults::ValidationStatus::Failed, results.status);
+  EXPECT_EQ(Ssl::ClientValidationStatus::Failed, results.detailed_status);
+
+  EXPECT_EQ(2, stats_.verify_offloaded_.value());
+  EXPECT_EQ(1, stats_.fail_verify_error_.value());
+  EXPECT_EQ(0, stats_.verify_cache_hit_.value());
+}
+
+TEST_F(DefaultCertValidatorAsyncTest, CacheVerifiedCertificates) {
+  envoy::extensions::transport_sockets::tls::v3::CertificateValidationContext::AsyncValidation
+      async_validation;
+  async_validation.mutable_cache_ttl()->set_seconds(60);
+  initialize(async_validation);
+  bssl::UniquePtr<STACK_OF(X509)> trusted_chain = readChain("san_dns_cert.pem");
+  EXPECT_EQ(ValidationResults::ValidationStatus::Successful, verify(*trusted_chain).status);
+  EXPECT_EQ(1, stats_.verify_offloaded_.value());
+
+  // The chain is not verified again, but the result is returned synchronously.
+  ValidationResults results = validator_->doVerifyCertChain(
+      *trusted_chain,
+      std::make_unique<TestValidateResultCallback>(
+          *dispatcher_, [](bool, Ssl::ClientValidationStatus) { FAIL(); }),
+      /*transport_socket_options=*/nullptr, *ssl_ctx_, {}, /*is_server=*/true, "");
+  EXPECT_EQ(ValidationResults::ValidationStatus::Successful, results.status);
+  EXPECT_EQ(Ssl::ClientValidationStatus::Validated, results.detailed_status);
+  EXPECT_EQ(1, stats_.verify_offloaded_.value());
+  EXPECT_EQ(1, stats_.verify_cache_hit_.value());
+
+  // Failures are not remembered.
+  bssl::UniquePtr<STACK_OF(X509)> untrusted_chain = readChain("selfsigned_cert.pem");
+  EXPECT_EQ(ValidationResults::ValidationStatus::Failed, verify(*untrusted_chain).status);
+  EXPECT_EQ(ValidationResults::ValidationStatus::Failed, verify(*untrusted_chain).status);
+  EXPECT_EQ(3, stats_.verify_offloaded_.value());
+}
+
+// Without a callback, e.g. when called by another validator, the verification is synchronous.
+TEST_F(DefaultCertValidatorAsyncTest, VerifySynchronouslyWithoutCallback) {
+  initialize({});
+  bssl::UniquePtr<STACK_OF(X509)> trusted_chain = readChain("san_dns_cert.pem");
+  ValidationResults results = validator_->doVerifyCertChain(
+      *trusted_chain, /*callback=*/nullptr, /*transport_socket_options=*/nullptr, *ssl_ctx_, {},
+      /*is_server=*/true, "");
+  EXPECT_EQ(ValidationResults::ValidationStatus::Successful, results.status);
+  EXPECT_EQ(0, stats_.verify_offloaded_.value());
+}
+
 class MockCertificateValidationContextConfig : public Ssl::CertificateValidationContextConfig {
 public:
   MockCertificateValidationContextConfig() : MockCertificateValidationContextConfig("") {}
@@ -313,6 +425,11 @@ public:
   MOCK_METHOD(Api::Api&, api, (), (const override));
   bool onlyVerifyLeafCertificateCrl() const override { return false; }
   absl::optional<uint32_t> maxVerifyDepth() const override { return absl::nullopt; }
+  const envoy::extensions::transport_sockets::tls::v3::CertificateValidationContext::
+      AsyncValidation*
+      asyncValidation() const override {
+    return nullptr;
+  }
 
 private:
   std::string s_;
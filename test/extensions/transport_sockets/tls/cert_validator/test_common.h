@@ -1,5 +1,6 @@
 #pragma once
 
+#include <functional>
 #include <memory>
 
 #include "envoy/ssl/context_config.h"
@@ -39,6 +40,27 @@ private:
   Ssl::ValidateStatus validate_result_{Ssl::ValidateStatus::NotStarted};
 };
 
+// Hands the result of an asynchronous certificate validation over to a function.
+class TestValidateResultCallback : public Ssl::ValidateResultCallback {
+public:
+  using OnResult =
+      std::function<void(bool succeeded, Envoy::Ssl::ClientValidationStatus detailed_status)>;
+
+  TestValidateResultCallback(Event::Dispatcher& dispatcher, OnResult on_result)
+      : dispatcher_(dispatcher), on_result_(std::move(on_result)) {}
+
+  Event::Dispatcher& dispatcher() override { return dispatcher_; }
+  void onCertValidationResult(bool succeeded, Envoy::Ssl::ClientValidationStatus detailed_status,
+                              const std::string& /*error_details*/,
+                              uint8_t /*tls_alert*/) override {
+    on_result_(succeeded, detailed_status);
+  }
+
+private:
+  Event::Dispatcher& dispatcher_;
+  OnResult on_result_;
+};
+
 class TestCertificateValidationContextConfig
     : public Envoy::Ssl::CertificateValidationContextConfig {
 public:
@@ -91,6 +113,18 @@ public:
 
   absl::optional<uint32_t> maxVerifyDepth() const override { return max_verify_depth_; }
 
+  const envoy::extensions::transport_sockets::tls::v3::CertificateValidationContext::
+      AsyncValidation*
+      asyncValidation() const override {
+    return async_validation_.has_value() ? &async_validation_.value() : nullptr;
+  }
+
+  void setAsyncValidation(
+      const envoy::extensions::transport_sockets::tls::v3::CertificateValidationContext::
+          AsyncValidation& async_validation) {
+    async_validation_ = async_validation;
+  }
+
 private:
   bool allow_expired_certificate_{false};
   Api::ApiPtr api_;
@@ -100,6 +134,9 @@ private:
   const std::string ca_cert_;
   const std::string ca_cert_path_{"TEST_CA_CERT_PATH"};
   const absl::optional<uint32_t> max_verify_depth_{absl::nullopt};
+  absl::optional<
+      envoy::extensions::transport_sockets::tls::v3::CertificateValidationContext::AsyncValidation>
+      async_validation_;
 };
 
 } // namespace Tls
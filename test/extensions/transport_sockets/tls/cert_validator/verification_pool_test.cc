@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "source/extensions/transport_sockets/tls/cert_validator/verification_pool.h"
+
+#include "test/extensions/transport_sockets/tls/cert_validator/test_common.h"
+#include "test/test_common/utility.h"
+
+#include "absl/synchronization/notification.h"
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+class VerificationPoolTest : public testing::Test {
+protected:
+  VerificationPoolTest()
+      : api_(Api::createApiForTest()), dispatcher_(api_->allocateDispatcher("test_thread")) {}
+
+  // Exits the dispatcher once expected_results results were delivered.
+  Ssl::ValidateResultCallbackPtr newCallback(size_t expected_results) {
+    return std::make_unique<TestValidateResultCallback>(
+        *dispatcher_, [this, expected_results](bool succeeded, Ssl::ClientValidationStatus) {
+          results_.push_back(succeeded);
+          if (results_.size() == expected_results) {
+            dispatcher_->exit();
+          }
+        });
+  }
+
+  static ValidationResults result(bool succeeded) {
+    if (succeeded) {
+      return {ValidationResults::ValidationStatus::Successful,
+              Ssl::ClientValidationStatus::Validated, absl::nullopt, absl::nullopt};
+    }
+    return {ValidationResults::ValidationStatus::Failed, Ssl::ClientValidationStatus::Failed,
+            absl::nullopt, absl::nullopt};
+  }
+
+  Api::ApiPtr api_;
+  Event::DispatcherPtr dispatcher_;
+  std::vector<bool> results_;
+};
+
+TEST_F(VerificationPoolTest, DeliverResults) {
+  VerificationPool pool(api_->threadFactory(), 2, 100);
+  const size_t count = 80;
+  for (size_t i = 0; i < count; ++i) {
+    Ssl::ValidateResultCallbackPtr callback = newCallback(count);
+    EXPECT_TRUE(pool.enqueue([i]() { return result(i % 2 == 0); }, callback));
+    EXPECT_EQ(nullptr, callback);
+  }
+  dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+  EXPECT_EQ(count, results_.size());
+  EXPECT_EQ(count / 2, std::count(results_.begin(), results_.end(), true));
+}
+
+TEST_F(VerificationPoolTest, DeliverEachResultOnCompletion) {
+  VerificationPool pool(api_->threadFactory(), 1, 10);
+  absl::Notification unblock;
+  Ssl::ValidateResultCallbackPtr callback = newCallback(1);
+  EXPECT_TRUE(pool.enqueue([]() { return result(true); }, callback));
+  callback = newCallback(2);
+  EXPECT_TRUE(pool.enqueue(
+      [&]() {
+        unblock.WaitForNotification();
+        return result(false);
+      },
+      callback));
+
+  // The result of the first verification is delivered while the thread is still blocked on the
+  // second one.
+  dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+  EXPECT_EQ(std::vector<bool>{true}, results_);
+
+  unblock.Notify();
+  dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+  EXPECT_EQ((std::vector<bool>{true, false}), results_);
+}
+
+TEST_F(VerificationPoolTest, MaxPending) {
+  VerificationPool pool(api_->threadFactory(), 1, 1);
+  absl::Notification started;
+  absl::Notification unblock;
+  Ssl::ValidateResultCallbackPtr callback = newCallback(2);
+  EXPECT_TRUE(pool.enqueue(
+      [&]() {
+        started.Notify();
+        unblock.WaitForNotification();
+        return result(true);
+      },
+      callback));
+  // The only thread took the first verification, and the second one fills the queue.
+  started.WaitForNotification();
+  callback = newCallback(2);
+  EXPECT_TRUE(pool.enqueue([]() { return result(true); }, callback));
+
+  callback = newCallback(2);
+  EXPECT_FALSE(pool.enqueue([]() { return result(true); }, callback));
+  EXPECT_NE(nullptr, callback);
+
+  unblock.Notify();
+  dispatcher_->run(Event::Dispatcher::RunType::RunUntilExit);
+  EXPECT_EQ(2, results_.size());
+}
+
+TEST_F(VerificationPoolTest, CompletePendingOnDestruction) {
+  {
+    VerificationPool pool(api_->threadFactory(), 1, 10);
+    for (size_t i = 0; i < 5; ++i) {
+      Ssl::ValidateResultCallbackPtr callback = newCallback(5);
+      EXPECT_TRUE(pool.enqueue([]() { return result(false); }, callback));
+    }
+  }
+  // Every result was posted before the threads were joined.
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  EXPECT_EQ(5, results_.size());
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
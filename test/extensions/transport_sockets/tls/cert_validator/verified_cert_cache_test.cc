@@ -0,0 +1,94 @@
+#include <chrono>
+#include <string>
+
+#include "source/extensions/transport_sockets/tls/cert_validator/verified_cert_cache.h"
+#include "source/extensions/transport_sockets/tls/utility.h"
+
+#include "test/extensions/transport_sockets/tls/ssl_test_utility.h"
+#include "test/test_common/environment.h"
+#include "test/test_common/simulated_time_system.h"
+
+#include "gtest/gtest.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+class VerifiedCertCacheTest : public testing::Test {
+protected:
+  static bssl::UniquePtr<X509> readCert(const std::string& name) {
+    return readCertFromFile(TestEnvironment::substitute(
+        "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/" + name));
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  bssl::UniquePtr<X509> cert1_{readCert("san_dns_cert.pem")};
+  bssl::UniquePtr<X509> cert2_{readCert("san_uri_cert.pem")};
+  bssl::UniquePtr<X509> cert3_{readCert("san_ip_cert.pem")};
+};
+
+TEST_F(VerifiedCertCacheTest, Contains) {
+  VerifiedCertCache cache(time_system_, std::chrono::seconds(60), 10);
+  cache.insert(*cert1_);
+  EXPECT_TRUE(cache.contains(*cert1_));
+  EXPECT_FALSE(cache.contains(*cert2_));
+}
+
+TEST_F(VerifiedCertCacheTest, Ttl) {
+  VerifiedCertCache cache(time_system_, std::chrono::seconds(60), 10);
+  cache.insert(*cert1_);
+  time_system_.advanceTimeWait(std::chrono::seconds(59));
+  EXPECT_TRUE(cache.contains(*cert1_));
+  time_system_.advanceTimeWait(std::chrono::seconds(1));
+  EXPECT_FALSE(cache.contains(*cert1_));
+  EXPECT_EQ(0, cache.size());
+}
+
+TEST_F(VerifiedCertCacheTest, ExpireWithCertificate) {
+  VerifiedCertCache cache(time_system_, std::chrono::hours(1), 10);
+  time_system_.setSystemTime(Utility::getExpirationTime(*cert1_) - std::chrono::seconds(10));
+  cache.insert(*cert1_);
+  EXPECT_TRUE(cache.contains(*cert1_));
+  time_system_.advanceTimeWait(std::chrono::seconds(10));
+  EXPECT_FALSE(cache.contains(*cert1_));
+}
+
+TEST_F(VerifiedCertCacheTest, ExpiredCertificateNotCached) {
+  VerifiedCertCache cache(time_system_, std::chrono::seconds(60), 10);
+  bssl::UniquePtr<X509> expired_cert = readCert("expired_cert.pem");
+  cache.insert(*expired_cert);
+  EXPECT_FALSE(cache.contains(*expired_cert));
+  EXPECT_EQ(0, cache.size());
+}
+
+TEST_F(VerifiedCertCacheTest, EvictExpiredWhenFull) {
+  VerifiedCertCache cache(time_system_, std::chrono::seconds(60), 2);
+  cache.insert(*cert1_);
+  time_system_.advanceTimeWait(std::chrono::seconds(30));
+  cache.insert(*cert2_);
+  time_system_.advanceTimeWait(std::chrono::seconds(30));
+  cache.insert(*cert3_);
+  EXPECT_EQ(2, cache.size());
+  EXPECT_TRUE(cache.contains(*cert2_));
+  EXPECT_TRUE(cache.contains(*cert3_));
+}
+
+TEST_F(VerifiedCertCacheTest, EvictWhenFull) {
+  VerifiedCertCache cache(time_system_, std::chrono::seconds(60), 2);
+  cache.insert(*cert1_);
+  cache.insert(*cert2_);
+  // Replacing an entry does not evict another one.
+  cache.insert(*cert2_);
+  EXPECT_EQ(2, cache.size());
+  cache.insert(*cert3_);
+  EXPECT_EQ(2, cache.size());
+  EXPECT_TRUE(cache.contains(*cert3_));
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -1175,6 +1175,16 @@ TEST_F(ClientContextConfigImplTest, EmptyServerNameIndication) {
       "SNI names containing NULL-byte are not allowed");
 }
 
+// Validate that kernel TLS offload is opt-in.
+TEST_F(ClientContextConfigImplTest, KernelTlsOffload) {
+  envoy::extensions::transport_sockets::tls::v3::UpstreamTlsContext tls_context;
+  NiceMock<Server::Configuration::MockTransportSocketFactoryContext> factory_context;
+  EXPECT_FALSE(ClientContextConfigImpl(tls_context, factory_context).kernelTlsOffload());
+
+  tls_context.mutable_common_tls_context()->set_kernel_tls_offload(true);
+  EXPECT_TRUE(ClientContextConfigImpl(tls_context, factory_context).kernelTlsOffload());
+}
+
 // Validate that values other than a hex-encoded SHA-256 fail config validation.
 TEST_F(ClientContextConfigImplTest, InvalidCertificateHash) {
   envoy::extensions::transport_sockets::tls::v3::UpstreamTlsContext tls_context;
@@ -1799,6 +1809,44 @@ TEST_F(ServerContextConfigImplTest, MultipleTlsCertificates) {
   EXPECT_THAT(tls_certs[1].get().privateKeyPath(), EndsWith("selfsigned_ecdsa_p256_key.pem"));
 }
 
+TEST_F(ServerContextConfigImplTest, DynamicRecordSizing) {
+  envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext tls_context;
+  const std::string tls_certificate_yaml = R"EOF(
+  certificate_chain:
+    filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/selfsigned_cert.pem"
+  private_key:
+    filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/selfsigned_key.pem"
+  )EOF";
+  TestUtility::loadFromYaml(TestEnvironment::substitute(tls_certificate_yaml),
+                            *tls_context.mutable_common_tls_context()->add_tls_certificates());
+  {
+    ServerContextConfigImpl server_context_config(tls_context, factory_context_);
+    EXPECT_FALSE(server_context_config.dynamicRecordSizing().has_value());
+  }
+
+  tls_context.mutable_dynamic_record_sizing();
+  {
+    ServerContextConfigImpl server_context_config(tls_context, factory_context_);
+    const auto sizing = server_context_config.dynamicRecordSizing();
+    ASSERT_TRUE(sizing.has_value());
+    EXPECT_EQ(1300, sizing->small_record_size_);
+    EXPECT_EQ(64 * 1024, sizing->small_record_bytes_);
+    EXPECT_EQ(std::chrono::seconds(1), sizing->idle_timeout_);
+  }
+
+  tls_context.mutable_dynamic_record_sizing()->mutable_small_record_size()->set_value(4096);
+  tls_context.mutable_dynamic_record_sizing()->mutable_small_record_bytes()->set_value(1024);
+  tls_context.mutable_dynamic_record_sizing()->mutable_idle_timeout()->set_seconds(5);
+  {
+    ServerContextConfigImpl server_context_config(tls_context, factory_context_);
+    const auto sizing = server_context_config.dynamicRecordSizing();
+    ASSERT_TRUE(sizing.has_value());
+    EXPECT_EQ(4096, sizing->small_record_size_);
+    EXPECT_EQ(1024, sizing->small_record_bytes_);
+    EXPECT_EQ(std::chrono::seconds(5), sizing->idle_timeout_);
+  }
+}
+
 TEST_F(ServerContextConfigImplTest, TlsCertificatesAndSdsConfig) {
   envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext tls_context;
   EXPECT_THROW_WITH_MESSAGE(
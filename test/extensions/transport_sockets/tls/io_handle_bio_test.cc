@@ -35,6 +35,16 @@ TEST_F(IoHandleBioTest, WriteError) {
   EXPECT_EQ(ERR_GET_REASON(err), 100);
 }
 
+TEST_F(IoHandleBioTest, WriteDisabled) {
+  BIO_io_handle_disable_write(bio_);
+  EXPECT_CALL(io_handle_, writev(_, _)).Times(0);
+  EXPECT_EQ(-1, bio_->method->bwrite(bio_, nullptr, 10));
+  EXPECT_FALSE(BIO_should_retry(bio_));
+  const int err = ERR_get_error();
+  EXPECT_EQ(ERR_GET_LIB(err), ERR_LIB_SYS);
+  EXPECT_EQ(ERR_GET_REASON(err), EPIPE);
+}
+
 TEST_F(IoHandleBioTest, TestMiscApis) {
   EXPECT_EQ(bio_->method->destroy(nullptr), 0);
   EXPECT_EQ(bio_->method->bread(nullptr, nullptr, 0), 0);
@@ -0,0 +1,199 @@
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+
+#include <string>
+#include <tuple>
+
+#include "source/common/buffer/buffer_impl.h"
+#include "source/common/network/io_socket_handle_impl.h"
+#include "source/extensions/transport_sockets/tls/kernel_tls.h"
+
+#include "test/test_common/environment.h"
+
+#include "gtest/gtest.h"
+#include "openssl/err.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+// Runs a TLS connection between two BoringSSL instances over loopback TCP, and hands the
+// encryption of the records the server sends over to the kernel. The tests are skipped when the
+// kernel does not support it, e.g. when the tls module is not loaded.
+class KernelTlsTest : public testing::TestWithParam<std::tuple<uint16_t, std::string>> {
+protected:
+  void SetUp() override {
+    const int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+    ASSERT_GE(listener, 0);
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t addr_len = sizeof(addr);
+    ASSERT_EQ(0, ::bind(listener, reinterpret_cast<sockaddr*>(&addr), addr_len));
+    ASSERT_EQ(0, ::listen(listener, 1));
+    ASSERT_EQ(0, ::getsockname(listener, reinterpret_cast<sockaddr*>(&addr), &addr_len));
+    client_fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    ASSERT_GE(client_fd_, 0);
+    ::connect(client_fd_, reinterpret_cast<sockaddr*>(&addr), addr_len);
+    const int server_fd = ::accept4(listener, nullptr, nullptr, SOCK_NONBLOCK);
+    ::close(listener);
+    ASSERT_GE(server_fd, 0);
+    server_io_handle_ = std::make_unique<Network::IoSocketHandleImpl>(server_fd);
+
+    const uint16_t version = std::get<0>(GetParam());
+    const std::string& cipher = std::get<1>(GetParam());
+    server_ctx_.reset(SSL_CTX_new(TLS_method()));
+    ASSERT_EQ(1, SSL_CTX_set_min_proto_version(server_ctx_.get(), version));
+    ASSERT_EQ(1, SSL_CTX_set_max_proto_version(server_ctx_.get(), version));
+    if (!cipher.empty()) {
+      ASSERT_EQ(1, SSL_CTX_set_strict_cipher_list(server_ctx_.get(), cipher.c_str()));
+    }
+    ASSERT_EQ(1, SSL_CTX_use_certificate_file(
+                     server_ctx_.get(),
+                     TestEnvironment::substitute("{{ test_rundir }}/test/extensions/"
+                                                 "transport_sockets/tls/test_data/san_dns_cert.pem")
+                         .c_str(),
+                     SSL_FILETYPE_PEM));
+    ASSERT_EQ(1, SSL_CTX_use_PrivateKey_file(
+                     server_ctx_.get(),
+                     TestEnvironment::substitute("{{ test_rundir }}/test/extensions/"
+                                                 "transport_sockets/tls/test_data/san_dns_key.pem")
+                         .c_str(),
+                     SSL_FILETYPE_PEM));
+    client_ctx_.reset(SSL_CTX_new(TLS_method()));
+
+    server_ssl_.reset(SSL_new(server_ctx_.get()));
+    SSL_set_fd(server_ssl_.get(), server_fd);
+    SSL_set_accept_state(server_ssl_.get());
+    client_ssl_.reset(SSL_new(client_ctx_.get()));
+    SSL_set_fd(client_ssl_.get(), client_fd_);
+    SSL_set_connect_state(client_ssl_.get());
+
+    bool client_done = false;
+    bool server_done = false;
+    while (!client_done || !server_done) {
+      client_done = client_done || handshakeStep(client_ssl_.get());
+      server_done = server_done || handshakeStep(server_ssl_.get());
+    }
+  }
+
+  void TearDown() override { ::close(client_fd_); }
+
+  static bool handshakeStep(SSL* ssl) {
+    const int rc = SSL_do_handshake(ssl);
+    if (rc == 1) {
+      return true;
+    }
+    const int err = SSL_get_error(ssl, rc);
+    RELEASE_ASSERT(err == SSL_ERROR_WANT_READ || err == SSL_ERROR_WANT_WRITE,
+                   absl::StrCat("handshake failed: ", err));
+    return false;
+  }
+
+  // Reads from an SSL until length bytes were received, or the connection was closed.
+  static std::string read(SSL* ssl, int fd, size_t length) {
+    std::string received;
+    char buf[16384];
+    while (received.size() < length) {
+      const int rc = SSL_read(ssl, buf, sizeof(buf));
+      if (rc > 0) {
+        received.append(buf, rc);
+        continue;
+      }
+      if (SSL_get_error(ssl, rc) != SSL_ERROR_WANT_READ) {
+        break;
+      }
+      pollfd pfd{fd, POLLIN, 0};
+      ::poll(&pfd, 1, 1000);
+    }
+    return received;
+  }
+
+  int client_fd_{-1};
+  Network::IoHandlePtr server_io_handle_;
+  bssl::UniquePtr<SSL_CTX> server_ctx_;
+  bssl::UniquePtr<SSL_CTX> client_ctx_;
+  bssl::UniquePtr<SSL> server_ssl_;
+  bssl::UniquePtr<SSL> client_ssl_;
+};
+
+INSTANTIATE_TEST_SUITE_P(
+    Ciphers, KernelTlsTest,
+    testing::Values(std::make_tuple(TLS1_2_VERSION, "ECDHE-RSA-AES128-GCM-SHA256"),
+                    std::make_tuple(TLS1_2_VERSION, "ECDHE-RSA-AES256-GCM-SHA384"),
+                    std::make_tuple(TLS1_2_VERSION, "ECDHE-RSA-CHACHA20-POLY1305")));
+
+TEST_P(KernelTlsTest, SendThroughKernel) {
+  // Records sent by BoringSSL before the kernel takes over advance the sequence number, which the
+  // kernel must continue from.
+  const std::string before = "sent by BoringSSL";
+  ASSERT_EQ(static_cast<int>(before.size()),
+            SSL_write(server_ssl_.get(), before.data(), before.size()));
+  EXPECT_EQ(before, read(client_ssl_.get(), client_fd_, before.size()));
+
+  if (!KernelTls::enableTx(server_ssl_.get(), *server_io_handle_)) {
+    GTEST_SKIP() << "kTLS is not supported for " << SSL_get_cipher_name(server_ssl_.get());
+  }
+
+  // Several records, written as plaintext.
+  const std::string payload(100000, 'a');
+  Buffer::OwnedImpl buffer(payload);
+  std::string received;
+  while (buffer.length() > 0) {
+    Api::IoCallUint64Result result = server_io_handle_->write(buffer);
+    ASSERT_TRUE(result.ok() || result.err_->getErrorCode() == Api::IoError::IoErrorCode::Again);
+    received += read(client_ssl_.get(), client_fd_, payload.size() - buffer.length() -
+                                                        received.size());
+  }
+  EXPECT_EQ(payload, received);
+
+  // The records received are still decrypted by BoringSSL.
+  const std::string request = "sent by the client";
+  ASSERT_EQ(static_cast<int>(request.size()),
+            SSL_write(client_ssl_.get(), request.data(), request.size()));
+  EXPECT_EQ(request, read(server_ssl_.get(), server_io_handle_->fdDoNotUse(), request.size()));
+
+  KernelTls::sendCloseNotify(*server_io_handle_);
+  char buf[1];
+  int rc;
+  do {
+    pollfd pfd{client_fd_, POLLIN, 0};
+    ::poll(&pfd, 1, 1000);
+    rc = SSL_read(client_ssl_.get(), buf, sizeof(buf));
+  } while (rc < 0 && SSL_get_error(client_ssl_.get(), rc) == SSL_ERROR_WANT_READ);
+  EXPECT_EQ(0, rc);
+  EXPECT_EQ(SSL_ERROR_ZERO_RETURN, SSL_get_error(client_ssl_.get(), rc));
+}
+
+using KernelTls13Test = KernelTlsTest;
+
+INSTANTIATE_TEST_SUITE_P(Tls13, KernelTls13Test,
+                         testing::Values(std::make_tuple(TLS1_3_VERSION, "")));
+
+// TLS 1.3 is not handed over to the kernel, so that BoringSSL answers a KeyUpdate requested by the
+// peer with its own, and sends the following records with the new write keys.
+TEST_P(KernelTls13Test, KeyUpdateRequestedByPeer) {
+  ASSERT_GE(SSL_write(server_ssl_.get(), nullptr, 0), 0);
+  EXPECT_FALSE(KernelTls::enableTx(server_ssl_.get(), *server_io_handle_));
+
+  ASSERT_EQ(1, SSL_key_update(client_ssl_.get(), SSL_KEY_UPDATE_REQUESTED));
+  const std::string request = "sent after the KeyUpdate";
+  ASSERT_EQ(static_cast<int>(request.size()),
+            SSL_write(client_ssl_.get(), request.data(), request.size()));
+  EXPECT_EQ(request, read(server_ssl_.get(), server_io_handle_->fdDoNotUse(), request.size()));
+
+  const std::string response = "sent with the new keys";
+  ASSERT_EQ(static_cast<int>(response.size()),
+            SSL_write(server_ssl_.get(), response.data(), response.size()));
+  EXPECT_EQ(response, read(client_ssl_.get(), client_fd_, response.size()));
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
@@ -0,0 +1,98 @@
+#include <chrono>
+#include <string>
+
+#include "source/extensions/transport_sockets/tls/session_cache.h"
+
+#include "test/test_common/simulated_time_system.h"
+
+#include "gtest/gtest.h"
+#include "openssl/ssl.h"
+
+namespace Envoy {
+namespace Extensions {
+namespace TransportSockets {
+namespace Tls {
+namespace {
+
+class SessionCacheTest : public testing::Test {
+protected:
+  SessionCacheTest() : ctx_(SSL_CTX_new(TLS_method())) {}
+
+  bssl::UniquePtr<SSL_SESSION> newSession(absl::string_view id, uint32_t timeout = 300) {
+    bssl::UniquePtr<SSL_SESSION> session(SSL_SESSION_new(ctx_.get()));
+    EXPECT_EQ(1, SSL_SESSION_set1_id(session.get(), reinterpret_cast<const uint8_t*>(id.data()),
+                                     id.size()));
+    SSL_SESSION_set_timeout(session.get(), timeout);
+    return session;
+  }
+
+  Event::SimulatedTimeSystem time_system_;
+  bssl::UniquePtr<SSL_CTX> ctx_;
+};
+
+TEST_F(SessionCacheTest, Lookup) {
+  SessionCache cache(time_system_);
+  bssl::UniquePtr<SSL_SESSION> session = newSession("session1");
+  SSL_SESSION* expected = session.get();
+  cache.insert(std::move(session));
+  cache.insert(newSession("session2"));
+  EXPECT_EQ(2, cache.size());
+
+  bssl::UniquePtr<SSL_SESSION> found = cache.lookup("session1");
+  EXPECT_EQ(expected, found.get());
+  EXPECT_EQ(nullptr, cache.lookup("session3"));
+}
+
+TEST_F(SessionCacheTest, Replace) {
+  SessionCache cache(time_system_);
+  cache.insert(newSession("session1"));
+  bssl::UniquePtr<SSL_SESSION> session = newSession("session1");
+  SSL_SESSION* expected = session.get();
+  cache.insert(std::move(session));
+  EXPECT_EQ(1, cache.size());
+  EXPECT_EQ(expected, cache.lookup("session1").get());
+}
+
+TEST_F(SessionCacheTest, Expiry) {
+  SessionCache cache(time_system_);
+  cache.insert(newSession("session1", 10));
+  cache.insert(newSession("session2", 100));
+
+  time_system_.advanceTimeWait(std::chrono::seconds(10));
+  EXPECT_EQ(nullptr, cache.lookup("session1"));
+  EXPECT_NE(nullptr, cache.lookup("session2"));
+  EXPECT_EQ(1, cache.size());
+}
+
+TEST_F(SessionCacheTest, EvictLeastRecentlyUsed) {
+  SessionCache cache(time_system_, 2, 1);
+  cache.insert(newSession("session1"));
+  cache.insert(newSession("session2"));
+  // session1 is now used more recently than session2.
+  EXPECT_NE(nullptr, cache.lookup("session1"));
+  cache.insert(newSession("session3"));
+
+  EXPECT_EQ(2, cache.size());
+  EXPECT_NE(nullptr, cache.lookup("session1"));
+  EXPECT_EQ(nullptr, cache.lookup("session2"));
+  EXPECT_NE(nullptr, cache.lookup("session3"));
+}
+
+// A session looked up stays valid after it is evicted.
+TEST_F(SessionCacheTest, LookupOutlivesEviction) {
+  SessionCache cache(time_system_, 1, 1);
+  cache.insert(newSession("session1"));
+  bssl::UniquePtr<SSL_SESSION> found = cache.lookup("session1");
+  cache.insert(newSession("session2"));
+  EXPECT_EQ(nullptr, cache.lookup("session1"));
+
+  unsigned int id_length;
+  const uint8_t* id = SSL_SESSION_get_id(found.get(), &id_length);
+  EXPECT_EQ("session1", std::string(reinterpret_cast<const char*>(id), id_length));
+}
+
+} // namespace
+} // namespace Tls
+} // namespace TransportSockets
+} // namespace Extensions
+} // namespace Envoy
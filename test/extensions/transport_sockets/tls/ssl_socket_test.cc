@@ -3268,6 +3268,214 @@ TEST_P(SslSocketTest, ShutdownWithCloseNotify) {
   dispatcher_->run(Event::Dispatcher::RunType::Block);
 }
 
+// A TLS 1.2 server with kTLS enabled sends data right after the handshake. The kernel may not
+// support kTLS, in which case BoringSSL keeps encrypting the records.
+TEST_P(SslSocketTest, KernelTlsOffload) {
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    kernel_tls_offload: true
+    tls_params:
+      tls_maximum_protocol_version: TLSv1_2
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/unittest_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/unittest_key.pem"
+)EOF";
+
+  envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext server_tls_context;
+  TestUtility::loadFromYaml(TestEnvironment::substitute(server_ctx_yaml), server_tls_context);
+  auto server_cfg = std::make_unique<ServerContextConfigImpl>(server_tls_context, factory_context_);
+  ContextManagerImpl manager(time_system_);
+  Stats::TestUtil::TestStore server_stats_store;
+  ServerSslSocketFactory server_ssl_socket_factory(
+      std::move(server_cfg), manager, *server_stats_store.rootScope(), std::vector<std::string>{});
+
+  auto socket = std::make_shared<Network::Test::TcpListenSocketImmediateListen>(
+      Network::Test::getCanonicalLoopbackAddress(version_));
+  Network::MockTcpListenerCallbacks listener_callbacks;
+  NiceMock<Network::MockListenerConfig> listener_config;
+  Server::ThreadLocalOverloadStateOptRef overload_state;
+  Network::ListenerPtr listener = dispatcher_->createListener(socket, listener_callbacks, runtime_,
+                                                              listener_config, overload_state);
+  std::shared_ptr<Network::MockReadFilter> server_read_filter(new Network::MockReadFilter());
+  std::shared_ptr<Network::MockReadFilter> client_read_filter(new Network::MockReadFilter());
+
+  const std::string client_ctx_yaml = R"EOF(
+    common_tls_context: {}
+  )EOF";
+
+  envoy::extensions::transport_sockets::tls::v3::UpstreamTlsContext tls_context;
+  TestUtility::loadFromYaml(TestEnvironment::substitute(client_ctx_yaml), tls_context);
+  auto client_cfg = std::make_unique<ClientContextConfigImpl>(tls_context, factory_context_);
+  Stats::TestUtil::TestStore client_stats_store;
+  ClientSslSocketFactory client_ssl_socket_factory(std::move(client_cfg), manager,
+                                                   *client_stats_store.rootScope());
+  Network::ClientConnectionPtr client_connection = dispatcher_->createClientConnection(
+      socket->connectionInfoProvider().localAddress(), Network::Address::InstanceConstSharedPtr(),
+      client_ssl_socket_factory.createTransportSocket(nullptr, nullptr), nullptr, nullptr);
+  Network::MockConnectionCallbacks client_connection_callbacks;
+  client_connection->enableHalfClose(true);
+  client_connection->addReadFilter(client_read_filter);
+  client_connection->addConnectionCallbacks(client_connection_callbacks);
+  client_connection->connect();
+
+  Network::ConnectionPtr server_connection;
+  Network::MockConnectionCallbacks server_connection_callbacks;
+  EXPECT_CALL(listener_callbacks, onAccept_(_))
+      .WillOnce(Invoke([&](Network::ConnectionSocketPtr& socket) -> void {
+        server_connection = dispatcher_->createServerConnection(
+            std::move(socket), server_ssl_socket_factory.createDownstreamTransportSocket(),
+            stream_info_);
+        server_connection->enableHalfClose(true);
+        server_connection->addReadFilter(server_read_filter);
+        server_connection->addConnectionCallbacks(server_connection_callbacks);
+      }));
+  EXPECT_CALL(listener_callbacks, recordConnectionsAcceptedOnSocketEvent(_));
+  EXPECT_CALL(*server_read_filter, onNewConnection());
+  EXPECT_CALL(server_connection_callbacks, onEvent(Network::ConnectionEvent::Connected))
+      .WillOnce(Invoke([&](Network::ConnectionEvent) -> void {
+        Buffer::OwnedImpl data("hello");
+        server_connection->write(data, true);
+        EXPECT_EQ(data.length(), 0);
+      }));
+
+  EXPECT_CALL(*client_read_filter, onNewConnection())
+      .WillOnce(Return(Network::FilterStatus::Continue));
+  EXPECT_CALL(client_connection_callbacks, onEvent(Network::ConnectionEvent::Connected));
+  EXPECT_CALL(*client_read_filter, onData(BufferStringEqual("hello"), true))
+      .WillOnce(Invoke([&](Buffer::Instance& read_buffer, bool) -> Network::FilterStatus {
+        read_buffer.drain(read_buffer.length());
+        client_connection->close(Network::ConnectionCloseType::NoFlush);
+        return Network::FilterStatus::StopIteration;
+      }));
+  EXPECT_CALL(*server_read_filter, onData(_, true));
+
+  EXPECT_CALL(client_connection_callbacks, onEvent(Network::ConnectionEvent::LocalClose));
+  EXPECT_CALL(server_connection_callbacks, onEvent(Network::ConnectionEvent::RemoteClose))
+      .WillOnce(Invoke([&](Network::ConnectionEvent) -> void {
+        server_connection->close(Network::ConnectionCloseType::NoFlush);
+        dispatcher_->exit();
+      }));
+
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+
+  EXPECT_EQ(1UL, server_stats_store.counter("ssl.ktls_tx_enabled").value() +
+                     server_stats_store.counter("ssl.ktls_tx_unsupported").value());
+  EXPECT_EQ(0UL, server_stats_store.counter("ssl.connection_error").value());
+  EXPECT_EQ(0UL, client_stats_store.counter("ssl.connection_error").value());
+}
+
+// TLS 1.3 connections are not offloaded, so that the server answers a KeyUpdate requested by the
+// client and keeps sending records.
+TEST_P(SslSocketTest, KernelTlsOffloadTls13KeyUpdate) {
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    kernel_tls_offload: true
+    tls_params:
+      tls_minimum_protocol_version: TLSv1_3
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/unittest_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/unittest_key.pem"
+)EOF";
+
+  envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext server_tls_context;
+  TestUtility::loadFromYaml(TestEnvironment::substitute(server_ctx_yaml), server_tls_context);
+  auto server_cfg = std::make_unique<ServerContextConfigImpl>(server_tls_context, factory_context_);
+  ContextManagerImpl manager(time_system_);
+  Stats::TestUtil::TestStore server_stats_store;
+  ServerSslSocketFactory server_ssl_socket_factory(
+      std::move(server_cfg), manager, *server_stats_store.rootScope(), std::vector<std::string>{});
+
+  auto socket = std::make_shared<Network::Test::TcpListenSocketImmediateListen>(
+      Network::Test::getCanonicalLoopbackAddress(version_));
+  Network::MockTcpListenerCallbacks listener_callbacks;
+  NiceMock<Network::MockListenerConfig> listener_config;
+  Server::ThreadLocalOverloadStateOptRef overload_state;
+  Network::ListenerPtr listener = dispatcher_->createListener(socket, listener_callbacks, runtime_,
+                                                              listener_config, overload_state);
+  std::shared_ptr<Network::MockReadFilter> server_read_filter(new Network::MockReadFilter());
+  std::shared_ptr<Network::MockReadFilter> client_read_filter(new Network::MockReadFilter());
+
+  const std::string client_ctx_yaml = R"EOF(
+    common_tls_context:
+      tls_params:
+        tls_minimum_protocol_version: TLSv1_3
+  )EOF";
+
+  envoy::extensions::transport_sockets::tls::v3::UpstreamTlsContext tls_context;
+  TestUtility::loadFromYaml(TestEnvironment::substitute(client_ctx_yaml), tls_context);
+  auto client_cfg = std::make_unique<ClientContextConfigImpl>(tls_context, factory_context_);
+  Stats::TestUtil::TestStore client_stats_store;
+  ClientSslSocketFactory client_ssl_socket_factory(std::move(client_cfg), manager,
+                                                   *client_stats_store.rootScope());
+  Network::ClientConnectionPtr client_connection = dispatcher_->createClientConnection(
+      socket->connectionInfoProvider().localAddress(), Network::Address::InstanceConstSharedPtr(),
+      client_ssl_socket_factory.createTransportSocket(nullptr, nullptr), nullptr, nullptr);
+  Network::MockConnectionCallbacks client_connection_callbacks;
+  client_connection->enableHalfClose(true);
+  client_connection->addReadFilter(client_read_filter);
+  client_connection->addConnectionCallbacks(client_connection_callbacks);
+  client_connection->connect();
+
+  Network::ConnectionPtr server_connection;
+  Network::MockConnectionCallbacks server_connection_callbacks;
+  EXPECT_CALL(listener_callbacks, onAccept_(_))
+      .WillOnce(Invoke([&](Network::ConnectionSocketPtr& socket) -> void {
+        server_connection = dispatcher_->createServerConnection(
+            std::move(socket), server_ssl_socket_factory.createDownstreamTransportSocket(),
+            stream_info_);
+        server_connection->enableHalfClose(true);
+        server_connection->addReadFilter(server_read_filter);
+        server_connection->addConnectionCallbacks(server_connection_callbacks);
+      }));
+  EXPECT_CALL(listener_callbacks, recordConnectionsAcceptedOnSocketEvent(_));
+  EXPECT_CALL(*server_read_filter, onNewConnection());
+  EXPECT_CALL(server_connection_callbacks, onEvent(Network::ConnectionEvent::Connected));
+
+  EXPECT_CALL(*client_read_filter, onNewConnection())
+      .WillOnce(Return(Network::FilterStatus::Continue));
+  EXPECT_CALL(client_connection_callbacks, onEvent(Network::ConnectionEvent::Connected))
+      .WillOnce(Invoke([&](Network::ConnectionEvent) -> void {
+        // The KeyUpdate is sent along with the data.
+        const SslHandshakerImpl* ssl_socket =
+            dynamic_cast<const SslHandshakerImpl*>(client_connection->ssl().get());
+        EXPECT_EQ(1, SSL_key_update(ssl_socket->ssl(), SSL_KEY_UPDATE_REQUESTED));
+        Buffer::OwnedImpl data("ping");
+        client_connection->write(data, false);
+      }));
+  EXPECT_CALL(*server_read_filter, onData(BufferStringEqual("ping"), false))
+      .WillOnce(Invoke([&](Buffer::Instance& read_buffer, bool) -> Network::FilterStatus {
+        read_buffer.drain(read_buffer.length());
+        Buffer::OwnedImpl data("pong");
+        server_connection->write(data, true);
+        return Network::FilterStatus::StopIteration;
+      }));
+  EXPECT_CALL(*client_read_filter, onData(BufferStringEqual("pong"), true))
+      .WillOnce(Invoke([&](Buffer::Instance& read_buffer, bool) -> Network::FilterStatus {
+        read_buffer.drain(read_buffer.length());
+        client_connection->close(Network::ConnectionCloseType::NoFlush);
+        return Network::FilterStatus::StopIteration;
+      }));
+  EXPECT_CALL(*server_read_filter, onData(_, true));
+
+  EXPECT_CALL(client_connection_callbacks, onEvent(Network::ConnectionEvent::LocalClose));
+  EXPECT_CALL(server_connection_callbacks, onEvent(Network::ConnectionEvent::RemoteClose))
+      .WillOnce(Invoke([&](Network::ConnectionEvent) -> void {
+        server_connection->close(Network::ConnectionCloseType::NoFlush);
+        dispatcher_->exit();
+      }));
+
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+
+  EXPECT_EQ(0UL, server_stats_store.counter("ssl.ktls_tx_enabled").value());
+  EXPECT_EQ(1UL, server_stats_store.counter("ssl.ktls_tx_unsupported").value());
+  EXPECT_EQ(0UL, server_stats_store.counter("ssl.connection_error").value());
+  EXPECT_EQ(0UL, client_stats_store.counter("ssl.connection_error").value());
+}
+
 TEST_P(SslSocketTest, ShutdownWithoutCloseNotify) {
   const std::string server_ctx_yaml = R"EOF(
   common_tls_context:
@@ -3471,7 +3679,8 @@ void testTicketSessionResumption(const std::string& server_ctx_yaml1,
                                  const std::vector<std::string>& server_names2,
                                  const std::string& client_ctx_yaml, bool expect_reuse,
                                  const Network::Address::IpVersion ip_version,
-                                 const uint32_t expected_lifetime_hint = 0) {
+                                 const uint32_t expected_lifetime_hint = 0,
+                                 const uint64_t expected_session_cache_hits = 0) {
   Event::SimulatedTimeSystem time_system;
   ContextManagerImpl manager(*time_system);
 
@@ -3622,6 +3831,8 @@ void testTicketSessionResumption(const std::string& server_ctx_yaml1,
 
   EXPECT_EQ(expect_reuse ? 1UL : 0UL, server_stats_store.counter("ssl.session_reused").value());
   EXPECT_EQ(expect_reuse ? 1UL : 0UL, client_stats_store.counter("ssl.session_reused").value());
+  EXPECT_EQ(expected_session_cache_hits,
+            server_stats_store.counter("ssl.session_cache_hit").value());
 }
 
 void testSupportForSessionResumption(const std::string& server_ctx_yaml,
@@ -4157,6 +4368,30 @@ TEST_P(SslSocketTest, TicketSessionResumptionDifferentServerCertDifferentSAN) {
                               version_);
 }
 
+// The session ID of a TLS 1.2 session is resumed through another server context, as contexts
+// setting shared_session_cache look sessions up in the cache of the context manager.
+TEST_P(SslSocketTest, SharedSessionCacheResumption) {
+  const std::string server_ctx_yaml = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/unittest_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/unittest_key.pem"
+  disable_stateless_session_resumption: true
+  shared_session_cache: true
+)EOF";
+
+  const std::string client_ctx_yaml = R"EOF(
+    common_tls_context:
+      tls_params:
+        tls_maximum_protocol_version: TLSv1_2
+  )EOF";
+
+  testTicketSessionResumption(server_ctx_yaml, {}, server_ctx_yaml, {}, client_ctx_yaml, true,
+                              version_, 0, 1);
+}
+
 TEST_P(SslSocketTest, SessionResumptionDisabled) {
   const std::string server_ctx_yaml = R"EOF(
   common_tls_context:
@@ -6226,6 +6461,189 @@ TEST_P(SslReadBufferLimitTest, SmallReadsIntoSameSlice) {
   dispatcher_->run(Event::Dispatcher::RunType::Block);
 }
 
+// Writes from a server sending its first bytes, and the first bytes after idle periods, in small
+// records. The records are counted by the stats of the server, and the time of the dispatcher is
+// simulated.
+class SslDynamicRecordSizingTest : public SslSocketTest {
+protected:
+  void initialize() {
+    envoy::extensions::transport_sockets::tls::v3::DownstreamTlsContext server_tls_context;
+    TestUtility::loadFromYaml(TestEnvironment::substitute(server_ctx_yaml_), server_tls_context);
+    auto server_cfg =
+        std::make_unique<ServerContextConfigImpl>(server_tls_context, factory_context_);
+    manager_ = std::make_unique<ContextManagerImpl>(time_system_);
+    server_ssl_socket_factory_ = std::make_unique<ServerSslSocketFactory>(
+        std::move(server_cfg), *manager_, *server_stats_store_.rootScope(),
+        std::vector<std::string>{});
+
+    socket_ = std::make_shared<Network::Test::TcpListenSocketImmediateListen>(
+        Network::Test::getCanonicalLoopbackAddress(version_));
+    NiceMock<Network::MockListenerConfig> listener_config;
+    Server::ThreadLocalOverloadStateOptRef overload_state;
+    listener_ = dispatcher_->createListener(socket_, listener_callbacks_, runtime_, listener_config,
+                                            overload_state);
+
+    envoy::extensions::transport_sockets::tls::v3::UpstreamTlsContext client_tls_context;
+    auto client_cfg =
+        std::make_unique<ClientContextConfigImpl>(client_tls_context, factory_context_);
+    client_ssl_socket_factory_ = std::make_unique<ClientSslSocketFactory>(
+        std::move(client_cfg), *manager_, *client_stats_store_.rootScope());
+    client_connection_ = dispatcher_->createClientConnection(
+        socket_->connectionInfoProvider().localAddress(),
+        Network::Address::InstanceConstSharedPtr(),
+        client_ssl_socket_factory_->createTransportSocket(nullptr, nullptr), nullptr, nullptr);
+    client_connection_->addConnectionCallbacks(client_callbacks_);
+    client_read_filter_ = std::make_shared<Network::MockReadFilter>();
+    client_connection_->addReadFilter(client_read_filter_);
+    client_connection_->connect();
+
+    EXPECT_CALL(listener_callbacks_, onAccept_(_))
+        .WillOnce(Invoke([&](Network::ConnectionSocketPtr& socket) -> void {
+          server_connection_ = dispatcher_->createServerConnection(
+              std::move(socket), server_ssl_socket_factory_->createDownstreamTransportSocket(),
+              stream_info_);
+          server_connection_->setBufferLimits(1024 * 1024);
+          server_connection_->addConnectionCallbacks(server_callbacks_);
+        }));
+    EXPECT_CALL(listener_callbacks_, recordConnectionsAcceptedOnSocketEvent(_));
+    EXPECT_CALL(*client_read_filter_, onNewConnection())
+        .WillOnce(Return(Network::FilterStatus::Continue));
+    EXPECT_CALL(*client_read_filter_, onData(_, false))
+        .WillRepeatedly(Invoke([&](Buffer::Instance& data, bool) -> Network::FilterStatus {
+          received_ += data.length();
+          data.drain(data.length());
+          if (received_ == sent_) {
+            dispatcher_->exit();
+          }
+          return Network::FilterStatus::StopIteration;
+        }));
+    // The server closes the connection if it fails to write.
+    ON_CALL(client_callbacks_, onEvent(Network::ConnectionEvent::RemoteClose))
+        .WillByDefault(Invoke([&](Network::ConnectionEvent) -> void { dispatcher_->exit(); }));
+    EXPECT_CALL(client_callbacks_, onEvent(Network::ConnectionEvent::Connected))
+        .WillOnce(Invoke([&](Network::ConnectionEvent) -> void { dispatcher_->exit(); }));
+    dispatcher_->run(Event::Dispatcher::RunType::Block);
+  }
+
+  // Writes from the server, and runs until the client received everything.
+  void write(uint64_t bytes) {
+    sent_ += bytes;
+    Buffer::OwnedImpl data(std::string(bytes, 'a'));
+    server_connection_->write(data, false);
+    dispatcher_->run(Event::Dispatcher::RunType::Block);
+    EXPECT_EQ(sent_, received_);
+  }
+
+  uint64_t smallRecords() { return server_stats_store_.counter("ssl.small_records_sent").value(); }
+  uint64_t largeRecords() { return server_stats_store_.counter("ssl.large_records_sent").value(); }
+
+  void disconnect() {
+    EXPECT_CALL(client_callbacks_, onEvent(Network::ConnectionEvent::LocalClose));
+    EXPECT_CALL(server_callbacks_, onEvent(Network::ConnectionEvent::RemoteClose))
+        .WillOnce(Invoke([&](Network::ConnectionEvent) -> void { dispatcher_->exit(); }));
+    client_connection_->close(Network::ConnectionCloseType::NoFlush);
+    dispatcher_->run(Event::Dispatcher::RunType::Block);
+
+    EXPECT_EQ(0UL, server_stats_store_.counter("ssl.connection_error").value());
+    EXPECT_EQ(0UL, client_stats_store_.counter("ssl.connection_error").value());
+  }
+
+  // Small records of 1000 bytes for the first 4000 bytes.
+  const std::string server_ctx_yaml_ = R"EOF(
+  common_tls_context:
+    tls_certificates:
+      certificate_chain:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/unittest_cert.pem"
+      private_key:
+        filename: "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/unittest_key.pem"
+  dynamic_record_sizing:
+    small_record_size: 1000
+    small_record_bytes: 4000
+    idle_timeout: 1s
+)EOF";
+
+  Stats::TestUtil::TestStore server_stats_store_;
+  Stats::TestUtil::TestStore client_stats_store_;
+  std::unique_ptr<ContextManagerImpl> manager_;
+  Network::DownstreamTransportSocketFactoryPtr server_ssl_socket_factory_;
+  Network::UpstreamTransportSocketFactoryPtr client_ssl_socket_factory_;
+  std::shared_ptr<Network::Test::TcpListenSocketImmediateListen> socket_;
+  NiceMock<Network::MockTcpListenerCallbacks> listener_callbacks_;
+  Network::ListenerPtr listener_;
+  Network::ClientConnectionPtr client_connection_;
+  Network::ConnectionPtr server_connection_;
+  std::shared_ptr<Network::MockReadFilter> client_read_filter_;
+  NiceMock<Network::MockConnectionCallbacks> client_callbacks_;
+  NiceMock<Network::MockConnectionCallbacks> server_callbacks_;
+  uint64_t sent_{};
+  uint64_t received_{};
+};
+
+INSTANTIATE_TEST_SUITE_P(IpVersions, SslDynamicRecordSizingTest,
+                         testing::ValuesIn(TestEnvironment::getIpVersionsForTest()),
+                         TestUtility::ipTestParamsToString);
+
+TEST_P(SslDynamicRecordSizingTest, SmallRecordsThenLargeRecords) {
+  initialize();
+
+  write(4000 + 2 * 16384);
+  EXPECT_EQ(4UL, smallRecords());
+  EXPECT_EQ(2UL, largeRecords());
+
+  // The connection was not idle long enough for the records to be small again.
+  time_system_.advanceTimeAndRun(std::chrono::milliseconds(500), *dispatcher_,
+                                 Event::Dispatcher::RunType::NonBlock);
+  write(16384);
+  EXPECT_EQ(4UL, smallRecords());
+  EXPECT_EQ(3UL, largeRecords());
+
+  disconnect();
+}
+
+TEST_P(SslDynamicRecordSizingTest, IdleResetsSmallRecords) {
+  initialize();
+
+  write(4000 + 16384);
+  EXPECT_EQ(4UL, smallRecords());
+  EXPECT_EQ(1UL, largeRecords());
+
+  time_system_.advanceTimeAndRun(std::chrono::seconds(1), *dispatcher_,
+                                 Event::Dispatcher::RunType::NonBlock);
+  write(4000 + 16384);
+  EXPECT_EQ(8UL, smallRecords());
+  EXPECT_EQ(2UL, largeRecords());
+
+  disconnect();
+}
+
+// SSL_write() must be retried with the size of the record it failed to send, even if the records
+// became small meanwhile.
+TEST_P(SslDynamicRecordSizingTest, RetryKeepsRecordSize) {
+  initialize();
+
+  // The client does not read, so the server stops writing in the middle of a large record once
+  // the socket is full.
+  client_connection_->readDisable(true);
+  const uint64_t bytes = 32 * 1024 * 1024;
+  sent_ += bytes;
+  Buffer::OwnedImpl data(std::string(bytes, 'a'));
+  server_connection_->write(data, false);
+  dispatcher_->run(Event::Dispatcher::RunType::NonBlock);
+  ASSERT_TRUE(server_connection_->aboveHighWatermark());
+  EXPECT_EQ(4UL, smallRecords());
+
+  // The record is retried once the connection was idle long enough for the records to be small.
+  time_system_.advanceTimeAndRun(std::chrono::seconds(2), *dispatcher_,
+                                 Event::Dispatcher::RunType::NonBlock);
+  client_connection_->readDisable(false);
+  dispatcher_->run(Event::Dispatcher::RunType::Block);
+  EXPECT_EQ(sent_, received_);
+  // The retried record is sent whole, and is the only record of the new small phase.
+  EXPECT_EQ(5UL, smallRecords());
+
+  disconnect();
+}
+
 // Test asynchronous signing (ECDHE) using a private key provider.
 TEST_P(SslSocketTest, RsaPrivateKeyProviderAsyncSignSuccess) {
   const std::string server_ctx_yaml = R"EOF(
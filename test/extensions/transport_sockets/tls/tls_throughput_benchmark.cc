@@ -1,4 +1,10 @@
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
 #include "source/common/buffer/buffer_impl.h"
+#include "source/common/network/io_socket_handle_impl.h"
+#include "source/extensions/transport_sockets/tls/kernel_tls.h"
 
 #include "test/test_common/environment.h"
 
@@ -64,17 +70,50 @@ static void addFullSlices(Buffer::Instance& output_buffer, unsigned num_slices,
   }
 }
 
+// kTLS needs TCP sockets. Their buffers are made large enough for a whole iteration, like those of
+// a UNIX socket pair.
+static void tcpSocketPair(int sockets[2]) {
+  const int listener = ::socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in addr{};
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t addr_len = sizeof(addr);
+  RELEASE_ASSERT(::bind(listener, reinterpret_cast<sockaddr*>(&addr), addr_len) == 0, "bind");
+  RELEASE_ASSERT(::listen(listener, 1) == 0, "listen");
+  RELEASE_ASSERT(::getsockname(listener, reinterpret_cast<sockaddr*>(&addr), &addr_len) == 0,
+                 "getsockname");
+  sockets[1] = ::socket(AF_INET, SOCK_STREAM, 0);
+  const int buffer_size = 4 * 1024 * 1024;
+  ::setsockopt(sockets[1], SOL_SOCKET, SO_SNDBUF, &buffer_size, sizeof(buffer_size));
+  RELEASE_ASSERT(::connect(sockets[1], reinterpret_cast<sockaddr*>(&addr), addr_len) == 0,
+                 "connect");
+  sockets[0] = ::accept4(listener, nullptr, nullptr, SOCK_NONBLOCK);
+  RELEASE_ASSERT(sockets[0] >= 0, "accept");
+  ::setsockopt(sockets[0], SOL_SOCKET, SO_RCVBUF, &buffer_size, sizeof(buffer_size));
+  ::fcntl(sockets[1], F_SETFL, ::fcntl(sockets[1], F_GETFL) | O_NONBLOCK);
+  ::close(listener);
+}
+
 static void testThroughput(benchmark::State& state) {
   std::string error;
   std::unique_ptr<bazel::tools::cpp::runfiles::Runfiles> runfiles(
       bazel::tools::cpp::runfiles::Runfiles::Create("tls_throughput_benchmark", &error));
   Envoy::TestEnvironment::setRunfiles(runfiles.get());
 
+  const bool ktls = state.range(4);
   int sockets[2];
-  socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sockets);
+  if (ktls) {
+    tcpSocketPair(sockets);
+  } else {
+    socketpair(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0, sockets);
+  }
 
   bssl::UniquePtr<SSL_CTX> server_ctx(SSL_CTX_new(TLS_method()));
   bssl::UniquePtr<SSL_CTX> client_ctx(SSL_CTX_new(TLS_method()));
+  if (ktls) {
+    // The kernel only takes over TLS 1.2 connections.
+    SSL_CTX_set_max_proto_version(client_ctx.get(), TLS1_2_VERSION);
+  }
   std::string cert_path = TestEnvironment::substitute(
       "{{ test_rundir }}/test/extensions/transport_sockets/tls/test_data/san_dns_cert.pem");
   std::string key_path = TestEnvironment::substitute(
@@ -107,6 +146,17 @@ static void testThroughput(benchmark::State& state) {
 
   RELEASE_ASSERT(handshake_success, "handshake completed successfully");
 
+  // With kTLS, the kernel encrypts the records the client sends, and owns its socket.
+  std::unique_ptr<Network::IoSocketHandleImpl> client_io_handle;
+  if (ktls) {
+    client_io_handle = std::make_unique<Network::IoSocketHandleImpl>(sockets[1]);
+    if (!KernelTls::enableTx(client_ssl.get(), *client_io_handle)) {
+      state.SkipWithError("kTLS is not supported");
+      ::close(sockets[0]);
+      return;
+    }
+  }
+
   static uint8_t read_buf[1024 * 1024];
 
   unsigned short_slice_size = state.range(0);
@@ -149,6 +199,12 @@ static void testThroughput(benchmark::State& state) {
     state.ResumeTiming();
     uint32_t num_writes = 0;
     uint32_t num_times_linearize_did_something = 0;
+    while (ktls && write_buf.length() > 0) {
+      // The slices are written as is, without being linearized.
+      Api::IoCallUint64Result result = client_io_handle->write(write_buf);
+      RELEASE_ASSERT(result.ok(), "write");
+      num_writes++;
+    }
     while (write_buf.length() > 0) {
       const Buffer::RawSlice initial = write_buf.frontSlice();
       void* mem;
@@ -171,19 +227,24 @@ static void testThroughput(benchmark::State& state) {
   state.counters["throughput"] = benchmark::Counter(bytes_written, benchmark::Counter::kIsRate);
 
   ::close(sockets[0]);
-  ::close(sockets[1]);
+  if (!ktls) {
+    ::close(sockets[1]);
+  }
 }
 
+// The last Arg selects whether the records are encrypted by BoringSSL or by the kernel.
 static void testParams(benchmark::internal::Benchmark* b) {
-  for (auto move_slices : {false, true}) {
-    for (auto align_to_16kb : {false, true}) {
-      // Add a single case of no short slices; don't iterate over the sizes
-      // which duplicates test cases when count is zero.
-      b->Args({0, 0, align_to_16kb, move_slices});
-
-      for (auto short_slice_size : {1, 128, 4095, 4096, 4097}) {
-        for (auto num_short_slices : {1, 2, 3}) {
-          b->Args({short_slice_size, num_short_slices, align_to_16kb, move_slices});
+  for (auto ktls : {false, true}) {
+    for (auto move_slices : {false, true}) {
+      for (auto align_to_16kb : {false, true}) {
+        // Add a single case of no short slices; don't iterate over the sizes
+        // which duplicates test cases when count is zero.
+        b->Args({0, 0, align_to_16kb, move_slices, ktls});
+
+        for (auto short_slice_size : {1, 128, 4095, 4096, 4097}) {
+          for (auto num_short_slices : {1, 2, 3}) {
+            b->Args({short_slice_size, num_short_slices, align_to_16kb, move_slices, ktls});
+          }
         }
       }
     }
@@ -394,6 +394,42 @@ TEST_P(HdsIntegrationTest, SingleEndpointHealthyHttp) {
   cleanupHdsConnection();
 }
 
+// Tests that the server shuts down while the HDS health checkers run on the health check threads.
+TEST_P(HdsIntegrationTest, SingleEndpointHealthyHttpOnHealthCheckThreads) {
+  config_helper_.addConfigModifier([](envoy::config::bootstrap::v3::Bootstrap& bootstrap) {
+    bootstrap.mutable_cluster_manager()->set_health_check_threads(2);
+  });
+  initialize();
+
+  // Server <--> Envoy
+  waitForHdsStream();
+  ASSERT_TRUE(hds_stream_->waitForGrpcMessage(*dispatcher_, envoy_msg_));
+
+  // Server asks for health checking
+  server_health_check_specifier_ =
+      makeHttpHealthCheckSpecifier(envoy::type::v3::CodecClientType::HTTP1, false);
+  hds_stream_->startGrpcStream();
+  hds_stream_->sendGrpcMessage(server_health_check_specifier_);
+  test_server_->waitForCounterGe("hds_delegate.requests", ++hds_requests_);
+
+  // Envoy sends a health check message to an endpoint
+  healthcheckEndpoints();
+
+  // Endpoint responds to the health check
+  host_stream_->encodeHeaders(Http::TestResponseHeaderMapImpl{{":status", "200"}}, false);
+  host_stream_->encodeData(1024, true);
+
+  // Receive updates until the one we expect arrives
+  waitForEndpointHealthResponse(envoy::config::core::v3::HEALTHY);
+
+  cleanupHostConnections();
+
+  // The HDS health checkers are destroyed before the health check threads exit, otherwise the
+  // shutdown never completes.
+  test_server_.reset();
+  ASSERT_TRUE(hds_fake_connection_->waitForDisconnect());
+}
+
 // Tests Envoy HTTP health checking a single endpoint that times out and reporting
 // that it is unhealthy to the server.
 TEST_P(HdsIntegrationTest, SingleEndpointTimeoutHttp) {
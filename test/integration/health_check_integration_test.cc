@@ -187,6 +187,10 @@ public:
     health_check->mutable_http_health_check()->set_path("/healthcheck");
     health_check->mutable_http_health_check()->set_codec_client_type(codec_client_type);
     health_check->mutable_unhealthy_threshold()->set_value(unhealthy_threshold);
+    if (!service_name_prefix_.empty()) {
+      health_check->mutable_http_health_check()->mutable_service_name_matcher()->set_prefix(
+          service_name_prefix_);
+    }
     if (retriable_range != nullptr) {
       auto* range = health_check->mutable_http_health_check()->add_retriable_statuses();
       range->set_start(retriable_range->start());
@@ -209,6 +213,9 @@ public:
     EXPECT_EQ(cluster_data.host_stream_->headers().getMethodValue(), "GET");
     EXPECT_EQ(cluster_data.host_stream_->headers().getHostValue(), cluster_data.name_);
   }
+
+  // If set, the health checks verify that the endpoints belong to a cluster with this prefix.
+  std::string service_name_prefix_;
 };
 
 class HttpHealthCheckIntegrationTest : public Event::TestUsingSimulatedTime,
@@ -243,6 +250,29 @@ TEST_P(HttpHealthCheckIntegrationTest, SingleEndpointHealthyHttp) {
   EXPECT_EQ(0, test_server_->counter("cluster.cluster_1.health_check.failure")->value());
 }
 
+// Tests that the HTTP health checks run on the health check threads, which create the codec
+// clients and read the runtime there.
+TEST_P(HttpHealthCheckIntegrationTest, SingleEndpointHealthyHttpOnHealthCheckThreads) {
+  const uint32_t cluster_idx = 0;
+  config_helper_.addConfigModifier([](envoy::config::bootstrap::v3::Bootstrap& bootstrap) {
+    bootstrap.mutable_cluster_manager()->set_health_check_threads(2);
+  });
+  service_name_prefix_ = "cluster_1";
+  initialize();
+  initHttpHealthCheck(cluster_idx);
+
+  clusters_[cluster_idx].host_stream_->encodeHeaders(
+      Http::TestResponseHeaderMapImpl{{":status", "200"},
+                                      {"x-envoy-upstream-healthchecked-cluster", "cluster_1"}},
+      false);
+  clusters_[cluster_idx].host_stream_->encodeData(1024, true);
+
+  test_server_->waitForCounterGe("cluster.cluster_1.health_check.success", 1);
+  EXPECT_EQ(1, test_server_->counter("cluster.cluster_1.health_check.success")->value());
+  EXPECT_EQ(0, test_server_->counter("cluster.cluster_1.health_check.failure")->value());
+  EXPECT_EQ(1, test_server_->counter("cluster.cluster_1.health_check.verify_cluster")->value());
+}
+
 // Tests that an unhealthy endpoint returns a valid HTTP health check response.
 TEST_P(HttpHealthCheckIntegrationTest, SingleEndpointUnhealthyHttp) {
   const uint32_t cluster_idx = 0;
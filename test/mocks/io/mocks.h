@@ -45,6 +45,43 @@ public:
   MOCK_METHOD(void, onCancel, (Request * req, int32_t result, bool injected));
   MOCK_METHOD(void, onShutdown, (Request * req, int32_t result, bool injected));
   MOCK_METHOD(void, injectCompletion, (Request::RequestType type));
+  MOCK_METHOD(void, enableRead, ());
+  MOCK_METHOD(void, disableRead, ());
+  MOCK_METHOD(void, enableCloseEvent, (bool enable));
+  MOCK_METHOD(void, close, (bool keep_fd_open, IoUringSocketOnClosedCb cb));
+  MOCK_METHOD(void, connect, (const Network::Address::InstanceConstSharedPtr& address));
+  MOCK_METHOD(uint64_t, write, (Buffer::Instance & data));
+  MOCK_METHOD(uint64_t, write, (const Buffer::RawSlice* slices, uint64_t num_slice));
+  MOCK_METHOD(void, shutdown, (int how));
+  MOCK_METHOD(void, setFileReadyCb, (Event::FileReadyCb cb));
+  MOCK_METHOD(OptRef<ReadParam>, getReadParam, ());
+  MOCK_METHOD(OptRef<WriteParam>, getWriteParam, ());
+  MOCK_METHOD(OptRef<AcceptedSocketParam>, getAcceptedSocketParam, ());
+  MOCK_METHOD(IoUringSocketStatus, getStatus, (), (const));
+};
+
+class MockIoUringWorker : public IoUringWorker {
+public:
+  MOCK_METHOD(Event::Dispatcher&, dispatcher, ());
+  MOCK_METHOD(IoUringSocket&, addAcceptSocket, (os_fd_t fd, Event::FileReadyCb cb));
+  MOCK_METHOD(IoUringSocket&, addServerSocket, (os_fd_t fd, Event::FileReadyCb cb));
+  MOCK_METHOD(IoUringSocket&, addClientSocket, (os_fd_t fd, Event::FileReadyCb cb));
+  MOCK_METHOD(Request*, submitAcceptRequest, (IoUringSocket & socket));
+  MOCK_METHOD(Request*, submitConnectRequest,
+              (IoUringSocket & socket, const Network::Address::InstanceConstSharedPtr& address));
+  MOCK_METHOD(Request*, submitReadRequest, (IoUringSocket & socket));
+  MOCK_METHOD(Request*, submitWriteRequest,
+              (IoUringSocket & socket, const Buffer::RawSliceVector& slices));
+  MOCK_METHOD(Request*, submitCloseRequest, (IoUringSocket & socket));
+  MOCK_METHOD(Request*, submitCancelRequest, (IoUringSocket & socket, Request* request_to_cancel));
+  MOCK_METHOD(Request*, submitShutdownRequest, (IoUringSocket & socket, int how));
+};
+
+class MockIoUringWorkerFactory : public IoUringWorkerFactory {
+public:
+  MOCK_METHOD(OptRef<IoUringWorker>, getIoUringWorker, ());
+  MOCK_METHOD(void, onWorkerThreadInitialized, ());
+  MOCK_METHOD(bool, currentThreadRegistered, ());
 };
 
 } // namespace Io
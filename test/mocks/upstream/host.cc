@@ -21,6 +21,9 @@ MockDetector::MockDetector() {
   ON_CALL(*this, addChangedStateCb(_)).WillByDefault(Invoke([this](ChangeStateCb cb) -> void {
     callbacks_.push_back(cb);
   }));
+  ON_CALL(*this, addChangedStatesCb(_)).WillByDefault(Invoke([this](ChangeStatesCb cb) -> void {
+    states_callbacks_.push_back(cb);
+  }));
 }
 
 MockDetector::~MockDetector() = default;
@@ -57,14 +57,19 @@ public:
     for (const ChangeStateCb& cb : callbacks_) {
       cb(host);
     }
+    for (const ChangeStatesCb& cb : states_callbacks_) {
+      cb({host});
+    }
   }
 
   MOCK_METHOD(void, addChangedStateCb, (ChangeStateCb cb));
+  MOCK_METHOD(void, addChangedStatesCb, (ChangeStatesCb cb));
   MOCK_METHOD(double, successRateAverage, (DetectorHostMonitor::SuccessRateMonitorType), (const));
   MOCK_METHOD(double, successRateEjectionThreshold, (DetectorHostMonitor::SuccessRateMonitorType),
               (const));
 
   std::list<ChangeStateCb> callbacks_;
+  std::list<ChangeStatesCb> states_callbacks_;
 };
 
 } // namespace Outlier
@@ -15,6 +15,7 @@ public:
   // Upstream::ThreadAwareLoadBalancer
   MOCK_METHOD(LoadBalancerFactorySharedPtr, factory, ());
   MOCK_METHOD(void, initialize, ());
+  MOCK_METHOD(void, setBuildPool, (LoadBalancerBuildPoolSharedPtr build_pool));
 };
 } // namespace Upstream
 } // namespace Envoy